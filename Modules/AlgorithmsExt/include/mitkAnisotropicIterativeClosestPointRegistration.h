@@ -29,6 +29,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // ITK
 #include <itkMatrix.h>
+#include <itkNumericTraits.h>
 
 // forward declarations
 class vtkPoints;
@@ -61,6 +62,9 @@ namespace mitk
     * Surface representation.
     *
     * \note The correspondence search is accelerated when OpenMP is enabled.
+    * For large surfaces an approximate correspondence search can be enabled
+    * with SetUseApproximateCorrespondences(). Instead of weighting every
+    * point inside the search radius only the closest candidates are weighted.
     *
     * \b Example:
     *
@@ -160,6 +164,14 @@ namespace mitk
     /** Amount of iterations used by the algorithm.*/
     unsigned int m_NumberOfIterations;
 
+    /** Use the approximate correspondence search. Default is false.*/
+    bool m_UseApproximateCorrespondences;
+
+    /** Amount of candidates weighted per point by the approximate
+      * correspondence search. Default is 8.
+      */
+    unsigned int m_MaxNumberOfCandidates;
+
     /** Moving surface that is transformed on the fixed surface.*/
     itk::SmartPointer<Surface> m_MovingSurface;
     /** The fixed / target surface.*/
@@ -200,6 +212,8 @@ namespace mitk
       *        their index in Y and distance.
       * @param radius The search radius used in in kd tree.
       *
+      * If the approximate search is enabled the radius is ignored and only the
+      * m_MaxNumberOfCandidates closest points in the euklidian space are weighted.
       */
     void ComputeCorrespondences(vtkPoints *X,
                                 vtkPoints *Z,
@@ -248,6 +262,23 @@ namespace mitk
       /** Get the number of iterations used by the algorithm.*/
       itkGetMacro(NumberOfIterations, unsigned int)
 
+      /**
+        * Enable the approximate correspondence search. The search terminates
+        * after the closest candidates in the euklidian space are weighted instead
+        * of weighting every point inside the search radius. This trades
+        * accuracy for speed on large surfaces. Default is false.
+        */
+      itkSetMacro(UseApproximateCorrespondences, bool)
+      itkGetMacro(UseApproximateCorrespondences, bool)
+      itkBooleanMacro(UseApproximateCorrespondences)
+
+      /**
+        * Set the amount of candidates weighted per point by the approximate
+        * correspondence search. Default is 8.
+        */
+      itkSetClampMacro(MaxNumberOfCandidates, unsigned int, 1, itk::NumericTraits<unsigned int>::max())
+      itkGetMacro(MaxNumberOfCandidates, unsigned int)
+
       /**
         * Factor that trimms the point set in percent for
         * partial overlapping surfaces. E.g. 0.4 will use 40 precent
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkProgressBar.h>
 #include <mitkSurface.h>
 // VTK
+#include <vtkDataSet.h>
 #include <vtkIdList.h>
 #include <vtkKdTree.h>
 #include <vtkKdTreePointLocator.h>
@@ -48,6 +49,8 @@ mitk::AnisotropicIterativeClosestPointRegistration::AnisotropicIterativeClosestP
     m_FRE(0.0),
     m_TrimmFactor(0.0),
     m_NumberOfIterations(0),
+    m_UseApproximateCorrespondences(false),
+    m_MaxNumberOfCandidates(8),
     m_MovingSurface(nullptr),
     m_FixedSurface(nullptr),
     m_WeightedPointTransform(mitk::WeightedPointTransform::New())
@@ -69,64 +72,87 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
 {
   typedef itk::Matrix<double, 3, 3> WeightMatrix;
 
-#pragma omp parallel for
-  for (vtkIdType i = 0; i < X->GetNumberOfPoints(); ++i)
+  const vtkIdType numberOfPoints = X->GetNumberOfPoints();
+  const int numberOfCandidates = static_cast<int>(m_MaxNumberOfCandidates);
+  const bool approximate = m_UseApproximateCorrespondences;
+  vtkDataSet *fixedPoints = Y->GetDataSet();
+
+  // make sure the tree is built before the threads query it concurrently
+  Y->BuildLocator();
+
+#pragma omp parallel
   {
-    vtkIdType bestIdx = 0;
-    mitk::Vector3D x;
-    mitk::Vector3D y;
-    double bestDist = std::numeric_limits<double>::max();
+    // query state is kept per thread and reused for every point
     vtkIdList *ids = vtkIdList::New();
-    double r = radius;
-    double p[3];
-    // get point
-    X->GetPoint(i, p);
-    // fill vector
-    x[0] = p[0];
-    x[1] = p[1];
-    x[2] = p[2];
-
-    // double the radius till we find at least one point
-    while (ids->GetNumberOfIds() <= 0)
-    {
-      Y->FindPointsWithinRadius(r, p, ids);
-      r *= 2.0;
-    }
 
-    // loop over the points in the sphere and find the point with the
-    // minimal weighted squared distance
-    for (vtkIdType j = 0; j < ids->GetNumberOfIds(); ++j)
+#pragma omp for schedule(dynamic, 256)
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
     {
-      // get id
-      const vtkIdType id = ids->GetId(j);
-      // compute weightmatrix
-      WeightMatrix m = mitk::AnisotropicRegistrationCommon::CalculateWeightMatrix(sigma_X[i], sigma_Y[id]);
-      // point of the fixed data set
-      Y->GetDataSet()->GetPoint(id, p);
+      vtkIdType bestIdx = 0;
+      mitk::Vector3D x;
+      mitk::Vector3D y;
+      double bestDist = std::numeric_limits<double>::max();
+      double r = radius;
+      double p[3];
+      // get point
+      X->GetPoint(i, p);
+      // fill vector
+      x[0] = p[0];
+      x[1] = p[1];
+      x[2] = p[2];
+
+      ids->Reset();
+
+      if (approximate)
+      {
+        // only weight the closest points in the euklidian space
+        Y->FindClosestNPoints(numberOfCandidates, p, ids);
+      }
+      else
+      {
+        // double the radius till we find at least one point
+        while (ids->GetNumberOfIds() <= 0)
+        {
+          Y->FindPointsWithinRadius(r, p, ids);
+          r *= 2.0;
+        }
+      }
 
-      // fill mitk vector
-      y[0] = p[0];
-      y[1] = p[1];
-      y[2] = p[2];
+      // loop over the candidates and find the point with the
+      // minimal weighted squared distance
+      for (vtkIdType j = 0; j < ids->GetNumberOfIds(); ++j)
+      {
+        // get id
+        const vtkIdType id = ids->GetId(j);
+        // compute weightmatrix
+        WeightMatrix m = mitk::AnisotropicRegistrationCommon::CalculateWeightMatrix(sigma_X[i], sigma_Y[id]);
+        // point of the fixed data set
+        fixedPoints->GetPoint(id, p);
 
-      const mitk::Vector3D res = m * (x - y);
+        // fill mitk vector
+        y[0] = p[0];
+        y[1] = p[1];
+        y[2] = p[2];
 
-      const double dist = res[0] * res[0] + res[1] * res[1] + res[2] * res[2];
+        const mitk::Vector3D res = m * (x - y);
 
-      if (dist < bestDist)
-      {
-        bestDist = dist;
-        bestIdx = id;
+        const double dist = res[0] * res[0] + res[1] * res[1] + res[2] * res[2];
+
+        if (dist < bestDist)
+        {
+          bestDist = dist;
+          bestIdx = id;
+        }
       }
-    }
 
-    // save correspondences of the fixed point set
-    Y->GetDataSet()->GetPoint(bestIdx, p);
-    Z->SetPoint(i, p);
-    sigma_Z[i] = sigma_Y[bestIdx];
+      // save correspondences of the fixed point set
+      fixedPoints->GetPoint(bestIdx, p);
+      Z->SetPoint(i, p);
+      sigma_Z[i] = sigma_Y[bestIdx];
 
-    Correspondence _pair(i, bestDist);
-    correspondences[i] = _pair;
+      Correspondence _pair(i, bestDist);
+      correspondences[i] = _pair;
+    }
 
     ids->Delete();
   }
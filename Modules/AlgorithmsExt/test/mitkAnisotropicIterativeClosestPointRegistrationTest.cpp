@@ -26,13 +26,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 /**
  * Test to verify the results of the A-ICP registration.
- * The test runs the standard A-ICP and the trimmed variant.
+ * The test runs the standard A-ICP, the trimmed and the approximate variant.
  */
 class mitkAnisotropicIterativeClosestPointRegistrationTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkAnisotropicIterativeClosestPointRegistrationTestSuite);
   MITK_TEST(testAicpRegistration);
   MITK_TEST(testTrimmedAicpregistration);
+  MITK_TEST(testApproximateAicpRegistration);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -165,6 +166,47 @@ public:
     CPPUNIT_ASSERT_MESSAGE("mitkAnisotropicIterativeClosestPointRegistrationTest:AicpRegistration Test TRE",
                            mitk::Equal(tre, expTRE, 0.01));
   }
+
+  void testApproximateAicpRegistration()
+  {
+    mitk::AnisotropicIterativeClosestPointRegistration::Pointer aICP =
+      mitk::AnisotropicIterativeClosestPointRegistration::New();
+
+    // set up parameters
+    aICP->SetMovingSurface(m_MovingSurface);
+    aICP->SetFixedSurface(m_FixedSurface);
+    aICP->SetCovarianceMatricesMovingSurface(m_SigmasMovingSurface);
+    aICP->SetCovarianceMatricesFixedSurface(m_SigmasFixedSurface);
+    aICP->SetFRENormalizationFactor(m_FRENormalizationFactor);
+    aICP->SetThreshold(0.000001);
+    aICP->UseApproximateCorrespondencesOn();
+    aICP->SetMaxNumberOfCandidates(16);
+
+    // run the algorithm
+    aICP->Update();
+
+    Matrix3x3 identity;
+    identity.SetIdentity();
+    mitk::Vector3D zero;
+    zero.Fill(0.0);
+
+    // the target registration error without registration
+    const double initialTre =
+      mitk::AnisotropicRegistrationCommon::ComputeTargetRegistrationError(m_TargetsMovingSurface.GetPointer(),
+                                                                          m_TargetsFixedSurface.GetPointer(),
+                                                                          identity,
+                                                                          zero);
+
+    const double tre =
+      mitk::AnisotropicRegistrationCommon::ComputeTargetRegistrationError(m_TargetsMovingSurface.GetPointer(),
+                                                                          m_TargetsFixedSurface.GetPointer(),
+                                                                          aICP->GetRotation(),
+                                                                          aICP->GetTranslation());
+
+    MITK_INFO << "TRE: Initial: " << initialTre << ", computed: " << tre;
+    CPPUNIT_ASSERT_MESSAGE("mitkAnisotropicIterativeClosestPointRegistrationTest:ApproximateAicpRegistration Test TRE",
+                           tre < initialTre);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkAnisotropicIterativeClosestPointRegistration)
@@ -0,0 +1,124 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkBackgroundFileWriter_h
+#define mitkBackgroundFileWriter_h
+
+#include <MitkCoreExports.h>
+
+#include <itkConditionVariable.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleMutexLock.h>
+
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+
+namespace mitk
+{
+  /**
+    * \brief Appends records to a file on a background thread.
+    *
+    * Used by writers that record data while it is acquired: the acquiring thread queues
+    * records, e.g. in a mitk::LockFreeRingBuffer, and calls RecordQueued() for each of them.
+    * The writer thread regularly calls the drain function given to Start(), which takes
+    * all queued records and stores them with Write(). The acquiring thread never waits for
+    * the disk.
+    *
+    * If writing fails, the failure is logged once, the remaining records are discarded
+    * and HasFailed() returns true. GetNumberOfStoredRecords() only counts records that
+    * were written and flushed successfully.
+    *
+    * \code
+    * m_FileWriter.Open(fileName, header.data(), header.size());
+    * m_FileWriter.Start([this]() { return this->WriteBufferedRecords(); });
+    * \endcode
+    */
+  class MITKCORE_EXPORT BackgroundFileWriter
+  {
+  public:
+    /** \brief Writes all queued records with Write() and returns how many records were taken from the queues. */
+    typedef std::function<unsigned int()> DrainFunction;
+
+    BackgroundFileWriter();
+
+    /** \brief Calls Close(). Owners must close the writer earlier if the drain function uses their members. */
+    ~BackgroundFileWriter();
+
+    BackgroundFileWriter(const BackgroundFileWriter &) = delete;
+    BackgroundFileWriter &operator=(const BackgroundFileWriter &) = delete;
+
+    /**
+      * \brief Creates the file and writes the header. A previously opened file is closed.
+      * \return false if the file cannot be created or the header cannot be written.
+      */
+    bool Open(const std::string &fileName, const char *header, std::size_t headerSize);
+
+    /** \brief Starts the writer thread, which calls \a drain until Close(). Requires Open(). */
+    void Start(DrainFunction drain);
+
+    /** \brief Lets the writer thread store all queued records, stops it and closes the file. */
+    void Close();
+
+    bool IsOpen() const;
+
+    /** \brief Appends \a size bytes to the file. Only to be called by the drain function. */
+    bool Write(const char *data, std::size_t size);
+
+    /** \brief Counts a record that was queued for the drain function, see Flush(). Does not block. */
+    void RecordQueued() { ++m_NumberOfQueuedRecords; }
+
+    /**
+      * \brief Blocks until all records queued so far were stored or discarded after a failure.
+      * \return false if writing failed since Open().
+      */
+    bool Flush();
+
+    bool HasFailed() const { return m_Failed; }
+
+    /** \brief Returns the number of records written and flushed successfully since Open(). */
+    unsigned int GetNumberOfStoredRecords() const { return m_NumberOfStoredRecords; }
+
+    const std::string &GetFileName() const { return m_FileName; }
+
+  private:
+    static ITK_THREAD_RETURN_TYPE ThreadStartWriting(void *data);
+
+    void Fail(const char *operation);
+
+    std::ofstream m_File;
+    std::string m_FileName;
+    DrainFunction m_Drain;
+
+    std::atomic<bool> m_Failed;
+    std::atomic<bool> m_StopWriting;
+    std::atomic<unsigned int> m_NumberOfQueuedRecords;
+    std::atomic<unsigned int> m_NumberOfStoredRecords;
+
+    unsigned int m_NumberOfWrittenRecords; ///< records of the current drain, only used by the writer thread
+    unsigned int m_NumberOfProcessedRecords; ///< stored or discarded records, guarded by m_Mutex
+
+    itk::SimpleMutexLock m_Mutex;
+    itk::ConditionVariable::Pointer m_RecordsProcessed;
+
+    itk::MultiThreader::Pointer m_MultiThreader;
+    int m_ThreadID;
+  };
+}
+
+#endif
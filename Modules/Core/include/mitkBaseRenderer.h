@@ -346,6 +346,10 @@ namespace mitk
       return m_Name.c_str();
     }
 
+    //##Documentation
+    //## @brief get the interned name of the Renderer, e.g. to look up renderer specific property lists
+    const PropertyKey &GetNameKey() const { return m_NameKey; }
+
     //##Documentation
     //## @brief get the x_size of the RendererWindow
     //## @note
@@ -520,6 +524,8 @@ namespace mitk
 
     std::string m_Name;
 
+    PropertyKey m_NameKey;
+
     double m_Bounds[6];
 
     bool m_EmptyWorldGeometry;
@@ -40,6 +40,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLevelWindow.h"
 #include <map>
 #include <set>
+#include <vector>
 
 class vtkLinearTransform;
 
@@ -228,6 +229,15 @@ namespace mitk
      */
     mitk::BaseProperty *GetProperty(const char *propertyKey, const mitk::BaseRenderer *renderer = nullptr) const;
 
+    /**
+     * \brief Same as GetProperty(const char *, const mitk::BaseRenderer *), but with an interned key.
+     *
+     * Neither the property lists nor the properties are searched by string, which makes this
+     * the preferred variant for properties queried while rendering.
+     * \sa PropertyKey
+     */
+    mitk::BaseProperty *GetProperty(const PropertyKey &propertyKey, const mitk::BaseRenderer *renderer = nullptr) const;
+
     /**
      * \brief Get the property of type T with key \a propertyKey from the PropertyList
      * of the \a renderer, if available there, otherwise use the BaseRenderer-independent PropertyList.
@@ -283,6 +293,18 @@ namespace mitk
       return false;
     }
 
+    template <typename T>
+    bool GetPropertyValue(const PropertyKey &propertyKey, T &value, const mitk::BaseRenderer *renderer = nullptr) const
+    {
+      GenericProperty<T> *gp = dynamic_cast<GenericProperty<T> *>(GetProperty(propertyKey, renderer));
+      if (gp != NULL)
+      {
+        value = gp->GetValue();
+        return true;
+      }
+      return false;
+    }
+
     /// \brief Get a set of all group tags from this node's property list
     GroupTagList GetGroupTags() const;
 
@@ -292,6 +314,9 @@ namespace mitk
      * \return \a true property was found
      */
     bool GetBoolProperty(const char *propertyKey, bool &boolValue, const mitk::BaseRenderer *renderer = nullptr) const;
+    bool GetBoolProperty(const PropertyKey &propertyKey,
+                         bool &boolValue,
+                         const mitk::BaseRenderer *renderer = nullptr) const;
 
     /**
      * \brief Convenience access method for int properties (instances of
@@ -299,6 +324,7 @@ namespace mitk
      * \return \a true property was found
      */
     bool GetIntProperty(const char *propertyKey, int &intValue, const mitk::BaseRenderer *renderer = nullptr) const;
+    bool GetIntProperty(const PropertyKey &propertyKey, int &intValue, const mitk::BaseRenderer *renderer = nullptr) const;
 
     /**
      * \brief Convenience access method for float properties (instances of
@@ -308,6 +334,9 @@ namespace mitk
     bool GetFloatProperty(const char *propertyKey,
                           float &floatValue,
                           const mitk::BaseRenderer *renderer = nullptr) const;
+    bool GetFloatProperty(const PropertyKey &propertyKey,
+                          float &floatValue,
+                          const mitk::BaseRenderer *renderer = nullptr) const;
 
     /**
      * \brief Convenience access method for double properties (instances of
@@ -545,6 +574,11 @@ namespace mitk
      * BaseData.
      */
     unsigned long GetDataReferenceChangedTime() const { return m_DataReferenceChangedTime.GetMTime(); }
+
+    /**
+     * \brief Get the timestamp of the last replacement of a mapper by SetMapper().
+     */
+    unsigned long GetMapperChangedTime() const { return m_MapperChangedTime.GetMTime(); }
   protected:
     DataNode();
 
@@ -573,11 +607,20 @@ namespace mitk
     /// \brief Map associating each BaseRenderer with its own PropertyList
     mutable MapOfPropertyLists m_MapOfPropertyLists;
 
+    /// \brief The lists of m_MapOfPropertyLists sorted by the ids of the interned renderer names
+    mutable std::vector<std::pair<PropertyKey::IdType, PropertyList *>> m_RendererPropertyLists;
+
+    /// \brief Returns the PropertyList specific to \a renderer or NULL if there is none
+    PropertyList *FindRendererPropertyList(const mitk::BaseRenderer *renderer) const;
+
     DataInteractor::Pointer m_DataInteractor;
 
     /// \brief Timestamp of the last change of m_Data
     itk::TimeStamp m_DataReferenceChangedTime;
 
+    /// \brief Timestamp of the last change of m_Mappers by SetMapper()
+    itk::TimeStamp m_MapperChangedTime;
+
     unsigned long m_PropertyListModifiedObserverTag;
   };
 
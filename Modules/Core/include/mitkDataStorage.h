@@ -23,8 +23,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataNode.h"
 #include "mitkGeometry3D.h"
 #include "mitkMessage.h"
+#include "mitkNodePredicateBase.h"
 #include <MitkCoreExports.h>
 #include <map>
+#include <set>
+#include <vector>
 
 namespace mitk
 {
@@ -218,6 +221,16 @@ namespace mitk
     // a Message1 object which is thread safe
     DataStorageEvent AddNodeEvent;
 
+    typedef Message1<const SetOfObjects *> DataStorageNodesEvent;
+    //##Documentation
+    //## @brief AddNodesEvent is emitted once after the AddNodeEvents of one or more added nodes.
+    //##
+    //## A single Add() emits it with this node, EndBatch() emits it with all nodes added during the batch.
+    //## Observers whose reaction does not depend on the individual node, e.g. updating a list of all nodes,
+    //## should register to this event instead of AddNodeEvent to react only once per batch. LevelWindowManager
+    //## and the data manager tree and table models do so, observers of AddNodeEvent still react once per node.
+    DataStorageNodesEvent AddNodesEvent;
+
     //##Documentation
     //## @brief RemoveEvent is emitted directly before a node is removed from the DataStorage.
     //##
@@ -375,6 +388,60 @@ namespace mitk
     //## react.
     void BlockNodeModifiedEvents(bool block);
 
+    //##Documentation
+    //## @brief Adds a property key to the keys for which GetSubset() keeps an index.
+    //##
+    //## For every indexed key the DataStorage knows which nodes have the property in their renderer
+    //## independent property list and, for string, bool, integer and enumeration properties, which nodes
+    //## have which value. GetSubset() uses these indexes and an index of the data types to answer
+    //## NodePredicateProperty conditions without renderer and NodePredicateDataType conditions, also as
+    //## part of a NodePredicateAnd, by checking only the nodes found in the index. The result of such conditions
+    //## is in the order the nodes were added, so GetNamedNode() returns the first added node of duplicate names.
+    //## The "name" property is always indexed, so GetNamedNode() does not check all nodes.
+    void AddIndexedPropertyKey(const std::string &propertyKey);
+
+    //##Documentation
+    //## @brief Defines whether GetSubset() reuses the results of its conditions.
+    //##
+    //## If enabled, the result of a condition for a node is kept until the node is modified (any event that
+    //## also leads to ChangedNodeEvent, even if it is blocked, or a change of an indexed property) or the
+    //## condition itself is modified. Changes that do not notify the node, e.g. of renderer specific
+    //## properties or of property objects that are changed in place, are not seen, and conditions that
+    //## depend on anything else than the node must not be used. Therefore caching is disabled by default.
+    void SetPredicateCaching(bool enable);
+    bool GetPredicateCaching() const;
+
+    //##Documentation
+    //## @brief Starts adding a batch of nodes, which is completed by EndBatch().
+    //##
+    //## Nodes added until EndBatch() are stored immediately and found by all queries, but the DataStorage
+    //## neither observes them nor emits AddNodeEvent for them yet, so modifying them does not emit
+    //## ChangedNodeEvent. EndBatch() registers the observers, emits AddNodeEvent for each node that is still
+    //## in the DataStorage, then AddNodesEvent once for all of them, and requests one update of all render
+    //## windows. A node removed before EndBatch() is not reported at all, neither by AddNodeEvent nor by
+    //## RemoveNodeEvent. Batches can be nested, only the outermost EndBatch() completes the batch, an
+    //## EndBatch() without BeginBatch() throws an mitk::Exception. Use BatchScope to end the batch also
+    //## if adding the nodes throws.
+    void BeginBatch();
+    void EndBatch();
+
+    //##Documentation
+    //## @brief Calls BeginBatch() of a DataStorage on construction and EndBatch() on destruction.
+    //##
+    //## Exceptions of the AddNodeEvent and AddNodesEvent observers are logged by the destructor, not thrown.
+    class MITKCORE_EXPORT BatchScope
+    {
+    public:
+      explicit BatchScope(DataStorage *dataStorage);
+      ~BatchScope();
+
+    private:
+      BatchScope(const BatchScope &) = delete;
+      BatchScope &operator=(const BatchScope &) = delete;
+
+      DataStorage::Pointer m_DataStorage;
+    };
+
   protected:
     //##Documentation
     //## @brief  EmitAddNodeEvent emits the AddNodeEvent
@@ -405,6 +472,30 @@ namespace mitk
     //## @brief  Removes a Modified-Listener from the given Node.
     void RemoveListeners(const mitk::DataNode *_Node);
 
+    //##Documentation
+    //## @brief  Adds the node to the indexes used by GetSubset().
+    //##
+    //## Subclasses that call AddToIndex() and RemoveFromIndex() for all of their nodes set m_UseIndex.
+    void AddToIndex(const mitk::DataNode *node);
+
+    //##Documentation
+    //## @brief  Removes the node from the indexes used by GetSubset().
+    void RemoveFromIndex(const mitk::DataNode *node);
+
+    //##Documentation
+    //## @brief  Returns true and remembers the node for EndBatch() if a batch is active.
+    //##
+    //## Subclasses call this when adding a node and only call AddListeners() and EmitAddNodeEvent() for it
+    //## if it returns false.
+    bool DeferNodeAddition(const mitk::DataNode *node);
+
+    //##Documentation
+    //## @brief  Returns true and forgets the node if its addition was deferred by the active batch.
+    //##
+    //## Subclasses call this when removing a node and do not call EmitRemoveNodeEvent() for it if it returns
+    //## true, because the observers were not told about its addition yet.
+    bool CancelNodeAddition(const mitk::DataNode *node);
+
     //##Documentation
     //## @brief  Saves Modified-Observer Tags for each node in order to remove the event listeners again.
     std::map<const mitk::DataNode *, unsigned long> m_NodeModifiedObserverTags;
@@ -420,6 +511,10 @@ namespace mitk
     //## to suppress NodeChangedEvent to be emitted.
     bool m_BlockNodeModifiedEvents;
 
+    //##Documentation
+    //## @brief True if the subclass keeps the indexes up to date, see AddToIndex()
+    bool m_UseIndex;
+
     //##Documentation
     //## @brief Standard Constructor for ::New() instantiation
     DataStorage();
@@ -434,6 +529,72 @@ namespace mitk
     //##Documentation
     //## @brief Prints the contents of the DataStorage to os. Do not call directly, call ->Print() instead
     virtual void PrintSelf(std::ostream &os, itk::Indent indent) const override;
+
+  private:
+    typedef std::set<const mitk::DataNode *> NodeSet;
+
+    struct IndexedProperty
+    {
+      BaseProperty::Pointer Property;
+      std::string Value;
+      bool HasValue;
+    };
+
+    struct NodeIndexEntry
+    {
+      std::string DataType;
+      std::map<std::string, IndexedProperty> Properties;
+      unsigned long Generation;
+      unsigned long Sequence; // order in which the nodes were added to the index
+    };
+
+    struct PropertyIndex
+    {
+      NodeSet Nodes;
+      std::map<std::string, NodeSet> NodesByValue;
+    };
+
+    struct PropertyObserver
+    {
+      unsigned long Tag;
+      NodeSet Nodes;
+    };
+
+    struct PredicateCacheEntry
+    {
+      NodePredicateBase::ConstPointer Predicate; // keeps the address from being reused by another predicate
+      unsigned long PredicateMTime;
+      std::map<const mitk::DataNode *, std::pair<unsigned long, bool>> Results;
+    };
+
+    //##Documentation
+    //## @brief Updates the index entry of the node, m_IndexMutex has to be locked
+    void UpdateIndexEntry(const mitk::DataNode *node, NodeIndexEntry &entry);
+    void RemoveIndexEntry(const mitk::DataNode *node, NodeIndexEntry &entry);
+
+    //##Documentation
+    //## @brief Returns the indexed nodes that can fulfill the condition or nullptr if the index does not help,
+    //## m_IndexMutex has to be locked
+    const NodeSet *FindIndexedCandidates(const NodePredicateBase *condition) const;
+
+    void OnIndexedPropertyModified(const itk::Object *caller, const itk::EventObject &event);
+
+    mutable itk::SimpleFastMutexLock m_IndexMutex;
+    std::set<std::string> m_IndexedPropertyKeys;
+    std::map<const mitk::DataNode *, NodeIndexEntry> m_NodeIndex;
+    std::map<std::string, NodeSet> m_DataTypeIndex;
+    std::map<std::string, PropertyIndex> m_PropertyIndex;
+    std::map<const BaseProperty *, PropertyObserver> m_PropertyObservers;
+    unsigned long m_IndexGeneration;
+    unsigned long m_IndexSequence;
+
+    bool m_PredicateCaching;
+    mutable std::map<const NodePredicateBase *, PredicateCacheEntry> m_PredicateCache;
+
+    //##Documentation
+    //## @brief Nesting depth of BeginBatch() and the nodes added in the batch, both guarded by m_MutexOne
+    unsigned int m_BatchDepth;
+    std::vector<DataNode::ConstPointer> m_BatchNodes;
   };
 } // namespace mitk
 
@@ -94,6 +94,15 @@ namespace mitk
      */
     virtual std::istream *GetInputStream() const = 0;
 
+    /**
+     * @brief Returns true if Read() reads the stream set by SetInput() directly and sequentially.
+     *
+     * Readers returning false copy an input stream to a temporary file first, see
+     * AbstractFileReader::GetLocalFileName(). Callers which can provide a file should
+     * pass its path to such readers instead of a stream. The default returns false.
+     */
+    virtual bool CanReadStream() const;
+
     /**
      * \brief Reads the specified file or input stream and returns its contents.
      *
@@ -232,6 +232,20 @@ namespace mitk
 
     static std::vector<BaseData::Pointer> Load(const std::vector<std::string> &paths);
 
+    /**
+     * @brief Enables or disables reading several files concurrently.
+     *
+     * If enabled, the Load() methods for several files select the readers and query
+     * reader options for all files first and then read the files on a thread pool.
+     * The loaded data and nodes are returned, and added to a DataStorage, in the order
+     * of the given paths. Each file is read by its own reader instance, but readers
+     * which use global state internally may not support this mode.
+     * Concurrent loading is disabled by default.
+     */
+    static void SetConcurrentLoading(bool concurrent);
+
+    static bool GetConcurrentLoading();
+
     /**
      * Load files in <code>fileNames</code> and add the constructed mitk::DataNode instances
      * to the mitk::DataStorage <code>storage</code>
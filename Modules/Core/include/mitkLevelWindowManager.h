@@ -91,6 +91,11 @@ namespace mitk
       */
     void DataStorageAddedNode(const DataNode *n = nullptr);
 
+    /** @brief Like DataStorageAddedNode(), but called only once for all nodes that were added together,
+      *        see DataStorage::AddNodesEvent.
+      */
+    void DataStorageAddedNodes(const DataStorage::SetOfObjects *nodes);
+
     /** @brief This method is called when a node is removed to the data storage.
       *        A listener on the data storage is used to call this method automatically directly before a node will be
      * removed.
@@ -0,0 +1,180 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkLockFreeRingBuffer_h
+#define __mitkLockFreeRingBuffer_h
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Bounded queue for exactly one producer thread and one consumer thread.
+
+    Neither TryPush() nor TryPop() block or allocate memory: all slots are
+    created by the constructor and elements are moved in and out of them.
+    This makes the buffer suitable for handing data from time critical
+    threads (e.g. tracking or network receive loops) to a worker thread.
+
+    The capacity is rounded up to the next power of two. Calling TryPush()
+    from more than one thread or TryPop() from more than one thread at the
+    same time is not supported.
+
+    \code
+
+    mitk::LockFreeRingBuffer<Sample> buffer(1024);
+
+    // producer thread
+    if (!buffer.TryPush(sample))
+      ++droppedSamples;
+
+    // consumer thread
+    Sample sample;
+    while (buffer.TryPop(sample))
+      Write(sample);
+    \endcode
+  */
+  template <typename T>
+  class LockFreeRingBuffer
+  {
+  public:
+    explicit LockFreeRingBuffer(std::size_t capacity) : m_Head(0), m_Tail(0) { this->Allocate(capacity, T()); }
+
+    /** \brief Initializes all slots with copies of \a prototype, e.g. to preallocate buffers held by the elements. */
+    LockFreeRingBuffer(std::size_t capacity, const T &prototype) : m_Head(0), m_Tail(0)
+    {
+      this->Allocate(capacity, prototype);
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer &) = delete;
+    LockFreeRingBuffer &operator=(const LockFreeRingBuffer &) = delete;
+
+    /** \brief Appends a copy of \a value. Returns false if the buffer is full. Producer thread only. */
+    bool TryPush(const T &value)
+    {
+      const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+      if (tail - m_Head.load(std::memory_order_acquire) > m_Mask)
+        return false;
+
+      m_Slots[tail & m_Mask] = value;
+      m_Tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /** \brief Moves \a value into the buffer. Returns false (leaving \a value untouched) if the buffer is full. */
+    bool TryPush(T &&value)
+    {
+      const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+      if (tail - m_Head.load(std::memory_order_acquire) > m_Mask)
+        return false;
+
+      m_Slots[tail & m_Mask] = std::move(value);
+      m_Tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+      \brief Returns a pointer to the next free slot or nullptr if the buffer is full. Producer thread only.
+
+      Together with PushBack() this fills a slot in place, e.g. to reuse the buffers held by the elements.
+      The slot still holds whatever element was stored in it before.
+    */
+    T *Back()
+    {
+      const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+      if (tail - m_Head.load(std::memory_order_acquire) > m_Mask)
+        return nullptr;
+
+      return &m_Slots[tail & m_Mask];
+    }
+
+    /** \brief Appends the slot filled after it was accessed by Back(). Producer thread only. */
+    void PushBack() { m_Tail.store(m_Tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /**
+      \brief Moves the oldest element to \a value. Returns false if the buffer is empty. Consumer thread only.
+
+      The slot is reset afterwards, so the buffer does not keep e.g. smart pointers
+      without move semantics alive.
+    */
+    bool TryPop(T &value)
+    {
+      const std::size_t head = m_Head.load(std::memory_order_relaxed);
+      if (head == m_Tail.load(std::memory_order_acquire))
+        return false;
+
+      value = std::move(m_Slots[head & m_Mask]);
+      m_Slots[head & m_Mask] = T();
+      m_Head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    /** \brief Returns a pointer to the oldest element or nullptr if the buffer is empty. Consumer thread only. */
+    T *Front()
+    {
+      const std::size_t head = m_Head.load(std::memory_order_relaxed);
+      if (head == m_Tail.load(std::memory_order_acquire))
+        return nullptr;
+
+      return &m_Slots[head & m_Mask];
+    }
+
+    /** \brief Removes the oldest element after it was accessed by Front(). Consumer thread only. */
+    void PopFront() { m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    /** \brief Number of elements; only a snapshot while the other thread is active. */
+    std::size_t GetSize() const
+    {
+      return m_Tail.load(std::memory_order_acquire) - m_Head.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const { return this->GetSize() == 0; }
+
+    std::size_t GetCapacity() const { return m_Slots.size(); }
+
+  private:
+    void Allocate(std::size_t capacity, const T &prototype)
+    {
+      std::size_t size = 2;
+      while (size < capacity)
+        size <<= 1;
+
+      m_Slots.assign(size, prototype);
+      m_Mask = size - 1;
+    }
+
+    // larger than or equal to the cache line size of common processors
+    static const std::size_t CacheLineSize = 64;
+
+    std::vector<T> m_Slots;
+    std::size_t m_Mask;
+
+    // head is only written by the consumer, tail only by the producer;
+    // both count continuously and are mapped to slots via m_Mask. The padding
+    // keeps them in separate cache lines, so that the threads do not
+    // invalidate each other's cache when updating their own index.
+    char m_PaddingBeforeHead[CacheLineSize];
+    std::atomic<std::size_t> m_Head;
+    char m_PaddingBeforeTail[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_Tail;
+    char m_PaddingAfterTail[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+  };
+}
+
+#endif
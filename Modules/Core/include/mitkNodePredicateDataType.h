@@ -44,6 +44,8 @@ namespace mitk
     //## @brief Checks, if the nodes data object is of a specific data type
     virtual bool CheckNode(const mitk::DataNode *node) const override;
 
+    const std::string &GetValidDataType() const { return m_ValidDataType; }
+
   protected:
     //##Documentation
     //## @brief Protected constructor, use static instantiation functions instead
@@ -0,0 +1,93 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkPlaneCutIndex_h
+#define mitkPlaneCutIndex_h
+
+#include <MitkCoreExports.h>
+
+#include <itkMultiThreader.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    * \brief Finds the cells of a vtkPolyData that a plane of a given orientation may cut.
+    *
+    * Every cell is projected onto the plane normal and sorted into buckets by the range
+    * of its projection. FindCells() only looks at the bucket containing the plane, so
+    * cutting a slice out of a large mesh (see PlaneCutIndex::ExtractCells()) does not visit
+    * all cells. The result is a superset of the cells a vtkCutter would cut.
+    *
+    * The index is created for a polydata and a normal but built only by Build(), so that
+    * users can create it cheaply to remember a request and build it when it is repeated.
+    * Build() uses several threads for large meshes.
+    *
+    * \sa SurfaceVtkMapper2D
+    */
+  class MITKCORE_EXPORT PlaneCutIndex
+  {
+  public:
+    /** \param normal normal of the planes, need not be normalized. */
+    PlaneCutIndex(vtkPolyData *polyData, const double normal[3]);
+
+    /** \brief Returns true if the index belongs to the current state of \a polyData, i.e. to its pointer and MTime. */
+    bool IsValidFor(vtkPolyData *polyData) const;
+
+    /** \brief Returns true if the index belongs to the current state of \a polyData and planes parallel to \a normal. */
+    bool IsValidFor(vtkPolyData *polyData, const double normal[3]) const;
+
+    void Build();
+    bool IsBuilt() const { return m_Built; }
+
+    /** \brief Returns the ids of the cells that the plane through \a origin might cut. Requires Build(). */
+    void FindCells(const double origin[3], std::vector<vtkIdType> &cellIds) const;
+
+    /** \brief Copies the cells \a cellIds of \a polyData together with their points, point data and cell data. */
+    static vtkSmartPointer<vtkPolyData> ExtractCells(vtkPolyData *polyData, const std::vector<vtkIdType> &cellIds);
+
+  private:
+    typedef std::pair<float, float> RangeType;
+
+    std::size_t GetBucket(double distance) const;
+    void ComputeRanges(vtkIdType firstCell, vtkIdType endCell);
+
+    static ITK_THREAD_RETURN_TYPE ComputeRangesThread(void *arg);
+
+    vtkSmartPointer<vtkPolyData> m_PolyData;
+    unsigned long m_PolyDataMTime;
+    double m_Normal[3];
+    bool m_Built;
+
+    /// projections of the cells onto the normal, rounded outwards to float
+    std::vector<RangeType> m_Ranges;
+
+    double m_Minimum;
+    double m_Maximum;
+    double m_BucketWidth;
+
+    /// cells of bucket i are m_BucketCells[m_BucketOffsets[i]] to m_BucketCells[m_BucketOffsets[i + 1] - 1]
+    std::vector<std::size_t> m_BucketOffsets;
+    std::vector<vtkIdType> m_BucketCells;
+  };
+}
+
+#endif
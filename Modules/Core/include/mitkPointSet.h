@@ -18,12 +18,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define MITKPointSet_H_HEADER_INCLUDED
 
 #include "mitkBaseData.h"
+#include "mitkPointSetSpatialIndex.h"
 
 #include <itkDefaultDynamicMeshTraits.h>
 #include <itkMesh.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <memory>
 
 namespace mitk
 {
+  class PlaneGeometry;
+
   /**
    * \brief Data structure which stores a set of points. Superclass of
    * mitk::Mesh.
@@ -53,6 +59,15 @@ namespace mitk
    * which is also derived from itk::PointSet. Thus several typedefs which seem
    * to be in wrong place, are declared here (for example SelectedLinesType).
    *
+   * Spatial queries (SearchPoint(), SearchClosestPoint(), SearchPointsNearPlane())
+   * use a mitk::PointSetSpatialIndex for time steps with at least
+   * SpatialIndexThreshold points. The index is built on the first query and kept
+   * up to date incrementally when points are inserted, moved or removed through
+   * the methods of this class. Changes made directly to the itk::PointSet are
+   * detected and lead to a rebuild on the next query. Queries may run concurrently,
+   * e.g. from mappers of several render windows, as long as the points are not changed
+   * at the same time.
+   *
    * \section mitkPointSetDisplayOptions
    *
    * The default mappers for this data structure are mitk::PointSetGLMapper2D and
@@ -89,6 +104,9 @@ namespace mitk
     static const unsigned int PointDimension = 3;
     static const unsigned int MaxTopologicalDimension = 3;
 
+    /** \brief minimal number of points of a time step for which spatial queries use an index */
+    static const int SpatialIndexThreshold = 64;
+
     /**
      * \brief struct for data of a point
      */
@@ -139,6 +157,7 @@ namespace mitk
     typedef DataType::PointDataContainer PointDataContainer;
     typedef DataType::PointDataContainerIterator PointDataIterator;
     typedef DataType::PointDataContainerIterator PointDataConstIterator;
+    typedef std::vector<PointIdentifier> PointIdentifierList;
 
     virtual void Expand(unsigned int timeSteps) override;
 
@@ -255,6 +274,29 @@ namespace mitk
      */
     int SearchPoint(Point3D point, ScalarType distance, int t = 0) const;
 
+    /**
+     * \brief searches the point closest to the given point
+     *
+     * \param point is in world coordinates.
+     * \param distance is the maximal euclidean distance in mm.
+     * returns -1 if no point is closer than distance, otherwise the id
+     * of the closest point
+     */
+    int SearchClosestPoint(Point3D point, ScalarType distance, int t = 0) const;
+
+    /**
+     * \brief searches all points with a distance to the plane smaller than
+     * the given distance
+     *
+     * \param plane is the plane in world coordinates.
+     * \param distance is in mm.
+     * \param ids receives the ids of the points found in ascending order.
+     */
+    void SearchPointsNearPlane(const PlaneGeometry *plane,
+                               ScalarType distance,
+                               PointIdentifierList &ids,
+                               int t = 0) const;
+
     virtual bool IsEmptyTimeStep(unsigned int t) const override;
 
     // virtual methods, that need to be implemented
@@ -283,6 +325,27 @@ namespace mitk
     /** \brief swaps point coordinates and point data of the points with identifiers id1 and id2 */
     bool SwapPointContents(PointIdentifier id1, PointIdentifier id2, int t = 0);
 
+    /**
+     * \brief returns the spatial index of the time step, (re)built if necessary,
+     * or nullptr if the time step has too few points to benefit from an index
+     *
+     * The returned index is owned by the caller as well, a concurrent rebuild or
+     * update replaces the index of the point set instead of modifying it.
+     */
+    std::shared_ptr<const PointSetSpatialIndex> GetSpatialIndex(int t) const;
+
+    /** \brief returns true if the spatial index of the time step reflects the current points */
+    bool IsSpatialIndexUpToDate(int t) const;
+
+    /**
+     * \brief updates the spatial index after a single point was changed
+     *
+     * \a oldPoint and \a newPoint are in index coordinates; pass nullptr for
+     * inserted or removed points. Only call this if IsSpatialIndexUpToDate()
+     * returned true before the point was changed.
+     */
+    void UpdateSpatialIndex(int t, PointIdentifier id, const PointType *oldPoint, const PointType *newPoint);
+
     typedef std::vector<DataType::Pointer> PointSetSeries;
 
     PointSetSeries m_PointSetSeries;
@@ -293,6 +356,16 @@ namespace mitk
     * @brief flag to indicate the right time to call SetBounds
     **/
     bool m_CalculateBoundingBox;
+
+    /**
+    * @brief lazily built spatial indices, one per time step
+    **/
+    mutable std::vector<std::shared_ptr<PointSetSpatialIndex>> m_SpatialIndices;
+
+    /**
+    * @brief guards building m_SpatialIndices from const queries
+    **/
+    mutable itk::SimpleFastMutexLock m_SpatialIndicesMutex;
   };
 
   /**
@@ -0,0 +1,130 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPOINTSETSPATIALINDEX_H_HEADER_INCLUDED
+#define MITKPOINTSETSPATIALINDEX_H_HEADER_INCLUDED
+
+#include <MitkCoreExports.h>
+#include <mitkNumericTypes.h>
+
+#include <itkMapContainer.h>
+#include <itkPoint.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Uniform grid over the points of a single time step of a mitk::PointSet.
+   *
+   * The point identifiers are hashed into cubic cells whose size is derived from
+   * the extent and the number of the indexed points. Queries return the identifiers
+   * of all points inside the cells touched by the query region, i.e. a superset of
+   * the points actually matching; the caller is responsible for the exact test.
+   *
+   * The grid works on the points as stored in the container (index coordinates of
+   * the point set). It remembers the modification time of the container it was
+   * built from, so that changes which bypass mitk::PointSet are detected by
+   * IsUpToDate() and lead to a rebuild instead of wrong query results.
+   *
+   * \ingroup Data
+   */
+  class MITKCORE_EXPORT PointSetSpatialIndex
+  {
+  public:
+    typedef itk::IdentifierType PointIdentifier;
+    typedef itk::Point<ScalarType, 3> PointType;
+    typedef itk::MapContainer<PointIdentifier, PointType> PointsContainer;
+    typedef std::vector<PointIdentifier> PointIdentifierList;
+
+    PointSetSpatialIndex();
+
+    /** \brief Rebuilds the grid from all points of the container. */
+    void Build(const PointsContainer *points);
+
+    /** \brief Releases the grid. IsUpToDate() returns false afterwards. */
+    void Clear();
+
+    /** \brief Returns true if the grid reflects the current state of the container. */
+    bool IsUpToDate(const PointsContainer *points) const;
+
+    /**
+     * \brief Incrementally updates the grid after a single point of the container changed.
+     *
+     * Pass \a oldPoint == nullptr for inserted points and \a newPoint == nullptr
+     * for removed points. Must only be called if the grid was up to date before
+     * the container was modified.
+     */
+    void Update(const PointsContainer *points,
+                PointIdentifier id,
+                const PointType *oldPoint,
+                const PointType *newPoint);
+
+    /**
+     * \brief Appends the identifiers of all points in the cells overlapping the
+     * axis aligned box [lower, upper] to \a ids.
+     */
+    void FindPointsInBox(const PointType &lower, const PointType &upper, PointIdentifierList &ids) const;
+
+    /**
+     * \brief Appends the identifiers of all points in the cells for which
+     * \a cellPredicate(lower, upper) returns true to \a ids.
+     *
+     * Only occupied cells are visited, which allows queries whose region is not
+     * an axis aligned box (e.g. a slab around a plane).
+     */
+    template <typename TCellPredicate>
+    void FindPointsInCells(TCellPredicate cellPredicate, PointIdentifierList &ids) const
+    {
+      PointType lower;
+      PointType upper;
+      for (auto it = m_Cells.begin(); it != m_Cells.end(); ++it)
+      {
+        this->GetCellBounds(it->first, lower, upper);
+        if (cellPredicate(lower, upper))
+        {
+          ids.insert(ids.end(), it->second.begin(), it->second.end());
+        }
+      }
+    }
+
+    /** \brief Returns the number of indexed points. */
+    std::size_t GetNumberOfPoints() const { return m_NumberOfPoints; }
+
+  private:
+    typedef std::int64_t CellKey;
+    typedef std::unordered_map<CellKey, PointIdentifierList> CellMap;
+
+    CellKey GetCellKey(const PointType &point) const;
+    CellKey GetCellKey(const std::int64_t cell[3]) const;
+    void GetCellIndex(const PointType &point, std::int64_t cell[3]) const;
+    void GetCellBounds(CellKey key, PointType &lower, PointType &upper) const;
+
+    void AddToCell(PointIdentifier id, const PointType &point);
+    void RemoveFromCell(PointIdentifier id, const PointType &point);
+
+    CellMap m_Cells;
+    PointType m_Origin;
+    ScalarType m_CellSize;
+    std::size_t m_NumberOfPoints;
+    bool m_Built;
+    unsigned long m_ContainerMTime;
+  };
+}
+
+#endif /* MITKPOINTSETSPATIALINDEX_H_HEADER_INCLUDED */
@@ -219,6 +219,17 @@ namespace mitk
    * PlaneGeometry is applied to the orienation of the glyphs. */
     virtual void CreateVTKRenderObjects(mitk::BaseRenderer *renderer);
 
+    /* \brief Adds the glyph and, if the "label" property is set, the text label of a point
+    * which lies within m_DistanceToPlane of the current slice. If the contour is not shown,
+    * only the points found by PointSet::SearchPointsNearPlane() are visited. */
+    void CreatePointMarker(LocalStorage *ls,
+                           const mitk::Point3D &point,
+                           const mitk::Point2D &pt2d,
+                           float dist,
+                           bool selected,
+                           itk::IdentifierType id,
+                           bool appendIdToLabel);
+
     // member variables holding the current value of the properties used in this mapper
     bool m_ShowContour;           // "show contour" property
     bool m_CloseContour;          // "close contour" property
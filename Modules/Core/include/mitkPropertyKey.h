@@ -0,0 +1,64 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkPropertyKey_h
+#define mitkPropertyKey_h
+
+#include <MitkCoreExports.h>
+#include <string>
+
+namespace mitk
+{
+  /** \brief Interned name of a property.
+    *
+    * Each distinct name is registered once in a process wide table and mapped to a small integer id,
+    * so comparing or looking up keys does not compare strings. PropertyList and DataNode provide
+    * overloads taking a PropertyKey which are meant for code that queries the same properties very
+    * often, e.g. mappers during rendering. Create the keys once and reuse them:
+    *
+    * \code
+    * static const mitk::PropertyKey opacityKey("opacity");
+    * float opacity = 1.0f;
+    * node->GetFloatProperty(opacityKey, opacity, renderer);
+    * \endcode
+    *
+    * The default constructed key is the empty name. Creating keys is thread-safe.
+    */
+  class MITKCORE_EXPORT PropertyKey
+  {
+  public:
+    typedef unsigned int IdType;
+
+    PropertyKey();
+    explicit PropertyKey(const char *name);
+    explicit PropertyKey(const std::string &name);
+
+    IdType GetId() const { return m_Id; }
+    const std::string &GetName() const;
+
+    /** \brief Returns true and sets \a id if \a name was interned before, without registering it. */
+    static bool Find(const std::string &name, IdType &id);
+
+    bool operator==(const PropertyKey &other) const { return m_Id == other.m_Id; }
+    bool operator!=(const PropertyKey &other) const { return m_Id != other.m_Id; }
+    bool operator<(const PropertyKey &other) const { return m_Id < other.m_Id; }
+
+  private:
+    IdType m_Id;
+  };
+}
+
+#endif
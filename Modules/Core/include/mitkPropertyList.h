@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBaseProperty.h"
 #include "mitkGenericProperty.h"
+#include "mitkPropertyKey.h"
 #include "mitkUIDGenerator.h"
 #include <MitkCoreExports.h>
 
@@ -26,6 +27,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace mitk
 {
@@ -83,6 +86,14 @@ namespace mitk
      */
     mitk::BaseProperty *GetProperty(const std::string &propertyKey) const;
 
+    /**
+     * @brief Get a property by its interned name.
+     *
+     * Searches a flat array sorted by key id instead of the string map,
+     * which is considerably faster for lists queried repeatedly.
+     */
+    mitk::BaseProperty *GetProperty(const PropertyKey &propertyKey) const;
+
     /**
      * @brief Set a property in the list/map by value.
      *
@@ -124,6 +135,18 @@ namespace mitk
       return false;
     }
 
+    template <typename T>
+    bool GetPropertyValue(const PropertyKey &propertyKey, T &value) const
+    {
+      GenericProperty<T> *gp = dynamic_cast<GenericProperty<T> *>(GetProperty(propertyKey));
+      if (gp != nullptr)
+      {
+        value = gp->GetValue();
+        return true;
+      }
+      return false;
+    }
+
     /**
     * @brief Convenience method to access the value of a BoolProperty
     */
@@ -245,6 +268,17 @@ namespace mitk
     PropertyMap m_Properties;
 
   private:
+    typedef std::vector<std::pair<PropertyKey::IdType, BaseProperty *>> PropertyIndex;
+
+    void AddToIndex(const std::string &propertyKey, BaseProperty *property);
+    void RemoveFromIndex(const std::string &propertyKey);
+
+    /**
+     * @brief The properties of m_Properties sorted by the ids of their interned keys.
+     * Holds plain pointers, the map keeps the properties alive.
+     */
+    PropertyIndex m_Index;
+
     virtual itk::LightObject::Pointer InternalClone() const override;
   };
 
@@ -224,6 +224,24 @@ namespace mitk
     /** En-/Disable LOD abort mechanism. */
     itkBooleanMacro(LODAbortMechanismEnabled);
 
+    /** En-/Disable concurrent mapper updates.
+     *
+     * If enabled, ExecutePendingRequests() lets the mappers of all pending
+     * VtkPropRenderers generate their data (e.g. reslice images) on a thread
+     * pool first and renders the windows one after another afterwards. All
+     * mappers of a data node are updated by the same thread, one renderer
+     * after the other. Only use this if the mappers in use neither modify
+     * data of other nodes nor request updates in Update(). Disabled by default.
+     * \sa VtkPropRenderer::GetLastMapperUpdateTime()
+     * \sa VtkPropRenderer::GetLastMapperRenderTime() */
+    itkSetMacro(ConcurrentMapperUpdates, bool);
+
+    /** En-/Disable concurrent mapper updates. */
+    itkGetMacro(ConcurrentMapperUpdates, bool);
+
+    /** En-/Disable concurrent mapper updates. */
+    itkBooleanMacro(ConcurrentMapperUpdates);
+
     /** Force a sub-class to start a timer for a pending hires-rendering request */
     virtual void StartOrResetTimer(){};
 
@@ -323,6 +341,8 @@ namespace mitk
 
     bool m_LODAbortMechanismEnabled;
 
+    bool m_ConcurrentMapperUpdates;
+
     BoolVector m_ShadingEnabled;
 
     bool m_ClippingPlaneEnabled;
@@ -359,6 +379,9 @@ namespace mitk
     bool m_ConstrainedPanningZooming;
 
   private:
+    /** Updates the mappers of the given windows on a thread pool, split by data node. */
+    void UpdateMappersConcurrently(const std::vector<vtkRenderWindow *> &renderWindows);
+
     void InternalViewInitialization(mitk::BaseRenderer *baseRenderer,
                                     const mitk::TimeGeometry *geometry,
                                     bool boundingBoxInitialized,
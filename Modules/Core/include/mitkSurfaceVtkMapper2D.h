@@ -22,6 +22,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkVtkMapper.h"
 #include <MitkCoreExports.h>
 
+#include <itkSimpleFastMutexLock.h>
+
+#include <deque>
+#include <memory>
+
 // VTK
 #include <vtkSmartPointer.h>
 class vtkAssembly;
@@ -31,18 +36,26 @@ class vtkLookupTable;
 class vtkGlyph3D;
 class vtkArrowSource;
 class vtkReverseSense;
+class vtkPolyData;
+class vtkTransformPolyDataFilter;
 
 namespace mitk
 {
+  class PlaneCutIndex;
   class Surface;
 
   /**
     * @brief Vtk-based mapper for cutting 2D slices out of Surfaces.
     *
     * The mapper uses a vtkCutter filter to cut out slices (contours) of the 3D
-    * volume and render these slices as vtkPolyData. The data is transformed
-    * according to its geometry before cutting, to support the geometry concept
-    * of MITK.
+    * volume and render these slices as vtkPolyData. The plane is transformed
+    * into the coordinates of the data before cutting and the contour is
+    * transformed according to the geometry of the data afterwards, to support
+    * the geometry concept of MITK.
+    *
+    * When a large mesh is cut repeatedly with planes of the same orientation
+    * (e.g. while scrolling through slices), the mapper builds a PlaneCutIndex
+    * and only passes the cells close to the plane to the vtkCutter.
     *
     * Properties:
     * \b Surface.2D.Line Width: Thickness of the rendered lines in 2D.
@@ -107,6 +120,10 @@ namespace mitk
          * @brief m_Cutter Filter to cut out the 2D slice.
          */
       vtkSmartPointer<vtkCutter> m_Cutter;
+      /**
+         * @brief m_TransformFilter Transforms the slice according to the geometry of the data.
+         */
+      vtkSmartPointer<vtkTransformPolyDataFilter> m_TransformFilter;
       /**
          * @brief m_CuttingPlane The plane where to cut off the 2D slice.
          */
@@ -212,6 +229,21 @@ namespace mitk
        * @param renderer The respective renderer of the mitkRenderWindow.
        */
     void Update(BaseRenderer *renderer) override;
+
+    /**
+     * @brief Returns the index to cut \a polyData with planes of \a normal, or nullptr if the mesh should be cut
+     * as a whole.
+     *
+     * Indices are only built for large meshes when the same mesh is cut with the same orientation the second time,
+     * so meshes that change for every frame are not indexed in vain. The indices are shared by all renderers.
+     * Indices of other meshes or of older states of \a polyData (see vtkPolyData::GetMTime()) are dropped, so the
+     * cache does not keep replaced meshes alive.
+     */
+    std::shared_ptr<PlaneCutIndex> GetCutIndex(vtkPolyData *polyData, const double normal[3]);
+
+    /** @brief Recently requested indices, most recent first. */
+    std::deque<std::shared_ptr<PlaneCutIndex>> m_CutIndices;
+    itk::SimpleFastMutexLock m_CutIndicesMutex;
   };
 } // namespace mitk
 #endif /* mitkSurfaceVtkMapper2D_h */
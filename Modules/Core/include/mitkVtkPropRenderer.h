@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <map>
 #include <utility>
+#include <vector>
 
 class vtkRenderWindow;
 class vtkLight;
@@ -90,6 +91,37 @@ namespace mitk
     /** \brief This methods contains all method neceassary before a VTK Render() call */
     virtual void PrepareRender();
 
+    /**
+    * \brief Prepares the concurrent update of the mappers for the next frame. Returns false if there is nothing
+    * to render.
+    *
+    * Has to be called from the thread that renders.
+    */
+    bool PrepareMapperUpdate();
+
+    /** \brief Returns the mappers of the next frame, valid after PrepareMapperUpdate(). */
+    const std::vector<itk::SmartPointer<Mapper>> &GetQueuedMappers() const { return m_QueuedMappers; }
+
+    /**
+    * \brief Lets the mapper generate its data for this renderer.
+    *
+    * In contrast to rendering this method may be called from any thread, as long as no other thread updates
+    * the same mapper or another mapper of its data node (see RenderingManager::SetConcurrentMapperUpdates()).
+    */
+    void UpdateMapper(Mapper *mapper);
+
+    /**
+    * \brief Marks the mappers of the next frame as updated, the next Render() does not update them again.
+    * \param updateTime Milliseconds the mappers spent in Update().
+    */
+    void SetMappersUpdated(double updateTime);
+
+    /** \brief Milliseconds the mappers spent in Update() for the last frame. */
+    double GetLastMapperUpdateTime() const { return m_LastMapperUpdateTime; }
+
+    /** \brief Milliseconds the mappers spent in drawing (MitkRender()) the last frame. */
+    double GetLastMapperRenderTime() const { return m_LastMapperRenderTime; }
+
     // Active current renderwindow
     virtual void MakeCurrent();
 
@@ -212,6 +244,22 @@ namespace mitk
     // prepare all mitk::mappers for rendering
     void PrepareMapperQueue();
 
+    /**
+    * \brief Rebuilds m_MappersMap from the DataStorage.
+    *
+    * The sorted mappers are kept between frames. The renderer observes the DataStorage, the nodes,
+    * their property lists and their "visible" and "layer" properties, and only rebuilds the
+    * queue after one of them changed.
+    */
+    void BuildMapperQueue();
+    void ClearMapperQueue();
+    void AddMapperQueueObserver(itk::Object *object, itk::Command *command);
+
+    void MapperQueueModified(const itk::Object *caller, const itk::EventObject &event);
+    void DataNodeModified(const itk::Object *caller, const itk::EventObject &event);
+    void DataStorageNodeAdded(const DataNode *node);
+    void DataStorageNodeRemoved(const DataNode *node);
+
     /** \brief Set parallel projection, remove the interactor and the lights of VTK. */
     bool Initialize2DvtkCamera();
 
@@ -234,6 +282,22 @@ namespace mitk
     // sorted list of mappers
     MappersMapType m_MappersMap;
 
+    // the mappers of m_MappersMap are kept alive until the queue is rebuilt
+    std::vector<itk::SmartPointer<Mapper>> m_QueuedMappers;
+    std::vector<Mapper *> m_VisibleQueuedMappers;
+    bool m_MapperQueueValid;
+    MapperSlotId m_MapperQueueMapperID;
+    itk::TimeStamp m_MapperQueueTime;
+
+    std::vector<std::pair<itk::Object::Pointer, unsigned long>> m_MapperQueueObservers;
+    itk::MemberCommand<VtkPropRenderer>::Pointer m_MapperQueueModifiedCommand;
+    itk::MemberCommand<VtkPropRenderer>::Pointer m_DataNodeModifiedCommand;
+
+    // set by SetMappersUpdated(), so that the next frame skips Update()
+    bool m_MappersUpdated;
+    double m_LastMapperUpdateTime;
+    double m_LastMapperRenderTime;
+
     // rendering of text
     vtkRenderer *m_TextRenderer;
     typedef std::map<unsigned int, vtkTextActor *> TextMapType;
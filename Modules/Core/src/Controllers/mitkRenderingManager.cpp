@@ -27,10 +27,71 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNumericTypes.h"
 #include <itkAffineGeometryFrame.h>
 #include <itkCommand.h>
+#include <itkMultiThreader.h>
 #include <itkScalableAffineTransform.h>
+#include <itkSimpleFastMutexLock.h>
+#include <mitkMapper.h>
 #include <mitkVtkPropRenderer.h>
 
 #include <algorithm>
+#include <chrono>
+#include <map>
+
+namespace
+{
+  struct MapperUpdate
+  {
+    mitk::VtkPropRenderer *Renderer;
+    mitk::Mapper *Mapper;
+    double Time;
+  };
+
+  // Mappers are shared by all renderers with the same mapper slot and keep their time step and the local
+  // storages of all renderers. Thus the work is split by data node: one thread updates all mappers of a
+  // node for all renderers, and the mappers and the data of different nodes are updated concurrently.
+  struct MapperUpdateJob
+  {
+    std::vector<std::vector<MapperUpdate>> NodeUpdates;
+    std::size_t NextNode;
+    itk::SimpleFastMutexLock Mutex;
+  };
+
+  ITK_THREAD_RETURN_TYPE UpdateMappersThread(void *arg)
+  {
+    typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+    ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+    MapperUpdateJob *job = static_cast<MapperUpdateJob *>(infoStruct->UserData);
+
+    while (true)
+    {
+      job->Mutex.Lock();
+      std::size_t nodeIndex = job->NextNode++;
+      job->Mutex.Unlock();
+
+      if (nodeIndex >= job->NodeUpdates.size())
+      {
+        break;
+      }
+
+      std::vector<MapperUpdate> &updates = job->NodeUpdates[nodeIndex];
+      for (auto update = updates.begin(); update != updates.end(); ++update)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        try
+        {
+          update->Renderer->UpdateMapper(update->Mapper);
+        }
+        catch (const std::exception &e)
+        {
+          MITK_ERROR << "Updating a mapper of " << update->Renderer->GetName() << " failed: " << e.what();
+        }
+        update->Time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      }
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+}
 
 namespace mitk
 {
@@ -44,6 +105,7 @@ namespace mitk
       m_MaxLOD(1),
       m_LODIncreaseBlocked(false),
       m_LODAbortMechanismEnabled(false),
+      m_ConcurrentMapperUpdates(false),
       m_ClippingPlaneEnabled(false),
       m_TimeNavigationController(SliceNavigationController::New()),
       m_DataStorage(NULL),
@@ -522,6 +584,19 @@ namespace mitk
   {
     m_UpdatePending = false;
 
+    if (m_ConcurrentMapperUpdates)
+    {
+      std::vector<vtkRenderWindow *> pendingRenderWindows;
+      for (auto it = m_RenderWindowList.cbegin(); it != m_RenderWindowList.cend(); ++it)
+      {
+        if (it->second == RENDERING_REQUESTED)
+          pendingRenderWindows.push_back(it->first);
+      }
+
+      if (!pendingRenderWindows.empty())
+        this->UpdateMappersConcurrently(pendingRenderWindows);
+    }
+
     // Satisfy all pending update requests
     RenderWindowList::const_iterator it;
     int i = 0;
@@ -534,6 +609,65 @@ namespace mitk
     }
   }
 
+  void RenderingManager::UpdateMappersConcurrently(const std::vector<vtkRenderWindow *> &renderWindows)
+  {
+    MapperUpdateJob job;
+    job.NextNode = 0;
+
+    // the jobs are set up here because DataNode::GetMapper() and the mapper queues are not thread-safe
+    std::vector<mitk::VtkPropRenderer *> renderers;
+    std::map<const mitk::DataNode *, std::size_t> nodeIndices;
+    for (auto renderWindow = renderWindows.cbegin(); renderWindow != renderWindows.cend(); ++renderWindow)
+    {
+      // ForceImmediateUpdate() does not render windows of size 0 either
+      int *size = (*renderWindow)->GetSize();
+      if (0 == size[0] || 0 == size[1])
+        continue;
+
+      mitk::VtkPropRenderer *vPR =
+        dynamic_cast<mitk::VtkPropRenderer *>(mitk::BaseRenderer::GetInstance(*renderWindow));
+      if (vPR == nullptr || !vPR->PrepareMapperUpdate())
+        continue;
+
+      renderers.push_back(vPR);
+
+      const std::vector<itk::SmartPointer<Mapper>> &mappers = vPR->GetQueuedMappers();
+      for (auto mapper = mappers.cbegin(); mapper != mappers.cend(); ++mapper)
+      {
+        auto nodeIndex = nodeIndices.insert(std::make_pair((*mapper)->GetDataNode(), job.NodeUpdates.size()));
+        if (nodeIndex.second)
+          job.NodeUpdates.push_back(std::vector<MapperUpdate>());
+
+        MapperUpdate update = {vPR, mapper->GetPointer(), 0.0};
+        job.NodeUpdates[nodeIndex.first->second].push_back(update);
+      }
+    }
+
+    // with a single node there is nothing to distribute, the renderers update their mappers while rendering
+    if (job.NodeUpdates.size() < 2)
+      return;
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(
+      std::min(threader->GetNumberOfThreads(), static_cast<itk::ThreadIdType>(job.NodeUpdates.size())));
+    threader->SetSingleMethod(UpdateMappersThread, &job);
+    threader->SingleMethodExecute();
+
+    for (auto renderer = renderers.cbegin(); renderer != renderers.cend(); ++renderer)
+    {
+      double updateTime = 0.0;
+      for (auto nodeUpdates = job.NodeUpdates.cbegin(); nodeUpdates != job.NodeUpdates.cend(); ++nodeUpdates)
+      {
+        for (auto update = nodeUpdates->cbegin(); update != nodeUpdates->cend(); ++update)
+        {
+          if (update->Renderer == *renderer)
+            updateTime += update->Time;
+        }
+      }
+      (*renderer)->SetMappersUpdated(updateTime);
+    }
+  }
+
   void RenderingManager::RenderingStartCallback(vtkObject *caller, unsigned long, void *, void *)
   {
     vtkRenderWindow *renderWindow = dynamic_cast<vtkRenderWindow *>(caller);
@@ -147,10 +147,19 @@ MBI_STD::ostream &mitk::operator<<(MBI_STD::ostream &o, mitk::DataNode::Pointer
 
 void mitk::DataNode::SetMapper(MapperSlotId id, mitk::Mapper *mapper)
 {
+  if (id >= m_Mappers.size())
+    m_Mappers.resize(id + 10);
+
+  if (m_Mappers[id] == mapper)
+    return;
+
   m_Mappers[id] = mapper;
 
   if (mapper != NULL)
     mapper->SetDataNode(this);
+
+  m_MapperChangedTime.Modified();
+  Modified();
 }
 
 void mitk::DataNode::UpdateOutputInformation()
@@ -208,8 +217,16 @@ mitk::PropertyList *mitk::DataNode::GetPropertyList(const std::string &rendererN
   mitk::PropertyList::Pointer &propertyList = m_MapOfPropertyLists[rendererName];
 
   if (propertyList.IsNull())
+  {
     propertyList = mitk::PropertyList::New();
 
+    const PropertyKey::IdType id = PropertyKey(rendererName).GetId();
+    auto position = m_RendererPropertyLists.begin();
+    while (position != m_RendererPropertyLists.end() && position->first < id)
+      ++position;
+    m_RendererPropertyLists.insert(position, std::make_pair(id, propertyList.GetPointer()));
+  }
+
   assert(m_MapOfPropertyLists[rendererName].IsNotNull());
 
   return propertyList;
@@ -220,44 +237,57 @@ void mitk::DataNode::ConcatenatePropertyList(PropertyList *pList, bool replace)
   m_PropertyList->ConcatenatePropertyList(pList, replace);
 }
 
+mitk::PropertyList *mitk::DataNode::FindRendererPropertyList(const mitk::BaseRenderer *renderer) const
+{
+  // there are only a few renderer specific lists per node, a linear search is fastest
+  const PropertyKey::IdType id = renderer->GetNameKey().GetId();
+  for (auto iter = m_RendererPropertyLists.cbegin(); iter != m_RendererPropertyLists.cend(); ++iter)
+  {
+    if (iter->first == id)
+      return iter->second;
+    if (iter->first > id)
+      break;
+  }
+  return nullptr;
+}
+
 mitk::BaseProperty *mitk::DataNode::GetProperty(const char *propertyKey, const mitk::BaseRenderer *renderer) const
 {
   if (propertyKey == NULL)
     return NULL;
 
-  // renderer specified?
+  const std::string key(propertyKey);
+
+  // check for the renderer specific property first
   if (renderer)
   {
-    std::string rendererName = renderer->GetName();
-
-    MapOfPropertyLists::const_iterator it;
-    // check for the renderer specific property
-    it = m_MapOfPropertyLists.find(rendererName);
-    if (it != m_MapOfPropertyLists.end()) // found
+    mitk::PropertyList *rendererList = this->FindRendererPropertyList(renderer);
+    if (rendererList != nullptr)
     {
-      mitk::BaseProperty::Pointer property;
-      property = it->second->GetProperty(propertyKey);
-      if (property.IsNotNull()) // found an enabled property in the render specific list
+      mitk::BaseProperty *property = rendererList->GetProperty(key);
+      if (property != nullptr)
         return property;
-      else                                               // found a renderer specific list, but not the desired property
-        return m_PropertyList->GetProperty(propertyKey); // return renderer unspecific property
-    }
-    else // didn't find the property list of the given renderer
-    {
-      // return the renderer unspecific property if there is one
-      return m_PropertyList->GetProperty(propertyKey);
     }
   }
-  else // no specific renderer given; use the renderer independent one
+
+  // return the renderer unspecific property if there is one
+  return m_PropertyList->GetProperty(key);
+}
+
+mitk::BaseProperty *mitk::DataNode::GetProperty(const PropertyKey &propertyKey, const mitk::BaseRenderer *renderer) const
+{
+  if (renderer)
   {
-    mitk::BaseProperty::Pointer property;
-    property = m_PropertyList->GetProperty(propertyKey);
-    if (property.IsNotNull())
-      return property;
+    mitk::PropertyList *rendererList = this->FindRendererPropertyList(renderer);
+    if (rendererList != nullptr)
+    {
+      mitk::BaseProperty *property = rendererList->GetProperty(propertyKey);
+      if (property != nullptr)
+        return property;
+    }
   }
 
-  // only to satisfy compiler!
-  return NULL;
+  return m_PropertyList->GetProperty(propertyKey);
 }
 
 mitk::DataNode::GroupTagList mitk::DataNode::GetGroupTags() const
@@ -290,6 +320,18 @@ bool mitk::DataNode::GetBoolProperty(const char *propertyKey, bool &boolValue, c
   return true;
 }
 
+bool mitk::DataNode::GetBoolProperty(const PropertyKey &propertyKey,
+                                     bool &boolValue,
+                                     const mitk::BaseRenderer *renderer) const
+{
+  mitk::BoolProperty *boolprop = dynamic_cast<mitk::BoolProperty *>(GetProperty(propertyKey, renderer));
+  if (boolprop == nullptr)
+    return false;
+
+  boolValue = boolprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetIntProperty(const char *propertyKey, int &intValue, const mitk::BaseRenderer *renderer) const
 {
   mitk::IntProperty::Pointer intprop = dynamic_cast<mitk::IntProperty *>(GetProperty(propertyKey, renderer));
@@ -300,6 +342,18 @@ bool mitk::DataNode::GetIntProperty(const char *propertyKey, int &intValue, cons
   return true;
 }
 
+bool mitk::DataNode::GetIntProperty(const PropertyKey &propertyKey,
+                                    int &intValue,
+                                    const mitk::BaseRenderer *renderer) const
+{
+  mitk::IntProperty *intprop = dynamic_cast<mitk::IntProperty *>(GetProperty(propertyKey, renderer));
+  if (intprop == nullptr)
+    return false;
+
+  intValue = intprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetFloatProperty(const char *propertyKey,
                                       float &floatValue,
                                       const mitk::BaseRenderer *renderer) const
@@ -312,6 +366,18 @@ bool mitk::DataNode::GetFloatProperty(const char *propertyKey,
   return true;
 }
 
+bool mitk::DataNode::GetFloatProperty(const PropertyKey &propertyKey,
+                                      float &floatValue,
+                                      const mitk::BaseRenderer *renderer) const
+{
+  mitk::FloatProperty *floatprop = dynamic_cast<mitk::FloatProperty *>(GetProperty(propertyKey, renderer));
+  if (floatprop == nullptr)
+    return false;
+
+  floatValue = floatprop->GetValue();
+  return true;
+}
+
 bool mitk::DataNode::GetDoubleProperty(const char *propertyKey,
                                        double &doubleValue,
                                        const mitk::BaseRenderer *renderer) const
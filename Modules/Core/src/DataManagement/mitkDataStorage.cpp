@@ -19,18 +19,56 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkCommand.h"
 #include "itkMutexLockHolder.h"
 #include "mitkDataNode.h"
+#include "mitkEnumerationProperty.h"
+#include "mitkExceptionMacro.h"
 #include "mitkGroupTagProperty.h"
 #include "mitkImage.h"
+#include "mitkNodePredicateAnd.h"
 #include "mitkNodePredicateBase.h"
+#include "mitkNodePredicateDataType.h"
 #include "mitkNodePredicateProperty.h"
 #include "mitkProperties.h"
+#include "mitkRenderingManager.h"
+#include "mitkStringProperty.h"
 
-mitk::DataStorage::DataStorage() : itk::Object(), m_BlockNodeModifiedEvents(false)
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+  // at most this many conditions are cached, older entries are dropped when it is exceeded
+  const std::size_t MAXIMUM_NUMBER_OF_CACHED_PREDICATES = 32;
+
+  // properties whose values are indexed, for these operator== is the same as comparing GetValueAsString()
+  bool IsValueIndexed(const mitk::BaseProperty *property)
+  {
+    return dynamic_cast<const mitk::StringProperty *>(property) != nullptr ||
+           dynamic_cast<const mitk::BoolProperty *>(property) != nullptr ||
+           dynamic_cast<const mitk::IntProperty *>(property) != nullptr ||
+           dynamic_cast<const mitk::UIntProperty *>(property) != nullptr ||
+           dynamic_cast<const mitk::EnumerationProperty *>(property) != nullptr;
+  }
+}
+
+mitk::DataStorage::DataStorage()
+  : itk::Object(),
+    m_BlockNodeModifiedEvents(false),
+    m_UseIndex(false),
+    m_IndexGeneration(0),
+    m_IndexSequence(0),
+    m_PredicateCaching(false),
+    m_BatchDepth(0)
 {
+  m_IndexedPropertyKeys.insert("name");
+  m_PropertyIndex["name"];
 }
 
 mitk::DataStorage::~DataStorage()
 {
+  // the properties may outlive the DataStorage
+  for (auto observer = m_PropertyObservers.cbegin(); observer != m_PropertyObservers.cend(); ++observer)
+    const_cast<BaseProperty *>(observer->first)->RemoveObserver(observer->second.Tag);
+
   ///// we can not call GetAll() in destructor, because it is implemented in a subclass
   // SetOfObjects::ConstPointer all = this->GetAll();
   // for (SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
@@ -57,8 +95,111 @@ void mitk::DataStorage::Remove(const mitk::DataStorage::SetOfObjects *nodes)
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubset(const NodePredicateBase *condition) const
 {
-  mitk::DataStorage::SetOfObjects::ConstPointer result = this->FilterSetOfObjects(this->GetAll(), condition);
-  return result;
+  if (condition == NULL)
+    return this->FilterSetOfObjects(this->GetAll(), condition);
+
+  // candidates are restricted by the index if it helps
+  std::vector<mitk::DataNode::Pointer> candidates;
+  bool indexed = false;
+  if (m_UseIndex)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+    const NodeSet *nodes = this->FindIndexedCandidates(condition);
+    if (nodes != nullptr)
+    {
+      // the index sets are ordered by address, the candidates are sorted in the order the nodes were added,
+      // e.g. GetNamedNode() returns the first added node of duplicate names
+      std::vector<std::pair<unsigned long, const mitk::DataNode *>> sequence;
+      sequence.reserve(nodes->size());
+      for (auto node = nodes->cbegin(); node != nodes->cend(); ++node)
+        sequence.push_back(std::make_pair(m_NodeIndex.find(*node)->second.Sequence, *node));
+      std::sort(sequence.begin(), sequence.end());
+
+      // indexed nodes are kept alive by the subclass until they are removed from the index
+      candidates.reserve(sequence.size());
+      for (auto node = sequence.cbegin(); node != sequence.cend(); ++node)
+        candidates.push_back(const_cast<mitk::DataNode *>(node->second));
+      indexed = true;
+    }
+  }
+
+  if (!indexed)
+  {
+    SetOfObjects::ConstPointer all = this->GetAll();
+    if (all.IsNull())
+      return NULL;
+    candidates = all->CastToSTLConstContainer();
+  }
+
+  // look up the cached results, the condition is checked without holding the lock
+  std::vector<char> known(candidates.size(), false);
+  std::vector<char> results(candidates.size(), false);
+  std::vector<unsigned long> generations(candidates.size(), 0);
+  const bool caching = m_PredicateCaching;
+  if (caching)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+    auto cache = m_PredicateCache.find(condition);
+    if (cache != m_PredicateCache.end() &&
+        (cache->second.Predicate.GetPointer() != condition || cache->second.PredicateMTime != condition->GetMTime()))
+    {
+      m_PredicateCache.erase(cache);
+      cache = m_PredicateCache.end();
+    }
+
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      auto entry = m_NodeIndex.find(candidates[i]);
+      if (entry == m_NodeIndex.end())
+        continue;
+      generations[i] = entry->second.Generation;
+
+      if (cache == m_PredicateCache.end())
+        continue;
+      auto result = cache->second.Results.find(candidates[i]);
+      if (result != cache->second.Results.end() && result->second.first == generations[i])
+      {
+        known[i] = true;
+        results[i] = result->second.second;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+    if (!known[i])
+      results[i] = condition->CheckNode(candidates[i]);
+
+  if (caching)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+    auto cache = m_PredicateCache.find(condition);
+    if (cache == m_PredicateCache.end())
+    {
+      if (m_PredicateCache.size() >= MAXIMUM_NUMBER_OF_CACHED_PREDICATES)
+        m_PredicateCache.clear();
+
+      PredicateCacheEntry &entry = m_PredicateCache[condition];
+      entry.Predicate = condition;
+      entry.PredicateMTime = condition->GetMTime();
+      cache = m_PredicateCache.find(condition);
+    }
+
+    for (std::size_t i = 0; i < candidates.size(); ++i)
+    {
+      // results of nodes that were modified meanwhile are not stored
+      auto entry = m_NodeIndex.find(candidates[i]);
+      if (!known[i] && entry != m_NodeIndex.end() && entry->second.Generation == generations[i])
+        cache->second.Results[candidates[i]] = std::make_pair(generations[i], results[i] != 0);
+    }
+  }
+
+  // always copy the set, otherwise the iterator in mitk::DataStorage::Remove() will crash
+  mitk::DataStorage::SetOfObjects::Pointer result = mitk::DataStorage::SetOfObjects::New();
+  for (std::size_t i = 0; i < candidates.size(); ++i)
+    if (results[i])
+      result->InsertElement(result->Size(), candidates[i]);
+
+  return mitk::DataStorage::SetOfObjects::ConstPointer(result);
 }
 
 mitk::DataNode *mitk::DataStorage::GetNamedNode(const char *name) const
@@ -179,6 +320,10 @@ const mitk::DataNode::GroupTagList mitk::DataStorage::GetGroupTags() const
 void mitk::DataStorage::EmitAddNodeEvent(const mitk::DataNode *node)
 {
   AddNodeEvent.Send(node);
+
+  mitk::DataStorage::SetOfObjects::Pointer nodes = mitk::DataStorage::SetOfObjects::New();
+  nodes->InsertElement(0, const_cast<mitk::DataNode *>(node));
+  AddNodesEvent.Send(nodes);
 }
 
 void mitk::DataStorage::EmitRemoveNodeEvent(const mitk::DataNode *node)
@@ -197,6 +342,16 @@ void mitk::DataStorage::OnNodeInteractorChanged(itk::Object *caller, const itk::
 
 void mitk::DataStorage::OnNodeModifiedOrDeleted(const itk::Object *caller, const itk::EventObject &event)
 {
+  // the index has to follow the node even if the events are blocked
+  if (m_UseIndex && dynamic_cast<const itk::ModifiedEvent *>(&event) != nullptr)
+  {
+    const mitk::DataNode *node = dynamic_cast<const mitk::DataNode *>(caller);
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+    auto entry = m_NodeIndex.find(node);
+    if (entry != m_NodeIndex.end())
+      this->UpdateIndexEntry(node, entry->second);
+  }
+
   if (m_BlockNodeModifiedEvents)
     return;
 
@@ -516,3 +671,317 @@ void mitk::DataStorage::BlockNodeModifiedEvents(bool block)
 {
   m_BlockNodeModifiedEvents = block;
 }
+
+void mitk::DataStorage::AddIndexedPropertyKey(const std::string &propertyKey)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+  if (!m_IndexedPropertyKeys.insert(propertyKey).second)
+    return;
+
+  m_PropertyIndex[propertyKey];
+  for (auto entry = m_NodeIndex.begin(); entry != m_NodeIndex.end(); ++entry)
+    this->UpdateIndexEntry(entry->first, entry->second);
+}
+
+void mitk::DataStorage::SetPredicateCaching(bool enable)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+  m_PredicateCaching = enable;
+  if (!enable)
+    m_PredicateCache.clear();
+}
+
+bool mitk::DataStorage::GetPredicateCaching() const
+{
+  return m_PredicateCaching;
+}
+
+void mitk::DataStorage::AddToIndex(const mitk::DataNode *node)
+{
+  if (node == nullptr)
+    return;
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+  if (m_NodeIndex.find(node) != m_NodeIndex.end())
+    return;
+
+  NodeIndexEntry &entry = m_NodeIndex[node];
+  entry.Sequence = ++m_IndexSequence;
+  entry.Generation = 0;
+  this->UpdateIndexEntry(node, entry);
+}
+
+void mitk::DataStorage::RemoveFromIndex(const mitk::DataNode *node)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+  auto entry = m_NodeIndex.find(node);
+  if (entry == m_NodeIndex.end())
+    return;
+
+  this->RemoveIndexEntry(node, entry->second);
+  m_NodeIndex.erase(entry);
+
+  // another node may be created at the same address
+  for (auto cache = m_PredicateCache.begin(); cache != m_PredicateCache.end(); ++cache)
+    cache->second.Results.erase(node);
+}
+
+void mitk::DataStorage::RemoveIndexEntry(const mitk::DataNode *node, NodeIndexEntry &entry)
+{
+  auto dataType = m_DataTypeIndex.find(entry.DataType);
+  if (dataType != m_DataTypeIndex.end())
+  {
+    dataType->second.erase(node);
+    if (dataType->second.empty())
+      m_DataTypeIndex.erase(dataType);
+  }
+
+  for (auto property = entry.Properties.cbegin(); property != entry.Properties.cend(); ++property)
+  {
+    PropertyIndex &index = m_PropertyIndex[property->first];
+    index.Nodes.erase(node);
+    if (property->second.HasValue)
+    {
+      auto value = index.NodesByValue.find(property->second.Value);
+      if (value != index.NodesByValue.end())
+      {
+        value->second.erase(node);
+        if (value->second.empty())
+          index.NodesByValue.erase(value);
+      }
+    }
+
+    auto observer = m_PropertyObservers.find(property->second.Property);
+    if (observer != m_PropertyObservers.end())
+    {
+      observer->second.Nodes.erase(node);
+      if (observer->second.Nodes.empty())
+      {
+        property->second.Property->RemoveObserver(observer->second.Tag);
+        m_PropertyObservers.erase(observer);
+      }
+    }
+  }
+  entry.Properties.clear();
+  entry.DataType.clear();
+}
+
+void mitk::DataStorage::UpdateIndexEntry(const mitk::DataNode *node, NodeIndexEntry &entry)
+{
+  // every change of the node invalidates the cached results
+  entry.Generation = ++m_IndexGeneration;
+
+  const mitk::BaseData *data = node->GetData();
+  const std::string dataType = data != nullptr ? data->GetNameOfClass() : std::string();
+
+  std::map<std::string, IndexedProperty> properties;
+  for (auto key = m_IndexedPropertyKeys.cbegin(); key != m_IndexedPropertyKeys.cend(); ++key)
+  {
+    BaseProperty *property = node->GetPropertyList()->GetProperty(*key);
+    if (property == nullptr)
+      continue;
+
+    IndexedProperty &indexed = properties[*key];
+    indexed.Property = property;
+    indexed.HasValue = IsValueIndexed(property);
+    if (indexed.HasValue)
+      indexed.Value = property->GetValueAsString();
+  }
+
+  // most modifications do not touch the indexed values
+  bool unchanged = dataType == entry.DataType && properties.size() == entry.Properties.size();
+  for (auto property = properties.cbegin(); unchanged && property != properties.cend(); ++property)
+  {
+    auto old = entry.Properties.find(property->first);
+    unchanged = old != entry.Properties.end() && old->second.Property == property->second.Property &&
+                old->second.HasValue == property->second.HasValue && old->second.Value == property->second.Value;
+  }
+  if (unchanged)
+    return;
+
+  this->RemoveIndexEntry(node, entry);
+
+  entry.DataType = dataType;
+  if (data != nullptr)
+    m_DataTypeIndex[dataType].insert(node);
+
+  entry.Properties.swap(properties);
+  for (auto property = entry.Properties.cbegin(); property != entry.Properties.cend(); ++property)
+  {
+    PropertyIndex &index = m_PropertyIndex[property->first];
+    index.Nodes.insert(node);
+    if (property->second.HasValue)
+      index.NodesByValue[property->second.Value].insert(node);
+
+    // changing the value of a property in place does not modify the node
+    PropertyObserver &observer = m_PropertyObservers[property->second.Property];
+    if (observer.Nodes.empty())
+    {
+      itk::MemberCommand<mitk::DataStorage>::Pointer command = itk::MemberCommand<mitk::DataStorage>::New();
+      command->SetCallbackFunction(this, &mitk::DataStorage::OnIndexedPropertyModified);
+      observer.Tag = property->second.Property->AddObserver(itk::ModifiedEvent(), command);
+    }
+    observer.Nodes.insert(node);
+  }
+}
+
+void mitk::DataStorage::OnIndexedPropertyModified(const itk::Object *caller, const itk::EventObject &)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+  auto observer = m_PropertyObservers.find(static_cast<const BaseProperty *>(caller));
+  if (observer == m_PropertyObservers.end())
+    return;
+
+  // updating an entry may remove the observer
+  const NodeSet nodes = observer->second.Nodes;
+  for (auto node = nodes.cbegin(); node != nodes.cend(); ++node)
+  {
+    auto entry = m_NodeIndex.find(*node);
+    if (entry != m_NodeIndex.end())
+      this->UpdateIndexEntry(*node, entry->second);
+  }
+}
+
+const mitk::DataStorage::NodeSet *mitk::DataStorage::FindIndexedCandidates(const NodePredicateBase *condition) const
+{
+  static const NodeSet noNodes;
+
+  if (const NodePredicateProperty *propertyPredicate = dynamic_cast<const NodePredicateProperty *>(condition))
+  {
+    if (propertyPredicate->GetRenderer() != nullptr)
+      return nullptr;
+
+    auto index = m_PropertyIndex.find(propertyPredicate->GetValidPropertyName());
+    if (index == m_PropertyIndex.cend())
+      return nullptr;
+
+    const BaseProperty *value = propertyPredicate->GetValidProperty();
+    if (value == nullptr || !IsValueIndexed(value))
+      return &index->second.Nodes;
+
+    auto nodes = index->second.NodesByValue.find(value->GetValueAsString());
+    return nodes != index->second.NodesByValue.cend() ? &nodes->second : &noNodes;
+  }
+
+  if (const NodePredicateDataType *dataTypePredicate = dynamic_cast<const NodePredicateDataType *>(condition))
+  {
+    auto nodes = m_DataTypeIndex.find(dataTypePredicate->GetValidDataType());
+    return nodes != m_DataTypeIndex.cend() ? &nodes->second : &noNodes;
+  }
+
+  // all children have to be fulfilled, so the smallest set of any child will do
+  if (const NodePredicateAnd *andPredicate = dynamic_cast<const NodePredicateAnd *>(condition))
+  {
+    const NodeSet *result = nullptr;
+    const NodePredicateCompositeBase::ChildPredicates children = andPredicate->GetPredicates();
+    for (auto child = children.cbegin(); child != children.cend(); ++child)
+    {
+      const NodeSet *nodes = this->FindIndexedCandidates(*child);
+      if (nodes != nullptr && (result == nullptr || nodes->size() < result->size()))
+        result = nodes;
+    }
+    return result;
+  }
+
+  return nullptr;
+}
+
+void mitk::DataStorage::BeginBatch()
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_MutexOne);
+  ++m_BatchDepth;
+}
+
+void mitk::DataStorage::EndBatch()
+{
+  std::vector<DataNode::ConstPointer> batchNodes;
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_MutexOne);
+    if (m_BatchDepth == 0)
+      mitkThrow() << "EndBatch() called without BeginBatch()";
+    if (--m_BatchDepth > 0)
+      return;
+    batchNodes.swap(m_BatchNodes);
+  }
+
+  // nodes that were removed again during the batch are not reported at all
+  std::set<const mitk::DataNode *> visited;
+  mitk::DataStorage::SetOfObjects::Pointer nodes = mitk::DataStorage::SetOfObjects::New();
+  for (auto node = batchNodes.cbegin(); node != batchNodes.cend(); ++node)
+  {
+    if (visited.insert(node->GetPointer()).second && this->Exists(*node))
+    {
+      this->AddListeners(*node);
+      nodes->InsertElement(nodes->Size(), const_cast<mitk::DataNode *>(node->GetPointer()));
+    }
+  }
+
+  // the nodes were not observed yet, so their modifications during the batch were missed by the index
+  if (m_UseIndex)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_IndexMutex);
+    for (auto node = nodes->Begin(); node != nodes->End(); ++node)
+    {
+      auto entry = m_NodeIndex.find(node->Value());
+      if (entry != m_NodeIndex.end())
+        this->UpdateIndexEntry(entry->first, entry->second);
+    }
+  }
+
+  if (nodes->Size() == 0)
+    return;
+
+  for (auto node = nodes->Begin(); node != nodes->End(); ++node)
+    AddNodeEvent.Send(node->Value());
+  AddNodesEvent.Send(nodes);
+
+  if (mitk::RenderingManager::IsInstantiated())
+    mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+}
+
+mitk::DataStorage::BatchScope::BatchScope(DataStorage *dataStorage) : m_DataStorage(dataStorage)
+{
+  if (m_DataStorage.IsNotNull())
+    m_DataStorage->BeginBatch();
+}
+
+mitk::DataStorage::BatchScope::~BatchScope()
+{
+  if (m_DataStorage.IsNull())
+    return;
+
+  // the destructor may run during stack unwinding, so nothing must be thrown
+  try
+  {
+    m_DataStorage->EndBatch();
+  }
+  catch (const std::exception &e)
+  {
+    MITK_ERROR << "Completing a batch of added nodes failed: " << e.what();
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Completing a batch of added nodes failed";
+  }
+}
+
+bool mitk::DataStorage::DeferNodeAddition(const mitk::DataNode *node)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_MutexOne);
+  if (m_BatchDepth == 0)
+    return false;
+
+  m_BatchNodes.push_back(node);
+  return true;
+}
+
+bool mitk::DataStorage::CancelNodeAddition(const mitk::DataNode *node)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_MutexOne);
+  auto newEnd = std::remove(m_BatchNodes.begin(), m_BatchNodes.end(), node);
+  if (newEnd == m_BatchNodes.end())
+    return false;
+
+  m_BatchNodes.erase(newEnd, m_BatchNodes.end());
+  return true;
+}
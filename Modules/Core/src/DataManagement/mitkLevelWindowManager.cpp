@@ -43,8 +43,8 @@ mitk::LevelWindowManager::~LevelWindowManager()
 {
   if (m_DataStorage.IsNotNull())
   {
-    m_DataStorage->AddNodeEvent.RemoveListener(
-      MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageAddedNode));
+    m_DataStorage->AddNodesEvent.RemoveListener(MessageDelegate1<LevelWindowManager, const DataStorage::SetOfObjects *>(
+      this, &LevelWindowManager::DataStorageAddedNodes));
     m_DataStorage->RemoveNodeEvent.RemoveListener(
       MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageRemovedNode));
     m_DataStorage = NULL;
@@ -68,16 +68,16 @@ void mitk::LevelWindowManager::SetDataStorage(mitk::DataStorage *ds)
   /* remove listeners of old DataStorage */
   if (m_DataStorage.IsNotNull())
   {
-    m_DataStorage->AddNodeEvent.RemoveListener(
-      MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageAddedNode));
+    m_DataStorage->AddNodesEvent.RemoveListener(MessageDelegate1<LevelWindowManager, const DataStorage::SetOfObjects *>(
+      this, &LevelWindowManager::DataStorageAddedNodes));
     m_DataStorage->RemoveNodeEvent.RemoveListener(
       MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageRemovedNode));
   }
 
   /* register listener for new DataStorage */
   m_DataStorage = ds; // register
-  m_DataStorage->AddNodeEvent.AddListener(
-    MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageAddedNode));
+  m_DataStorage->AddNodesEvent.AddListener(MessageDelegate1<LevelWindowManager, const DataStorage::SetOfObjects *>(
+    this, &LevelWindowManager::DataStorageAddedNodes));
   m_DataStorage->RemoveNodeEvent.AddListener(
     MessageDelegate1<LevelWindowManager, const mitk::DataNode *>(this, &LevelWindowManager::DataStorageRemovedNode));
 
@@ -279,6 +279,12 @@ void mitk::LevelWindowManager::DataStorageAddedNode(const mitk::DataNode *)
   }
 }
 
+void mitk::LevelWindowManager::DataStorageAddedNodes(const DataStorage::SetOfObjects *)
+{
+  // the update looks at all nodes anyway
+  this->DataStorageAddedNode();
+}
+
 void mitk::LevelWindowManager::DataStorageRemovedNode(const mitk::DataNode *removedNode)
 {
   // first: check if deleted node is part of relevant nodes. If not, abort method because there is no need change
@@ -26,11 +26,13 @@ mitk::NodePredicateCompositeBase::~NodePredicateCompositeBase()
 void mitk::NodePredicateCompositeBase::AddPredicate(const NodePredicateBase *p)
 {
   m_ChildPredicates.push_back(p);
+  this->Modified();
 }
 
 void mitk::NodePredicateCompositeBase::RemovePredicate(const NodePredicateBase *p)
 {
   m_ChildPredicates.remove(p);
+  this->Modified();
 }
 
 mitk::NodePredicateCompositeBase::ChildPredicates mitk::NodePredicateCompositeBase::GetPredicates() const
@@ -16,11 +16,33 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkPointSet.h"
 #include "mitkInteractionConst.h"
+#include "mitkPlaneGeometry.h"
 #include "mitkPointOperation.h"
+#include <itkMutexLockHolder.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
+#include <limits>
+#include <type_traits>
 #include <mitkNumericTypes.h>
 
+static_assert(std::is_same<mitk::PointSet::PointsContainer, mitk::PointSetSpatialIndex::PointsContainer>::value,
+              "PointSetSpatialIndex must index the points container of PointSet");
+
+namespace
+{
+  // collects the ids of all points in ascending order, used for time steps without spatial index
+  void GetAllPointIds(const mitk::PointSet::PointsContainer *points, mitk::PointSet::PointIdentifierList &ids)
+  {
+    ids.reserve(points->Size());
+    for (mitk::PointSet::PointsContainer::ConstIterator it = points->Begin(); it != points->End(); ++it)
+    {
+      ids.push_back(it->Index());
+    }
+  }
+}
+
 mitk::PointSet::PointSet() : m_CalculateBoundingBox(true)
 {
   this->InitializeEmpty();
@@ -55,6 +77,7 @@ mitk::PointSet::~PointSet()
 void mitk::PointSet::ClearData()
 {
   m_PointSetSeries.clear();
+  m_SpatialIndices.clear();
   Superclass::ClearData();
 }
 
@@ -65,6 +88,7 @@ void mitk::PointSet::InitializeEmpty()
   m_PointSetSeries[0] = DataType::New();
   PointDataContainer::Pointer pointData = PointDataContainer::New();
   m_PointSetSeries[0]->SetPointData(pointData);
+  m_SpatialIndices.clear();
   m_CalculateBoundingBox = false;
 
   Superclass::InitializeTimeGeometry(1);
@@ -200,9 +224,7 @@ int mitk::PointSet::SearchPoint(Point3D point, ScalarType distance, int t) const
 
   // Searching the first point in the Set, that is +- distance far away fro
   // the given point
-  unsigned int i;
-  PointsContainer::Iterator it, end;
-  end = m_PointSetSeries[t]->GetPoints()->End();
+  const PointsContainer *points = m_PointSetSeries[t]->GetPoints();
   int bestIndex = -1;
   distance = distance * distance;
 
@@ -212,12 +234,34 @@ int mitk::PointSet::SearchPoint(Point3D point, ScalarType distance, int t) const
     distance = 0.000001;
   }
 
+  // candidates in ascending order of their ids, either all points or the
+  // points in the index cells around the searched point
+  PointIdentifierList candidates;
+  std::shared_ptr<const PointSetSpatialIndex> spatialIndex = this->GetSpatialIndex(t);
+  if (spatialIndex != nullptr)
+  {
+    const ScalarType radius = std::sqrt(distance);
+    PointType lower;
+    PointType upper;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      lower[i] = indexPoint[i] - radius;
+      upper[i] = indexPoint[i] + radius;
+    }
+    spatialIndex->FindPointsInBox(lower, upper, candidates);
+    std::sort(candidates.begin(), candidates.end());
+  }
+  else
+  {
+    GetAllPointIds(points, candidates);
+  }
+
   ScalarType bestDist = distance;
   ScalarType dist, tmp;
 
-  for (it = m_PointSetSeries[t]->GetPoints()->Begin(), i = 0; it != end; ++it, ++i)
+  for (auto it = candidates.begin(); it != candidates.end(); ++it)
   {
-    bool ok = m_PointSetSeries[t]->GetPoints()->GetElementIfIndexExists(it->Index(), &out);
+    bool ok = points->GetElementIfIndexExists(*it, &out);
 
     if (!ok)
     {
@@ -225,7 +269,7 @@ int mitk::PointSet::SearchPoint(Point3D point, ScalarType distance, int t) const
     }
     else if (indexPoint == out) // if totally equal
     {
-      return it->Index();
+      return *it;
     }
 
     // distance calculation
@@ -238,13 +282,137 @@ int mitk::PointSet::SearchPoint(Point3D point, ScalarType distance, int t) const
 
     if (dist < bestDist)
     {
-      bestIndex = it->Index();
+      bestIndex = *it;
       bestDist = dist;
     }
   }
   return bestIndex;
 }
 
+int mitk::PointSet::SearchClosestPoint(Point3D point, ScalarType distance, int t) const
+{
+  if (t < 0 || t >= (int)m_PointSetSeries.size())
+  {
+    return -1;
+  }
+
+  const BaseGeometry *geometry = this->GetGeometry(t);
+  const PointsContainer *points = m_PointSetSeries[t]->GetPoints();
+
+  PointIdentifierList candidates;
+  std::shared_ptr<const PointSetSpatialIndex> spatialIndex = this->GetSpatialIndex(t);
+  if (spatialIndex != nullptr)
+  {
+    // the index works in index coordinates: query the box enclosing the
+    // corners of the world space box around the searched point
+    PointType lower;
+    PointType upper;
+    for (unsigned int corner = 0; corner < 8; ++corner)
+    {
+      Point3D cornerPoint;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        cornerPoint[i] = (corner & (1u << i)) ? point[i] + distance : point[i] - distance;
+      }
+      geometry->WorldToIndex(cornerPoint, cornerPoint);
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        lower[i] = (corner == 0) ? cornerPoint[i] : std::min(lower[i], cornerPoint[i]);
+        upper[i] = (corner == 0) ? cornerPoint[i] : std::max(upper[i], cornerPoint[i]);
+      }
+    }
+    spatialIndex->FindPointsInBox(lower, upper, candidates);
+    std::sort(candidates.begin(), candidates.end());
+  }
+  else
+  {
+    GetAllPointIds(points, candidates);
+  }
+
+  int bestIndex = -1;
+  ScalarType bestDist = distance * distance;
+  PointType out;
+
+  for (auto it = candidates.begin(); it != candidates.end(); ++it)
+  {
+    if (!points->GetElementIfIndexExists(*it, &out))
+    {
+      continue;
+    }
+    geometry->IndexToWorld(out, out);
+
+    const ScalarType dist = point.SquaredEuclideanDistanceTo(out);
+    if (dist < bestDist)
+    {
+      bestIndex = *it;
+      bestDist = dist;
+    }
+  }
+  return bestIndex;
+}
+
+void mitk::PointSet::SearchPointsNearPlane(const PlaneGeometry *plane,
+                                           ScalarType distance,
+                                           PointIdentifierList &ids,
+                                           int t) const
+{
+  ids.clear();
+
+  if (plane == nullptr || t < 0 || t >= (int)m_PointSetSeries.size())
+  {
+    return;
+  }
+
+  const BaseGeometry *geometry = this->GetGeometry(t);
+  const PointsContainer *points = m_PointSetSeries[t]->GetPoints();
+
+  PointIdentifierList candidates;
+  std::shared_ptr<const PointSetSpatialIndex> spatialIndex = this->GetSpatialIndex(t);
+  if (spatialIndex != nullptr)
+  {
+    // the signed distance is affine, so its range over a cell is spanned
+    // by the distances of the cell corners
+    spatialIndex->FindPointsInCells(
+      [geometry, plane, distance](const PointSetSpatialIndex::PointType &lower,
+                                   const PointSetSpatialIndex::PointType &upper) {
+        ScalarType minDistance = std::numeric_limits<ScalarType>::max();
+        ScalarType maxDistance = -std::numeric_limits<ScalarType>::max();
+        for (unsigned int corner = 0; corner < 8; ++corner)
+        {
+          Point3D cornerPoint;
+          for (unsigned int i = 0; i < 3; ++i)
+          {
+            cornerPoint[i] = (corner & (1u << i)) ? upper[i] : lower[i];
+          }
+          geometry->IndexToWorld(cornerPoint, cornerPoint);
+          const ScalarType cornerDistance = plane->SignedDistanceFromPlane(cornerPoint);
+          minDistance = std::min(minDistance, cornerDistance);
+          maxDistance = std::max(maxDistance, cornerDistance);
+        }
+        return minDistance < distance && maxDistance > -distance;
+      },
+      candidates);
+    std::sort(candidates.begin(), candidates.end());
+  }
+  else
+  {
+    GetAllPointIds(points, candidates);
+  }
+
+  PointType out;
+  for (auto it = candidates.begin(); it != candidates.end(); ++it)
+  {
+    if (points->GetElementIfIndexExists(*it, &out))
+    {
+      geometry->IndexToWorld(out, out);
+      if (plane->DistanceFromPlane(out) < distance)
+      {
+        ids.push_back(*it);
+      }
+    }
+  }
+}
+
 mitk::PointSet::PointType mitk::PointSet::GetPoint(PointIdentifier id, int t) const
 {
   PointType out;
@@ -290,6 +458,10 @@ void mitk::PointSet::SetPoint(PointIdentifier id, PointType point, int t)
   // Adapt the size of the data vector if necessary
   this->Expand(t + 1);
 
+  const bool indexed = this->IsSpatialIndexUpToDate(t);
+  PointType oldIndexPoint;
+  const bool existed = m_PointSetSeries[t]->GetPoints()->GetElementIfIndexExists(id, &oldIndexPoint);
+
   mitk::Point3D indexPoint;
   this->GetGeometry(t)->WorldToIndex(point, indexPoint);
   m_PointSetSeries[t]->SetPoint(id, indexPoint);
@@ -299,6 +471,8 @@ void mitk::PointSet::SetPoint(PointIdentifier id, PointType point, int t)
   defaultPointData.pointSpec = mitk::PTUNDEFINED;
 
   m_PointSetSeries[t]->SetPointData(id, defaultPointData);
+  if (indexed)
+    this->UpdateSpatialIndex(t, id, existed ? &oldIndexPoint : nullptr, &indexPoint);
   // boundingbox has to be computed anyway
   m_CalculateBoundingBox = true;
   this->Modified();
@@ -309,6 +483,10 @@ void mitk::PointSet::SetPoint(PointIdentifier id, PointType point, PointSpecific
   // Adapt the size of the data vector if necessary
   this->Expand(t + 1);
 
+  const bool indexed = this->IsSpatialIndexUpToDate(t);
+  PointType oldIndexPoint;
+  const bool existed = m_PointSetSeries[t]->GetPoints()->GetElementIfIndexExists(id, &oldIndexPoint);
+
   mitk::Point3D indexPoint;
   this->GetGeometry(t)->WorldToIndex(point, indexPoint);
   m_PointSetSeries[t]->SetPoint(id, indexPoint);
@@ -317,6 +495,8 @@ void mitk::PointSet::SetPoint(PointIdentifier id, PointType point, PointSpecific
   defaultPointData.selected = false;
   defaultPointData.pointSpec = spec;
   m_PointSetSeries[t]->SetPointData(id, defaultPointData);
+  if (indexed)
+    this->UpdateSpatialIndex(t, id, existed ? &oldIndexPoint : nullptr, &indexPoint);
   // boundingbox has to be computed anyway
   m_CalculateBoundingBox = true;
   this->Modified();
@@ -339,12 +519,19 @@ void mitk::PointSet::InsertPoint(PointIdentifier id, PointType point, PointSpeci
       return;
     }
     tempGeometry->WorldToIndex(point, indexPoint);
+
+    const bool indexed = this->IsSpatialIndexUpToDate(t);
+    PointType oldIndexPoint;
+    const bool existed = m_PointSetSeries[t]->GetPoints()->GetElementIfIndexExists(id, &oldIndexPoint);
+
     m_PointSetSeries[t]->GetPoints()->InsertElement(id, indexPoint);
     PointDataType defaultPointData;
     defaultPointData.id = id;
     defaultPointData.selected = false;
     defaultPointData.pointSpec = spec;
     m_PointSetSeries[t]->GetPointData()->InsertElement(id, defaultPointData);
+    if (indexed)
+      this->UpdateSpatialIndex(t, id, existed ? &oldIndexPoint : nullptr, &indexPoint);
 
     // boundingbox has to be computed anyway
     m_CalculateBoundingBox = true;
@@ -365,6 +552,8 @@ mitk::PointSet::PointIdentifier mitk::PointSet::InsertPoint(PointType point, int
     ++id;
   }
 
+  const bool indexed = this->IsSpatialIndexUpToDate(t);
+
   mitk::Point3D indexPoint;
   this->GetGeometry(t)->WorldToIndex(point, indexPoint);
   m_PointSetSeries[t]->SetPoint(id, indexPoint);
@@ -374,6 +563,8 @@ mitk::PointSet::PointIdentifier mitk::PointSet::InsertPoint(PointType point, int
   defaultPointData.pointSpec = mitk::PTUNDEFINED;
 
   m_PointSetSeries[t]->SetPointData(id, defaultPointData);
+  if (indexed)
+    this->UpdateSpatialIndex(t, id, nullptr, &indexPoint);
   // boundingbox has to be computed anyway
   m_CalculateBoundingBox = true;
   this->Modified();
@@ -390,11 +581,15 @@ bool mitk::PointSet::RemovePointIfExists(PointIdentifier id, int t)
     PointsContainer *points = pointSet->GetPoints();
     PointDataContainer *pdata = pointSet->GetPointData();
 
-    bool exists = points->IndexExists(id);
+    PointType oldIndexPoint;
+    bool exists = points->GetElementIfIndexExists(id, &oldIndexPoint);
     if (exists)
     {
+      const bool indexed = this->IsSpatialIndexUpToDate(t);
       points->DeleteIndex(id);
       pdata->DeleteIndex(id);
+      if (indexed)
+        this->UpdateSpatialIndex(t, id, &oldIndexPoint, nullptr);
       return true;
     }
   }
@@ -416,8 +611,12 @@ mitk::PointSet::PointsIterator mitk::PointSet::RemovePointAtEnd(int t)
     if (eit != bit)
     {
       PointsContainer::ElementIdentifier id = (--eit).Index();
+      const PointType oldIndexPoint = eit.Value();
+      const bool indexed = this->IsSpatialIndexUpToDate(t);
       points->DeleteIndex(id);
       pdata->DeleteIndex(id);
+      if (indexed)
+        this->UpdateSpatialIndex(t, id, &oldIndexPoint, nullptr);
       PointsIterator eit2 = points->End();
       return --eit2;
     }
@@ -602,7 +801,13 @@ void mitk::PointSet::ExecuteOperation(Operation *operation)
       }
       geometry->WorldToIndex(pt, pt);
 
+      const bool indexed = this->IsSpatialIndexUpToDate(timeStep);
+      PointType oldIndexPoint;
+      const bool existed = m_PointSetSeries[timeStep]->GetPoints()->GetElementIfIndexExists(position, &oldIndexPoint);
+
       m_PointSetSeries[timeStep]->GetPoints()->InsertElement(position, pt);
+      if (indexed)
+        this->UpdateSpatialIndex(timeStep, position, existed ? &oldIndexPoint : nullptr, &pt);
 
       PointDataType pointData = {
         static_cast<unsigned int>(pointOp->GetIndex()), pointOp->GetSelected(), pointOp->GetPointType()};
@@ -627,8 +832,15 @@ void mitk::PointSet::ExecuteOperation(Operation *operation)
       // transfer from world to index coordinates
       this->GetGeometry(timeStep)->WorldToIndex(pt, pt);
 
+      const bool indexed = this->IsSpatialIndexUpToDate(timeStep);
+      PointType oldIndexPoint;
+      const bool existed =
+        m_PointSetSeries[timeStep]->GetPoints()->GetElementIfIndexExists(pointOp->GetIndex(), &oldIndexPoint);
+
       // Copy new point into container
       m_PointSetSeries[timeStep]->SetPoint(pointOp->GetIndex(), pt);
+      if (indexed)
+        this->UpdateSpatialIndex(timeStep, pointOp->GetIndex(), existed ? &oldIndexPoint : nullptr, &pt);
 
       // Insert a default point data object to keep the containers in sync
       // (if no point data object exists yet)
@@ -651,8 +863,15 @@ void mitk::PointSet::ExecuteOperation(Operation *operation)
 
     case OpREMOVE: // removes the point at given by position
     {
+      const bool indexed = this->IsSpatialIndexUpToDate(timeStep);
+      PointType oldIndexPoint;
+      const bool existed = m_PointSetSeries[timeStep]->GetPoints()->GetElementIfIndexExists(
+        (unsigned)pointOp->GetIndex(), &oldIndexPoint);
+
       m_PointSetSeries[timeStep]->GetPoints()->DeleteIndex((unsigned)pointOp->GetIndex());
       m_PointSetSeries[timeStep]->GetPointData()->DeleteIndex((unsigned)pointOp->GetIndex());
+      if (indexed && existed)
+        this->UpdateSpatialIndex(timeStep, pointOp->GetIndex(), &oldIndexPoint, nullptr);
 
       this->OnPointSetChange();
 
@@ -878,6 +1097,52 @@ bool mitk::PointSet::SwapPointContents(PointIdentifier id1, PointIdentifier id2,
   return true;
 }
 
+std::shared_ptr<const mitk::PointSetSpatialIndex> mitk::PointSet::GetSpatialIndex(int t) const
+{
+  if (t < 0 || t >= (int)m_PointSetSeries.size() || this->GetSize(t) < SpatialIndexThreshold)
+  {
+    return nullptr;
+  }
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_SpatialIndicesMutex);
+  if (m_SpatialIndices.size() < m_PointSetSeries.size())
+  {
+    m_SpatialIndices.resize(m_PointSetSeries.size());
+  }
+
+  const PointsContainer *points = m_PointSetSeries[t]->GetPoints();
+  if (!m_SpatialIndices[t] || !m_SpatialIndices[t]->IsUpToDate(points))
+  {
+    // callers may still query the outdated index, so it is replaced instead of rebuilt in place
+    auto spatialIndex = std::make_shared<PointSetSpatialIndex>();
+    spatialIndex->Build(points);
+    m_SpatialIndices[t] = spatialIndex;
+  }
+
+  return m_SpatialIndices[t];
+}
+
+bool mitk::PointSet::IsSpatialIndexUpToDate(int t) const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_SpatialIndicesMutex);
+  return t >= 0 && t < (int)m_SpatialIndices.size() && t < (int)m_PointSetSeries.size() && m_SpatialIndices[t] &&
+         m_SpatialIndices[t]->IsUpToDate(m_PointSetSeries[t]->GetPoints());
+}
+
+void mitk::PointSet::UpdateSpatialIndex(int t, PointIdentifier id, const PointType *oldPoint, const PointType *newPoint)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_SpatialIndicesMutex);
+  std::shared_ptr<PointSetSpatialIndex> &spatialIndex = m_SpatialIndices[t];
+
+  // an index that is still used by a query is copied before the update
+  if (spatialIndex.use_count() > 1)
+  {
+    spatialIndex = std::make_shared<PointSetSpatialIndex>(*spatialIndex);
+  }
+
+  spatialIndex->Update(m_PointSetSeries[t]->GetPoints(), id, oldPoint, newPoint);
+}
+
 bool mitk::PointSet::PointDataType::operator==(const mitk::PointSet::PointDataType &other) const
 {
   return id == other.id && selected == other.selected && pointSpec == other.pointSpec;
@@ -0,0 +1,241 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPointSetSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // Cell coordinates are packed into 21 bits per dimension
+  const std::int64_t CellIndexBits = 21;
+  const std::int64_t CellIndexOffset = std::int64_t(1) << (CellIndexBits - 1);
+  const std::int64_t CellIndexMask = (std::int64_t(1) << CellIndexBits) - 1;
+
+  // Average number of points per cell aimed at when building the grid
+  const double PointsPerCell = 4.0;
+}
+
+mitk::PointSetSpatialIndex::PointSetSpatialIndex()
+  : m_CellSize(1.0), m_NumberOfPoints(0), m_Built(false), m_ContainerMTime(0)
+{
+  m_Origin.Fill(0.0);
+}
+
+void mitk::PointSetSpatialIndex::Build(const PointsContainer *points)
+{
+  this->Clear();
+
+  if (points == nullptr)
+    return;
+
+  PointType lower;
+  PointType upper;
+  lower.Fill(0.0);
+  upper.Fill(0.0);
+
+  for (auto it = points->Begin(); it != points->End(); ++it)
+  {
+    const PointType &point = it->Value();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (it == points->Begin() || point[i] < lower[i])
+        lower[i] = point[i];
+      if (it == points->Begin() || point[i] > upper[i])
+        upper[i] = point[i];
+    }
+  }
+
+  // derive the cell size from the extent of the non-degenerated dimensions,
+  // so that planar or linear point sets do not end up in a few huge cells
+  const std::size_t numberOfPoints = points->Size();
+  double maxExtent = 0.0;
+  for (unsigned int i = 0; i < 3; ++i)
+    maxExtent = std::max(maxExtent, upper[i] - lower[i]);
+
+  if (numberOfPoints > 0 && maxExtent > 0.0)
+  {
+    double volume = 1.0;
+    unsigned int dimensions = 0;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const double extent = upper[i] - lower[i];
+      if (extent > maxExtent * 1.0e-3)
+      {
+        volume *= extent;
+        ++dimensions;
+      }
+    }
+    m_CellSize = std::pow(volume * PointsPerCell / numberOfPoints, 1.0 / dimensions);
+    // keep the cell coordinates within the range that can be packed into a key
+    m_CellSize = std::max(m_CellSize, maxExtent / CellIndexOffset);
+  }
+
+  m_Origin = lower;
+  m_Cells.reserve(static_cast<std::size_t>(numberOfPoints / PointsPerCell) + 1);
+
+  for (auto it = points->Begin(); it != points->End(); ++it)
+  {
+    this->AddToCell(it->Index(), it->Value());
+  }
+
+  m_Built = true;
+  m_ContainerMTime = points->GetMTime();
+}
+
+void mitk::PointSetSpatialIndex::Clear()
+{
+  m_Cells.clear();
+  m_CellSize = 1.0;
+  m_Origin.Fill(0.0);
+  m_NumberOfPoints = 0;
+  m_Built = false;
+  m_ContainerMTime = 0;
+}
+
+bool mitk::PointSetSpatialIndex::IsUpToDate(const PointsContainer *points) const
+{
+  return m_Built && points != nullptr && points->GetMTime() == m_ContainerMTime;
+}
+
+void mitk::PointSetSpatialIndex::Update(const PointsContainer *points,
+                                        PointIdentifier id,
+                                        const PointType *oldPoint,
+                                        const PointType *newPoint)
+{
+  if (!m_Built)
+    return;
+
+  if (oldPoint != nullptr)
+    this->RemoveFromCell(id, *oldPoint);
+
+  if (newPoint != nullptr)
+    this->AddToCell(id, *newPoint);
+
+  m_ContainerMTime = points->GetMTime();
+}
+
+void mitk::PointSetSpatialIndex::FindPointsInBox(const PointType &lower,
+                                                 const PointType &upper,
+                                                 PointIdentifierList &ids) const
+{
+  std::int64_t lowerCell[3];
+  std::int64_t upperCell[3];
+  this->GetCellIndex(lower, lowerCell);
+  this->GetCellIndex(upper, upperCell);
+
+  double numberOfCells = 1.0;
+  for (unsigned int i = 0; i < 3; ++i)
+    numberOfCells *= static_cast<double>(upperCell[i] - lowerCell[i] + 1);
+
+  // for large query regions visiting the occupied cells is cheaper than
+  // probing every cell of the region
+  if (numberOfCells > static_cast<double>(m_Cells.size()))
+  {
+    this->FindPointsInCells(
+      [&lower, &upper](const PointType &cellLower, const PointType &cellUpper) {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          if (cellUpper[i] < lower[i] || cellLower[i] > upper[i])
+            return false;
+        }
+        return true;
+      },
+      ids);
+    return;
+  }
+
+  std::int64_t cell[3];
+  for (cell[2] = lowerCell[2]; cell[2] <= upperCell[2]; ++cell[2])
+  {
+    for (cell[1] = lowerCell[1]; cell[1] <= upperCell[1]; ++cell[1])
+    {
+      for (cell[0] = lowerCell[0]; cell[0] <= upperCell[0]; ++cell[0])
+      {
+        auto it = m_Cells.find(this->GetCellKey(cell));
+        if (it != m_Cells.end())
+          ids.insert(ids.end(), it->second.begin(), it->second.end());
+      }
+    }
+  }
+}
+
+mitk::PointSetSpatialIndex::CellKey mitk::PointSetSpatialIndex::GetCellKey(const PointType &point) const
+{
+  std::int64_t cell[3];
+  this->GetCellIndex(point, cell);
+  return this->GetCellKey(cell);
+}
+
+mitk::PointSetSpatialIndex::CellKey mitk::PointSetSpatialIndex::GetCellKey(const std::int64_t cell[3]) const
+{
+  return ((cell[0] + CellIndexOffset) << (2 * CellIndexBits)) | ((cell[1] + CellIndexOffset) << CellIndexBits) |
+         (cell[2] + CellIndexOffset);
+}
+
+void mitk::PointSetSpatialIndex::GetCellIndex(const PointType &point, std::int64_t cell[3]) const
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const double index = std::floor((point[i] - m_Origin[i]) / m_CellSize);
+    // points far outside of the initial extent share the border cells
+    cell[i] = static_cast<std::int64_t>(
+      std::max(static_cast<double>(-CellIndexOffset), std::min(index, static_cast<double>(CellIndexOffset - 1))));
+  }
+}
+
+void mitk::PointSetSpatialIndex::GetCellBounds(CellKey key, PointType &lower, PointType &upper) const
+{
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const std::int64_t cell = ((key >> ((2 - i) * CellIndexBits)) & CellIndexMask) - CellIndexOffset;
+    lower[i] = m_Origin[i] + cell * m_CellSize;
+    upper[i] = lower[i] + m_CellSize;
+
+    // border cells also hold the points beyond the packable range
+    if (cell == -CellIndexOffset)
+      lower[i] = -std::numeric_limits<ScalarType>::max();
+    if (cell == CellIndexOffset - 1)
+      upper[i] = std::numeric_limits<ScalarType>::max();
+  }
+}
+
+void mitk::PointSetSpatialIndex::AddToCell(PointIdentifier id, const PointType &point)
+{
+  m_Cells[this->GetCellKey(point)].push_back(id);
+  ++m_NumberOfPoints;
+}
+
+void mitk::PointSetSpatialIndex::RemoveFromCell(PointIdentifier id, const PointType &point)
+{
+  auto cellIt = m_Cells.find(this->GetCellKey(point));
+  if (cellIt == m_Cells.end())
+    return;
+
+  PointIdentifierList &cellIds = cellIt->second;
+  auto idIt = std::find(cellIds.begin(), cellIds.end(), id);
+  if (idIt == cellIds.end())
+    return;
+
+  *idIt = cellIds.back();
+  cellIds.pop_back();
+  --m_NumberOfPoints;
+
+  if (cellIds.empty())
+    m_Cells.erase(cellIt);
+}
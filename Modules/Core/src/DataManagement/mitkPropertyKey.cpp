@@ -0,0 +1,93 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPropertyKey.h"
+
+#include <itkMutexLockHolder.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <deque>
+#include <unordered_map>
+
+namespace
+{
+  struct KeyRegistry
+  {
+    KeyRegistry()
+    {
+      // id 0 is the empty name, i.e. the default constructed key
+      Names.push_back(std::string());
+      Ids.insert(std::make_pair(std::string(), 0));
+    }
+
+    itk::SimpleFastMutexLock Mutex;
+    std::unordered_map<std::string, mitk::PropertyKey::IdType> Ids;
+    std::deque<std::string> Names; // a deque does not move its elements, GetName() hands out references
+  };
+
+  KeyRegistry &GetRegistry()
+  {
+    static KeyRegistry registry;
+    return registry;
+  }
+
+  mitk::PropertyKey::IdType Intern(const std::string &name)
+  {
+    KeyRegistry &registry = GetRegistry();
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(registry.Mutex);
+
+    auto iter = registry.Ids.find(name);
+    if (iter != registry.Ids.end())
+      return iter->second;
+
+    mitk::PropertyKey::IdType id = static_cast<mitk::PropertyKey::IdType>(registry.Names.size());
+    registry.Names.push_back(name);
+    registry.Ids.insert(std::make_pair(name, id));
+    return id;
+  }
+}
+
+mitk::PropertyKey::PropertyKey() : m_Id(0)
+{
+}
+
+mitk::PropertyKey::PropertyKey(const char *name) : m_Id(name != nullptr ? Intern(name) : 0)
+{
+}
+
+mitk::PropertyKey::PropertyKey(const std::string &name) : m_Id(Intern(name))
+{
+}
+
+const std::string &mitk::PropertyKey::GetName() const
+{
+  KeyRegistry &registry = GetRegistry();
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(registry.Mutex);
+  return registry.Names[m_Id];
+}
+
+bool mitk::PropertyKey::Find(const std::string &name, IdType &id)
+{
+  KeyRegistry &registry = GetRegistry();
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(registry.Mutex);
+
+  auto iter = registry.Ids.find(name);
+  if (iter == registry.Ids.end())
+    return false;
+
+  id = iter->second;
+  return true;
+}
@@ -20,6 +20,20 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkProperties.h"
 #include "mitkStringProperty.h"
 
+#include <algorithm>
+
+namespace
+{
+  struct IndexEntryLess
+  {
+    template <typename Entry>
+    bool operator()(const Entry &entry, mitk::PropertyKey::IdType id) const
+    {
+      return entry.first < id;
+    }
+  };
+}
+
 mitk::BaseProperty *mitk::PropertyList::GetProperty(const std::string &propertyKey) const
 {
   PropertyMap::const_iterator it;
@@ -31,6 +45,39 @@ mitk::BaseProperty *mitk::PropertyList::GetProperty(const std::string &propertyK
     return nullptr;
 }
 
+mitk::BaseProperty *mitk::PropertyList::GetProperty(const PropertyKey &propertyKey) const
+{
+  const PropertyKey::IdType id = propertyKey.GetId();
+  auto it = std::lower_bound(m_Index.cbegin(), m_Index.cend(), id, IndexEntryLess());
+
+  if (it != m_Index.cend() && it->first == id)
+    return it->second;
+  else
+    return nullptr;
+}
+
+void mitk::PropertyList::AddToIndex(const std::string &propertyKey, BaseProperty *property)
+{
+  const PropertyKey::IdType id = PropertyKey(propertyKey).GetId();
+  auto it = std::lower_bound(m_Index.begin(), m_Index.end(), id, IndexEntryLess());
+
+  if (it != m_Index.end() && it->first == id)
+    it->second = property;
+  else
+    m_Index.insert(it, std::make_pair(id, property));
+}
+
+void mitk::PropertyList::RemoveFromIndex(const std::string &propertyKey)
+{
+  PropertyKey::IdType id;
+  if (!PropertyKey::Find(propertyKey, id))
+    return;
+
+  auto it = std::lower_bound(m_Index.begin(), m_Index.end(), id, IndexEntryLess());
+  if (it != m_Index.end() && it->first == id)
+    m_Index.erase(it);
+}
+
 void mitk::PropertyList::SetProperty(const std::string &propertyKey, BaseProperty *property)
 {
   if (!property)
@@ -71,6 +118,7 @@ void mitk::PropertyList::SetProperty(const std::string &propertyKey, BasePropert
 
   // no? add it.
   m_Properties.insert(PropertyMap::value_type(propertyKey, property));
+  this->AddToIndex(propertyKey, property);
   this->Modified();
 }
 
@@ -90,6 +138,7 @@ void mitk::PropertyList::ReplaceProperty(const std::string &propertyKey, BasePro
 
   // no? add/replace it.
   m_Properties.insert(PropertyMap::value_type(propertyKey, property));
+  this->AddToIndex(propertyKey, property);
   Modified();
 }
 
@@ -101,7 +150,9 @@ mitk::PropertyList::PropertyList(const mitk::PropertyList &other) : itk::Object(
 {
   for (auto i = other.m_Properties.cbegin(); i != other.m_Properties.cend(); ++i)
   {
-    m_Properties.insert(std::make_pair(i->first, i->second->Clone()));
+    BaseProperty::Pointer property = i->second->Clone();
+    m_Properties.insert(std::make_pair(i->first, property));
+    this->AddToIndex(i->first, property);
   }
 }
 
@@ -138,6 +189,7 @@ bool mitk::PropertyList::DeleteProperty(const std::string &propertyKey)
 
   if (it != m_Properties.end())
   {
+    this->RemoveFromIndex(propertyKey);
     it->second = nullptr;
     m_Properties.erase(it);
     Modified();
@@ -155,6 +207,7 @@ void mitk::PropertyList::Clear()
     ++it;
   }
   m_Properties.clear();
+  m_Index.clear();
 }
 
 itk::LightObject::Pointer mitk::PropertyList::InternalClone() const
@@ -24,8 +24,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNodePredicateProperty.h"
 #include "mitkProperties.h"
 
+#include <set>
+
 mitk::StandaloneDataStorage::StandaloneDataStorage() : mitk::DataStorage()
 {
+  m_UseIndex = true;
 }
 
 mitk::StandaloneDataStorage::~StandaloneDataStorage()
@@ -43,6 +46,7 @@ bool mitk::StandaloneDataStorage::IsInitialized() const
 
 void mitk::StandaloneDataStorage::Add(mitk::DataNode *node, const mitk::DataStorage::SetOfObjects *parents)
 {
+  bool deferred = false;
   {
     itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
     if (!IsInitialized())
@@ -83,12 +87,17 @@ void mitk::StandaloneDataStorage::Add(mitk::DataNode *node, const mitk::DataStor
                           node); // node is derived from parent. Insert it into the parents list of derived objects
     }
 
-    // register for ITK changed events
-    this->AddListeners(node);
+    this->AddToIndex(node);
+
+    // in a batch the node is observed and announced by EndBatch()
+    deferred = this->DeferNodeAddition(node);
+    if (!deferred)
+      this->AddListeners(node); // register for ITK changed events
   }
 
   /* Notify observers */
-  EmitAddNodeEvent(node);
+  if (!deferred)
+    EmitAddNodeEvent(node);
 }
 
 void mitk::StandaloneDataStorage::Remove(const mitk::DataNode *node)
@@ -109,14 +118,20 @@ void mitk::StandaloneDataStorage::Remove(const mitk::DataNode *node)
   //
   mitk::DataNode::ConstPointer nodeGuard(node);
 
+  // the observers do not know the node yet if it was added in the active batch
+  const bool additionCancelled = this->CancelNodeAddition(node);
+
   /* Notify observers of imminent node removal */
-  EmitRemoveNodeEvent(node);
+  if (!additionCancelled)
+    EmitRemoveNodeEvent(node);
   {
     itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_Mutex);
     /* remove node from both relation adjacency lists */
     this->RemoveFromRelation(node, m_SourceNodes);
     this->RemoveFromRelation(node, m_DerivedNodes);
   }
+  // the node is found by GetSubset() until here, like in GetAll()
+  this->RemoveFromIndex(node);
 }
 
 bool mitk::StandaloneDataStorage::Exists(const mitk::DataNode *node) const
@@ -187,10 +202,12 @@ mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetRe
   /* Or traverse adjacency list to collect all related nodes */
   std::vector<mitk::DataNode::ConstPointer> resultset;
   std::vector<mitk::DataNode::ConstPointer> openlist;
+  std::set<const mitk::DataNode *> visited; // nodes that are in resultset or openlist
 
   /* Initialize openlist with node. this will add node to resultset,
      but that is necessary to detect circular relations that would lead to endless recursion */
   openlist.push_back(node);
+  visited.insert(node);
 
   while (openlist.size() > 0)
   {
@@ -208,12 +225,9 @@ mitk::DataStorage::SetOfObjects::ConstPointer mitk::StandaloneDataStorage::GetRe
       for (SetOfObjects::ConstIterator parentIt = it->second->Begin(); parentIt != it->second->End();
            ++parentIt) // for each parent of current node
       {
-        mitk::DataNode::ConstPointer p = parentIt.Value().GetPointer();
-        if (!(std::find(resultset.cbegin(), resultset.cend(), p) !=
-              resultset.end()) // if it is not already in resultset
-            &&
-            !(std::find(openlist.cbegin(), openlist.cend(), p) != openlist.cend())) // and not already in openlist
-          openlist.push_back(p); // then add it to openlist, so that it can be processed
+        const mitk::DataNode *p = parentIt.Value().GetPointer();
+        if (visited.insert(p).second) // if it is neither in resultset nor in openlist
+          openlist.push_back(p);      // then add it to openlist, so that it can be processed
       }
   }
 
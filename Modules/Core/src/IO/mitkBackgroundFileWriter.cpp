@@ -0,0 +1,175 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkBackgroundFileWriter.h"
+
+#include <mitkLogMacros.h>
+
+#include <itksys/SystemTools.hxx>
+
+mitk::BackgroundFileWriter::BackgroundFileWriter()
+  : m_Failed(false),
+    m_StopWriting(false),
+    m_NumberOfQueuedRecords(0),
+    m_NumberOfStoredRecords(0),
+    m_NumberOfWrittenRecords(0),
+    m_NumberOfProcessedRecords(0),
+    m_RecordsProcessed(itk::ConditionVariable::New()),
+    m_MultiThreader(itk::MultiThreader::New()),
+    m_ThreadID(-1)
+{
+}
+
+mitk::BackgroundFileWriter::~BackgroundFileWriter()
+{
+  this->Close();
+}
+
+bool mitk::BackgroundFileWriter::Open(const std::string &fileName, const char *header, std::size_t headerSize)
+{
+  this->Close();
+
+  m_File.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_File.is_open())
+    return false;
+
+  m_File.write(header, headerSize);
+  m_File.flush();
+  if (!m_File.good())
+  {
+    m_File.close();
+    return false;
+  }
+
+  m_FileName = fileName;
+  m_Failed = false;
+  m_NumberOfQueuedRecords = 0;
+  m_NumberOfStoredRecords = 0;
+  m_NumberOfWrittenRecords = 0;
+  m_NumberOfProcessedRecords = 0;
+  return true;
+}
+
+void mitk::BackgroundFileWriter::Start(DrainFunction drain)
+{
+  if (!m_File.is_open() || m_ThreadID != -1)
+    return;
+
+  m_Drain = drain;
+  m_StopWriting = false;
+  m_ThreadID = m_MultiThreader->SpawnThread(ThreadStartWriting, this);
+}
+
+void mitk::BackgroundFileWriter::Close()
+{
+  if (m_ThreadID != -1)
+  {
+    m_StopWriting = true;
+    // the writer thread stores all queued records before it terminates
+    m_MultiThreader->TerminateThread(m_ThreadID);
+    m_ThreadID = -1;
+  }
+
+  m_Drain = DrainFunction();
+
+  if (m_File.is_open())
+    m_File.close();
+}
+
+bool mitk::BackgroundFileWriter::IsOpen() const
+{
+  return m_File.is_open();
+}
+
+bool mitk::BackgroundFileWriter::Write(const char *data, std::size_t size)
+{
+  if (m_Failed)
+    return false;
+
+  if (!m_File.write(data, size))
+  {
+    this->Fail("write");
+    return false;
+  }
+
+  ++m_NumberOfWrittenRecords;
+  return true;
+}
+
+bool mitk::BackgroundFileWriter::Flush()
+{
+  if (m_ThreadID == -1)
+    return !m_Failed;
+
+  const unsigned int queued = m_NumberOfQueuedRecords;
+
+  m_Mutex.Lock();
+  while (m_NumberOfProcessedRecords < queued)
+    m_RecordsProcessed->Wait(&m_Mutex);
+  m_Mutex.Unlock();
+
+  return !m_Failed;
+}
+
+void mitk::BackgroundFileWriter::Fail(const char *operation)
+{
+  if (!m_Failed)
+    MITK_ERROR << "Could not " << operation << " '" << m_FileName << "', further records are discarded.";
+
+  m_Failed = true;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::BackgroundFileWriter::ThreadStartWriting(void *pInfoStruct)
+{
+  /* extract this pointer from Thread Info structure */
+  struct itk::MultiThreader::ThreadInfoStruct *pInfo = (struct itk::MultiThreader::ThreadInfoStruct *)pInfoStruct;
+  if (pInfo == nullptr || pInfo->UserData == nullptr)
+    return ITK_THREAD_RETURN_VALUE;
+
+  BackgroundFileWriter *writer = static_cast<BackgroundFileWriter *>(pInfo->UserData);
+
+  while (true)
+  {
+    // read the flag before emptying the queues so that no record queued before Close() is lost
+    const bool stop = writer->m_StopWriting;
+
+    writer->m_NumberOfWrittenRecords = 0;
+    const unsigned int taken = writer->m_Drain();
+
+    if (taken > 0)
+    {
+      if (!writer->m_Failed && !writer->m_File.flush())
+        writer->Fail("flush");
+
+      if (!writer->m_Failed)
+        writer->m_NumberOfStoredRecords += writer->m_NumberOfWrittenRecords;
+
+      writer->m_Mutex.Lock();
+      writer->m_NumberOfProcessedRecords += taken;
+      writer->m_RecordsProcessed->Broadcast();
+      writer->m_Mutex.Unlock();
+    }
+
+    if (stop)
+      break;
+
+    // the acquiring threads do not signal new records, they must never wait for the writer
+    if (taken == 0)
+      itksys::SystemTools::Delay(1);
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
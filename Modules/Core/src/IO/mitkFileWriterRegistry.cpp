@@ -24,7 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 // Microservices
 #include <usGetModuleContext.h>
 #include <usLDAPProp.h>
+#include <usModule.h>
 #include <usModuleContext.h>
+#include <usModuleRegistry.h>
 #include <usServiceProperties.h>
 
 mitk::FileWriterRegistry::FileWriterRegistry()
@@ -58,6 +60,10 @@ std::vector<mitk::FileWriterRegistry::WriterReference> mitk::FileWriterRegistry:
   if (context == NULL)
     context = us::GetModuleContext();
 
+  // writers of IO modules whose auto-loading was deferred are registered now
+  us::ModuleRegistry::LoadDeferredModules(
+    us::GetModuleContext()->GetModule()->GetProperty(us::Module::PROP_AUTOLOAD_DIR()).ToString());
+
   std::vector<WriterReference> result;
 
   // loop over the class hierarchy of baseData and get all writers
@@ -19,4 +19,5 @@ See LICENSE.txt or http://www.mitk.org for details.
 namespace mitk
 {
   IFileReader::~IFileReader() {}
+  bool IFileReader::CanReadStream() const { return false; }
 }
@@ -32,6 +32,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <usModuleResourceStream.h>
 
 // ITK
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
 #include <itksys/SystemTools.hxx>
 
 // VTK
@@ -39,6 +41,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkSmartPointer.h>
 #include <vtkTriangleFilter.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdlib>
 
@@ -318,8 +322,45 @@ namespace mitk
     static BaseData::Pointer LoadBaseDataFromFile(const std::string &path);
 
     static void SetDefaultDataNodeProperties(mitk::DataNode *node, const std::string &filePath = std::string());
+
+    // reading a single file in concurrent mode, see SetConcurrentLoading()
+    struct ReadTask
+    {
+      ReadTask(LoadInfo *info, IFileReader *reader) : Info(info), Reader(reader) {}
+      LoadInfo *Info;
+      IFileReader *Reader;
+      StandaloneDataStorage::Pointer Storage;
+      DataStorage::SetOfObjects::Pointer Nodes;
+      std::string Error;
+    };
+
+    // shared by all threads reading files; tasks are handed out one at a time
+    // so that a few large files do not end up in the same thread
+    struct ReadJob
+    {
+      std::vector<ReadTask> *Tasks;
+      bool UseStorage;
+      std::size_t NextTask;
+      itk::SimpleFastMutexLock Mutex;
+    };
+
+    static DataStorage::SetOfObjects::Pointer ReadNodes(IFileReader *reader, DataStorage *ds);
+
+    static std::string AddLoadedNodes(LoadInfo &loadInfo,
+                                      const DataStorage::SetOfObjects *nodes,
+                                      DataStorage::SetOfObjects *nodeResult);
+
+    static void AddNodesToStorage(const DataStorage &source,
+                                  const DataStorage::SetOfObjects *nodes,
+                                  DataStorage &target);
+
+    static void ReadConcurrently(std::vector<ReadTask> &tasks, bool useStorage);
+
+    static ITK_THREAD_RETURN_TYPE ReadThread(void *arg);
   };
 
+  static std::atomic<bool> s_ConcurrentLoading(false);
+
 #ifdef US_PLATFORM_WINDOWS
   std::string IOUtil::GetProgramPath()
   {
@@ -644,6 +685,11 @@ namespace mitk
 
     std::map<std::string, FileReaderSelector::Item> usedReaderItems;
 
+    // in concurrent mode, the files are only read after the readers
+    // for all files were selected (which may need user interaction)
+    const bool concurrent = GetConcurrentLoading() && loadInfos.size() > 1;
+    std::vector<Impl::ReadTask> tasks;
+
     for (auto &loadInfo : loadInfos)
     {
       std::vector<FileReaderSelector::Item> readers = loadInfo.m_ReaderSelector.Get();
@@ -725,61 +771,58 @@ namespace mitk
         break;
       }
 
+      if (concurrent)
+      {
+        tasks.push_back(Impl::ReadTask(&loadInfo, reader));
+        continue;
+      }
+
       // Do the actual reading
       try
       {
-        DataStorage::SetOfObjects::Pointer nodes;
-        if (ds != NULL)
-        {
-          nodes = reader->Read(*ds);
-        }
-        else
+        DataStorage::SetOfObjects::Pointer nodes = Impl::ReadNodes(reader, ds);
+        errMsg += Impl::AddLoadedNodes(loadInfo, nodes, nodeResult);
+      }
+      catch (const std::exception &e)
+      {
+        errMsg += "Exception occured when reading file " + loadInfo.m_Path + ":\n" + e.what() + "\n\n";
+      }
+      mitk::ProgressBar::GetInstance()->Progress(2);
+      --filesToRead;
+    }
+
+    if (!tasks.empty())
+    {
+      Impl::ReadConcurrently(tasks, ds != NULL);
+
+      // the nodes of all files are announced together, also if adding them fails
+      DataStorage::BatchScope batch(ds);
+
+      // results are handled in the order of the input files
+      for (auto &task : tasks)
+      {
+        if (task.Error.empty())
         {
-          nodes = DataStorage::SetOfObjects::New();
-          std::vector<mitk::BaseData::Pointer> baseData = reader->Read();
-          for (std::vector<mitk::BaseData::Pointer>::iterator iter = baseData.begin(); iter != baseData.end(); ++iter)
+          try
           {
-            if (iter->IsNotNull())
+            if (ds != NULL)
             {
-              mitk::DataNode::Pointer node = mitk::DataNode::New();
-              node->SetData(*iter);
-              nodes->InsertElement(nodes->Size(), node);
+              Impl::AddNodesToStorage(*task.Storage, task.Nodes, *ds);
             }
+            errMsg += Impl::AddLoadedNodes(*task.Info, task.Nodes, nodeResult);
           }
-        }
-
-        for (DataStorage::SetOfObjects::ConstIterator nodeIter = nodes->Begin(), nodeIterEnd = nodes->End();
-             nodeIter != nodeIterEnd;
-             ++nodeIter)
-        {
-          const mitk::DataNode::Pointer &node = nodeIter->Value();
-          mitk::BaseData::Pointer data = node->GetData();
-          if (data.IsNull())
-          {
-            continue;
-          }
-
-          mitk::StringProperty::Pointer pathProp = mitk::StringProperty::New(loadInfo.m_Path);
-          data->SetProperty("path", pathProp);
-
-          loadInfo.m_Output.push_back(data);
-          if (nodeResult)
+          catch (const std::exception &e)
           {
-            nodeResult->push_back(nodeIter->Value());
+            task.Error = e.what();
           }
         }
-
-        if (loadInfo.m_Output.empty() || (nodeResult && nodeResult->Size() == 0))
+        if (!task.Error.empty())
         {
-          errMsg += "Unknown read error occurred reading " + loadInfo.m_Path;
+          errMsg += "Exception occured when reading file " + task.Info->m_Path + ":\n" + task.Error + "\n\n";
         }
+        mitk::ProgressBar::GetInstance()->Progress(2);
+        --filesToRead;
       }
-      catch (const std::exception &e)
-      {
-        errMsg += "Exception occured when reading file " + loadInfo.m_Path + ":\n" + e.what() + "\n\n";
-      }
-      mitk::ProgressBar::GetInstance()->Progress(2);
-      --filesToRead;
     }
 
     if (!errMsg.empty())
@@ -792,6 +835,149 @@ namespace mitk
     return errMsg;
   }
 
+  void IOUtil::SetConcurrentLoading(bool concurrent) { s_ConcurrentLoading = concurrent; }
+  bool IOUtil::GetConcurrentLoading() { return s_ConcurrentLoading; }
+
+  DataStorage::SetOfObjects::Pointer IOUtil::Impl::ReadNodes(IFileReader *reader, DataStorage *ds)
+  {
+    if (ds != NULL)
+    {
+      return reader->Read(*ds);
+    }
+
+    DataStorage::SetOfObjects::Pointer nodes = DataStorage::SetOfObjects::New();
+    std::vector<mitk::BaseData::Pointer> baseData = reader->Read();
+    for (std::vector<mitk::BaseData::Pointer>::iterator iter = baseData.begin(); iter != baseData.end(); ++iter)
+    {
+      if (iter->IsNotNull())
+      {
+        mitk::DataNode::Pointer node = mitk::DataNode::New();
+        node->SetData(*iter);
+        nodes->InsertElement(nodes->Size(), node);
+      }
+    }
+    return nodes;
+  }
+
+  std::string IOUtil::Impl::AddLoadedNodes(LoadInfo &loadInfo,
+                                           const DataStorage::SetOfObjects *nodes,
+                                           DataStorage::SetOfObjects *nodeResult)
+  {
+    for (DataStorage::SetOfObjects::ConstIterator nodeIter = nodes->Begin(), nodeIterEnd = nodes->End();
+         nodeIter != nodeIterEnd;
+         ++nodeIter)
+    {
+      const mitk::DataNode::Pointer &node = nodeIter->Value();
+      mitk::BaseData::Pointer data = node->GetData();
+      if (data.IsNull())
+      {
+        continue;
+      }
+
+      mitk::StringProperty::Pointer pathProp = mitk::StringProperty::New(loadInfo.m_Path);
+      data->SetProperty("path", pathProp);
+
+      loadInfo.m_Output.push_back(data);
+      if (nodeResult)
+      {
+        nodeResult->push_back(nodeIter->Value());
+      }
+    }
+
+    if (loadInfo.m_Output.empty() || (nodeResult && nodeResult->Size() == 0))
+    {
+      return "Unknown read error occurred reading " + loadInfo.m_Path;
+    }
+    return std::string();
+  }
+
+  void IOUtil::Impl::AddNodesToStorage(const DataStorage &source,
+                                       const DataStorage::SetOfObjects *nodes,
+                                       DataStorage &target)
+  {
+    // parents are added before their children, as if the reader had added the nodes to target
+    std::vector<DataNode::Pointer> pendingNodes(nodes->begin(), nodes->end());
+    while (!pendingNodes.empty())
+    {
+      std::size_t numberOfPendingNodes = pendingNodes.size();
+      for (auto nodeIter = pendingNodes.begin(); nodeIter != pendingNodes.end();)
+      {
+        DataStorage::SetOfObjects::ConstPointer parents = source.GetSources(*nodeIter);
+        bool hasPendingParent =
+          std::find_first_of(parents->begin(), parents->end(), pendingNodes.begin(), pendingNodes.end()) !=
+          parents->end();
+        if (hasPendingParent)
+        {
+          ++nodeIter;
+          continue;
+        }
+
+        target.Add(*nodeIter, parents);
+        nodeIter = pendingNodes.erase(nodeIter);
+      }
+
+      if (pendingNodes.size() == numberOfPendingNodes)
+      {
+        mitkThrow() << "Cyclic source relations between the loaded nodes.";
+      }
+    }
+  }
+
+  void IOUtil::Impl::ReadConcurrently(std::vector<ReadTask> &tasks, bool useStorage)
+  {
+    ReadJob job;
+    job.Tasks = &tasks;
+    job.UseStorage = useStorage;
+    job.NextTask = 0;
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(
+      std::min(threader->GetNumberOfThreads(), static_cast<itk::ThreadIdType>(tasks.size())));
+    threader->SetSingleMethod(ReadThread, &job);
+    threader->SingleMethodExecute();
+  }
+
+  ITK_THREAD_RETURN_TYPE IOUtil::Impl::ReadThread(void *arg)
+  {
+    typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+    ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+    ReadJob *job = static_cast<ReadJob *>(infoStruct->UserData);
+
+    while (true)
+    {
+      job->Mutex.Lock();
+      std::size_t taskIndex = job->NextTask++;
+      job->Mutex.Unlock();
+
+      if (taskIndex >= job->Tasks->size())
+      {
+        break;
+      }
+
+      // Runs in a worker thread: the nodes are only added to a storage private to the task
+      // and neither progress is reported nor errors are logged here.
+      ReadTask &task = (*job->Tasks)[taskIndex];
+      try
+      {
+        if (job->UseStorage)
+        {
+          task.Storage = StandaloneDataStorage::New();
+        }
+        task.Nodes = ReadNodes(task.Reader, task.Storage);
+      }
+      catch (const std::exception &e)
+      {
+        task.Error = e.what();
+      }
+      catch (...)
+      {
+        task.Error = "Unknown exception";
+      }
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
   std::vector<BaseData::Pointer> IOUtil::Load(const us::ModuleResource &usResource, std::ios_base::openmode mode)
   {
     us::ModuleResourceStream resStream(usResource, mode);
@@ -19,10 +19,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLogMacros.h"
 
 #include <usGetModuleContext.h>
+#include <usModule.h>
 #include <usModuleContext.h>
+#include <usModuleRegistry.h>
 
+#include <itkMutexLockHolder.h>
 #include <itksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <cctype>
+#include <typeinfo>
+
 #ifdef _MSC_VER
 #pragma warning(disable : 4503) // decorated name length exceeded, name was truncated
 #pragma warning(disable : 4355)
@@ -30,7 +37,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 namespace mitk
 {
-  MimeTypeProvider::MimeTypeProvider() : m_Tracker(NULL) {}
+  MimeTypeProvider::MimeTypeProvider() : m_Tracker(NULL), m_ExtensionIndexValid(false) {}
   MimeTypeProvider::~MimeTypeProvider() { delete m_Tracker; }
   void MimeTypeProvider::Start()
   {
@@ -44,6 +51,7 @@ namespace mitk
   void MimeTypeProvider::Stop() { m_Tracker->Close(); }
   std::vector<MimeType> MimeTypeProvider::GetMimeTypes() const
   {
+    this->LoadDeferredModules();
     std::vector<MimeType> result;
     for (const auto &elem : m_NameToMimeType)
     {
@@ -54,10 +62,11 @@ namespace mitk
 
   std::vector<MimeType> MimeTypeProvider::GetMimeTypesForFile(const std::string &filePath) const
   {
-    std::vector<MimeType> result;
+    this->LoadDeferredModules();
+    std::vector<MimeType> result = this->GetMimeTypesForExtension(filePath);
     for (const auto &elem : m_NameToMimeType)
     {
-      if (elem.second.AppliesTo(filePath))
+      if (m_ExtensionMimeTypeIds.count(elem.second.GetId()) == 0 && elem.second.AppliesTo(filePath))
       {
         result.push_back(elem.second);
       }
@@ -69,6 +78,7 @@ namespace mitk
 
   std::vector<MimeType> MimeTypeProvider::GetMimeTypesForCategory(const std::string &category) const
   {
+    this->LoadDeferredModules();
     std::vector<MimeType> result;
     for (const auto &elem : m_NameToMimeType)
     {
@@ -82,6 +92,7 @@ namespace mitk
 
   MimeType MimeTypeProvider::GetMimeTypeForName(const std::string &name) const
   {
+    this->LoadDeferredModules();
     std::map<std::string, MimeType>::const_iterator iter = m_NameToMimeType.find(name);
     if (iter != m_NameToMimeType.end())
       return iter->second;
@@ -90,6 +101,7 @@ namespace mitk
 
   std::vector<std::string> MimeTypeProvider::GetCategories() const
   {
+    this->LoadDeferredModules();
     std::vector<std::string> result;
     for (const auto &elem : m_NameToMimeType)
     {
@@ -106,9 +118,16 @@ namespace mitk
 
   MimeTypeProvider::TrackedType MimeTypeProvider::AddingService(const ServiceReferenceType &reference)
   {
-    MimeType result = this->GetMimeType(reference);
+    bool matchesExtensionOnly = false;
+    MimeType result = this->GetMimeType(reference, matchesExtensionOnly);
     if (result.IsValid())
     {
+      if (matchesExtensionOnly)
+      {
+        m_ExtensionMimeTypeIds.insert(result.GetId());
+      }
+      this->InvalidateExtensionIndex();
+
       std::string name = result.GetName();
       m_NameToMimeTypes[name].insert(result);
 
@@ -125,6 +144,9 @@ namespace mitk
 
   void MimeTypeProvider::RemovedService(const ServiceReferenceType & /*reference*/, TrackedType mimeType)
   {
+    m_ExtensionMimeTypeIds.erase(mimeType.GetId());
+    this->InvalidateExtensionIndex();
+
     std::string name = mimeType.GetName();
     std::set<MimeType> &mimeTypes = m_NameToMimeTypes[name];
     mimeTypes.erase(mimeType);
@@ -140,7 +162,7 @@ namespace mitk
     }
   }
 
-  MimeType MimeTypeProvider::GetMimeType(const ServiceReferenceType &reference) const
+  MimeType MimeTypeProvider::GetMimeType(const ServiceReferenceType &reference, bool &matchesExtensionOnly) const
   {
     MimeType result;
     if (!reference)
@@ -159,6 +181,7 @@ namespace mitk
         }
         long id = us::any_cast<long>(reference.GetProperty(us::ServiceConstants::SERVICE_ID()));
         result = MimeType(*mimeType, rank, id);
+        matchesExtensionOnly = typeid(*mimeType) == typeid(CustomMimeType);
       }
       catch (const us::BadAnyCastException &e)
       {
@@ -168,4 +191,82 @@ namespace mitk
     }
     return result;
   }
+
+  std::vector<MimeType> MimeTypeProvider::GetMimeTypesForExtension(const std::string &filePath) const
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ExtensionIndexMutex);
+
+    if (!m_ExtensionIndexValid)
+    {
+      m_ExtensionIndex.clear();
+      m_ExtensionLengths.clear();
+      for (const auto &elem : m_NameToMimeType)
+      {
+        if (m_ExtensionMimeTypeIds.count(elem.second.GetId()) == 0)
+        {
+          continue;
+        }
+
+        std::vector<std::string> extensions = elem.second.GetExtensions();
+        for (auto &extension : extensions)
+        {
+          if (extension.empty())
+          {
+            continue;
+          }
+          std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+          std::vector<MimeType> &mimeTypes = m_ExtensionIndex[extension];
+          if (std::find(mimeTypes.begin(), mimeTypes.end(), elem.second) == mimeTypes.end())
+          {
+            mimeTypes.push_back(elem.second);
+          }
+          m_ExtensionLengths.insert(extension.size());
+        }
+      }
+      m_ExtensionIndexValid = true;
+    }
+
+    // same as CustomMimeType::AppliesTo(), but one lookup per extension length
+    // instead of comparing the path with all extensions of all mime-types
+    std::vector<MimeType> result;
+    for (std::size_t length : m_ExtensionLengths)
+    {
+      if (length > filePath.size())
+      {
+        break;
+      }
+
+      std::string suffix = filePath.substr(filePath.size() - length);
+      std::transform(suffix.begin(), suffix.end(), suffix.begin(), ::tolower);
+      ExtensionIndexType::const_iterator iter = m_ExtensionIndex.find(suffix);
+      if (iter == m_ExtensionIndex.end())
+      {
+        continue;
+      }
+
+      for (const auto &mimeType : iter->second)
+      {
+        // a mime-type with several matching extensions is returned once
+        if (std::find(result.begin(), result.end(), mimeType) == result.end())
+        {
+          result.push_back(mimeType);
+        }
+      }
+    }
+    return result;
+  }
+
+  void MimeTypeProvider::InvalidateExtensionIndex()
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ExtensionIndexMutex);
+    m_ExtensionIndexValid = false;
+  }
+
+  void MimeTypeProvider::LoadDeferredModules() const
+  {
+    // the modules register their mime-types while they are loaded,
+    // which adds them to this provider via the tracker
+    us::ModuleRegistry::LoadDeferredModules(
+      us::GetModuleContext()->GetModule()->GetProperty(us::Module::PROP_AUTOLOAD_DIR()).ToString());
+  }
 }
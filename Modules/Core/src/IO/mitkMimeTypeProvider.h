@@ -23,6 +23,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "usServiceTracker.h"
 #include "usServiceTrackerCustomizer.h"
 
+#include <itkSimpleFastMutexLock.h>
+
 #include <set>
 
 namespace mitk
@@ -57,7 +59,14 @@ namespace mitk
     virtual void ModifiedService(const ServiceReferenceType &reference, TrackedType service) override;
     virtual void RemovedService(const ServiceReferenceType &reference, TrackedType service) override;
 
-    MimeType GetMimeType(const ServiceReferenceType &reference) const;
+    MimeType GetMimeType(const ServiceReferenceType &reference, bool &matchesExtensionOnly) const;
+
+    /** \brief Returns the mime-types matching \c filePath by extension only, see m_ExtensionMimeTypeIds. */
+    std::vector<MimeType> GetMimeTypesForExtension(const std::string &filePath) const;
+    void InvalidateExtensionIndex();
+
+    /** \brief Loads the IO modules whose auto-loading was deferred, so that their mime-types are known. */
+    void LoadDeferredModules() const;
 
     us::ServiceTracker<CustomMimeType, MimeTypeTrackerTypeTraits> *m_Tracker;
 
@@ -65,6 +74,17 @@ namespace mitk
     MapType m_NameToMimeTypes;
 
     std::map<std::string, MimeType> m_NameToMimeType;
+
+    // Ids of the mime-types whose AppliesTo() only compares the end of the path with their
+    // extensions. Subclasses of CustomMimeType may probe the file contents and are not indexed.
+    std::set<long> m_ExtensionMimeTypeIds;
+
+    // lower case extension -> mime-types, built on demand for GetMimeTypesForFile()
+    typedef std::map<std::string, std::vector<MimeType>> ExtensionIndexType;
+    mutable ExtensionIndexType m_ExtensionIndex;
+    mutable std::set<std::size_t> m_ExtensionLengths;
+    mutable bool m_ExtensionIndexValid;
+    mutable itk::SimpleFastMutexLock m_ExtensionIndexMutex;
   };
 }
 
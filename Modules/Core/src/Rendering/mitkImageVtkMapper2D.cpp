@@ -59,6 +59,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+namespace
+{
+  // keys of the properties queried for every rendered slice, interned once
+  const mitk::PropertyKey LayerKey("layer");
+  const mitk::PropertyKey VisibleKey("visible");
+  const mitk::PropertyKey OpacityKey("opacity");
+  const mitk::PropertyKey BinaryKey("binary");
+  const mitk::PropertyKey SelectedKey("selected");
+  const mitk::PropertyKey HoveringKey("binaryimage.ishovering");
+  const mitk::PropertyKey RenderingModeKey("Image Rendering.Mode");
+}
+
 mitk::ImageVtkMapper2D::ImageVtkMapper2D()
 {
 }
@@ -94,7 +106,7 @@ float mitk::ImageVtkMapper2D::CalculateLayerDepth(mitk::BaseRenderer *renderer)
   // Due to a VTK bug, we cannot use the whole clipping range. /100 is empirically determined
   float depth = -maxRange * 0.01; // divide by 100
   int layer = 0;
-  GetDataNode()->GetIntProperty("layer", layer, renderer);
+  GetDataNode()->GetIntProperty(LayerKey, layer, renderer);
   // add the layer property for each image to render images with a higher layer on top of the others
   depth += layer * 10; //*10: keep some room for each image (e.g. for QBalls in between)
   if (depth > 0.0f)
@@ -477,9 +489,9 @@ void mitk::ImageVtkMapper2D::ApplyColor(mitk::BaseRenderer *renderer)
   bool hover = false;
   bool selected = false;
   bool binary = false;
-  GetDataNode()->GetBoolProperty("binaryimage.ishovering", hover, renderer);
-  GetDataNode()->GetBoolProperty("selected", selected, renderer);
-  GetDataNode()->GetBoolProperty("binary", binary, renderer);
+  GetDataNode()->GetBoolProperty(HoveringKey, hover, renderer);
+  GetDataNode()->GetBoolProperty(SelectedKey, selected, renderer);
+  GetDataNode()->GetBoolProperty(BinaryKey, binary, renderer);
   if (binary && hover && !selected)
   {
     mitk::ColorProperty::Pointer colorprop =
@@ -534,7 +546,7 @@ void mitk::ImageVtkMapper2D::ApplyOpacity(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = this->GetLocalStorage(renderer);
   float opacity = 1.0f;
   // check for opacity prop and use it for rendering if it exists
-  GetDataNode()->GetOpacity(opacity, renderer, "opacity");
+  GetDataNode()->GetFloatProperty(OpacityKey, opacity, renderer);
   // set the opacity according to the properties
   localStorage->m_Actor->GetProperty()->SetOpacity(opacity);
   if (localStorage->m_Actors->GetParts()->GetNumberOfItems() > 1)
@@ -550,7 +562,7 @@ void mitk::ImageVtkMapper2D::ApplyRenderingMode(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
 
   bool binary = false;
-  this->GetDataNode()->GetBoolProperty("binary", binary, renderer);
+  this->GetDataNode()->GetBoolProperty(BinaryKey, binary, renderer);
   if (binary) // is it a binary image?
   {
     // for binary images, we always use our default LuT and map every value to (0,1)
@@ -562,7 +574,7 @@ void mitk::ImageVtkMapper2D::ApplyRenderingMode(mitk::BaseRenderer *renderer)
     // all other image types can make use of the rendering mode
     int renderingMode = mitk::RenderingModeProperty::LOOKUPTABLE_LEVELWINDOW_COLOR;
     mitk::RenderingModeProperty::Pointer mode =
-      dynamic_cast<mitk::RenderingModeProperty *>(this->GetDataNode()->GetProperty("Image Rendering.Mode", renderer));
+      dynamic_cast<mitk::RenderingModeProperty *>(this->GetDataNode()->GetProperty(RenderingModeKey, renderer));
     if (mode.IsNotNull())
     {
       renderingMode = mode->GetRenderingMode();
@@ -642,7 +654,7 @@ void mitk::ImageVtkMapper2D::ApplyColorTransferFunction(mitk::BaseRenderer *rend
 void mitk::ImageVtkMapper2D::Update(mitk::BaseRenderer *renderer)
 {
   bool visible = true;
-  GetDataNode()->GetVisibility(visible, renderer, "visible");
+  GetDataNode()->GetBoolProperty(VisibleKey, visible, renderer);
 
   if (!visible)
   {
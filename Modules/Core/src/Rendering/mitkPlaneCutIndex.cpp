@@ -0,0 +1,281 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPlaneCutIndex.h"
+
+#include <vtkCellData.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace
+{
+  // meshes with fewer cells are indexed by a single thread
+  const vtkIdType MINIMUM_NUMBER_OF_CELLS_PER_THREAD = 50000;
+
+  // the buckets hold this many cells on average, a query checks about one bucket
+  const vtkIdType CELLS_PER_BUCKET = 32;
+  const vtkIdType MAXIMUM_NUMBER_OF_BUCKETS = 16384;
+
+  float RoundDown(double value)
+  {
+    float result = static_cast<float>(value);
+    return result > value ? std::nextafter(result, -std::numeric_limits<float>::infinity()) : result;
+  }
+
+  float RoundUp(double value)
+  {
+    float result = static_cast<float>(value);
+    return result < value ? std::nextafter(result, std::numeric_limits<float>::infinity()) : result;
+  }
+}
+
+mitk::PlaneCutIndex::PlaneCutIndex(vtkPolyData *polyData, const double normal[3])
+  : m_PolyData(polyData),
+    m_PolyDataMTime(polyData->GetMTime()),
+    m_Built(false),
+    m_Minimum(0.0),
+    m_Maximum(0.0),
+    m_BucketWidth(1.0)
+{
+  double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+  if (length == 0.0)
+    length = 1.0;
+
+  for (int i = 0; i < 3; ++i)
+    m_Normal[i] = normal[i] / length;
+}
+
+bool mitk::PlaneCutIndex::IsValidFor(vtkPolyData *polyData) const
+{
+  return polyData == m_PolyData.GetPointer() && polyData->GetMTime() == m_PolyDataMTime;
+}
+
+bool mitk::PlaneCutIndex::IsValidFor(vtkPolyData *polyData, const double normal[3]) const
+{
+  if (!this->IsValidFor(polyData))
+    return false;
+
+  const double length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+  const double cosine = (normal[0] * m_Normal[0] + normal[1] * m_Normal[1] + normal[2] * m_Normal[2]) / length;
+
+  // planes with opposite normals are the same planes
+  return std::abs(cosine) > 1.0 - 1e-9;
+}
+
+void mitk::PlaneCutIndex::ComputeRanges(vtkIdType firstCell, vtkIdType endCell)
+{
+  vtkPoints *points = m_PolyData->GetPoints();
+  double point[3];
+
+  for (vtkIdType cellId = firstCell; cellId < endCell; ++cellId)
+  {
+    vtkIdType numberOfPoints;
+    vtkIdType *pointIds;
+    m_PolyData->GetCellPoints(cellId, numberOfPoints, pointIds);
+
+    double minimum = std::numeric_limits<double>::max();
+    double maximum = -std::numeric_limits<double>::max();
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+      points->GetPoint(pointIds[i], point);
+      const double distance = point[0] * m_Normal[0] + point[1] * m_Normal[1] + point[2] * m_Normal[2];
+      minimum = std::min(minimum, distance);
+      maximum = std::max(maximum, distance);
+    }
+
+    // empty cells get an empty range and are not put into any bucket
+    m_Ranges[cellId] = numberOfPoints > 0 ? RangeType(RoundDown(minimum), RoundUp(maximum)) : RangeType(1.0f, 0.0f);
+  }
+}
+
+ITK_THREAD_RETURN_TYPE mitk::PlaneCutIndex::ComputeRangesThread(void *arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+  PlaneCutIndex *index = static_cast<PlaneCutIndex *>(infoStruct->UserData);
+
+  const vtkIdType numberOfCells = static_cast<vtkIdType>(index->m_Ranges.size());
+  const vtkIdType firstCell = numberOfCells * infoStruct->ThreadID / infoStruct->NumberOfThreads;
+  const vtkIdType endCell = numberOfCells * (infoStruct->ThreadID + 1) / infoStruct->NumberOfThreads;
+  index->ComputeRanges(firstCell, endCell);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void mitk::PlaneCutIndex::Build()
+{
+  if (m_Built)
+    return;
+
+  const vtkIdType numberOfCells = m_PolyData->GetNumberOfCells();
+  m_Ranges.resize(numberOfCells);
+
+  if (numberOfCells > 0 && m_PolyData->GetPoints() != nullptr)
+  {
+    // the cell table is built on demand, which must not happen in several threads at once
+    if (m_PolyData->NeedToBuildCells())
+      m_PolyData->BuildCells();
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    const itk::ThreadIdType numberOfThreads = std::max<itk::ThreadIdType>(
+      1,
+      std::min(threader->GetNumberOfThreads(),
+               static_cast<itk::ThreadIdType>(numberOfCells / MINIMUM_NUMBER_OF_CELLS_PER_THREAD)));
+
+    if (numberOfThreads > 1)
+    {
+      threader->SetNumberOfThreads(numberOfThreads);
+      threader->SetSingleMethod(ComputeRangesThread, this);
+      threader->SingleMethodExecute();
+    }
+    else
+    {
+      this->ComputeRanges(0, numberOfCells);
+    }
+  }
+
+  m_Minimum = std::numeric_limits<double>::max();
+  m_Maximum = -std::numeric_limits<double>::max();
+  for (auto range = m_Ranges.cbegin(); range != m_Ranges.cend(); ++range)
+  {
+    if (range->first <= range->second)
+    {
+      m_Minimum = std::min<double>(m_Minimum, range->first);
+      m_Maximum = std::max<double>(m_Maximum, range->second);
+    }
+  }
+
+  const std::size_t numberOfBuckets = static_cast<std::size_t>(
+    std::max<vtkIdType>(1, std::min(numberOfCells / CELLS_PER_BUCKET, MAXIMUM_NUMBER_OF_BUCKETS)));
+
+  m_BucketWidth = m_Maximum > m_Minimum ? (m_Maximum - m_Minimum) / numberOfBuckets : 1.0;
+
+  // count the cells per bucket first to store all buckets in one array
+  m_BucketOffsets.assign(numberOfBuckets + 1, 0);
+  for (auto range = m_Ranges.cbegin(); range != m_Ranges.cend(); ++range)
+  {
+    if (range->first > range->second)
+      continue;
+
+    const std::size_t last = this->GetBucket(range->second);
+    for (std::size_t bucket = this->GetBucket(range->first); bucket <= last; ++bucket)
+      ++m_BucketOffsets[bucket + 1];
+  }
+
+  for (std::size_t bucket = 0; bucket < numberOfBuckets; ++bucket)
+    m_BucketOffsets[bucket + 1] += m_BucketOffsets[bucket];
+
+  m_BucketCells.resize(m_BucketOffsets.back());
+  std::vector<std::size_t> position(m_BucketOffsets.cbegin(), m_BucketOffsets.cend() - 1);
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+  {
+    const RangeType &range = m_Ranges[cellId];
+    if (range.first > range.second)
+      continue;
+
+    const std::size_t last = this->GetBucket(range.second);
+    for (std::size_t bucket = this->GetBucket(range.first); bucket <= last; ++bucket)
+      m_BucketCells[position[bucket]++] = cellId;
+  }
+
+  m_Built = true;
+}
+
+std::size_t mitk::PlaneCutIndex::GetBucket(double distance) const
+{
+  const std::size_t lastBucket = m_BucketOffsets.size() - 2;
+
+  if (distance <= m_Minimum)
+    return 0;
+
+  const double bucket = (distance - m_Minimum) / m_BucketWidth;
+  return bucket >= lastBucket ? lastBucket : static_cast<std::size_t>(bucket);
+}
+
+void mitk::PlaneCutIndex::FindCells(const double origin[3], std::vector<vtkIdType> &cellIds) const
+{
+  cellIds.clear();
+
+  const double distance = origin[0] * m_Normal[0] + origin[1] * m_Normal[1] + origin[2] * m_Normal[2];
+  if (!m_Built || distance < m_Minimum || distance > m_Maximum)
+    return;
+
+  const std::size_t bucket = this->GetBucket(distance);
+  for (std::size_t i = m_BucketOffsets[bucket]; i < m_BucketOffsets[bucket + 1]; ++i)
+  {
+    const RangeType &range = m_Ranges[m_BucketCells[i]];
+    if (range.first <= distance && distance <= range.second)
+      cellIds.push_back(m_BucketCells[i]);
+  }
+}
+
+vtkSmartPointer<vtkPolyData> mitk::PlaneCutIndex::ExtractCells(vtkPolyData *polyData,
+                                                              const std::vector<vtkIdType> &cellIds)
+{
+  vtkSmartPointer<vtkPolyData> result = vtkSmartPointer<vtkPolyData>::New();
+  if (cellIds.empty() || polyData->GetPoints() == nullptr)
+    return result;
+
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataType(polyData->GetPoints()->GetDataType());
+  points->Allocate(3 * cellIds.size());
+  result->SetPoints(points);
+  result->Allocate(cellIds.size());
+
+  vtkPointData *inputPointData = polyData->GetPointData();
+  vtkPointData *pointData = result->GetPointData();
+  pointData->CopyAllocate(inputPointData, 3 * cellIds.size());
+
+  vtkCellData *inputCellData = polyData->GetCellData();
+  vtkCellData *cellData = result->GetCellData();
+  cellData->CopyAllocate(inputCellData, cellIds.size());
+
+  std::unordered_map<vtkIdType, vtkIdType> pointMap;
+  std::vector<vtkIdType> cellPointIds;
+  double point[3];
+
+  for (auto cellId = cellIds.cbegin(); cellId != cellIds.cend(); ++cellId)
+  {
+    vtkIdType numberOfPoints;
+    vtkIdType *pointIds;
+    polyData->GetCellPoints(*cellId, numberOfPoints, pointIds);
+
+    cellPointIds.resize(numberOfPoints);
+    for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+      auto inserted = pointMap.insert(std::make_pair(pointIds[i], vtkIdType(0)));
+      if (inserted.second)
+      {
+        polyData->GetPoints()->GetPoint(pointIds[i], point);
+        inserted.first->second = points->InsertNextPoint(point);
+        pointData->CopyData(inputPointData, pointIds[i], inserted.first->second);
+      }
+      cellPointIds[i] = inserted.first->second;
+    }
+
+    const vtkIdType newCellId =
+      result->InsertNextCell(polyData->GetCellType(*cellId), numberOfPoints, cellPointIds.data());
+    cellData->CopyData(inputCellData, *cellId, newCellId);
+  }
+
+  result->Squeeze();
+  return result;
+}
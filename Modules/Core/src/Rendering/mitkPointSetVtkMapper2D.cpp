@@ -156,6 +156,61 @@ static bool makePerpendicularVector2D(const mitk::Vector2D &in, mitk::Vector2D &
     return false;
 }
 
+void mitk::PointSetVtkMapper2D::CreatePointMarker(LocalStorage *ls,
+                                                  const mitk::Point3D &point,
+                                                  const mitk::Point2D &pt2d,
+                                                  float dist,
+                                                  bool selected,
+                                                  itk::IdentifierType id,
+                                                  bool appendIdToLabel)
+{
+  const int text2dDistance = 10;
+
+  // is point selected or not?
+  if (selected)
+  {
+    ls->m_SelectedPoints->InsertNextPoint(point[0], point[1], point[2]);
+    // point is scaled according to its distance to the plane
+    ls->m_SelectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
+  }
+  else
+  {
+    ls->m_UnselectedPoints->InsertNextPoint(point[0], point[1], point[2]);
+    // point is scaled according to its distance to the plane
+    ls->m_UnselectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
+  }
+
+  //---- LABEL -----//
+  // paint label for each point if available
+  if (dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")) != NULL)
+  {
+    const char *pointLabel =
+      dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"))->GetValue();
+    std::string l = pointLabel;
+    if (appendIdToLabel)
+    {
+      std::stringstream ss;
+      ss << id;
+      l.append(ss.str());
+    }
+
+    ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+
+    ls->m_VtkTextActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
+    ls->m_VtkTextActor->SetInput(l.c_str());
+    ls->m_VtkTextActor->GetTextProperty()->SetOpacity(100);
+
+    float unselectedColor[4] = {1.0, 1.0, 0.0, 1.0};
+
+    // check if there is a color property
+    GetDataNode()->GetColor(unselectedColor);
+
+    ls->m_VtkTextActor->GetTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
+
+    ls->m_VtkTextLabelActors.push_back(ls->m_VtkTextActor);
+  }
+}
+
 void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *renderer)
 {
   LocalStorage *ls = m_LSH.GetLocalStorage(renderer);
@@ -273,168 +328,170 @@ void mitk::PointSetVtkMapper2D::CreateVTKRenderObjects(mitk::BaseRenderer *rende
 
   const mitk::PlaneGeometry *geo2D = renderer->GetCurrentWorldPlaneGeometry();
 
-  vtkLinearTransform *dataNodeTransform = input->GetGeometry()->GetVtkTransform();
+  // the same time step as the points, SearchPointsNearPlane() transforms them with it as well
+  vtkLinearTransform *dataNodeTransform = input->GetGeometry(timestep)->GetVtkTransform();
 
   int count = 0;
 
-  for (pointsIter = itkPointSet->GetPoints()->Begin(); pointsIter != itkPointSet->GetPoints()->End(); pointsIter++)
+  if (!m_ShowContour)
   {
-    lastP = p;              // valid for number of points count > 0
-    preLastPt2d = lastPt2d; // valid only for count > 1
-    lastPt2d = pt2d;        // valid for number of points count > 0
-
-    lastVec = vec; // valid only for counter > 1
+    // Only the markers of points close to the current plane are drawn, so only
+    // those are visited. The search distance is slightly enlarged to compensate
+    // the float precision of the transform used below.
+    mitk::PointSet::PointIdentifierList pointIds;
+    input->SearchPointsNearPlane(geo2D, m_DistanceToPlane + 1.0, pointIds, timestep);
 
-    // get current point in point set
-    point = pointsIter->Value();
-
-    // transform point
+    for (auto idIter = pointIds.begin(); idIter != pointIds.end(); ++idIter)
     {
-      float vtkp[3];
-      itk2vtk(point, vtkp);
-      dataNodeTransform->TransformPoint(vtkp, vtkp);
-      vtk2itk(vtkp, point);
-    }
+      if (!itkPointSet->GetPoint(*idIter, &point))
+        continue;
 
-    p[0] = point[0];
-    p[1] = point[1];
-    p[2] = point[2];
+      // transform point
+      {
+        float vtkp[3];
+        itk2vtk(point, vtkp);
+        dataNodeTransform->TransformPoint(vtkp, vtkp);
+        vtk2itk(vtkp, point);
+      }
 
-    renderer->WorldToDisplay(p, pt2d);
+      // compute distance to current plane
+      float dist = geo2D->Distance(point);
 
-    vec = p - lastP; // valid only for counter > 0
+      if (dist < m_DistanceToPlane)
+      {
+        p[0] = point[0];
+        p[1] = point[1];
+        p[2] = point[2];
+        renderer->WorldToDisplay(p, pt2d);
 
-    // compute distance to current plane
-    float dist = geo2D->Distance(point);
+        mitk::PointSet::PointDataType pointData = {0, false, PTUNDEFINED};
+        itkPointSet->GetPointData(*idIter, &pointData);
 
-    // draw markers on slices a certain distance away from the points
-    // location according to the tolerance threshold (m_DistanceToPlane)
-    if (dist < m_DistanceToPlane)
-    {
-      // is point selected or not?
-      if (pointDataIter->Value().selected)
-      {
-        ls->m_SelectedPoints->InsertNextPoint(point[0], point[1], point[2]);
-        // point is scaled according to its distance to the plane
-        ls->m_SelectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
-      }
-      else
-      {
-        ls->m_UnselectedPoints->InsertNextPoint(point[0], point[1], point[2]);
-        // point is scaled according to its distance to the plane
-        ls->m_UnselectedScales->InsertNextTuple3(std::max(0.0f, m_Point2DSize - (2 * dist)), 0, 0);
+        this->CreatePointMarker(ls, p, pt2d, dist, pointData.selected, *idIter, input->GetSize() > 1);
       }
+    }
+  }
+  else
+  {
+    for (pointsIter = itkPointSet->GetPoints()->Begin(); pointsIter != itkPointSet->GetPoints()->End(); pointsIter++)
+    {
+      lastP = p;              // valid for number of points count > 0
+      preLastPt2d = lastPt2d; // valid only for count > 1
+      lastPt2d = pt2d;        // valid for number of points count > 0
 
-      //---- LABEL -----//
-      // paint label for each point if available
-      if (dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label")) != NULL)
-      {
-        const char *pointLabel =
-          dynamic_cast<mitk::StringProperty *>(this->GetDataNode()->GetProperty("label"))->GetValue();
-        std::string l = pointLabel;
-        if (input->GetSize() > 1)
-        {
-          std::stringstream ss;
-          ss << pointsIter->Index();
-          l.append(ss.str());
-        }
+      lastVec = vec; // valid only for counter > 1
+
+      // get current point in point set
+      point = pointsIter->Value();
 
-        ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+      // transform point
+      {
+        float vtkp[3];
+        itk2vtk(point, vtkp);
+        dataNodeTransform->TransformPoint(vtkp, vtkp);
+        vtk2itk(vtkp, point);
+      }
 
-        ls->m_VtkTextActor->SetDisplayPosition(pt2d[0] + text2dDistance, pt2d[1] + text2dDistance);
-        ls->m_VtkTextActor->SetInput(l.c_str());
-        ls->m_VtkTextActor->GetTextProperty()->SetOpacity(100);
+      p[0] = point[0];
+      p[1] = point[1];
+      p[2] = point[2];
 
-        float unselectedColor[4] = {1.0, 1.0, 0.0, 1.0};
+      renderer->WorldToDisplay(p, pt2d);
 
-        // check if there is a color property
-        GetDataNode()->GetColor(unselectedColor);
+      vec = p - lastP; // valid only for counter > 0
 
-        ls->m_VtkTextActor->GetTextProperty()->SetColor(unselectedColor[0], unselectedColor[1], unselectedColor[2]);
+      // compute distance to current plane
+      float dist = geo2D->Distance(point);
 
-        ls->m_VtkTextLabelActors.push_back(ls->m_VtkTextActor);
+      // draw markers on slices a certain distance away from the points
+      // location according to the tolerance threshold (m_DistanceToPlane)
+      if (dist < m_DistanceToPlane)
+      {
+        this->CreatePointMarker(
+          ls, p, pt2d, dist, pointDataIter->Value().selected, pointsIter->Index(), input->GetSize() > 1);
       }
-    }
 
-    // draw contour, distance text and angle text in render window
+      // draw contour, distance text and angle text in render window
 
-    // lines between points, which intersect the current plane, are drawn
-    if (m_ShowContour && count > 0)
-    {
-      ScalarType distance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(point);
-      ScalarType lastDistance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(lastP);
+      // lines between points, which intersect the current plane, are drawn
+      if (m_ShowContour && count > 0)
+      {
+        ScalarType distance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(point);
+        ScalarType lastDistance = renderer->GetCurrentWorldPlaneGeometry()->SignedDistance(lastP);
 
-      pointsOnSameSideOfPlane = (distance * lastDistance) > 0.5;
+        pointsOnSameSideOfPlane = (distance * lastDistance) > 0.5;
 
-      // Points must be on different side of plane in order to draw a contour.
-      // If "show distant lines" is enabled this condition is disregarded.
-      if (!pointsOnSameSideOfPlane || m_ShowDistantLines)
-      {
-        vtkSmartPointer<vtkLine> line = vtkSmartPointer<vtkLine>::New();
+        // Points must be on different side of plane in order to draw a contour.
+        // If "show distant lines" is enabled this condition is disregarded.
+        if (!pointsOnSameSideOfPlane || m_ShowDistantLines)
+        {
+          vtkSmartPointer<vtkLine> line = vtkSmartPointer<vtkLine>::New();
 
-        ls->m_ContourPoints->InsertNextPoint(lastP[0], lastP[1], lastP[2]);
-        line->GetPointIds()->SetId(0, NumberContourPoints);
-        NumberContourPoints++;
+          ls->m_ContourPoints->InsertNextPoint(lastP[0], lastP[1], lastP[2]);
+          line->GetPointIds()->SetId(0, NumberContourPoints);
+          NumberContourPoints++;
 
-        ls->m_ContourPoints->InsertNextPoint(point[0], point[1], point[2]);
-        line->GetPointIds()->SetId(1, NumberContourPoints);
-        NumberContourPoints++;
+          ls->m_ContourPoints->InsertNextPoint(point[0], point[1], point[2]);
+          line->GetPointIds()->SetId(1, NumberContourPoints);
+          NumberContourPoints++;
 
-        ls->m_ContourLines->InsertNextCell(line);
+          ls->m_ContourLines->InsertNextCell(line);
 
-        if (m_ShowDistances) // calculate and print distance between adjacent points
-        {
-          float distancePoints = point.EuclideanDistanceTo(lastP);
+          if (m_ShowDistances) // calculate and print distance between adjacent points
+          {
+            float distancePoints = point.EuclideanDistanceTo(lastP);
 
-          std::stringstream buffer;
-          buffer << std::fixed << std::setprecision(m_DistancesDecimalDigits) << distancePoints << " mm";
+            std::stringstream buffer;
+            buffer << std::fixed << std::setprecision(m_DistancesDecimalDigits) << distancePoints << " mm";
 
-          // compute desired display position of text
-          Vector2D vec2d = pt2d - lastPt2d;
-          makePerpendicularVector2D(vec2d,
-                                    vec2d); // text is rendered within text2dDistance perpendicular to current line
-          Vector2D pos2d = (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
+            // compute desired display position of text
+            Vector2D vec2d = pt2d - lastPt2d;
+            makePerpendicularVector2D(vec2d,
+                                      vec2d); // text is rendered within text2dDistance perpendicular to current line
+            Vector2D pos2d =
+              (lastPt2d.GetVectorFromOrigin() + pt2d.GetVectorFromOrigin()) * 0.5 + vec2d * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+            ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
 
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
+            ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
+            ls->m_VtkTextActor->SetInput(buffer.str().c_str());
+            ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
 
-          ls->m_VtkTextDistanceActors.push_back(ls->m_VtkTextActor);
-        }
+            ls->m_VtkTextDistanceActors.push_back(ls->m_VtkTextActor);
+          }
 
-        if (m_ShowAngles && count > 1) // calculate and print angle between connected lines
-        {
-          std::stringstream buffer;
-          buffer << angle(vec.GetVnlVector(), -lastVec.GetVnlVector()) * 180 / vnl_math::pi << "°";
+          if (m_ShowAngles && count > 1) // calculate and print angle between connected lines
+          {
+            std::stringstream buffer;
+            buffer << angle(vec.GetVnlVector(), -lastVec.GetVnlVector()) * 180 / vnl_math::pi << "°";
 
-          // compute desired display position of text
-          Vector2D vec2d = pt2d - lastPt2d; // first arm enclosing the angle
-          vec2d.Normalize();
-          Vector2D lastVec2d = lastPt2d - preLastPt2d; // second arm enclosing the angle
-          lastVec2d.Normalize();
-          vec2d = vec2d - lastVec2d; // vector connecting both arms
-          vec2d.Normalize();
+            // compute desired display position of text
+            Vector2D vec2d = pt2d - lastPt2d; // first arm enclosing the angle
+            vec2d.Normalize();
+            Vector2D lastVec2d = lastPt2d - preLastPt2d; // second arm enclosing the angle
+            lastVec2d.Normalize();
+            vec2d = vec2d - lastVec2d; // vector connecting both arms
+            vec2d.Normalize();
 
-          // middle between two vectors that enclose the angle
-          Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
+            // middle between two vectors that enclose the angle
+            Vector2D pos2d = lastPt2d.GetVectorFromOrigin() + vec2d * text2dDistance * text2dDistance;
 
-          ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
+            ls->m_VtkTextActor = vtkSmartPointer<vtkTextActor>::New();
 
-          ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
-          ls->m_VtkTextActor->SetInput(buffer.str().c_str());
-          ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
+            ls->m_VtkTextActor->SetDisplayPosition(pos2d[0], pos2d[1]);
+            ls->m_VtkTextActor->SetInput(buffer.str().c_str());
+            ls->m_VtkTextActor->GetTextProperty()->SetColor(0.0, 1.0, 0.0);
 
-          ls->m_VtkTextAngleActors.push_back(ls->m_VtkTextActor);
+            ls->m_VtkTextAngleActors.push_back(ls->m_VtkTextActor);
+          }
         }
       }
-    }
 
-    if (pointDataIter != itkPointSet->GetPointData()->End())
-    {
-      pointDataIter++;
-      count++;
+      if (pointDataIter != itkPointSet->GetPointData()->End())
+      {
+        pointDataIter++;
+        count++;
+      }
     }
   }
 
@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIPropertyAliases.h>
 #include <mitkIPropertyDescriptions.h>
 #include <mitkLookupTableProperty.h>
+#include <mitkPlaneCutIndex.h>
 #include <mitkProperties.h>
 #include <mitkSurface.h>
 #include <mitkTransferFunctionProperty.h>
@@ -35,12 +36,26 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkCutter.h>
 #include <vtkGlyph3D.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkPlane.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
 #include <vtkReverseSense.h>
 #include <vtkTransformPolyDataFilter.h>
 
+#include <itkMutexLockHolder.h>
+
+#include <algorithm>
+
+namespace
+{
+  // smaller meshes are always cut as a whole
+  const vtkIdType MINIMUM_NUMBER_OF_INDEXED_CELLS = 20000;
+
+  // enough for the three standard orientations of two meshes or time steps
+  const std::size_t MAXIMUM_NUMBER_OF_CUT_INDICES = 6;
+}
+
 // constructor LocalStorage
 mitk::SurfaceVtkMapper2D::LocalStorage::LocalStorage()
 {
@@ -52,7 +67,9 @@ mitk::SurfaceVtkMapper2D::LocalStorage::LocalStorage()
   m_CuttingPlane = vtkSmartPointer<vtkPlane>::New();
   m_Cutter = vtkSmartPointer<vtkCutter>::New();
   m_Cutter->SetCutFunction(m_CuttingPlane);
-  m_Mapper->SetInputConnection(m_Cutter->GetOutputPort());
+  m_TransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  m_TransformFilter->SetInputConnection(m_Cutter->GetOutputPort());
+  m_Mapper->SetInputConnection(m_TransformFilter->GetOutputPort());
 
   m_NormalGlyph = vtkSmartPointer<vtkGlyph3D>::New();
 
@@ -212,22 +229,46 @@ void mitk::SurfaceVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rende
   normal[1] = planeGeometry->GetNormal()[1];
   normal[2] = planeGeometry->GetNormal()[2];
 
-  localStorage->m_CuttingPlane->SetOrigin(origin);
-  localStorage->m_CuttingPlane->SetNormal(normal);
-  // Transform the data according to its geometry.
+  // Cut the data in its own coordinates and transform only the slice according to the geometry.
   // See UpdateVtkTransform documentation for details.
   vtkSmartPointer<vtkLinearTransform> vtktransform = GetDataNode()->GetVtkTransform(this->GetTimestep());
-  vtkSmartPointer<vtkTransformPolyDataFilter> filter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  filter->SetTransform(vtktransform);
-  filter->SetInputData(inputPolyData);
-  localStorage->m_Cutter->SetInputConnection(filter->GetOutputPort());
-  localStorage->m_Cutter->Update();
+  vtkSmartPointer<vtkMatrix4x4> matrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  vtktransform->GetMatrix(matrix);
+  vtkSmartPointer<vtkMatrix4x4> inverseMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  vtkMatrix4x4::Invert(matrix, inverseMatrix);
+
+  double localOrigin[4] = {origin[0], origin[1], origin[2], 1.0};
+  inverseMatrix->MultiplyPoint(localOrigin, localOrigin);
+
+  // the plane normal is transformed with the transposed matrix of the data geometry
+  double localNormal[3];
+  for (int i = 0; i < 3; ++i)
+    localNormal[i] =
+      matrix->GetElement(0, i) * normal[0] + matrix->GetElement(1, i) * normal[1] + matrix->GetElement(2, i) * normal[2];
+
+  localStorage->m_CuttingPlane->SetOrigin(localOrigin);
+  localStorage->m_CuttingPlane->SetNormal(localNormal);
+
+  std::shared_ptr<PlaneCutIndex> cutIndex = this->GetCutIndex(inputPolyData, localNormal);
+  if (cutIndex != nullptr)
+  {
+    std::vector<vtkIdType> cellIds;
+    cutIndex->FindCells(localOrigin, cellIds);
+    localStorage->m_Cutter->SetInputData(PlaneCutIndex::ExtractCells(inputPolyData, cellIds));
+  }
+  else
+  {
+    localStorage->m_Cutter->SetInputData(inputPolyData);
+  }
+
+  localStorage->m_TransformFilter->SetTransform(vtktransform);
+  localStorage->m_TransformFilter->Update();
 
   bool generateNormals = false;
   node->GetBoolProperty("draw normals 2D", generateNormals);
   if (generateNormals)
   {
-    localStorage->m_NormalGlyph->SetInputConnection(localStorage->m_Cutter->GetOutputPort());
+    localStorage->m_NormalGlyph->SetInputConnection(localStorage->m_TransformFilter->GetOutputPort());
     localStorage->m_NormalGlyph->Update();
 
     localStorage->m_NormalMapper->SetInputConnection(localStorage->m_NormalGlyph->GetOutputPort());
@@ -244,7 +285,7 @@ void mitk::SurfaceVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rende
   node->GetBoolProperty("invert normals", generateInverseNormals);
   if (generateInverseNormals)
   {
-    localStorage->m_ReverseSense->SetInputConnection(localStorage->m_Cutter->GetOutputPort());
+    localStorage->m_ReverseSense->SetInputConnection(localStorage->m_TransformFilter->GetOutputPort());
     localStorage->m_ReverseSense->ReverseCellsOff();
     localStorage->m_ReverseSense->ReverseNormalsOn();
 
@@ -262,6 +303,44 @@ void mitk::SurfaceVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *rende
   }
 }
 
+std::shared_ptr<mitk::PlaneCutIndex> mitk::SurfaceVtkMapper2D::GetCutIndex(vtkPolyData *polyData,
+                                                                            const double normal[3])
+{
+  // the mapper is shared by all renderers, which may update concurrently
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_CutIndicesMutex);
+
+  // the indices hold their polydata, so they are dropped as soon as the input is replaced or modified
+  m_CutIndices.erase(std::remove_if(m_CutIndices.begin(),
+                                    m_CutIndices.end(),
+                                    [polyData](const std::shared_ptr<PlaneCutIndex> &cutIndex) {
+                                      return !cutIndex->IsValidFor(polyData);
+                                    }),
+                     m_CutIndices.end());
+
+  if (polyData->GetNumberOfCells() < MINIMUM_NUMBER_OF_INDEXED_CELLS)
+    return nullptr;
+
+  for (auto iter = m_CutIndices.begin(); iter != m_CutIndices.end(); ++iter)
+  {
+    if ((*iter)->IsValidFor(polyData, normal))
+    {
+      std::shared_ptr<PlaneCutIndex> cutIndex = *iter;
+      m_CutIndices.erase(iter);
+      m_CutIndices.push_front(cutIndex);
+
+      cutIndex->Build();
+      return cutIndex;
+    }
+  }
+
+  // remember the request, the index is built when it is repeated
+  m_CutIndices.push_front(std::make_shared<PlaneCutIndex>(polyData, normal));
+  if (m_CutIndices.size() > MAXIMUM_NUMBER_OF_CUT_INDICES)
+    m_CutIndices.pop_back();
+
+  return nullptr;
+}
+
 void mitk::SurfaceVtkMapper2D::FixupLegacyProperties(PropertyList *properties)
 {
   // Before bug 18528, "line width" was an IntProperty, now it is a FloatProperty
@@ -56,14 +56,35 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransform.h>
 #include <vtkWorldPointPicker.h>
 
+#include <chrono>
+
+namespace
+{
+  double GetMillisecondsSince(const std::chrono::steady_clock::time_point &start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
 mitk::VtkPropRenderer::VtkPropRenderer(const char *name,
                                        vtkRenderWindow *renWin,
                                        mitk::RenderingManager *rm,
                                        mitk::BaseRenderer::RenderingMode::Type renderingMode)
-  : BaseRenderer(name, renWin, rm, renderingMode), m_CameraInitializedForMapperID(0)
+  : BaseRenderer(name, renWin, rm, renderingMode),
+    m_CameraInitializedForMapperID(0),
+    m_MapperQueueValid(false),
+    m_MapperQueueMapperID(0),
+    m_MappersUpdated(false),
+    m_LastMapperUpdateTime(0.0),
+    m_LastMapperRenderTime(0.0)
 {
   didCount = false;
 
+  m_MapperQueueModifiedCommand = itk::MemberCommand<VtkPropRenderer>::New();
+  m_MapperQueueModifiedCommand->SetCallbackFunction(this, &VtkPropRenderer::MapperQueueModified);
+  m_DataNodeModifiedCommand = itk::MemberCommand<VtkPropRenderer>::New();
+  m_DataNodeModifiedCommand->SetCallbackFunction(this, &VtkPropRenderer::DataNodeModified);
+
   m_WorldPointPicker = vtkWorldPointPicker::New();
 
   m_PointPicker = vtkPointPicker::New();
@@ -91,6 +112,15 @@ mitk::VtkPropRenderer::VtkPropRenderer(const char *name,
 */
 mitk::VtkPropRenderer::~VtkPropRenderer()
 {
+  this->ClearMapperQueue();
+  if (m_DataStorage.IsNotNull())
+  {
+    m_DataStorage->AddNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeAdded));
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeRemoved));
+  }
+
   // Workaround for GLDisplayList Bug
   {
     m_MapperID = 0;
@@ -126,8 +156,22 @@ void mitk::VtkPropRenderer::SetDataStorage(mitk::DataStorage *storage)
   if (storage == nullptr || storage == m_DataStorage)
     return;
 
+  if (m_DataStorage.IsNotNull())
+  {
+    m_DataStorage->AddNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeAdded));
+    m_DataStorage->RemoveNodeEvent.RemoveListener(
+      MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeRemoved));
+  }
+
   BaseRenderer::SetDataStorage(storage);
 
+  m_DataStorage->AddNodeEvent.AddListener(
+    MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeAdded));
+  m_DataStorage->RemoveNodeEvent.AddListener(
+    MessageDelegate1<VtkPropRenderer, const DataNode *>(this, &VtkPropRenderer::DataStorageNodeRemoved));
+  m_MapperQueueValid = false;
+
   static_cast<mitk::PlaneGeometryDataVtkMapper3D *>(m_CurrentWorldPlaneGeometryMapper.GetPointer())
     ->SetDataStorageForTexture(m_DataStorage.GetPointer());
 
@@ -172,11 +216,13 @@ int mitk::VtkPropRenderer::Render(mitk::VtkPropRenderer::RenderType type)
     this->PrepareMapperQueue();
 
   // go through the generated list and let the sorted mappers paint
+  const auto start = std::chrono::steady_clock::now();
   for (auto it = m_MappersMap.cbegin(); it != m_MappersMap.cend(); it++)
   {
     Mapper *mapper = (*it).second;
     mapper->MitkRender(this, type);
   }
+  m_LastMapperRenderTime += GetMillisecondsSince(start);
 
   // Render text
   if (type == VtkPropRenderer::Overlay)
@@ -196,20 +242,33 @@ int mitk::VtkPropRenderer::Render(mitk::VtkPropRenderer::RenderType type)
 \brief PrepareMapperQueue iterates the datatree
 
 PrepareMapperQueue iterates the datatree in order to find mappers which shall be rendered. Also, it sortes the mappers
-wrt to their layer.
+wrt to their layer. The sorted mappers are only collected again after the DataStorage or a relevant property
+changed, see BuildMapperQueue().
 */
 void mitk::VtkPropRenderer::PrepareMapperQueue()
 {
   // variable for counting LOD-enabled mappers
   m_NumberOfVisibleLODEnabledMappers = 0;
 
+  // the opaque pass comes first, the times of all passes of a frame are summed up
+  m_LastMapperRenderTime = 0.0;
+
   // Do we have to update the mappers ?
-  if (m_LastUpdateTime < GetMTime() || m_LastUpdateTime < this->GetCurrentWorldPlaneGeometry()->GetMTime())
+  if (m_MappersUpdated)
+  {
+    // the mappers were updated already, possibly in other threads
+    m_MappersUpdated = false;
+    Modified();
+    m_LastUpdateTime = GetMTime();
+  }
+  else if (m_LastUpdateTime < GetMTime() || m_LastUpdateTime < this->GetCurrentWorldPlaneGeometry()->GetMTime())
   {
     Update();
   }
   else if (m_MapperID >= 1 && m_MapperID < 6)
     Update();
+  else
+    m_LastMapperUpdateTime = 0.0;
 
   // remove all text properties before mappers will add new ones
   m_TextRenderer->RemoveAllViewProps();
@@ -220,14 +279,33 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
   }
   m_TextCollection.clear();
 
-  // clear priority_queue
-  m_MappersMap.clear();
-
-  int mapperNo = 0;
-
   // DataStorage
   if (m_DataStorage.IsNull())
+  {
+    this->ClearMapperQueue();
     return;
+  }
+
+  if (!m_MapperQueueValid || m_MapperQueueMapperID != m_MapperID)
+  {
+    this->BuildMapperQueue();
+  }
+
+  // The information about LOD-enabled mappers is required by RenderingManager
+  for (auto mapper : m_VisibleQueuedMappers)
+  {
+    if (mapper->IsLODEnabled(this))
+    {
+      ++m_NumberOfVisibleLODEnabledMappers;
+    }
+  }
+}
+
+void mitk::VtkPropRenderer::BuildMapperQueue()
+{
+  this->ClearMapperQueue();
+
+  int mapperNo = 0;
 
   DataStorage::SetOfObjects::ConstPointer allObjects = m_DataStorage->GetAll();
 
@@ -236,6 +314,10 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
     const DataNode::Pointer node = it->Value();
     if (node.IsNull())
       continue;
+
+    // a node without mapper may get one together with new data
+    this->AddMapperQueueObserver(node, m_DataNodeModifiedCommand);
+
     const mitk::Mapper::Pointer mapper = node->GetMapper(m_MapperID);
 
     if (mapper.IsNull())
@@ -244,18 +326,80 @@ void mitk::VtkPropRenderer::PrepareMapperQueue()
     bool visible = true;
     node->GetVisibility(visible, this, "visible");
 
-    // The information about LOD-enabled mappers is required by RenderingManager
-    if (mapper->IsLODEnabled(this) && visible)
-    {
-      ++m_NumberOfVisibleLODEnabledMappers;
-    }
     // mapper without a layer property get layer number 1
     int layer = 1;
     node->GetIntProperty("layer", layer, this);
     int nr = (layer << 16) + mapperNo;
     m_MappersMap.insert(std::pair<int, Mapper *>(nr, mapper));
     mapperNo++;
+
+    m_QueuedMappers.push_back(mapper);
+    if (visible)
+    {
+      m_VisibleQueuedMappers.push_back(mapper);
+    }
+
+    // property lists change if "visible" or "layer" are added or replaced, the
+    // properties themselves if their values change
+    this->AddMapperQueueObserver(node->GetPropertyList(), m_MapperQueueModifiedCommand);
+    this->AddMapperQueueObserver(node->GetPropertyList(this), m_MapperQueueModifiedCommand);
+    this->AddMapperQueueObserver(node->GetProperty("visible", this), m_MapperQueueModifiedCommand);
+    this->AddMapperQueueObserver(node->GetProperty("layer", this), m_MapperQueueModifiedCommand);
   }
+
+  m_MapperQueueMapperID = m_MapperID;
+  m_MapperQueueTime.Modified();
+  m_MapperQueueValid = true;
+}
+
+void mitk::VtkPropRenderer::ClearMapperQueue()
+{
+  for (auto observer = m_MapperQueueObservers.begin(); observer != m_MapperQueueObservers.end(); ++observer)
+  {
+    observer->first->RemoveObserver(observer->second);
+  }
+  m_MapperQueueObservers.clear();
+
+  m_MappersMap.clear();
+  m_QueuedMappers.clear();
+  m_VisibleQueuedMappers.clear();
+  m_MapperQueueValid = false;
+}
+
+void mitk::VtkPropRenderer::AddMapperQueueObserver(itk::Object *object, itk::Command *command)
+{
+  if (object == nullptr)
+    return;
+
+  unsigned long tag = object->AddObserver(itk::ModifiedEvent(), command);
+  m_MapperQueueObservers.push_back(std::make_pair(itk::Object::Pointer(object), tag));
+}
+
+void mitk::VtkPropRenderer::MapperQueueModified(const itk::Object *, const itk::EventObject &)
+{
+  m_MapperQueueValid = false;
+}
+
+void mitk::VtkPropRenderer::DataNodeModified(const itk::Object *caller, const itk::EventObject &)
+{
+  // nodes are modified whenever their data is, but only new data objects or SetMapper() change the mappers
+  const DataNode *node = dynamic_cast<const DataNode *>(caller);
+  if (node != nullptr && (node->GetDataReferenceChangedTime() > m_MapperQueueTime.GetMTime() ||
+                          node->GetMapperChangedTime() > m_MapperQueueTime.GetMTime()))
+  {
+    m_MapperQueueValid = false;
+  }
+}
+
+void mitk::VtkPropRenderer::DataStorageNodeAdded(const DataNode *)
+{
+  m_MapperQueueValid = false;
+}
+
+void mitk::VtkPropRenderer::DataStorageNodeRemoved(const DataNode *)
+{
+  // release the node and its mapper now, this renderer may not render again for a while
+  this->ClearMapperQueue();
 }
 
 void mitk::VtkPropRenderer::Update(mitk::DataNode *datatreenode)
@@ -265,16 +409,21 @@ void mitk::VtkPropRenderer::Update(mitk::DataNode *datatreenode)
     mitk::Mapper::Pointer mapper = datatreenode->GetMapper(m_MapperID);
     if (mapper.IsNotNull())
     {
-      if (GetCurrentWorldPlaneGeometry()->IsValid())
+      this->UpdateMapper(mapper);
+    }
+  }
+}
+
+void mitk::VtkPropRenderer::UpdateMapper(Mapper *mapper)
+{
+  if (GetCurrentWorldPlaneGeometry()->IsValid())
+  {
+    mapper->Update(this);
+    {
+      VtkMapper *vtkmapper = dynamic_cast<VtkMapper *>(mapper);
+      if (vtkmapper != nullptr)
       {
-        mapper->Update(this);
-        {
-          VtkMapper *vtkmapper = dynamic_cast<VtkMapper *>(mapper.GetPointer());
-          if (vtkmapper != nullptr)
-          {
-            vtkmapper->UpdateVtkTransform(this);
-          }
-        }
+        vtkmapper->UpdateVtkTransform(this);
       }
     }
   }
@@ -285,14 +434,47 @@ void mitk::VtkPropRenderer::Update()
   if (m_DataStorage.IsNull())
     return;
 
-  mitk::DataStorage::SetOfObjects::ConstPointer all = m_DataStorage->GetAll();
-  for (mitk::DataStorage::SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
-    Update(it->Value());
+  const auto start = std::chrono::steady_clock::now();
+
+  if (m_MapperQueueValid && m_MapperQueueMapperID == m_MapperID)
+  {
+    // nodes without a mapper for this renderer are not in the queue, Update() would skip them anyway
+    for (auto mapper = m_QueuedMappers.cbegin(); mapper != m_QueuedMappers.cend(); ++mapper)
+      this->UpdateMapper(*mapper);
+  }
+  else
+  {
+    mitk::DataStorage::SetOfObjects::ConstPointer all = m_DataStorage->GetAll();
+    for (mitk::DataStorage::SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
+      Update(it->Value());
+  }
+
+  m_LastMapperUpdateTime = GetMillisecondsSince(start);
 
   Modified();
   m_LastUpdateTime = GetMTime();
 }
 
+bool mitk::VtkPropRenderer::PrepareMapperUpdate()
+{
+  m_MappersUpdated = false;
+
+  if (this->GetEmptyWorldGeometry() || m_DataStorage.IsNull())
+    return false;
+
+  if (!m_MapperQueueValid || m_MapperQueueMapperID != m_MapperID)
+  {
+    this->BuildMapperQueue();
+  }
+  return true;
+}
+
+void mitk::VtkPropRenderer::SetMappersUpdated(double updateTime)
+{
+  m_LastMapperUpdateTime = updateTime;
+  m_MappersUpdated = true;
+}
+
 /*!
 \brief
 
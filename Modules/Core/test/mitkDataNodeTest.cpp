@@ -134,6 +134,15 @@ public:
     dataNode->SetMapper(1, mapper);
     MITK_TEST_CONDITION(mapper == dataNode->GetMapper(1), "Testing if a SurfaceVtkMapper3D was set correctly")
     MITK_TEST_CONDITION(dataNode == mapper->GetDataNode(), "Testing if the mapper returns the right DataNode")
+
+    unsigned long mapperChangedTime = dataNode->GetMapperChangedTime();
+    dataNode->SetMapper(1, mapper);
+    MITK_TEST_CONDITION(mapperChangedTime == dataNode->GetMapperChangedTime(),
+                        "Testing if setting the same mapper again does not modify the node")
+    dataNode->SetMapper(1, NULL);
+    MITK_TEST_CONDITION(mapperChangedTime < dataNode->GetMapperChangedTime() &&
+                          mapperChangedTime < dataNode->GetMTime(),
+                        "Testing if replacing a mapper modifies the node")
   }
 
   static void TestInteractorSetting(mitk::DataNode::Pointer dataNode)
@@ -21,11 +21,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataNode.h"
 #include "mitkGroupTagProperty.h"
 #include "mitkImage.h"
+#include "mitkProperties.h"
 #include "mitkReferenceCountWatcher.h"
 #include "mitkStringProperty.h"
 #include "mitkSurface.h"
 
 #include "mitkDataStorage.h"
+#include "mitkExceptionMacro.h"
 #include "mitkIOUtil.h"
 #include "mitkMessage.h"
 #include "mitkNodePredicateAnd.h"
@@ -64,10 +66,17 @@ class DSEventReceiver // Helper class for event testing
 public:
   const mitk::DataNode *m_NodeAdded;
   const mitk::DataNode *m_NodeRemoved;
+  unsigned int m_NumberOfAddNodesEvents;
+  unsigned int m_NumberOfNodesAdded;
 
-  DSEventReceiver() : m_NodeAdded(NULL), m_NodeRemoved(NULL) {}
+  DSEventReceiver() : m_NodeAdded(NULL), m_NodeRemoved(NULL), m_NumberOfAddNodesEvents(0), m_NumberOfNodesAdded(0) {}
   void OnAdd(const mitk::DataNode *node) { m_NodeAdded = node; }
   void OnRemove(const mitk::DataNode *node) { m_NodeRemoved = node; }
+  void OnAddNodes(const mitk::DataStorage::SetOfObjects *nodes)
+  {
+    ++m_NumberOfAddNodesEvents;
+    m_NumberOfNodesAdded = nodes->Size();
+  }
 };
 
 ///
@@ -872,6 +881,152 @@ void TestDataStorage(mitk::DataStorage *ds, std::string filename)
     MITK_TEST_FAILED_MSG(<< "Exception during testing DataStorage thread safe");
   }
 
+  // test the indexed queries and the predicate caching
+  try
+  {
+    mitk::DataStorage::Pointer indexedStorage = mitk::StandaloneDataStorage::New().GetPointer();
+    mitk::DataNode::Pointer imageNode = mitk::DataNode::New();
+    imageNode->SetData(image);
+    imageNode->SetName("image");
+    imageNode->SetProperty("organ", mitk::StringProperty::New("liver"));
+    indexedStorage->Add(imageNode);
+    mitk::DataNode::Pointer surfaceNode = mitk::DataNode::New();
+    surfaceNode->SetData(mitk::Surface::New());
+    surfaceNode->SetName("surface");
+    surfaceNode->SetProperty("organ", mitk::StringProperty::New("liver"));
+    indexedStorage->Add(surfaceNode, imageNode);
+
+    MITK_TEST_CONDITION(indexedStorage->GetNamedNode("surface") == surfaceNode, "Indexed GetNamedNode()");
+
+    surfaceNode->SetName("renamed surface");
+    MITK_TEST_CONDITION(indexedStorage->GetNamedNode("surface") == nullptr &&
+                          indexedStorage->GetNamedNode("renamed surface") == surfaceNode,
+                        "Indexed GetNamedNode() after renaming a node");
+
+    dynamic_cast<mitk::StringProperty *>(surfaceNode->GetProperty("name"))->SetValue("surface");
+    MITK_TEST_CONDITION(indexedStorage->GetNamedNode("surface") == surfaceNode,
+                        "Indexed GetNamedNode() after changing the name property in place");
+
+    mitk::DataNode::Pointer firstDuplicateNode;
+    for (int i = 0; i < 10; ++i)
+    {
+      mitk::DataNode::Pointer duplicateNode = mitk::DataNode::New();
+      duplicateNode->SetName("duplicate");
+      indexedStorage->Add(duplicateNode);
+      if (firstDuplicateNode.IsNull())
+        firstDuplicateNode = duplicateNode;
+    }
+    MITK_TEST_CONDITION(indexedStorage->GetNamedNode("duplicate") == firstDuplicateNode,
+                        "Indexed GetNamedNode() returns the first added node for duplicate names");
+    indexedStorage->Remove(indexedStorage->GetSubset(mitk::NodePredicateProperty::New(
+      "name", mitk::StringProperty::New("duplicate"))));
+
+    indexedStorage->AddIndexedPropertyKey("organ");
+    mitk::NodePredicateAnd::Pointer liverSurfaces = mitk::NodePredicateAnd::New();
+    liverSurfaces->AddPredicate(mitk::NodePredicateProperty::New("organ", mitk::StringProperty::New("liver")));
+    liverSurfaces->AddPredicate(mitk::NodePredicateDataType::New("Surface"));
+    mitk::DataStorage::SetOfObjects::ConstPointer subset = indexedStorage->GetSubset(liverSurfaces);
+    MITK_TEST_CONDITION(subset->Size() == 1 && subset->GetElement(0) == surfaceNode,
+                        "Indexed GetSubset() with a conjunction of property and data type");
+
+    imageNode->SetData(mitk::Surface::New());
+    subset = indexedStorage->GetSubset(liverSurfaces);
+    MITK_TEST_CONDITION(subset->Size() == 2, "Indexed GetSubset() after replacing the data of a node");
+
+    indexedStorage->SetPredicateCaching(true);
+    mitk::NodePredicateProperty::Pointer visible =
+      mitk::NodePredicateProperty::New("visible", mitk::BoolProperty::New(false));
+    imageNode->SetVisibility(true);
+    surfaceNode->SetVisibility(true);
+    MITK_TEST_CONDITION(indexedStorage->GetSubset(visible)->Size() == 0, "Cached GetSubset()");
+    surfaceNode->SetVisibility(false);
+    subset = indexedStorage->GetSubset(visible);
+    MITK_TEST_CONDITION(subset->Size() == 1 && subset->GetElement(0) == surfaceNode,
+                        "Cached GetSubset() after modifying a node");
+
+    indexedStorage->Remove(surfaceNode);
+    MITK_TEST_CONDITION(indexedStorage->GetSubset(visible)->Size() == 0 &&
+                          indexedStorage->GetNamedNode("surface") == nullptr,
+                        "Indexed and cached GetSubset() after removing a node");
+  }
+  catch (...)
+  {
+    MITK_TEST_FAILED_MSG(<< "Exception during testing indexed DataStorage queries");
+  }
+
+  // test adding a batch of nodes
+  try
+  {
+    mitk::DataStorage::Pointer batchStorage = mitk::StandaloneDataStorage::New().GetPointer();
+    DSEventReceiver batchListener;
+    batchStorage->AddNodeEvent +=
+      mitk::MessageDelegate1<DSEventReceiver, const mitk::DataNode *>(&batchListener, &DSEventReceiver::OnAdd);
+    batchStorage->AddNodesEvent += mitk::MessageDelegate1<DSEventReceiver, const mitk::DataStorage::SetOfObjects *>(
+      &batchListener, &DSEventReceiver::OnAddNodes);
+    batchStorage->RemoveNodeEvent +=
+      mitk::MessageDelegate1<DSEventReceiver, const mitk::DataNode *>(&batchListener, &DSEventReceiver::OnRemove);
+
+    mitk::DataNode::Pointer parentNode = mitk::DataNode::New();
+    batchStorage->Add(parentNode);
+    MITK_TEST_CONDITION(batchListener.m_NumberOfAddNodesEvents == 1 && batchListener.m_NumberOfNodesAdded == 1,
+                        "Checking AddNodesEvent of a single node");
+
+    batchStorage->BeginBatch();
+    mitk::DataNode::Pointer removedNode = mitk::DataNode::New();
+    batchStorage->Add(removedNode);
+    for (int i = 0; i < 10; ++i)
+    {
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      batchStorage->Add(node, parentNode);
+      node->SetName("batch node");
+    }
+    batchStorage->Remove(removedNode);
+    MITK_TEST_CONDITION(batchListener.m_NodeRemoved == NULL,
+                        "Removing a node added in the same batch does not emit RemoveNodeEvent");
+    MITK_TEST_CONDITION(batchStorage->GetDerivations(parentNode)->Size() == 10 &&
+                          batchListener.m_NumberOfAddNodesEvents == 1 && batchListener.m_NodeAdded == parentNode,
+                        "Nodes of a batch are stored, but not announced before EndBatch()");
+
+    batchStorage->EndBatch();
+    MITK_TEST_CONDITION(batchListener.m_NumberOfAddNodesEvents == 2 && batchListener.m_NumberOfNodesAdded == 10 &&
+                          batchListener.m_NodeAdded != parentNode,
+                        "Checking AddNodesEvent of a batch");
+    MITK_TEST_CONDITION(batchStorage->GetSubset(mitk::NodePredicateProperty::New(
+                                                  "name", mitk::StringProperty::New("batch node")))->Size() == 10,
+                        "Nodes renamed during a batch are found by name");
+
+    bool endBatchThrows = false;
+    try
+    {
+      batchStorage->EndBatch();
+    }
+    catch (const mitk::Exception &)
+    {
+      endBatchThrows = true;
+    }
+    MITK_TEST_CONDITION(endBatchThrows, "EndBatch() without BeginBatch() throws an mitk::Exception");
+
+    mitk::DataNode::Pointer scopedNode = mitk::DataNode::New();
+    try
+    {
+      mitk::DataStorage::BatchScope batch(batchStorage);
+      batchStorage->Add(scopedNode);
+      mitkThrow() << "failure while adding a batch";
+    }
+    catch (const mitk::Exception &)
+    {
+    }
+    MITK_TEST_CONDITION(batchListener.m_NumberOfAddNodesEvents == 3 && batchListener.m_NodeAdded == scopedNode,
+                        "BatchScope ends the batch if an exception is thrown");
+    batchStorage->Add(mitk::DataNode::New());
+    MITK_TEST_CONDITION(batchListener.m_NumberOfAddNodesEvents == 4,
+                        "Nodes are announced immediately after the BatchScope");
+  }
+  catch (...)
+  {
+    MITK_TEST_FAILED_MSG(<< "Exception during testing batches of nodes");
+  }
+
   /* Clear DataStorage */
   ds->Remove(ds->GetAll());
   MITK_TEST_CONDITION(ds->GetAll()->Size() == 0, "Checking Clear DataStorage");
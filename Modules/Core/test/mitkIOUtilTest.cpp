@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkIOUtil.h>
 #include <mitkImageGenerator.h>
+#include <mitkStandaloneDataStorage.h>
 
 #include <itksys/SystemTools.hxx>
 
@@ -33,6 +34,7 @@ class mitkIOUtilTestSuite : public mitk::TestFixture
   MITK_TEST(TestNullSave);
   MITK_TEST(TestLoadAndSavePointSet);
   MITK_TEST(TestLoadAndSaveSurface);
+  MITK_TEST(TestConcurrentLoading);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
   MITK_TEST(TestTempMethodsForUniqueFilenames);
   CPPUNIT_TEST_SUITE_END();
@@ -235,6 +237,42 @@ public:
     // delete the files after the test is done
     std::remove(surfacePath.c_str());
   }
+
+  void TestConcurrentLoading()
+  {
+    std::vector<std::string> paths;
+    paths.push_back(m_ImagePath);
+    paths.push_back(m_SurfacePath);
+    paths.push_back(m_PointSetPath);
+    paths.push_back(m_ImagePath);
+
+    mitk::IOUtil::SetConcurrentLoading(true);
+
+    std::vector<mitk::BaseData::Pointer> data;
+    CPPUNIT_ASSERT_NO_THROW(data = mitk::IOUtil::Load(paths));
+
+    mitk::StandaloneDataStorage::Pointer storage = mitk::StandaloneDataStorage::New();
+    mitk::DataStorage::SetOfObjects::Pointer nodes;
+    CPPUNIT_ASSERT_NO_THROW(nodes = mitk::IOUtil::Load(paths, *storage));
+
+    paths.push_back("fileWhichDoesNotExist.nrrd");
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load(paths), mitk::Exception);
+
+    mitk::IOUtil::SetConcurrentLoading(false);
+
+    // the results are in the order of the paths
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), data.size());
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(data[0].GetPointer()) != nullptr);
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Surface *>(data[1].GetPointer()) != nullptr);
+    CPPUNIT_ASSERT(dynamic_cast<mitk::PointSet *>(data[2].GetPointer()) != nullptr);
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Image *>(data[3].GetPointer()) != nullptr);
+    CPPUNIT_ASSERT(data[0] != data[3]);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), static_cast<std::size_t>(nodes->Size()));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), static_cast<std::size_t>(storage->GetAll()->Size()));
+    CPPUNIT_ASSERT(dynamic_cast<mitk::Surface *>(nodes->GetElement(1)->GetData()) != nullptr);
+    CPPUNIT_ASSERT(storage->Exists(nodes->GetElement(2)));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkIOUtil)
@@ -0,0 +1,91 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPlaneCutIndex.h"
+#include "mitkTestingMacros.h"
+
+#include <vtkCutter.h>
+#include <vtkPlane.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+#include <algorithm>
+
+static vtkIdType CountCutLines(vtkPolyData *polyData, const double origin[3], const double normal[3])
+{
+  vtkSmartPointer<vtkPlane> plane = vtkSmartPointer<vtkPlane>::New();
+  plane->SetOrigin(origin[0], origin[1], origin[2]);
+  plane->SetNormal(normal[0], normal[1], normal[2]);
+
+  vtkSmartPointer<vtkCutter> cutter = vtkSmartPointer<vtkCutter>::New();
+  cutter->SetCutFunction(plane);
+  cutter->SetInputData(polyData);
+  cutter->Update();
+  return cutter->GetOutput()->GetNumberOfLines();
+}
+
+int mitkPlaneCutIndexTest(int /*argc*/, char * /*argv*/ [])
+{
+  MITK_TEST_BEGIN("PlaneCutIndex");
+
+  vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+  sphereSource->SetRadius(10.0);
+  sphereSource->SetThetaResolution(200);
+  sphereSource->SetPhiResolution(200);
+  sphereSource->Update();
+  vtkPolyData *sphere = sphereSource->GetOutput();
+
+  const double normal[3] = {0.2, 0.3, 1.0};
+  const double oppositeNormal[3] = {-0.4, -0.6, -2.0};
+  const double otherNormal[3] = {1.0, 0.0, 0.0};
+
+  mitk::PlaneCutIndex index(sphere, normal);
+  MITK_TEST_CONDITION(!index.IsBuilt(), "Index is not built by the constructor");
+  MITK_TEST_CONDITION(index.IsValidFor(sphere, normal), "Index is valid for its mesh and normal");
+  MITK_TEST_CONDITION(index.IsValidFor(sphere, oppositeNormal), "Index is valid for the opposite normal");
+  MITK_TEST_CONDITION(!index.IsValidFor(sphere, otherNormal), "Index is not valid for another normal");
+  MITK_TEST_CONDITION(index.IsValidFor(sphere), "Index is valid for its mesh");
+  vtkSmartPointer<vtkPolyData> otherMesh = vtkSmartPointer<vtkPolyData>::New();
+  MITK_TEST_CONDITION(!index.IsValidFor(otherMesh, normal), "Index is not valid for another mesh");
+
+  index.Build();
+  MITK_TEST_CONDITION_REQUIRED(index.IsBuilt(), "Index is built");
+
+  const double origins[3][3] = {{0.0, 0.0, 0.0}, {1.0, -2.0, 7.5}, {0.0, 0.0, -9.9}};
+  for (int i = 0; i < 3; ++i)
+  {
+    std::vector<vtkIdType> cellIds;
+    index.FindCells(origins[i], cellIds);
+    MITK_TEST_CONDITION(!cellIds.empty() && cellIds.size() < static_cast<std::size_t>(sphere->GetNumberOfCells()),
+                        "Plane " << i << " needs only some of the cells");
+
+    vtkSmartPointer<vtkPolyData> cells = mitk::PlaneCutIndex::ExtractCells(sphere, cellIds);
+    MITK_TEST_CONDITION(CountCutLines(cells, origins[i], normal) == CountCutLines(sphere, origins[i], normal),
+                        "Cutting the cells found for plane " << i << " yields the same contour as cutting the mesh");
+  }
+
+  std::vector<vtkIdType> cellIds;
+  const double outside[3] = {0.0, 0.0, 20.0};
+  index.FindCells(outside, cellIds);
+  MITK_TEST_CONDITION(cellIds.empty(), "No cells are found for a plane outside of the mesh");
+
+  sphere->GetPoints()->Modified();
+  MITK_TEST_CONDITION(!index.IsValidFor(sphere, normal) && !index.IsValidFor(sphere),
+                      "Index is invalid after the mesh was modified");
+
+  MITK_TEST_END();
+}
@@ -19,9 +19,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkInteractionConst.h>
 #include <mitkNumericTypes.h>
+#include <mitkPlaneGeometry.h>
 #include <mitkPointOperation.h>
 #include <mitkPointSet.h>
 
+#include <algorithm>
 #include <fstream>
 
 /**
@@ -45,6 +47,7 @@ class mitkPointSetTestSuite : public mitk::TestFixture
   MITK_TEST(TestRemovePointInterface);
   MITK_TEST(TestMaxIdAccess);
   MITK_TEST(TestInsertPointAtEnd);
+  MITK_TEST(TestSpatialQueries);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -483,6 +486,65 @@ std::cout<<"[PASSED]"<<std::endl;
     pointSet->InsertPoint(in4, 7);
     MITK_ASSERT_EQUAL(pointSet, refPs4, "Check point insertion for time step 7.");
   }
+
+  void TestSpatialQueries()
+  {
+    // a regular grid of 10x10x10 points with 2mm spacing is large enough to be indexed
+    mitk::PointSet::Pointer gridPointSet = mitk::PointSet::New();
+    mitk::Point3D point;
+    for (int k = 0; k < 10; ++k)
+      for (int j = 0; j < 10; ++j)
+        for (int i = 0; i < 10; ++i)
+        {
+          mitk::FillVector3D(point, 2.0 * i, 2.0 * j, 2.0 * k);
+          gridPointSet->InsertPoint(i + 10 * j + 100 * k, point);
+        }
+
+    mitk::Point3D query;
+    mitk::FillVector3D(query, 4.1, 6.0, 8.0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "SearchPoint finds the close point", 3 + 30 + 400, gridPointSet->SearchPoint(query, 0.5));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "SearchClosestPoint finds the close point", 3 + 30 + 400, gridPointSet->SearchClosestPoint(query, 1.5));
+
+    mitk::FillVector3D(query, 5.0, 6.0, 8.0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("SearchPoint finds nothing between points", -1, gridPointSet->SearchPoint(query, 0.5));
+
+    // move a point by an operation
+    mitk::Point3D moved;
+    mitk::FillVector3D(moved, 40.0, 40.0, 40.0);
+    mitk::PointOperation moveOp(mitk::OpMOVE, 0, moved, 433);
+    gridPointSet->ExecuteOperation(&moveOp);
+    mitk::FillVector3D(query, 4.0, 6.0, 8.0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Moved point is not found at its old position", -1, gridPointSet->SearchPoint(query, 0.5));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Moved point is found at its new position", 433, gridPointSet->SearchPoint(moved, 0.5));
+
+    // remove a point
+    gridPointSet->RemovePointIfExists(433);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Removed point is not found", -1, gridPointSet->SearchPoint(moved, 0.5));
+
+    // modify the itk point set directly, bypassing the incremental update
+    mitk::FillVector3D(moved, -20.0, -20.0, -20.0);
+    gridPointSet->GetPointSet()->SetPoint(0, moved);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Directly modified point is found at its new position", 0, gridPointSet->SearchPoint(moved, 0.5));
+
+    // the standard plane lies at z == 0
+    mitk::PlaneGeometry::Pointer plane = mitk::PlaneGeometry::New();
+    mitk::Vector3D right, bottom;
+    mitk::FillVector3D(right, 1.0, 0.0, 0.0);
+    mitk::FillVector3D(bottom, 0.0, 1.0, 0.0);
+    plane->InitializeStandardPlane(right, bottom);
+
+    mitk::PointSet::PointIdentifierList ids;
+    gridPointSet->SearchPointsNearPlane(plane, 0.5, ids);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "SearchPointsNearPlane finds the points of the first layer", std::size_t(99), ids.size());
+    CPPUNIT_ASSERT_MESSAGE("SearchPointsNearPlane returns ascending ids", std::is_sorted(ids.begin(), ids.end()));
+    CPPUNIT_ASSERT_MESSAGE("SearchPointsNearPlane returns the first layer", ids.front() == 1 && ids.back() == 99);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkPointSet)
@@ -246,6 +246,32 @@ int mitkPropertyListTest(int /*argc*/, char * /*argv*/ [])
     }
   }
 
+  {
+    std::cout << "Testing GetProperty() with interned keys: ";
+    mitk::PropertyKey testKey("test");
+    mitk::PropertyKey otherKey("another test");
+    mitk::IntProperty::Pointer prop = mitk::IntProperty::New(42);
+    propList->ReplaceProperty("test", prop);
+    propList->SetProperty("another test", mitk::BoolProperty::New(true));
+    int v = 0;
+    bool found = propList->GetProperty(testKey) == prop.GetPointer() && propList->GetPropertyValue(testKey, v) &&
+                 v == 42 && testKey == mitk::PropertyKey(std::string("test")) && testKey.GetName() == "test" &&
+                 propList->GetProperty(otherKey) != nullptr;
+
+    propList->DeleteProperty("another test");
+    mitk::PropertyList::Pointer clone = propList->Clone();
+    propList->Clear();
+    if (found && propList->GetProperty(otherKey) == nullptr && propList->GetProperty(testKey) == nullptr &&
+        clone->GetProperty(otherKey) == nullptr && clone->GetProperty(testKey) != nullptr &&
+        clone->GetProperty(mitk::PropertyKey()) == nullptr)
+      std::cout << "[PASSED]" << std::endl;
+    else
+    {
+      std::cout << "[FAILED]" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   std::cout << "[TEST DONE]" << std::endl;
   return EXIT_SUCCESS;
 }
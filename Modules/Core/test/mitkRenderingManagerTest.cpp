@@ -22,9 +22,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkTestingMacros.h"
 
+#include "mitkPointSet.h"
+#include "mitkPointSetVtkMapper2D.h"
 #include "mitkSurface.h"
 #include <vtkCubeSource.h>
 
+#include <sstream>
+
 // Propertylist Test
 
 /**
@@ -161,6 +165,97 @@ public:
     myRenderingManager->ForceImmediateUpdateAll();
   }
 
+  static std::vector<vtkIdType> GetVisiblePoints(const std::vector<mitk::DataNode::Pointer> &nodes,
+                                                 const std::vector<mitk::VtkPropRenderer::Pointer> &renderers)
+  {
+    std::vector<vtkIdType> visiblePoints;
+    for (auto node = nodes.cbegin(); node != nodes.cend(); ++node)
+    {
+      mitk::PointSetVtkMapper2D *mapper =
+        dynamic_cast<mitk::PointSetVtkMapper2D *>((*node)->GetMapper(mitk::BaseRenderer::Standard2D));
+      for (auto renderer = renderers.cbegin(); renderer != renderers.cend(); ++renderer)
+      {
+        visiblePoints.push_back(mapper->m_LSH.GetLocalStorage(*renderer)->m_UnselectedPoints->GetNumberOfPoints());
+      }
+    }
+    return visiblePoints;
+  }
+
+  static void TestConcurrentMapperUpdates()
+  {
+    mitk::RenderingManager::Pointer renderingManager = mitk::RenderingManager::New();
+    mitk::StandaloneDataStorage::Pointer dataStorage = mitk::StandaloneDataStorage::New();
+    renderingManager->SetDataStorage(dataStorage);
+
+    // each point set is drawn by one 2D mapper that is shared by all three windows
+    std::vector<mitk::DataNode::Pointer> nodes;
+    for (int n = 0; n < 2; ++n)
+    {
+      mitk::PointSet::Pointer pointSet = mitk::PointSet::New();
+      for (int i = 0; i < 10; ++i)
+      {
+        mitk::Point3D point;
+        mitk::FillVector3D(point, i, 5 * n + i % 2, i % 3);
+        pointSet->InsertPoint(i, point);
+      }
+
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetData(pointSet);
+      dataStorage->Add(node);
+      nodes.push_back(node);
+    }
+
+    const mitk::SliceNavigationController::ViewDirection viewDirections[] = {
+      mitk::SliceNavigationController::Axial,
+      mitk::SliceNavigationController::Sagittal,
+      mitk::SliceNavigationController::Frontal};
+
+    std::vector<vtkRenderWindow *> renderWindows;
+    std::vector<mitk::VtkPropRenderer::Pointer> renderers;
+    for (int i = 0; i < 3; ++i)
+    {
+      vtkRenderWindow *renderWindow = vtkRenderWindow::New();
+      renderWindow->SetSize(100, 100);
+
+      std::ostringstream name;
+      name << "concurrentMapperUpdates" << i;
+      mitk::VtkPropRenderer::Pointer renderer =
+        mitk::VtkPropRenderer::New(name.str().c_str(), renderWindow, renderingManager);
+      renderer->SetMapperID(mitk::BaseRenderer::Standard2D);
+      renderer->GetSliceNavigationController()->SetDefaultViewDirection(viewDirections[i]);
+
+      mitk::BaseRenderer::AddInstance(renderWindow, renderer);
+      renderingManager->AddRenderWindow(renderWindow);
+      renderWindows.push_back(renderWindow);
+      renderers.push_back(renderer);
+    }
+
+    mitk::TimeGeometry::Pointer geometry = dataStorage->ComputeBoundingGeometry3D(dataStorage->GetAll());
+    MITK_TEST_CONDITION_REQUIRED(renderingManager->InitializeViews(geometry), "Initializing the 2D views")
+
+    renderingManager->RequestUpdateAll();
+    renderingManager->ExecutePendingRequests();
+    std::vector<vtkIdType> sequentialPoints = GetVisiblePoints(nodes, renderers);
+
+    renderingManager->SetConcurrentMapperUpdates(true);
+    for (auto node = nodes.cbegin(); node != nodes.cend(); ++node)
+    {
+      (*node)->GetData()->Modified();
+    }
+    renderingManager->RequestUpdateAll();
+    renderingManager->ExecutePendingRequests();
+
+    MITK_TEST_CONDITION(GetVisiblePoints(nodes, renderers) == sequentialPoints,
+                        "Testing if concurrent updates of shared 2D mappers give the same result as sequential ones")
+
+    for (auto renderWindow = renderWindows.cbegin(); renderWindow != renderWindows.cend(); ++renderWindow)
+    {
+      renderingManager->RemoveRenderWindow(*renderWindow);
+      mitk::BaseRenderer::RemoveInstance(*renderWindow);
+      (*renderWindow)->Delete();
+    }
+  }
+
 }; // mitkDataNodeTestClass
 int mitkRenderingManagerTest(int /* argc */, char * /*argv*/ [])
 {
@@ -202,6 +297,8 @@ int mitkRenderingManagerTest(int /* argc */, char * /*argv*/ [])
 
   mitkRenderingManagerTestClass::TestSurfaceLoading(myRenderingManager);
 
+  mitkRenderingManagerTestClass::TestConcurrentMapperUpdates();
+
   // write your own tests here and use the macros from mitkTestingMacros.h !!!
   // do not write to std::cout and do not return from this function yourself!
 
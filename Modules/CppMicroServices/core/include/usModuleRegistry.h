@@ -74,6 +74,19 @@ public:
    */
   static std::vector<Module*> GetLoadedModules();
 
+  /**
+   * Load the modules whose auto-loading was deferred, see
+   * ModuleSettings::AddDeferredAutoLoadDir(). Modules in the auto-load
+   * directory are only loaded by the first call, later calls return
+   * an empty list unless more modules were deferred in the meantime.
+   * Calls from other threads wait until the first call has loaded the
+   * modules.
+   *
+   * @param autoLoadDir The name of the deferred auto-load directory.
+   * @return A list of the absolute file paths of the loaded modules.
+   */
+  static std::vector<std::string> LoadDeferredModules(const std::string& autoLoadDir);
+
   static void Register(ModuleInfo* info);
 
   static void UnRegister(const ModuleInfo* info);
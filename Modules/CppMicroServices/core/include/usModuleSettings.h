@@ -41,6 +41,9 @@ US_BEGIN_NAMESPACE
  * - \e US_DISABLE_AUTOLOADING If set, auto-loading of modules is disabled.
  * - \e US_AUTOLOAD_PATHS A ':' (Unix) or ';' (Windows) separated list of paths
  *   from which modules should be auto-loaded.
+ * - \e US_DEFERRED_AUTOLOAD_DIRS A ':' (Unix) or ';' (Windows) separated list of
+ *   auto-load directories whose modules are not loaded at start-up, see
+ *   AddDeferredAutoLoadDir().
  *
  * \remarks This class is thread safe.
  */
@@ -118,6 +121,43 @@ public:
    */
   static void AddAutoLoadPath(const std::string& path);
 
+  /**
+   * \return The auto-load directories whose modules are not loaded together
+   * with the module owning the directory.
+   */
+  static PathList GetDeferredAutoLoadDirs();
+
+  /**
+   * Set the auto-load directories whose modules are not loaded together with
+   * the module owning the directory.
+   *
+   * @param dirs A list of auto-load directory names, see AddDeferredAutoLoadDir().
+   */
+  static void SetDeferredAutoLoadDirs(const PathList& dirs);
+
+  /**
+   * Defer auto-loading of the modules in the given auto-load directory.
+   *
+   * When the module owning the directory is loaded, the modules in the directory
+   * are only looked up but not loaded. They are loaded by a call of
+   * ModuleRegistry::LoadDeferredModules(), e.g. when the services they provide are
+   * requested for the first time. This shortens the start-up time of applications
+   * which auto-load many modules that are not always used, like file readers.
+   *
+   * @param dir The name of the auto-load directory, which is the name of the
+   *        module owning the directory unless its manifest specifies a
+   *        different auto-load directory.
+   *
+   * \sa MicroServices_AutoLoading
+   */
+  static void AddDeferredAutoLoadDir(const std::string& dir);
+
+  /**
+   * \return \c true if auto-loading of the modules in the given auto-load
+   * directory is deferred, \c false otherwise.
+   */
+  static bool IsAutoLoadingDeferred(const std::string& dir);
+
   /**
    * Set a local storage path for persistend module data.
    *
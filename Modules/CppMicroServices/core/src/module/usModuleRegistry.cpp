@@ -29,6 +29,7 @@
 #include "usCoreModuleContext_p.h"
 #include "usGetModuleContext.h"
 #include "usStaticInit_p.h"
+#include "usUtils_p.h"
 
 #include <cassert>
 #include <map>
@@ -202,6 +203,11 @@ std::vector<Module*> ModuleRegistry::GetLoadedModules()
   return result;
 }
 
+std::vector<std::string> ModuleRegistry::LoadDeferredModules(const std::string& autoLoadDir)
+{
+  return US_PREPEND_NAMESPACE(LoadDeferredModules)(autoLoadDir);
+}
+
 // Control the static initialization order for several core objects
 struct StaticInitializationOrder
 {
@@ -71,16 +71,17 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
   {
     autoLoadPaths.insert(ModuleSettings::CURRENT_MODULE_PATH());
 
+#ifdef US_PLATFORM_WINDOWS
+    const char separator = ';';
+#else
+    const char separator = ':';
+#endif
+
     char* envPaths = getenv("US_AUTOLOAD_PATHS");
     if (envPaths != NULL)
     {
       std::stringstream ss(envPaths);
       std::string envPath;
-#ifdef US_PLATFORM_WINDOWS
-      const char separator = ';';
-#else
-      const char separator = ':';
-#endif
       while (std::getline(ss, envPath, separator))
       {
         std::string normalizedEnvPath = RemoveTrailingPathSeparator(envPath);
@@ -91,6 +92,20 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
       }
     }
 
+    char* envDeferredDirs = getenv("US_DEFERRED_AUTOLOAD_DIRS");
+    if (envDeferredDirs != NULL)
+    {
+      std::stringstream ss(envDeferredDirs);
+      std::string envDir;
+      while (std::getline(ss, envDir, separator))
+      {
+        if (!envDir.empty())
+        {
+          deferredAutoLoadDirs.insert(envDir);
+        }
+      }
+    }
+
     if (getenv("US_DISABLE_AUTOLOADING"))
     {
       autoLoadingDisabled = true;
@@ -99,6 +114,7 @@ struct ModuleSettingsPrivate : public MultiThreaded<>
 
   std::set<std::string> autoLoadPaths;
   std::set<std::string> extraPaths;
+  std::set<std::string> deferredAutoLoadDirs;
   bool autoLoadingEnabled;
   bool autoLoadingDisabled;
   std::string storagePath;
@@ -162,6 +178,32 @@ void ModuleSettings::AddAutoLoadPath(const std::string& path)
   moduleSettingsPrivate()->autoLoadPaths.insert(RemoveTrailingPathSeparator(path));
 }
 
+ModuleSettings::PathList ModuleSettings::GetDeferredAutoLoadDirs()
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  return PathList(moduleSettingsPrivate()->deferredAutoLoadDirs.begin(),
+                  moduleSettingsPrivate()->deferredAutoLoadDirs.end());
+}
+
+void ModuleSettings::SetDeferredAutoLoadDirs(const PathList& dirs)
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  moduleSettingsPrivate()->deferredAutoLoadDirs.clear();
+  moduleSettingsPrivate()->deferredAutoLoadDirs.insert(dirs.begin(), dirs.end());
+}
+
+void ModuleSettings::AddDeferredAutoLoadDir(const std::string& dir)
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  moduleSettingsPrivate()->deferredAutoLoadDirs.insert(dir);
+}
+
+bool ModuleSettings::IsAutoLoadingDeferred(const std::string& dir)
+{
+  US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
+  return moduleSettingsPrivate()->deferredAutoLoadDirs.count(dir) > 0;
+}
+
 void ModuleSettings::SetStoragePath(const std::string &path)
 {
   US_UNUSED(ModuleSettingsPrivate::Lock(moduleSettingsPrivate()));
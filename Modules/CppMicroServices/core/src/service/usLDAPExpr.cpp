@@ -287,6 +287,52 @@ bool LDAPExpr::GetMatchedObjectClasses(ObjectClassSet& objClasses) const
   return false;
 }
 
+void LDAPExpr::GetRequiredValues(RequiredValues& required) const
+{
+  if (d->m_operator == AND)
+  {
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      d->m_args[i].GetRequiredValues(required);
+    }
+    return;
+  }
+
+  std::string attrName;
+  StringList values;
+  if (GetEqualityValues(attrName, values))
+  {
+    required.push_back(std::make_pair(attrName, values));
+  }
+}
+
+bool LDAPExpr::GetEqualityValues(std::string& attrName, StringList& values) const
+{
+  if (d->m_operator == EQ)
+  {
+    if (d->m_attrValue.find(LDAPExprConstants::WILDCARD()) != std::string::npos)
+      return false;
+
+    const std::string name = ToLower(d->m_attrName);
+    if (!attrName.empty() && attrName != name)
+      return false;
+
+    attrName = name;
+    values.push_back(d->m_attrValue);
+    return true;
+  }
+  else if (d->m_operator == OR)
+  {
+    for (std::size_t i = 0; i < d->m_args.size(); i++)
+    {
+      if (!d->m_args[i].GetEqualityValues(attrName, values))
+        return false;
+    }
+    return !d->m_args.empty();
+  }
+  return false;
+}
+
 std::string LDAPExpr::ToLower(const std::string& str)
 {
   std::string lowerStr(str);
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 
 US_BEGIN_NAMESPACE
 
@@ -57,6 +58,7 @@ public:
   typedef std::vector<std::string> StringList;
   typedef std::vector<StringList> LocalCache;
   typedef US_UNORDERED_SET_TYPE<std::string> ObjectClassSet;
+  typedef std::vector<std::pair<std::string, StringList> > RequiredValues;
 
 
   /**
@@ -83,6 +85,20 @@ public:
    */
   bool GetMatchedObjectClasses(ObjectClassSet& objClasses) const;
 
+  /**
+   * Get the attribute values a service must have to match this LDAP expression.
+   * For an equality comparison without wildcards, or an OR of such comparisons
+   * on the same attribute, the lower case attribute name and the compared values are
+   * added to <code>required</code>. The operands of an AND expression are inspected
+   * the same way, all other expressions do not add anything.
+   *
+   * A service whose attribute is a string or a list of strings can only match this
+   * expression if it contains one of the required values for every added attribute.
+   *
+   * \param required The attributes and values are added to required.
+   */
+  void GetRequiredValues(RequiredValues& required) const;
+
   /**
    * Checks if this LDAP expression is "simple". The definition of
    * a simple filter is:
@@ -149,6 +165,9 @@ private:
 
   static std::string ToLower(const std::string& str);
 
+  //!
+  bool GetEqualityValues(std::string& attrName, StringList& values) const;
+
   //!
   bool Compare(const Any& obj, int op, const std::string& s) const;
 
@@ -19,7 +19,9 @@
 
 =============================================================================*/
 
+#include <algorithm>
 #include <iterator>
+#include <list>
 #include <stdexcept>
 #include <cassert>
 
@@ -81,6 +83,11 @@ void ServiceRegistry::Clear()
   services.clear();
   serviceRegistrations.clear();
   classServices.clear();
+  propertyIndexes.clear();
+  {
+    MutexLock lock(filterMutex);
+    filters.clear();
+  }
   core = 0;
 }
 
@@ -115,6 +122,7 @@ ServiceRegistrationBase ServiceRegistry::RegisterService(ModulePrivate* module,
     MutexLock lock(mutex);
     services.insert(std::make_pair(res, classes));
     serviceRegistrations.push_back(res);
+    AddToPropertyIndexes_unlocked(res);
     for (std::vector<std::string>::const_iterator i = classes.begin();
          i != classes.end(); ++i)
     {
@@ -188,98 +196,340 @@ ServiceReferenceBase ServiceRegistry::Get(ModulePrivate* module, const std::stri
 void ServiceRegistry::Get(const std::string& clazz, const std::string& filter,
                           ModulePrivate* module, std::vector<ServiceReferenceBase>& res) const
 {
-  MutexLock lock(mutex);
-  Get_unlocked(clazz, filter, module, res);
+  LDAPExpr ldap;
+  if (!filter.empty())
+  {
+    ldap = GetFilter(filter);
+  }
+
+  std::vector<ServiceRegistrationBase> candidates;
+  {
+    MutexLock lock(mutex);
+    GetCandidates_unlocked(clazz, ldap, candidates);
+  }
+
+  FilterCandidates(clazz, ldap, candidates, res);
+
+  if (!res.empty())
+  {
+    MutexLock lock(mutex);
+    FilterServiceReferences_unlocked(clazz, filter, module, res);
+  }
 }
 
 void ServiceRegistry::Get_unlocked(const std::string& clazz, const std::string& filter,
                           ModulePrivate* module, std::vector<ServiceReferenceBase>& res) const
 {
-  std::vector<ServiceRegistrationBase>::const_iterator s;
-  std::vector<ServiceRegistrationBase>::const_iterator send;
-  std::vector<ServiceRegistrationBase> v;
   LDAPExpr ldap;
+  if (!filter.empty())
+  {
+    ldap = GetFilter(filter);
+  }
+
+  std::vector<ServiceRegistrationBase> candidates;
+  GetCandidates_unlocked(clazz, ldap, candidates);
+  FilterCandidates(clazz, ldap, candidates, res);
+
+  if (!res.empty())
+  {
+    FilterServiceReferences_unlocked(clazz, filter, module, res);
+  }
+}
+
+LDAPExpr ServiceRegistry::GetFilter(const std::string& filter) const
+{
+  // filters are usually built from a few constant strings, the limit
+  // only protects against filters which contain e.g. time stamps
+  static const std::size_t MAX_FILTERS = 256;
+
+  {
+    MutexLock lock(filterMutex);
+    MapFilters::const_iterator i = filters.find(filter);
+    if (i != filters.end())
+    {
+      return i->second;
+    }
+  }
+
+  LDAPExpr ldap(filter);
+
+  MutexLock lock(filterMutex);
+  if (filters.size() >= MAX_FILTERS)
+  {
+    filters.clear();
+  }
+  filters.insert(std::make_pair(filter, ldap));
+  return ldap;
+}
+
+void ServiceRegistry::GetCandidates_unlocked(const std::string& clazz, const LDAPExpr& ldap,
+                                             std::vector<ServiceRegistrationBase>& candidates) const
+{
   if (clazz.empty())
   {
-    if (!filter.empty())
+    LDAPExpr::ObjectClassSet matched;
+    if (!ldap.IsNull() && ldap.GetMatchedObjectClasses(matched))
     {
-      ldap = LDAPExpr(filter);
-      LDAPExpr::ObjectClassSet matched;
-      if (ldap.GetMatchedObjectClasses(matched))
+      for(LDAPExpr::ObjectClassSet::const_iterator className = matched.begin();
+          className != matched.end(); ++className)
       {
-        v.clear();
-        for(LDAPExpr::ObjectClassSet::const_iterator className = matched.begin();
-            className != matched.end(); ++className)
-        {
-          MapClassServices::const_iterator i = classServices.find(*className);
-          if (i != classServices.end())
-          {
-            std::copy(i->second.begin(), i->second.end(), std::back_inserter(v));
-          }
-        }
-        if (!v.empty())
-        {
-          s = v.begin();
-          send = v.end();
-        }
-        else
+        MapClassServices::const_iterator i = classServices.find(*className);
+        if (i != classServices.end())
         {
-          return;
+          std::copy(i->second.begin(), i->second.end(), std::back_inserter(candidates));
         }
       }
-      else
-      {
-        s = serviceRegistrations.begin();
-        send = serviceRegistrations.end();
-      }
     }
     else
     {
-      s = serviceRegistrations.begin();
-      send = serviceRegistrations.end();
+      candidates = serviceRegistrations;
     }
   }
   else
   {
     MapClassServices::const_iterator it = classServices.find(clazz);
-    if (it != classServices.end())
+    if (it == classServices.end())
     {
-      s = it->second.begin();
-      send = it->second.end();
+      return;
     }
-    else
+
+    if (ldap.IsNull() || !GetIndexedCandidates_unlocked(clazz, ldap, it->second.size(), candidates))
     {
-      return;
+      candidates = it->second;
     }
-    if (!filter.empty())
+  }
+}
+
+bool ServiceRegistry::GetIndexedCandidates_unlocked(const std::string& clazz, const LDAPExpr& ldap,
+                                                    std::size_t maxCandidates,
+                                                    std::vector<ServiceRegistrationBase>& candidates) const
+{
+  LDAPExpr::RequiredValues required;
+  ldap.GetRequiredValues(required);
+
+  // find the index which yields the fewest candidates
+  const PropertyIndex* bestIndex = NULL;
+  const LDAPExpr::StringList* bestValues = NULL;
+  std::size_t bestCount = maxCandidates;
+  for (LDAPExpr::RequiredValues::const_iterator req = required.begin(); req != required.end(); ++req)
+  {
+    // the class services are already selected by clazz
+    if (req->first == ServiceConstants::OBJECTCLASS())
+    {
+      continue;
+    }
+
+    const PropertyIndex* index = GetPropertyIndex_unlocked(req->first);
+    if (index == NULL)
     {
-      ldap = LDAPExpr(filter);
+      continue;
+    }
+
+    std::size_t count = index->others.size();
+    for (LDAPExpr::StringList::const_iterator value = req->second.begin(); value != req->second.end(); ++value)
+    {
+      PropertyIndex::MapValueServices::const_iterator services = index->values.find(*value);
+      if (services != index->values.end())
+      {
+        count += services->second.size();
+      }
+    }
+
+    if (count < bestCount)
+    {
+      bestIndex = index;
+      bestValues = &req->second;
+      bestCount = count;
     }
   }
 
-  for (; s != send; ++s)
+  if (bestIndex == NULL)
   {
-    ServiceReferenceBase sri = s->GetReference(clazz);
+    return false;
+  }
 
-    if (filter.empty() || ldap.Evaluate(s->d->properties, false))
+  std::vector<ServiceRegistrationBase> indexed(bestIndex->others);
+  for (LDAPExpr::StringList::const_iterator value = bestValues->begin(); value != bestValues->end(); ++value)
+  {
+    PropertyIndex::MapValueServices::const_iterator services = bestIndex->values.find(*value);
+    if (services != bestIndex->values.end())
     {
-      res.push_back(sri);
+      std::copy(services->second.begin(), services->second.end(), std::back_inserter(indexed));
     }
   }
 
-  if (!res.empty())
+  for (std::vector<ServiceRegistrationBase>::const_iterator sr = indexed.begin(); sr != indexed.end(); ++sr)
   {
-    if (module != NULL)
+    MapServiceClasses::const_iterator classes = services.find(*sr);
+    if (classes != services.end() &&
+        std::find(classes->second.begin(), classes->second.end(), clazz) != classes->second.end())
     {
-      core->serviceHooks.FilterServiceReferences(module->moduleContext, clazz, filter, res);
+      candidates.push_back(*sr);
+    }
+  }
+
+  // same order as in classServices
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  return true;
+}
+
+void ServiceRegistry::FilterCandidates(const std::string& clazz, const LDAPExpr& ldap,
+                                       const std::vector<ServiceRegistrationBase>& candidates,
+                                       std::vector<ServiceReferenceBase>& res)
+{
+  for (std::vector<ServiceRegistrationBase>::const_iterator s = candidates.begin();
+       s != candidates.end(); ++s)
+  {
+    if (!ldap.IsNull())
+    {
+      MutexLock lock(s->d->propsLock);
+      if (!s->d->available || !ldap.Evaluate(s->d->properties, false))
+      {
+        continue;
+      }
+    }
+
+    res.push_back(s->GetReference(clazz));
+  }
+}
+
+void ServiceRegistry::FilterServiceReferences_unlocked(const std::string& clazz, const std::string& filter,
+                                                       ModulePrivate* module,
+                                                       std::vector<ServiceReferenceBase>& res) const
+{
+  if (module != NULL)
+  {
+    core->serviceHooks.FilterServiceReferences(module->moduleContext, clazz, filter, res);
+  }
+  else
+  {
+    core->serviceHooks.FilterServiceReferences(NULL, clazz, filter, res);
+  }
+}
+
+ServiceRegistry::PropertyIndex* ServiceRegistry::GetPropertyIndex_unlocked(const std::string& key) const
+{
+  // indexes are only created for keys used in filters, the limit only
+  // bounds the work of registering a service if many keys are used
+  static const std::size_t MAX_PROPERTY_INDEXES = 32;
+
+  MapPropertyIndexes::iterator i = propertyIndexes.find(key);
+  if (i != propertyIndexes.end())
+  {
+    return &i->second;
+  }
+
+  if (propertyIndexes.size() >= MAX_PROPERTY_INDEXES)
+  {
+    return NULL;
+  }
+
+  PropertyIndex& index = propertyIndexes[key];
+  for (std::vector<ServiceRegistrationBase>::const_iterator sr = serviceRegistrations.begin();
+       sr != serviceRegistrations.end(); ++sr)
+  {
+    AddToPropertyIndex(key, index, *sr);
+  }
+  return &index;
+}
+
+void ServiceRegistry::AddToPropertyIndex(const std::string& key, PropertyIndex& index,
+                                         const ServiceRegistrationBase& sr)
+{
+  std::vector<std::string> values;
+  {
+    MutexLock lock(sr.d->propsLock);
+
+    const Any& value = sr.d->properties.Value(sr.d->properties.Find(key));
+    if (value.Empty())
+    {
+      // services without the property never match an equality comparison
+      return;
+    }
+
+    if (value.Type() == typeid(std::string))
+    {
+      values.push_back(ref_any_cast<std::string>(value));
+    }
+    else if (value.Type() == typeid(std::vector<std::string>))
+    {
+      values = ref_any_cast<std::vector<std::string> >(value);
+    }
+    else if (value.Type() == typeid(std::list<std::string>))
+    {
+      const std::list<std::string>& list = ref_any_cast<std::list<std::string> >(value);
+      values.assign(list.begin(), list.end());
     }
     else
     {
-      core->serviceHooks.FilterServiceReferences(NULL, clazz, filter, res);
+      index.others.push_back(sr);
+      return;
+    }
+  }
+
+  std::sort(values.begin(), values.end());
+  values.erase(std::unique(values.begin(), values.end()), values.end());
+  for (std::vector<std::string>::const_iterator i = values.begin(); i != values.end(); ++i)
+  {
+    index.values[*i].push_back(sr);
+  }
+  index.serviceValues[sr].swap(values);
+}
+
+void ServiceRegistry::AddToPropertyIndexes_unlocked(const ServiceRegistrationBase& sr)
+{
+  for (MapPropertyIndexes::iterator i = propertyIndexes.begin(); i != propertyIndexes.end(); ++i)
+  {
+    AddToPropertyIndex(i->first, i->second, sr);
+  }
+}
+
+void ServiceRegistry::RemoveFromPropertyIndexes_unlocked(const ServiceRegistrationBase& sr)
+{
+  for (MapPropertyIndexes::iterator i = propertyIndexes.begin(); i != propertyIndexes.end(); ++i)
+  {
+    PropertyIndex& index = i->second;
+
+    PropertyIndex::MapServiceValues::iterator serviceValues = index.serviceValues.find(sr);
+    if (serviceValues == index.serviceValues.end())
+    {
+      index.others.erase(std::remove(index.others.begin(), index.others.end(), sr), index.others.end());
+      continue;
+    }
+
+    for (std::vector<std::string>::const_iterator value = serviceValues->second.begin();
+         value != serviceValues->second.end(); ++value)
+    {
+      PropertyIndex::MapValueServices::iterator services = index.values.find(*value);
+      if (services == index.values.end())
+      {
+        continue;
+      }
+
+      std::vector<ServiceRegistrationBase>& s = services->second;
+      s.erase(std::remove(s.begin(), s.end(), sr), s.end());
+      if (s.empty())
+      {
+        index.values.erase(services);
+      }
     }
+    index.serviceValues.erase(serviceValues);
   }
 }
 
+void ServiceRegistry::UpdatePropertyIndexes(const ServiceRegistrationBase& sr)
+{
+  MutexLock lock(mutex);
+  if (services.find(sr) == services.end())
+  {
+    return;
+  }
+
+  RemoveFromPropertyIndexes_unlocked(sr);
+  AddToPropertyIndexes_unlocked(sr);
+}
+
 void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& sr)
 {
   MutexLock lock(mutex);
@@ -290,6 +540,7 @@ void ServiceRegistry::RemoveServiceRegistration(const ServiceRegistrationBase& s
   services.erase(sr);
   serviceRegistrations.erase(std::remove(serviceRegistrations.begin(), serviceRegistrations.end(), sr),
                              serviceRegistrations.end());
+  RemoveFromPropertyIndexes_unlocked(sr);
   for (std::vector<std::string>::const_iterator i = classes.begin();
        i != classes.end(); ++i)
   {
@@ -26,6 +26,7 @@
 #include "usServiceInterface.h"
 #include "usServiceRegistration.h"
 
+#include "usLDAPExpr_p.h"
 #include "usThreads_p.h"
 
 US_BEGIN_NAMESPACE
@@ -63,6 +64,30 @@ public:
   typedef US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, std::vector<std::string> > MapServiceClasses;
   typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > MapClassServices;
 
+  /**
+   * Registered services by the value of one service property.
+   * Only string and string list values are indexed, services with
+   * other values of the property are kept in <code>others</code>.
+   * Services without the property are not contained at all.
+   */
+  struct PropertyIndex
+  {
+    typedef US_UNORDERED_MAP_TYPE<std::string, std::vector<ServiceRegistrationBase> > MapValueServices;
+    typedef US_UNORDERED_MAP_TYPE<ServiceRegistrationBase, std::vector<std::string> > MapServiceValues;
+
+    MapValueServices values;
+    std::vector<ServiceRegistrationBase> others;
+
+    /**
+     * The values each service is indexed with, the properties of
+     * the service may have changed when it is removed.
+     */
+    MapServiceValues serviceValues;
+  };
+
+  typedef US_UNORDERED_MAP_TYPE<std::string, PropertyIndex> MapPropertyIndexes;
+  typedef US_UNORDERED_MAP_TYPE<std::string, LDAPExpr> MapFilters;
+
   /**
    * All registered services in the current framework.
    * Mapping of registered service to class names under which
@@ -116,6 +141,13 @@ public:
   void UpdateServiceRegistrationOrder(const ServiceRegistrationBase& sr,
                                       const std::vector<std::string>& classes);
 
+  /**
+   * Service properties changed, update the property indexes.
+   *
+   * @param sr The ServiceRegistration object whose properties changed.
+   */
+  void UpdatePropertyIndexes(const ServiceRegistrationBase& sr);
+
   /**
    * Get all services implementing a certain class.
    * Only used internally by the framework.
@@ -138,6 +170,10 @@ public:
    * Get all services implementing a certain class and then
    * filter these with a property filter.
    *
+   * The filter is evaluated on a snapshot of the candidate services
+   * without holding the registry lock, so concurrent lookups do not
+   * wait for each other.
+   *
    * @param clazz The class name of requested service.
    * @param filter The property filter.
    * @param module The module requesting reference.
@@ -178,6 +214,59 @@ private:
   void Get_unlocked(const std::string& clazz, const std::string& filter,
                     ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
 
+  /**
+   * Returns the parsed filter, parsing it only on its first use.
+   *
+   * @exception std::invalid_argument If the filter is not valid.
+   */
+  LDAPExpr GetFilter(const std::string& filter) const;
+
+  /**
+   * Get the services of class clazz which may match ldap, in the order
+   * in which they are returned to the caller.
+   */
+  void GetCandidates_unlocked(const std::string& clazz, const LDAPExpr& ldap,
+                              std::vector<ServiceRegistrationBase>& candidates) const;
+
+  /**
+   * Get the candidates from the property index with the fewest services
+   * for the values required by ldap. Returns false if no index helps.
+   */
+  bool GetIndexedCandidates_unlocked(const std::string& clazz, const LDAPExpr& ldap, std::size_t maxCandidates,
+                                     std::vector<ServiceRegistrationBase>& candidates) const;
+
+  void FilterServiceReferences_unlocked(const std::string& clazz, const std::string& filter,
+                                        ModulePrivate* module, std::vector<ServiceReferenceBase>& serviceRefs) const;
+
+  static void FilterCandidates(const std::string& clazz, const LDAPExpr& ldap,
+                               const std::vector<ServiceRegistrationBase>& candidates,
+                               std::vector<ServiceReferenceBase>& serviceRefs);
+
+  /**
+   * Returns the index of the given lower case property name. It is created
+   * on first use, or 0 is returned if too many properties are indexed already.
+   */
+  PropertyIndex* GetPropertyIndex_unlocked(const std::string& key) const;
+
+  static void AddToPropertyIndex(const std::string& key, PropertyIndex& index, const ServiceRegistrationBase& sr);
+
+  void AddToPropertyIndexes_unlocked(const ServiceRegistrationBase& sr);
+
+  void RemoveFromPropertyIndexes_unlocked(const ServiceRegistrationBase& sr);
+
+  /**
+   * Indexes of registered services by the value of a service property. An
+   * index is created when a filter compares the (lower case) property for
+   * equality for the first time.
+   */
+  mutable MapPropertyIndexes propertyIndexes;
+
+  /**
+   * Parsed filters by filter string, guarded by filterMutex.
+   */
+  mutable MapFilters filters;
+  mutable MutexType filterMutex;
+
   // purposely not implemented
   ServiceRegistry(const ServiceRegistry&);
   ServiceRegistry& operator=(const ServiceRegistry&);
@@ -24,11 +24,15 @@
 #include "usLog_p.h"
 #include "usModuleInfo.h"
 #include "usModuleSettings.h"
+#include "usStaticInit_p.h"
+#include "usThreads_p.h"
 
 #include <string>
 #include <cstdio>
 #include <cctype>
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <typeinfo>
 
 #ifdef US_PLATFORM_POSIX
@@ -36,6 +40,8 @@
   #include <string.h>
   #include <dlfcn.h>
   #include <dirent.h>
+  #include <fcntl.h>
+  #include <unistd.h>
 #else
   #ifndef WIN32_LEAN_AND_MEAN
     #define WIN32_LEAN_AND_MEAN
@@ -102,13 +108,37 @@ bool load_impl(const std::string&) { return false; }
 
 #endif
 
+#if defined(US_PLATFORM_POSIX) && !defined(US_PLATFORM_APPLE)
+void prefetch_impl(const std::string& modulePath)
+{
+  // Let the kernel read the library in the background. This is only
+  // a hint, so errors are ignored.
+  int fd = open(modulePath.c_str(), O_RDONLY);
+  if (fd >= 0)
+  {
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+  }
+}
+#else
+void prefetch_impl(const std::string&) {}
+#endif
+
+typedef std::map<std::string, std::vector<std::string> > DeferredModulesMap;
+
+US_GLOBAL_STATIC(DeferredModulesMap, deferredModules)
+US_GLOBAL_STATIC(US_PREPEND_NAMESPACE(Mutex), deferredModulesLock)
+// Held while deferred modules are loaded. It is recursive because module
+// activators may query mime-types, which loads deferred modules again.
+US_GLOBAL_STATIC(std::recursive_mutex, deferredModulesLoadLock)
+
 }
 
 US_BEGIN_NAMESPACE
 
-std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBasePath, const std::string& subDir)
+std::vector<std::string> FindModulesInPath(const std::string& absoluteBasePath, const std::string& subDir)
 {
-  std::vector<std::string> loadedModules;
+  std::vector<std::string> modulePaths;
 
   std::string loadPath = absoluteBasePath + DIR_SEP + subDir;
 
@@ -169,19 +199,35 @@ std::vector<std::string> AutoLoadModulesFromPath(const std::string& absoluteBase
         libPath += DIR_SEP;
       }
       libPath += entryFileName;
-      US_DEBUG << "Auto-loading module " << libPath;
-
-      if (!load_impl(libPath))
-      {
-        US_WARN << "Auto-loading of module " << libPath << " failed.";
-      }
-      else
-      {
-        loadedModules.push_back(libPath);
-      }
+      modulePaths.push_back(libPath);
     }
     closedir(dir);
   }
+  return modulePaths;
+}
+
+std::vector<std::string> LoadModules(const std::vector<std::string>& modulePaths)
+{
+  // Module initialization is not thread-safe, so the modules are loaded one
+  // after the other. But the libraries are read from disk in the background
+  // while the first ones are loaded.
+  std::for_each(modulePaths.begin(), modulePaths.end(), prefetch_impl);
+
+  std::vector<std::string> loadedModules;
+  for (std::vector<std::string>::const_iterator libPath = modulePaths.begin();
+       libPath != modulePaths.end(); ++libPath)
+  {
+    US_DEBUG << "Auto-loading module " << *libPath;
+
+    if (!load_impl(*libPath))
+    {
+      US_WARN << "Auto-loading of module " << *libPath << " failed.";
+    }
+    else
+    {
+      loadedModules.push_back(*libPath);
+    }
+  }
   return loadedModules;
 }
 
@@ -213,16 +259,50 @@ std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo)
   // We could have introduced a duplicate above, so remove it.
   std::sort(autoLoadPaths.begin(), autoLoadPaths.end());
   autoLoadPaths.erase(std::unique(autoLoadPaths.begin(), autoLoadPaths.end()), autoLoadPaths.end());
+  std::vector<std::string> modulePaths;
   for (ModuleSettings::PathList::iterator i = autoLoadPaths.begin();
        i != autoLoadPaths.end(); ++i)
   {
     if (i->empty()) continue;
-    std::vector<std::string> paths = AutoLoadModulesFromPath(*i, moduleInfo.autoLoadDir);
-    loadedModules.insert(loadedModules.end(), paths.begin(), paths.end());
+    std::vector<std::string> paths = FindModulesInPath(*i, moduleInfo.autoLoadDir);
+    modulePaths.insert(modulePaths.end(), paths.begin(), paths.end());
+  }
+
+  if (ModuleSettings::IsAutoLoadingDeferred(moduleInfo.autoLoadDir))
+  {
+    US_DEBUG << "Deferring auto-loading of " << modulePaths.size() << " modules from " << moduleInfo.autoLoadDir;
+
+    MutexLock lock(*deferredModulesLock());
+    std::vector<std::string>& deferredPaths = (*deferredModules())[moduleInfo.autoLoadDir];
+    deferredPaths.insert(deferredPaths.end(), modulePaths.begin(), modulePaths.end());
+    return loadedModules;
   }
+
+  loadedModules = LoadModules(modulePaths);
   return loadedModules;
 }
 
+std::vector<std::string> LoadDeferredModules(const std::string& autoLoadDir)
+{
+  // Concurrent calls wait until the modules are loaded, recursive calls
+  // (e.g. from module activators) return without loading them twice.
+  std::lock_guard<std::recursive_mutex> loadLock(*deferredModulesLoadLock());
+
+  std::vector<std::string> modulePaths;
+  {
+    MutexLock lock(*deferredModulesLock());
+    DeferredModulesMap::iterator i = deferredModules()->find(autoLoadDir);
+    if (i == deferredModules()->end())
+    {
+      return modulePaths;
+    }
+    modulePaths.swap(i->second);
+    deferredModules()->erase(i);
+  }
+
+  return LoadModules(modulePaths);
+}
+
 US_END_NAMESPACE
 
 //-------------------------------------------------------------------
@@ -38,6 +38,8 @@ struct ModuleInfo;
 
 std::vector<std::string> AutoLoadModules(const ModuleInfo& moduleInfo);
 
+std::vector<std::string> LoadDeferredModules(const std::string& autoLoadDir);
+
 US_END_NAMESPACE
 
 //-------------------------------------------------------------------
@@ -156,6 +156,43 @@ void testCustomAutoLoadPath()
   mc->RemoveModuleListener(&listener, &TestModuleListener::ModuleChanged);
 }
 
+void testDeferredAutoLoadPath()
+{
+  ModuleSettings::AddDeferredAutoLoadDir("TestModuleAL");
+  US_TEST_CONDITION(ModuleSettings::IsAutoLoadingDeferred("TestModuleAL"), "Test for deferred auto-load directory")
+
+  SharedLibrary libAL(LIB_PATH, "TestModuleAL");
+
+  try
+  {
+    libAL.Load();
+  }
+  catch (const std::exception& e)
+  {
+    US_TEST_FAILED_MSG(<< "Load module exception: " << e.what())
+  }
+
+  Module* moduleAL = ModuleRegistry::GetModule("TestModuleAL");
+  US_TEST_CONDITION_REQUIRED(moduleAL != NULL, "Test for existing module TestModuleAL")
+
+  Any loadedModules = moduleAL->GetProperty(Module::PROP_AUTOLOADED_MODULES());
+  US_TEST_CONDITION(loadedModules.Empty(), "Test for empty PROP_AUTOLOADED_MODULES property")
+
+  std::vector<std::string> deferredModules = ModuleRegistry::LoadDeferredModules("TestModuleAL");
+  Module* moduleAL_1 = ModuleRegistry::GetModule("TestModuleAL_1");
+  US_TEST_CONDITION_REQUIRED(moduleAL_1 != NULL, "Test for existing auto-loaded module TestModuleAL_1")
+  US_TEST_CONDITION_REQUIRED(deferredModules.size() == 1, "Test for number of deferred modules")
+  US_TEST_CONDITION(deferredModules[0] == moduleAL_1->GetLocation(), "Test for deferred module path")
+
+  deferredModules = ModuleRegistry::LoadDeferredModules("TestModuleAL");
+  US_TEST_CONDITION(deferredModules.empty(), "Test for loading deferred modules only once")
+
+  libAL.Unload();
+
+  ModuleSettings::SetDeferredAutoLoadDirs(ModuleSettings::PathList());
+  US_TEST_CONDITION(!ModuleSettings::IsAutoLoadingDeferred("TestModuleAL"), "Test for reset deferred auto-load directories")
+}
+
 } // end unnamed namespace
 
 
@@ -171,5 +208,7 @@ int usModuleAutoLoadTest(int /*argc*/, char* /*argv*/[])
 
   testCustomAutoLoadPath();
 
+  testDeferredAutoLoadPath();
+
   US_TEST_END()
 }
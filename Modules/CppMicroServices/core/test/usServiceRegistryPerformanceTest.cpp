@@ -204,6 +204,7 @@ public:
   void TestAddListeners();
   void TestRegisterServices();
 
+  void TestFilterServices();
   void TestModifyServices();
   void TestUnregisterServices();
 
@@ -358,6 +359,25 @@ void ServiceRegistryPerformanceTest::RegisterServices(int n)
   }
 }
 
+void ServiceRegistryPerformanceTest::TestFilterServices()
+{
+  Log() << "Look up each of the " << nServices << " services by a filter on its pid\n";
+
+  HighPrecisionTimer t;
+  t.Start();
+  std::size_t nFound = 0;
+  for(int i = 0; i < nServices; i++)
+  {
+    std::stringstream ss;
+    ss << "(service.pid=my.service." << i << ")";
+    nFound += mc->GetServiceReferences<IPerfTestService>(ss.str()).size();
+  }
+  long long ms = t.ElapsedMilli();
+  Log() << "filtered lookups took " << ms << "ms\n";
+  US_TEST_CONDITION_REQUIRED(static_cast<std::size_t>(nServices) == nFound,
+                             "Each filtered lookup must find exactly one service");
+}
+
 void ServiceRegistryPerformanceTest::TestModifyServices()
 {
   Log() << "Modify all services, and check that we get #of services ("
@@ -420,6 +440,7 @@ int usServiceRegistryPerformanceTest(int /*argc*/, char* /*argv*/[])
   perfTest.InitTestCase();
   perfTest.TestAddListeners();
   perfTest.TestRegisterServices();
+  perfTest.TestFilterServices();
   perfTest.TestModifyServices();
   perfTest.TestUnregisterServices();
   perfTest.CleanupTestCase();
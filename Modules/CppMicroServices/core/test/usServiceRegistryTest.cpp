@@ -127,6 +127,86 @@ void TestServicePropertiesUpdate()
   US_TEST_CONDITION_REQUIRED(context->GetServiceReferences<ITestServiceA>().empty(), "Testing service count")
 }
 
+void TestFilteredServiceLookup()
+{
+  struct TestServiceA : public ITestServiceA
+  {
+  };
+
+  ModuleContext* context = GetModuleContext();
+
+  TestServiceA s1;
+  ServiceProperties props1;
+  props1["mimetype"] = std::string("application/a");
+  props1["extensions"] = std::vector<std::string>(1, "a");
+  ServiceRegistration<ITestServiceA> reg1 = context->RegisterService<ITestServiceA>(&s1, props1);
+
+  TestServiceA s2;
+  ServiceProperties props2;
+  props2["MimeType"] = std::string("application/b");
+  std::vector<std::string> extensions2;
+  extensions2.push_back("b");
+  extensions2.push_back("a");
+  props2["extensions"] = extensions2;
+  props2[ServiceConstants::SERVICE_RANKING()] = 10;
+  ServiceRegistration<ITestServiceA> reg2 = context->RegisterService<ITestServiceA>(&s2, props2);
+
+  TestServiceA s3;
+  ServiceProperties props3;
+  props3["mimetype"] = 5;
+  ServiceRegistration<ITestServiceA> reg3 = context->RegisterService<ITestServiceA>(&s3, props3);
+
+  std::vector<ServiceReference<ITestServiceA> > refs =
+      context->GetServiceReferences<ITestServiceA>("(mimetype=application/a)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s1, "Testing equality filter")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(MIMETYPE=application/b)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s2, "Testing case insensitive key")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=5)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s3, "Testing non-string property")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(|(mimetype=application/a)(mimetype=application/b))");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Testing OR filter")
+  US_TEST_CONDITION_REQUIRED(context->GetService(refs.back()) == &s2, "Testing ranking order of OR filter")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(&(extensions=a)(mimetype=application/b))");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s2, "Testing AND filter")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(extensions=a)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Testing string list property")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/*)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Testing wildcard filter")
+
+  refs = context->GetServiceReferences<ITestServiceA>("(!(mimetype=application/a))");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 2, "Testing NOT filter")
+
+  // changed properties must be found with the same filter
+  props1["mimetype"] = std::string("application/c");
+  reg1.SetProperties(props1);
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/a)");
+  US_TEST_CONDITION_REQUIRED(refs.empty(), "Testing filter after property change")
+  refs = context->GetServiceReferences<ITestServiceA>("(mimetype=application/c)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s1, "Testing changed property")
+
+  reg2.Unregister();
+  refs = context->GetServiceReferences<ITestServiceA>("(extensions=a)");
+  US_TEST_CONDITION_REQUIRED(refs.size() == 1 && context->GetService(refs.front()) == &s1, "Testing filter after unregistration")
+
+  try
+  {
+    context->GetServiceReferences<ITestServiceA>("(mimetype=application/a");
+    US_TEST_FAILED_MSG(<< "Invalid filter did not throw")
+  }
+  catch (const std::invalid_argument&)
+  {
+  }
+
+  reg1.Unregister();
+  reg3.Unregister();
+}
+
 
 int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
 {
@@ -135,6 +215,7 @@ int usServiceRegistryTest(int /*argc*/, char* /*argv*/[])
   TestServiceInterfaceId();
   TestMultipleServiceRegistrations();
   TestServicePropertiesUpdate();
+  TestFilteredServiceLookup();
 
   US_TEST_END()
 }
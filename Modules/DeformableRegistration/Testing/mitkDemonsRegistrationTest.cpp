@@ -124,5 +124,53 @@ int mitkDemonsRegistrationTest(int /*argc*/, char * /*argv*/ [])
   itk::Image<class itk::Vector<float, 3>, 3>::Pointer deformationField = demonsRegistration->GetDeformationField();
   std::cout << "[PASSED]" << std::endl;
 
+  std::cout << "Get the iteration infos: ";
+  if (demonsRegistration->GetIterationInfos().size() != 5)
+  {
+    std::cout << "[FAILED] expected 5 iterations" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "[PASSED]" << std::endl;
+
+  std::cout << "Perform multiresolution registration: ";
+  mitk::DemonsRegistration::Pointer multiResolutionRegistration = mitk::DemonsRegistration::New();
+  multiResolutionRegistration->SetReferenceImage(image);
+  multiResolutionRegistration->SetInput(image2);
+  multiResolutionRegistration->SetNumberOfIterations(5);
+  multiResolutionRegistration->SetNumberOfLevels(2);
+  multiResolutionRegistration->SetSaveDeformationField(false);
+  multiResolutionRegistration->SetSaveResult(false);
+  multiResolutionRegistration->UseProgressBarOff();
+  multiResolutionRegistration->Update();
+
+  mitk::RegistrationBase::IterationInfoVectorType infos = multiResolutionRegistration->GetIterationInfos();
+  if (infos.empty() || infos.front().Level != 0 || infos.back().Level != 1)
+  {
+    std::cout << "[FAILED] expected iterations on both levels" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "[PASSED]" << std::endl;
+
+  std::cout << "Cancel registration: ";
+  mitk::DemonsRegistration::Pointer canceledRegistration = mitk::DemonsRegistration::New();
+  canceledRegistration->SetReferenceImage(image);
+  canceledRegistration->SetInput(image2);
+  canceledRegistration->SetNumberOfIterations(5);
+  canceledRegistration->SetNumberOfLevels(2);
+  canceledRegistration->SetSaveDeformationField(false);
+  canceledRegistration->SetSaveResult(false);
+  canceledRegistration->UseProgressBarOff();
+  canceledRegistration->Cancel();
+  canceledRegistration->Update();
+
+  if (canceledRegistration->GetIterationInfos().size() != 1 || canceledRegistration->GetDeformationField().IsNull())
+  {
+    std::cout << "[FAILED] expected one iteration and a deformation field" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "[PASSED]" << std::endl;
+
+  mitk::RegistrationBase::ClearPyramidCache();
+
   return EXIT_SUCCESS;
 }
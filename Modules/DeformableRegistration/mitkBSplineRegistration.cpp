@@ -33,9 +33,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkMetricFactory.h"
 #include "mitkOptimizerFactory.h"
 
+#include <itkGradientDescentOptimizer.h>
 #include <itkHistogramMatchingImageFilter.h>
+#include <itkRegularStepGradientDescentBaseOptimizer.h>
 #include <itkRescaleIntensityImageFilter.h>
 
+#include <limits>
+
 namespace mitk
 {
   BSplineRegistration::BSplineRegistration()
@@ -45,7 +49,8 @@ namespace mitk
       m_SaveDeformationField(false),
       m_UpdateInputImage(false),
       m_MatchHistograms(true),
-      m_Metric(0)
+      m_Metric(0),
+      m_OptimizerIteration(0)
   {
     m_Observer = mitk::RigidRegistrationObserver::New();
   }
@@ -54,6 +59,27 @@ namespace mitk
   void BSplineRegistration::SetNumberOfIterations(int iterations) { m_Iterations = iterations; }
   void BSplineRegistration::SetSaveResult(bool saveResult) { m_SaveResult = saveResult; }
   void BSplineRegistration::SetResultFileName(const char *resultName) { m_ResultName = resultName; }
+  void BSplineRegistration::OnOptimizerIteration(itk::Object *caller, const itk::EventObject &)
+  {
+    double metricValue = std::numeric_limits<double>::quiet_NaN();
+
+    if (itk::RegularStepGradientDescentBaseOptimizer *optimizer =
+          dynamic_cast<itk::RegularStepGradientDescentBaseOptimizer *>(caller))
+    {
+      metricValue = optimizer->GetValue();
+      if (this->GetCanceled())
+        optimizer->StopOptimization();
+    }
+    else if (itk::GradientDescentOptimizer *optimizer = dynamic_cast<itk::GradientDescentOptimizer *>(caller))
+    {
+      metricValue = optimizer->GetValue();
+      if (this->GetCanceled())
+        optimizer->StopOptimization();
+    }
+
+    this->AddIteration(0, m_OptimizerIteration++, metricValue);
+  }
+
   template <typename TPixel, unsigned int VImageDimension>
   void BSplineRegistration::GenerateData2(const itk::Image<TPixel, VImageDimension> *itkImage1)
   {
@@ -109,11 +135,13 @@ namespace mitk
       typename MetricType::Pointer metric = MetricType::New();
       metric->SetNumberOfHistogramBins(32);
       metric->SetNumberOfSpatialSamples(90000);
+      metric->SetNumberOfThreads(this->GetNumberOfThreads());
       registration->SetMetric(metric);
     }
     else
     {
       typename MetricTypeMS::Pointer metric = MetricTypeMS::New();
+      metric->SetNumberOfThreads(this->GetNumberOfThreads());
       registration->SetMetric(metric);
     }
 
@@ -124,6 +152,10 @@ namespace mitk
 
     optimizer->AddObserver(itk::AnyEvent(), m_Observer);
 
+    itk::MemberCommand<BSplineRegistration>::Pointer iterationCommand = itk::MemberCommand<BSplineRegistration>::New();
+    iterationCommand->SetCallbackFunction(this, &BSplineRegistration::OnOptimizerIteration);
+    optimizer->AddObserver(itk::IterationEvent(), iterationCommand);
+
     // typedef mitk::MetricFactory <TPixel, VImageDimension> MetricFactoryType;
     // typename MetricFactoryType::Pointer metricFac = MetricFactoryType::New();
     // metricFac->SetMetricParameters(m_MetricParameters);
@@ -204,6 +236,9 @@ namespace mitk
 
     std::cout << std::endl << "Starting Registration" << std::endl;
 
+    this->StartIterations();
+    m_OptimizerIteration = 0;
+
     try
     {
       double tstart(clock());
@@ -218,6 +253,8 @@ namespace mitk
       std::cerr << err << std::endl;
     }
 
+    this->FinishIterations();
+
     typename OptimizerType::ParametersType finalParameters = registration->GetLastTransformParameters();
 
     std::cout << "Last Transform Parameters" << std::endl;
@@ -115,6 +115,12 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void GenerateData2(const itk::Image<TPixel, VImageDimension> *itkImage1);
 
+    /*!
+    * \brief Records the iterations of the optimizer and stops it if the registration was canceled. Only gradient
+    * descent optimizers provide a metric value and can be stopped.
+    */
+    void OnOptimizerIteration(itk::Object *caller, const itk::EventObject &);
+
     int m_Iterations;
     const char *m_ResultName;
     bool m_SaveResult;
@@ -132,6 +138,8 @@ namespace mitk
     int m_Metric;
 
     RigidRegistrationObserver::Pointer m_Observer;
+
+    unsigned int m_OptimizerIteration;
   };
 }
 
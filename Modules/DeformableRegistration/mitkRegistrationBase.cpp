@@ -17,9 +17,40 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkRegistrationBase.h"
 #include "mitkProgressBar.h"
 
+#include <itkMutexLockHolder.h>
+
+namespace
+{
+  /*! pyramid of the last reference image, shared by all registrations */
+  struct PyramidCache
+  {
+    PyramidCache() : NumberOfLevels(0), MTime(0) {}
+    itk::SimpleFastMutexLock Mutex;
+    mitk::Image::ConstPointer Image;
+    unsigned int NumberOfLevels;
+    unsigned long MTime;
+    std::vector<itk::DataObject::Pointer> Levels;
+  };
+
+  PyramidCache &GetPyramidCache()
+  {
+    static PyramidCache cache;
+    return cache;
+  }
+}
+
 namespace mitk
 {
-  RegistrationBase::RegistrationBase() { m_ReferenceImage = Image::New(); }
+  RegistrationBase::RegistrationBase()
+    : m_NumberOfLevels(1),
+      m_ConvergenceThreshold(0.0),
+      m_UseProgressBar(true),
+      m_Canceled(false),
+      m_CurrentLevel(0)
+  {
+    m_ReferenceImage = Image::New();
+  }
+
   RegistrationBase::~RegistrationBase() {}
   void RegistrationBase::SetReferenceImage(Image::Pointer fixedImage)
   {
@@ -30,10 +61,96 @@ namespace mitk
 
   void RegistrationBase::SetProgress(const itk::EventObject &)
   {
-    ProgressBar::GetInstance()->AddStepsToDo(1);
-    ProgressBar::GetInstance()->Progress();
+    if (m_UseProgressBar)
+    {
+      ProgressBar::GetInstance()->AddStepsToDo(1);
+      ProgressBar::GetInstance()->Progress();
+    }
+  }
+
+  void RegistrationBase::AddStepsToDo(int steps)
+  {
+    if (m_UseProgressBar)
+      ProgressBar::GetInstance()->AddStepsToDo(steps);
+  }
+
+  void RegistrationBase::SetRemainingProgress(int steps)
+  {
+    if (m_UseProgressBar)
+      ProgressBar::GetInstance()->Progress(steps);
+  }
+
+  void RegistrationBase::Cancel() { m_Canceled = true; }
+  bool RegistrationBase::GetCanceled() const { return m_Canceled; }
+  RegistrationBase::IterationInfoVectorType RegistrationBase::GetIterationInfos() const
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_IterationInfosMutex);
+    return m_IterationInfos;
   }
 
-  void RegistrationBase::AddStepsToDo(int steps) { ProgressBar::GetInstance()->AddStepsToDo(steps); }
-  void RegistrationBase::SetRemainingProgress(int steps) { ProgressBar::GetInstance()->Progress(steps); }
+  void RegistrationBase::StartIterations()
+  {
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_IterationInfosMutex);
+      m_IterationInfos.clear();
+    }
+    m_CurrentLevel = 0;
+    m_IterationStartTime = std::chrono::steady_clock::now();
+  }
+
+  void RegistrationBase::AddIteration(unsigned int level, unsigned int iteration, double metricValue)
+  {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    IterationInfo info;
+    info.Level = level;
+    info.Iteration = iteration;
+    info.Milliseconds = std::chrono::duration<double, std::milli>(now - m_IterationStartTime).count();
+    info.MetricValue = metricValue;
+    m_IterationStartTime = now;
+
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_IterationInfosMutex);
+      m_IterationInfos.push_back(info);
+    }
+
+    this->InvokeEvent(itk::IterationEvent());
+  }
+
+  void RegistrationBase::FinishIterations() { m_Canceled = false; }
+  void RegistrationBase::ClearPyramidCache()
+  {
+    PyramidCache &cache = GetPyramidCache();
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(cache.Mutex);
+    cache.Image = nullptr;
+    cache.NumberOfLevels = 0;
+    cache.MTime = 0;
+    cache.Levels.clear();
+  }
+
+  bool RegistrationBase::GetCachedPyramid(const Image *image,
+                                          unsigned int numberOfLevels,
+                                          std::vector<itk::DataObject::Pointer> &levels)
+  {
+    PyramidCache &cache = GetPyramidCache();
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(cache.Mutex);
+
+    if (cache.Image.GetPointer() != image || cache.MTime != image->GetMTime() || cache.NumberOfLevels != numberOfLevels)
+      return false;
+
+    levels = cache.Levels;
+    return true;
+  }
+
+  void RegistrationBase::SetCachedPyramid(const Image *image,
+                                          unsigned int numberOfLevels,
+                                          const std::vector<itk::DataObject::Pointer> &levels)
+  {
+    PyramidCache &cache = GetPyramidCache();
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(cache.Mutex);
+    cache.Image = image;
+    cache.NumberOfLevels = numberOfLevels;
+    cache.MTime = image->GetMTime();
+    cache.Levels = levels;
+  }
 }
@@ -20,6 +20,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkDeformableRegistrationExports.h"
 #include "mitkImageToImageFilter.h"
 
+#include <itkEventObject.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
 namespace mitk
 {
   /*!
@@ -27,6 +34,9 @@ namespace mitk
   registration process.
   It is the base class for the registration classes.
 
+  Registrations can run in a background thread: switch off UseProgressBar, observe itk::IterationEvent
+  to follow the registration (see GetIterationInfos()) and call Cancel() from any thread to stop it.
+
   \ingroup DeformableRegistration
 
   \author Daniel Stein
@@ -47,6 +57,61 @@ namespace mitk
       */
       virtual void SetReferenceImage(Image::Pointer fixedImage);
 
+    /*!
+    * \brief Duration and metric value of one iteration of the registration.
+    */
+    struct IterationInfo
+    {
+      /*! resolution level, 0 is the coarsest one */
+      unsigned int Level;
+      /*! iteration within the level */
+      unsigned int Iteration;
+      double Milliseconds;
+      /*! NaN if the registration method does not provide a metric value */
+      double MetricValue;
+    };
+    typedef std::vector<IterationInfo> IterationInfoVectorType;
+
+    /*!
+    * \brief Stops a running registration after the current iteration. The result of the iterations done so far
+    * is used. May be called from any thread.
+    */
+    void Cancel();
+    bool GetCanceled() const;
+
+    /*!
+    * \brief Returns the iterations done by the last or the running registration. May be called from any thread.
+    * The registration invokes an itk::IterationEvent after each iteration.
+    */
+    IterationInfoVectorType GetIterationInfos() const;
+
+    /*!
+    * \brief Sets the number of resolution levels used by registrations supporting a multiresolution schedule.
+    * Each level halves the resolution of the next finer one. Default is 1, i.e. only the full resolution.
+    */
+    itkSetMacro(NumberOfLevels, unsigned int);
+    itkGetConstMacro(NumberOfLevels, unsigned int);
+
+    /*!
+    * \brief A resolution level is finished early if the RMS change of the deformation field in an iteration
+    * drops below this value. Default is 0, i.e. all iterations are done.
+    */
+    itkSetMacro(ConvergenceThreshold, double);
+    itkGetConstMacro(ConvergenceThreshold, double);
+
+    /*!
+    * \brief Sets whether the progress is shown in the mitk::ProgressBar. Switch it off if the registration
+    * does not run in the GUI thread.
+    */
+    itkSetMacro(UseProgressBar, bool);
+    itkGetConstMacro(UseProgressBar, bool);
+    itkBooleanMacro(UseProgressBar);
+
+    /*!
+    * \brief Releases the image pyramid cached for the last reference image (see GetReferencePyramid()).
+    */
+    static void ClearPyramidCache();
+
   protected:
     /*!
     * \brief Default constructor
@@ -74,7 +139,58 @@ namespace mitk
     */
     virtual void SetRemainingProgress(int steps);
 
+    /*!
+    * \brief Clears the iteration infos and starts timing the first iteration.
+    */
+    void StartIterations();
+
+    /*!
+    * \brief Records an iteration and invokes an itk::IterationEvent.
+    */
+    void AddIteration(unsigned int level, unsigned int iteration, double metricValue);
+
+    /*!
+    * \brief Ends the registration, resets the cancel request.
+    */
+    void FinishIterations();
+
+    /*!
+    * \brief Returns the reference image cast to TImage and downsampled to numberOfLevels resolution levels,
+    * coarsest level first. The levels of the last reference image are cached for all registrations, so
+    * repeated registrations against the same reference image reuse them. Defined in mitkRegistrationBase.txx.
+    */
+    template <typename TImage>
+    std::vector<typename TImage::Pointer> GetReferencePyramid(unsigned int numberOfLevels);
+
+    /*!
+    * \brief Runs a PDE based registration filter (e.g. itk::DemonsRegistrationFilter) on all resolution levels
+    * and returns the deformation field at full resolution. Each level starts with the field of the coarser level
+    * and ends after the given number of iterations, on convergence (see SetConvergenceThreshold()) or if the
+    * registration was canceled. Defined in mitkRegistrationBase.txx.
+    */
+    template <typename TRegistrationFilter>
+    typename TRegistrationFilter::DisplacementFieldType::Pointer RunPDERegistration(
+      const typename TRegistrationFilter::MovingImageType *movingImage, unsigned int iterations, float standardDeviation);
+
     Image::Pointer m_ReferenceImage;
+
+    unsigned int m_NumberOfLevels;
+    double m_ConvergenceThreshold;
+    bool m_UseProgressBar;
+
+  private:
+    template <typename TRegistrationFilter>
+    void OnPDEIteration(itk::Object *caller, const itk::EventObject &);
+
+    static bool GetCachedPyramid(const Image *image, unsigned int numberOfLevels, std::vector<itk::DataObject::Pointer> &levels);
+    static void SetCachedPyramid(const Image *image, unsigned int numberOfLevels, const std::vector<itk::DataObject::Pointer> &levels);
+
+    std::atomic<bool> m_Canceled;
+    unsigned int m_CurrentLevel;
+
+    IterationInfoVectorType m_IterationInfos;
+    mutable itk::SimpleFastMutexLock m_IterationInfosMutex;
+    std::chrono::steady_clock::time_point m_IterationStartTime;
   };
 
 } // namespace mitk
@@ -0,0 +1,206 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKREGISTRATIONBASE_TXX
+#define MITKREGISTRATIONBASE_TXX
+
+#include "mitkRegistrationBase.h"
+
+#include <mitkImageCast.h>
+
+#include <itkCommand.h>
+#include <itkRecursiveMultiResolutionPyramidImageFilter.h>
+#include <itkVectorResampleImageFilter.h>
+
+namespace mitk
+{
+  template <typename TImage>
+  std::vector<typename TImage::Pointer> RegistrationBase::GetReferencePyramid(unsigned int numberOfLevels)
+  {
+    std::vector<typename TImage::Pointer> levels;
+
+    std::vector<itk::DataObject::Pointer> cachedLevels;
+    if (GetCachedPyramid(m_ReferenceImage, numberOfLevels, cachedLevels))
+    {
+      // the cached levels may belong to another image type
+      for (unsigned int level = 0; level < cachedLevels.size(); ++level)
+      {
+        TImage *levelImage = dynamic_cast<TImage *>(cachedLevels[level].GetPointer());
+        if (levelImage == nullptr)
+          break;
+        levels.push_back(levelImage);
+      }
+
+      if (levels.size() == numberOfLevels)
+        return levels;
+
+      levels.clear();
+    }
+
+    typename TImage::Pointer referenceImage = TImage::New();
+    mitk::CastToItkImage(m_ReferenceImage, referenceImage);
+
+    if (numberOfLevels > 1)
+    {
+      typedef itk::RecursiveMultiResolutionPyramidImageFilter<TImage, TImage> PyramidType;
+      typename PyramidType::Pointer pyramid = PyramidType::New();
+      pyramid->SetInput(referenceImage);
+      pyramid->SetNumberOfLevels(numberOfLevels);
+      pyramid->SetNumberOfThreads(this->GetNumberOfThreads());
+      pyramid->Update();
+
+      for (unsigned int level = 0; level < numberOfLevels; ++level)
+      {
+        typename TImage::Pointer levelImage = pyramid->GetOutput(level);
+        levelImage->DisconnectPipeline();
+        levels.push_back(levelImage);
+      }
+    }
+    else
+    {
+      levels.push_back(referenceImage);
+    }
+
+    SetCachedPyramid(m_ReferenceImage,
+                     numberOfLevels,
+                     std::vector<itk::DataObject::Pointer>(levels.begin(), levels.end()));
+    return levels;
+  }
+
+  template <typename TRegistrationFilter>
+  void RegistrationBase::OnPDEIteration(itk::Object *caller, const itk::EventObject &)
+  {
+    TRegistrationFilter *filter = dynamic_cast<TRegistrationFilter *>(caller);
+    if (filter == nullptr)
+      return;
+
+    this->AddIteration(m_CurrentLevel, filter->GetElapsedIterations() - 1, filter->GetMetric());
+
+    if (this->GetCanceled())
+    {
+      filter->StopRegistration();
+    }
+  }
+
+  template <typename TRegistrationFilter>
+  typename TRegistrationFilter::DisplacementFieldType::Pointer RegistrationBase::RunPDERegistration(
+    const typename TRegistrationFilter::MovingImageType *movingImage, unsigned int iterations, float standardDeviation)
+  {
+    typedef typename TRegistrationFilter::FixedImageType FixedImageType;
+    typedef typename TRegistrationFilter::MovingImageType MovingImageType;
+    typedef typename TRegistrationFilter::DisplacementFieldType DisplacementFieldType;
+    typedef itk::VectorResampleImageFilter<DisplacementFieldType, DisplacementFieldType> FieldResamplerType;
+
+    const unsigned int numberOfLevels = m_NumberOfLevels > 0 ? m_NumberOfLevels : 1;
+
+    std::vector<typename FixedImageType::Pointer> fixedLevels =
+      this->GetReferencePyramid<FixedImageType>(numberOfLevels);
+
+    std::vector<typename MovingImageType::ConstPointer> movingLevels;
+    if (numberOfLevels > 1)
+    {
+      typedef itk::RecursiveMultiResolutionPyramidImageFilter<MovingImageType, MovingImageType> PyramidType;
+      typename PyramidType::Pointer pyramid = PyramidType::New();
+      pyramid->SetInput(movingImage);
+      pyramid->SetNumberOfLevels(numberOfLevels);
+      pyramid->SetNumberOfThreads(this->GetNumberOfThreads());
+      pyramid->Update();
+
+      for (unsigned int level = 0; level < numberOfLevels; ++level)
+      {
+        movingLevels.push_back(pyramid->GetOutput(level));
+      }
+    }
+    else
+    {
+      movingLevels.push_back(movingImage);
+    }
+
+    itk::ReceptorMemberCommand<RegistrationBase>::Pointer progressCommand =
+      itk::ReceptorMemberCommand<RegistrationBase>::New();
+    progressCommand->SetCallbackFunction(this, &RegistrationBase::SetProgress);
+
+    itk::MemberCommand<RegistrationBase>::Pointer iterationCommand =
+      itk::MemberCommand<RegistrationBase>::New();
+    iterationCommand->SetCallbackFunction(this, &RegistrationBase::OnPDEIteration<TRegistrationFilter>);
+
+    this->StartIterations();
+
+    typename DisplacementFieldType::Pointer field;
+    unsigned int level = 0;
+
+    for (; level < numberOfLevels; ++level)
+    {
+      // the first level always runs, it stops after one iteration if the registration was canceled before
+      if (level > 0 && this->GetCanceled())
+        break;
+
+      m_CurrentLevel = level;
+
+      typename TRegistrationFilter::Pointer filter = TRegistrationFilter::New();
+      filter->AddObserver(itk::IterationEvent(), progressCommand);
+      filter->AddObserver(itk::IterationEvent(), iterationCommand);
+      filter->SetFixedImage(fixedLevels[level]);
+      filter->SetMovingImage(movingLevels[level]);
+      filter->SetNumberOfIterations(iterations);
+      filter->SetStandardDeviations(standardDeviation);
+      filter->SetMaximumRMSError(m_ConvergenceThreshold);
+      filter->SetNumberOfThreads(this->GetNumberOfThreads());
+
+      if (field.IsNotNull())
+      {
+        // start with the field of the coarser level
+        typename FieldResamplerType::Pointer resampler = FieldResamplerType::New();
+        resampler->SetInput(field);
+        resampler->SetOutputOrigin(fixedLevels[level]->GetOrigin());
+        resampler->SetOutputSpacing(fixedLevels[level]->GetSpacing());
+        resampler->SetOutputDirection(fixedLevels[level]->GetDirection());
+        resampler->SetOutputStartIndex(fixedLevels[level]->GetLargestPossibleRegion().GetIndex());
+        resampler->SetSize(fixedLevels[level]->GetLargestPossibleRegion().GetSize());
+        resampler->Update();
+        filter->SetInitialDisplacementField(resampler->GetOutput());
+      }
+
+      filter->Update();
+
+      field = filter->GetOutput();
+      field->DisconnectPipeline();
+    }
+
+    // a canceled registration may have stopped on a coarser level
+    if (field.IsNotNull() && level < numberOfLevels)
+    {
+      const FixedImageType *finestLevel = fixedLevels.back();
+
+      typename FieldResamplerType::Pointer resampler = FieldResamplerType::New();
+      resampler->SetInput(field);
+      resampler->SetOutputOrigin(finestLevel->GetOrigin());
+      resampler->SetOutputSpacing(finestLevel->GetSpacing());
+      resampler->SetOutputDirection(finestLevel->GetDirection());
+      resampler->SetOutputStartIndex(finestLevel->GetLargestPossibleRegion().GetIndex());
+      resampler->SetSize(finestLevel->GetLargestPossibleRegion().GetSize());
+      resampler->Update();
+
+      field = resampler->GetOutput();
+      field->DisconnectPipeline();
+    }
+
+    this->FinishIterations();
+    return field;
+  }
+}
+
+#endif
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkInverseDisplacementFieldImageFilter.h"
 
 #include "mitkSymmetricForcesDemonsRegistration.h"
+#include "mitkRegistrationBase.txx"
 
 namespace mitk
 {
@@ -55,12 +56,10 @@ namespace mitk
   template <typename TPixel, unsigned int VImageDimension>
   void SymmetricForcesDemonsRegistration::GenerateData2(const itk::Image<TPixel, VImageDimension> *itkImage1)
   {
-    typedef typename itk::Image<TPixel, VImageDimension> FixedImageType;
     typedef typename itk::Image<TPixel, VImageDimension> MovingImageType;
 
     typedef float InternalPixelType;
     typedef typename itk::Image<InternalPixelType, VImageDimension> InternalImageType;
-    typedef typename itk::CastImageFilter<FixedImageType, InternalImageType> FixedImageCasterType;
     typedef typename itk::CastImageFilter<MovingImageType, InternalImageType> MovingImageCasterType;
     typedef typename itk::Vector<float, VImageDimension> VectorPixelType;
     typedef typename itk::Image<VectorPixelType, VImageDimension> DeformationFieldType;
@@ -76,38 +75,31 @@ namespace mitk
     typedef typename itk::ImageFileWriter<OutputImageType> WriterType;
     typedef typename itk::ImageFileWriter<DeformationFieldType> FieldWriterType;
 
-    typename FixedImageType::Pointer fixedImage = FixedImageType::New();
-    mitk::CastToItkImage(m_ReferenceImage, fixedImage);
     typename MovingImageType::ConstPointer movingImage = itkImage1;
 
-    if (fixedImage.IsNotNull() && movingImage.IsNotNull())
+    if (m_ReferenceImage.IsNotNull() && movingImage.IsNotNull())
     {
-      typename RegistrationFilterType::Pointer filter = RegistrationFilterType::New();
-
       this->AddStepsToDo(4);
-      itk::ReceptorMemberCommand<SymmetricForcesDemonsRegistration>::Pointer command =
-        itk::ReceptorMemberCommand<SymmetricForcesDemonsRegistration>::New();
-      command->SetCallbackFunction(this, &SymmetricForcesDemonsRegistration::SetProgress);
-      filter->AddObserver(itk::IterationEvent(), command);
-
-      typename FixedImageCasterType::Pointer fixedImageCaster = FixedImageCasterType::New();
-      fixedImageCaster->SetInput(fixedImage);
-      filter->SetFixedImage(fixedImageCaster->GetOutput());
+
+      // the reference image is cast and downsampled by RunPDERegistration (and cached for later registrations)
       typename MovingImageCasterType::Pointer movingImageCaster = MovingImageCasterType::New();
       movingImageCaster->SetInput(movingImage);
-      filter->SetMovingImage(movingImageCaster->GetOutput());
-      filter->SetNumberOfIterations(m_Iterations);
-      filter->SetStandardDeviations(m_StandardDeviation);
-      filter->Update();
+      movingImageCaster->SetNumberOfThreads(this->GetNumberOfThreads());
+      movingImageCaster->Update();
+
+      typename DeformationFieldType::Pointer field =
+        this->RunPDERegistration<RegistrationFilterType>(movingImageCaster->GetOutput(), m_Iterations, m_StandardDeviation);
 
       typename WarperType::Pointer warper = WarperType::New();
       typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
 
       warper->SetInput(movingImage);
       warper->SetInterpolator(interpolator);
-      warper->SetOutputSpacing(fixedImage->GetSpacing());
-      warper->SetOutputOrigin(fixedImage->GetOrigin());
-      warper->SetDisplacementField(filter->GetOutput());
+      warper->SetOutputSpacing(field->GetSpacing());
+      warper->SetOutputOrigin(field->GetOrigin());
+      warper->SetOutputDirection(field->GetDirection());
+      warper->SetDisplacementField(field);
+      warper->SetNumberOfThreads(this->GetNumberOfThreads());
       warper->Update();
       typename WriterType::Pointer writer = WriterType::New();
       typename CastFilterType::Pointer caster = CastFilterType::New();
@@ -128,7 +120,7 @@ namespace mitk
         typedef DeformationFieldType VectorImage2DType;
         typedef typename DeformationFieldType::PixelType Vector2DType;
 
-        typename VectorImage2DType::ConstPointer vectorImage2D = filter->GetOutput();
+        typename VectorImage2DType::ConstPointer vectorImage2D = field;
 
         typename VectorImage2DType::RegionType region2D = vectorImage2D->GetBufferedRegion();
         typename VectorImage2DType::IndexType index2D = region2D.GetIndex();
@@ -216,9 +208,8 @@ namespace mitk
       {
         typename FieldWriterType::Pointer fieldwriter = FieldWriterType::New();
         fieldwriter->SetFileName(m_FieldName);
-        fieldwriter->SetInput(filter->GetOutput());
-        // m_DeformationField = filter->GetOutput();
-        m_DeformationField = (itk::Image<itk::Vector<float, 3>, 3> *)(filter->GetOutput()); // see BUG #3732
+        fieldwriter->SetInput(field);
+        m_DeformationField = (itk::Image<itk::Vector<float, 3>, 3> *)(field.GetPointer()); // see BUG #3732
         if (m_SaveField)
         {
           fieldwriter->Update();
@@ -17,11 +17,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "QmitkDemonsRegistrationView.h"
 #include "itkRegularStepGradientDescentOptimizer.h"
 #include "mitkITKImageImport.h"
-#include "mitkProgressBar.h"
 #include "ui_QmitkDemonsRegistrationViewControls.h"
 #include <mitkImageCast.h>
 #include <mitkLevelWindowProperty.h>
 #include <mitkRenderingManager.h>
+#include <QtConcurrentRun>
 #include <qfiledialog.h>
 #include <qmessagebox.h>
 #include <qvalidator.h>
@@ -48,10 +48,17 @@ QmitkDemonsRegistrationView::QmitkDemonsRegistrationView(QWidget *parent, Qt::Wi
 
   QValidator *validatorStandardDeviation = new QDoubleValidator(0, 20000000, 2, this);
   m_Controls.m_StandardDeviation->setValidator(validatorStandardDeviation);
+
+  connect(&m_Watcher, SIGNAL(finished()), this, SLOT(RegistrationFinished()));
 }
 
 QmitkDemonsRegistrationView::~QmitkDemonsRegistrationView()
 {
+  if (m_Watcher.isRunning())
+  {
+    m_Registration->Cancel();
+    m_Watcher.waitForFinished();
+  }
 }
 
 int QmitkDemonsRegistrationView::GetNumberOfIterations()
@@ -74,9 +81,14 @@ mitk::Image::Pointer QmitkDemonsRegistrationView::GetResultDeformationfield()
   return m_ResultDeformationField;
 }
 
+bool QmitkDemonsRegistrationView::IsCalculating() const
+{
+  return m_Watcher.isRunning();
+}
+
 void QmitkDemonsRegistrationView::CalculateTransformation()
 {
-  if (m_FixedNode.IsNotNull() && m_MovingNode.IsNotNull())
+  if (m_FixedNode.IsNotNull() && m_MovingNode.IsNotNull() && !m_Watcher.isRunning())
   {
     mitk::Image::Pointer fimage = dynamic_cast<mitk::Image *>(m_FixedNode->GetData());
     mitk::Image::Pointer mimage = dynamic_cast<mitk::Image *>(m_MovingNode->GetData());
@@ -95,94 +107,114 @@ void QmitkDemonsRegistrationView::CalculateTransformation()
       mitk::DemonsRegistration::Pointer registration = mitk::DemonsRegistration::New();
       registration->SetSaveDeformationField(false);
       registration->SetSaveResult(false);
-      registration->SetReferenceImage(fimage);
       registration->SetNumberOfIterations(atoi(m_Controls.m_Iterations->text().toLatin1()));
       registration->SetStandardDeviation(atof(m_Controls.m_StandardDeviation->text().toLatin1()));
-      if (m_Controls.m_UseHistogramMatching->isChecked())
-      {
-        mitk::HistogramMatching::Pointer histogramMatching = mitk::HistogramMatching::New();
-        histogramMatching->SetReferenceImage(fimage);
-        histogramMatching->SetInput(mimage);
-        histogramMatching->SetNumberOfHistogramLevels(atoi(m_Controls.m_NumberOfHistogramLevels->text().toLatin1()));
-        histogramMatching->SetNumberOfMatchPoints(atoi(m_Controls.m_NumberOfMatchPoints->text().toLatin1()));
-        histogramMatching->SetThresholdAtMeanIntensity(m_Controls.m_ThresholdAtMeanIntensity->isChecked());
-        histogramMatching->Update();
-        mitk::Image::Pointer histimage = histogramMatching->GetOutput();
-        if (histimage.IsNotNull())
-        {
-          registration->SetInput(histimage);
-        }
-        else
-        {
-          registration->SetInput(mimage);
-        }
-      }
-      else
-      {
-        registration->SetInput(mimage);
-      }
-      try
-      {
-        registration->Update();
-      }
-      catch (itk::ExceptionObject &excpt)
-      {
-        QMessageBox::information(this, "Registration exception", excpt.GetDescription(), QMessageBox::Ok);
-        mitk::ProgressBar::GetInstance()->Progress(4);
-        return;
-      }
-      m_ResultImage = registration->GetOutput();
-      typedef itk::Image<itk::Vector<float, 3>, 3> VectorImageType;
-      VectorImageType::Pointer deformationField = registration->GetDeformationField();
-      m_ResultDeformationField = mitk::ImportItkImage(deformationField)->Clone();
+      m_Registration = registration;
     }
     else if (m_Controls.m_RegistrationSelection->currentIndex() == 1)
     {
       mitk::SymmetricForcesDemonsRegistration::Pointer registration = mitk::SymmetricForcesDemonsRegistration::New();
       registration->SetSaveDeformationField(false);
       registration->SetSaveResult(false);
-      registration->SetReferenceImage(fimage);
       registration->SetNumberOfIterations(atoi(m_Controls.m_Iterations->text().toLatin1()));
       registration->SetStandardDeviation(atof(m_Controls.m_StandardDeviation->text().toLatin1()));
-      if (m_Controls.m_UseHistogramMatching->isChecked())
-      {
-        mitk::HistogramMatching::Pointer histogramMatching = mitk::HistogramMatching::New();
-        histogramMatching->SetReferenceImage(fimage);
-        histogramMatching->SetInput(mimage);
-        histogramMatching->SetNumberOfHistogramLevels(atoi(m_Controls.m_NumberOfHistogramLevels->text().toLatin1()));
-        histogramMatching->SetNumberOfMatchPoints(atoi(m_Controls.m_NumberOfMatchPoints->text().toLatin1()));
-        histogramMatching->SetThresholdAtMeanIntensity(m_Controls.m_ThresholdAtMeanIntensity->isChecked());
-        histogramMatching->Update();
-        mitk::Image::Pointer histimage = histogramMatching->GetOutput();
-        if (histimage.IsNotNull())
-        {
-          registration->SetInput(histimage);
-        }
-        else
-        {
-          registration->SetInput(mimage);
-        }
-      }
-      else
-      {
-        registration->SetInput(mimage);
-      }
-      try
-      {
-        registration->Update();
-      }
-      catch (itk::ExceptionObject &excpt)
-      {
-        QMessageBox::information(this, "Registration exception", excpt.GetDescription(), QMessageBox::Ok);
-        mitk::ProgressBar::GetInstance()->Progress(4);
-        return;
-      }
-      m_ResultImage = registration->GetOutput();
-      typedef itk::Image<itk::Vector<float, 3>, 3> VectorImageType;
-      VectorImageType::Pointer deformationField = registration->GetDeformationField();
+      m_Registration = registration;
+    }
+    else
+    {
+      return;
+    }
+    // the progress bar must only be used by the GUI thread
+    m_Registration->UseProgressBarOff();
+    m_Registration->SetReferenceImage(fimage);
+
+    m_HistogramMatching = nullptr;
+    if (m_Controls.m_UseHistogramMatching->isChecked())
+    {
+      m_HistogramMatching = mitk::HistogramMatching::New();
+      m_HistogramMatching->SetReferenceImage(fimage);
+      m_HistogramMatching->SetInput(mimage);
+      m_HistogramMatching->SetNumberOfHistogramLevels(atoi(m_Controls.m_NumberOfHistogramLevels->text().toLatin1()));
+      m_HistogramMatching->SetNumberOfMatchPoints(atoi(m_Controls.m_NumberOfMatchPoints->text().toLatin1()));
+      m_HistogramMatching->SetThresholdAtMeanIntensity(m_Controls.m_ThresholdAtMeanIntensity->isChecked());
+    }
+
+    m_MovingImage = mimage;
+    m_ResultImage = nullptr;
+    m_ResultDeformationField = nullptr;
+    m_ErrorMessage.clear();
+
+    m_Watcher.setFuture(QtConcurrent::run(this, &QmitkDemonsRegistrationView::RunRegistration));
+  }
+}
+
+void QmitkDemonsRegistrationView::CancelTransformation()
+{
+  if (m_Watcher.isRunning())
+  {
+    m_Registration->Cancel();
+  }
+}
+
+void QmitkDemonsRegistrationView::RunRegistration()
+{
+  try
+  {
+    mitk::Image::Pointer histimage;
+    if (m_HistogramMatching.IsNotNull())
+    {
+      m_HistogramMatching->Update();
+      histimage = m_HistogramMatching->GetOutput();
+    }
+    if (histimage.IsNotNull())
+    {
+      m_Registration->SetInput(histimage);
+    }
+    else
+    {
+      m_Registration->SetInput(m_MovingImage);
+    }
+    m_Registration->Update();
+  }
+  catch (itk::ExceptionObject &excpt)
+  {
+    m_ErrorMessage = excpt.GetDescription();
+  }
+}
+
+void QmitkDemonsRegistrationView::RegistrationFinished()
+{
+  if (m_ErrorMessage.empty())
+  {
+    typedef itk::Image<itk::Vector<float, 3>, 3> VectorImageType;
+    VectorImageType::Pointer deformationField;
+    if (mitk::DemonsRegistration *registration = dynamic_cast<mitk::DemonsRegistration *>(m_Registration.GetPointer()))
+    {
+      deformationField = registration->GetDeformationField();
+    }
+    else if (mitk::SymmetricForcesDemonsRegistration *registration =
+               dynamic_cast<mitk::SymmetricForcesDemonsRegistration *>(m_Registration.GetPointer()))
+    {
+      deformationField = registration->GetDeformationField();
+    }
+    m_ResultImage = m_Registration->GetOutput();
+    if (deformationField.IsNotNull())
+    {
       m_ResultDeformationField = mitk::ImportItkImage(deformationField)->Clone();
     }
   }
+
+  // release the images of the registration
+  m_Registration = nullptr;
+  m_HistogramMatching = nullptr;
+  m_MovingImage = nullptr;
+
+  if (!m_ErrorMessage.empty())
+  {
+    QMessageBox::information(this, "Registration exception", QString::fromStdString(m_ErrorMessage), QMessageBox::Ok);
+  }
+
+  emit transformationCalculated();
 }
 
 void QmitkDemonsRegistrationView::SetFixedNode(mitk::DataNode *fixedNode)
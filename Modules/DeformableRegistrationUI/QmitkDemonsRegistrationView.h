@@ -21,10 +21,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDataNode.h"
 #include "ui_QmitkDemonsRegistrationViewControls.h"
 
+#include <QFutureWatcher>
+
 /*!
 * \brief Widget for deformable demons registration
 *
-* Displays options for demons registration.
+* Displays options for demons registration. The registration runs in a background thread, see
+* CalculateTransformation().
 */
 class MITKDEFORMABLEREGISTRATIONUI_EXPORT QmitkDemonsRegistrationView : public QWidget
 {
@@ -43,15 +46,49 @@ public:
   mitk::Image::Pointer GetResultImage();
   mitk::Image::Pointer GetResultDeformationfield();
 
+  /*!
+  * \brief Returns true while a registration started by CalculateTransformation() is running.
+  */
+  bool IsCalculating() const;
+
 public slots:
+  /*!
+  * \brief Starts the registration of the moving node onto the fixed node in a background thread.
+  *
+  * transformationCalculated() is emitted when the registration is finished. Then the results are available
+  * by GetResultImage() and GetResultDeformationfield(), which return NULL if the registration failed.
+  */
   void CalculateTransformation();
 
+  /*!
+  * \brief Stops a running registration after its current iteration. The result of the iterations done so far
+  * is used.
+  */
+  void CancelTransformation();
+
+signals:
+  void transformationCalculated();
+
+protected slots:
+  void RegistrationFinished();
+
 protected:
+  /*!
+  * \brief Runs the histogram matching (if any) and the registration. Called in a background thread.
+  */
+  void RunRegistration();
+
   Ui::QmitkDemonsRegistrationViewControls m_Controls;
   mitk::DataNode::Pointer m_FixedNode;
   mitk::DataNode::Pointer m_MovingNode;
   mitk::Image::Pointer m_ResultImage;
   mitk::Image::Pointer m_ResultDeformationField;
+
+  mitk::RegistrationBase::Pointer m_Registration;
+  mitk::HistogramMatching::Pointer m_HistogramMatching;
+  mitk::Image::Pointer m_MovingImage;
+  std::string m_ErrorMessage;
+  QFutureWatcher<void> m_Watcher;
 };
 
 #endif
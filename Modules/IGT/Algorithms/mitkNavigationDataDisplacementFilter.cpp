@@ -55,6 +55,19 @@ void mitk::NavigationDataDisplacementFilter::GenerateData()
 }
 
 
+bool mitk::NavigationDataDisplacementFilter::ProcessSamples(unsigned int /*idx*/, NavigationDataSample* samples, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (!samples[i].DataValid)
+      continue;
+    for (unsigned int j = 0; j < 3; ++j)
+      samples[i].Position[j] += m_Offset[j];
+  }
+  return true;
+}
+
+
 void mitk::NavigationDataDisplacementFilter::SetParameters( const mitk::PropertyList* p )
 {
   if (p == NULL)
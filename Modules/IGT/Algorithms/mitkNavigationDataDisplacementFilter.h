@@ -59,6 +59,11 @@ namespace mitk
     */
     mitk::PropertyList::ConstPointer GetParameters() const override;
 
+    /**
+    *\brief adds the offset to the positions of the samples
+    */
+    virtual bool ProcessSamples(unsigned int idx, NavigationDataSample* samples, unsigned int count) override;
+
   protected:
     NavigationDataDisplacementFilter();
     virtual ~NavigationDataDisplacementFilter();
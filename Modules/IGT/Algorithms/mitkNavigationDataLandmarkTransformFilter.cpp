@@ -38,6 +38,8 @@ m_QuatLandmarkTransform(NULL), m_QuatTransform(NULL), m_Errors(), m_UseICPInitia
   //transform to rotate orientation
   m_QuatLandmarkTransform = QuaternionTransformType::New();
   m_QuatTransform = QuaternionTransformType::New();
+  m_SampleQuatLandmarkTransform = QuaternionTransformType::New();
+  m_SampleQuatTransform = QuaternionTransformType::New();
 }
 
 
@@ -47,6 +49,8 @@ mitk::NavigationDataLandmarkTransformFilter::~NavigationDataLandmarkTransformFil
   m_LandmarkTransformInitializer = NULL;
   m_QuatLandmarkTransform = NULL;
   m_QuatTransform = NULL;
+  m_SampleQuatLandmarkTransform = NULL;
+  m_SampleQuatTransform = NULL;
 }
 
 
@@ -186,8 +190,6 @@ void mitk::NavigationDataLandmarkTransformFilter::GenerateData()
 {
   this->CreateOutputsForAllInputs(); // make sure that we have the same number of outputs as inputs
 
-  TransformInitializerType::LandmarkPointType lPointIn, lPointOut;
-
   /* update outputs with tracking data from tools */
   for (unsigned int i = 0; i < this->GetNumberOfOutputs() ; ++i)
   {
@@ -206,36 +208,67 @@ void mitk::NavigationDataLandmarkTransformFilter::GenerateData()
     if (this->IsInitialized() == false) // as long as there is no valid transformation matrix, only graft the outputs
       continue;
 
-    mitk::NavigationData::PositionType tempCoordinate;
-    tempCoordinate = input->GetPosition();
-    lPointIn[0] = tempCoordinate[0]; // convert navigation data position to transform point
-    lPointIn[1] = tempCoordinate[1];
-    lPointIn[2] = tempCoordinate[2];
-
-    /* transform position */
-    lPointOut = m_LandmarkTransform->TransformPoint(lPointIn); // transform position
-    tempCoordinate[0] = lPointOut[0];  // convert back into navigation data position
-    tempCoordinate[1] = lPointOut[1];
-    tempCoordinate[2] = lPointOut[2];
-    output->SetPosition(tempCoordinate); // update output navigation data with new position
-
-    /* transform orientation */
-    NavigationData::OrientationType  quatIn = input->GetOrientation();
-    vnl_quaternion<double> const vnlQuatIn(quatIn.x(), quatIn.y(), quatIn.z(), quatIn.r());  // convert orientation into vnl quaternion
-    m_QuatTransform->SetRotation(vnlQuatIn);  // convert orientation into transform
+    mitk::NavigationData::PositionType tempCoordinate = input->GetPosition();
+    NavigationData::OrientationType quatIn = input->GetOrientation();
+    double position[3] = { tempCoordinate[0], tempCoordinate[1], tempCoordinate[2] };
+    double orientation[4] = { quatIn.x(), quatIn.y(), quatIn.z(), quatIn.r() };
 
-    m_QuatLandmarkTransform->SetMatrix(m_LandmarkTransform->GetMatrix());
+    this->TransformPose(m_QuatTransform, m_QuatLandmarkTransform, position, orientation);
 
-    m_QuatLandmarkTransform->Compose(m_QuatTransform, true); // compose navigation data transform and landmark transform
+    tempCoordinate[0] = position[0];  // convert back into navigation data position
+    tempCoordinate[1] = position[1];
+    tempCoordinate[2] = position[2];
+    output->SetPosition(tempCoordinate); // update output navigation data with new position
 
-    vnl_quaternion<double> vnlQuatOut = m_QuatLandmarkTransform->GetRotation();  // convert composed transform back into a quaternion
-    NavigationData::OrientationType quatOut(vnlQuatOut[0], vnlQuatOut[1], vnlQuatOut[2], vnlQuatOut[3]); // convert back into navigation data orientation
+    NavigationData::OrientationType quatOut(orientation[0], orientation[1], orientation[2], orientation[3]); // convert back into navigation data orientation
     output->SetOrientation(quatOut); // update output navigation data with new orientation
     output->SetDataValid(true); // operation was successful, therefore data of output is valid.
   }
 }
 
 
+bool mitk::NavigationDataLandmarkTransformFilter::ProcessSamples(unsigned int /*idx*/, NavigationDataSample* samples, unsigned int count)
+{
+  if (this->IsInitialized() == false) // as long as there is no valid transformation matrix, the samples pass unchanged
+    return true;
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (samples[i].DataValid)
+      this->TransformPose(m_SampleQuatTransform, m_SampleQuatLandmarkTransform, samples[i].Position, samples[i].Orientation);
+  }
+  return true;
+}
+
+
+void mitk::NavigationDataLandmarkTransformFilter::TransformPose(QuaternionTransformType* quatTransform,
+  QuaternionTransformType* quatLandmarkTransform, double position[3], double orientation[4]) const
+{
+  TransformInitializerType::LandmarkPointType lPointIn, lPointOut;
+  lPointIn[0] = position[0]; // convert navigation data position to transform point
+  lPointIn[1] = position[1];
+  lPointIn[2] = position[2];
+
+  /* transform position */
+  lPointOut = m_LandmarkTransform->TransformPoint(lPointIn); // transform position
+  position[0] = lPointOut[0];
+  position[1] = lPointOut[1];
+  position[2] = lPointOut[2];
+
+  /* transform orientation */
+  vnl_quaternion<double> const vnlQuatIn(orientation[0], orientation[1], orientation[2], orientation[3]);  // convert orientation into vnl quaternion
+  quatTransform->SetRotation(vnlQuatIn);  // convert orientation into transform
+
+  quatLandmarkTransform->SetMatrix(m_LandmarkTransform->GetMatrix());
+
+  quatLandmarkTransform->Compose(quatTransform, true); // compose navigation data transform and landmark transform
+
+  vnl_quaternion<double> vnlQuatOut = quatLandmarkTransform->GetRotation();  // convert composed transform back into a quaternion
+  for (unsigned int i = 0; i < 4; ++i)
+    orientation[i] = vnlQuatOut[i];
+}
+
+
 bool mitk::NavigationDataLandmarkTransformFilter::IsInitialized() const
 {
   return (m_SourcePoints.size() >= 3) && (m_TargetPoints.size() >= 3);
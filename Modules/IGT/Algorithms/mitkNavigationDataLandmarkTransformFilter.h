@@ -115,6 +115,13 @@ namespace mitk {
 
     itkGetConstObjectMacro(LandmarkTransform, LandmarkTransformType);  ///< returns the current landmark transform
 
+    /**
+    *\brief transforms the samples, see NavigationDataToNavigationDataFilter::ProcessSamples()
+    *
+    * As long as the filter is not initialized, the samples are not changed.
+    */
+    virtual bool ProcessSamples(unsigned int idx, NavigationDataSample* samples, unsigned int count) override;
+
   protected:
     typedef itk::Image< signed short, 3>  ImageType;       // only because itk::LandmarkBasedTransformInitializer must be templated over two imagetypes
 
@@ -134,6 +141,14 @@ namespace mitk {
     */
     virtual void GenerateData() override;
 
+    /**
+    * \brief applies the landmark transform to the pose given by position and orientation (in place)
+    *
+    * quatTransform and quatLandmarkTransform are overwritten, so that no transform has to be created per pose.
+    */
+    void TransformPose(QuaternionTransformType* quatTransform, QuaternionTransformType* quatLandmarkTransform,
+      double position[3], double orientation[4]) const;
+
     /**Documentation
     * \brief perform an iterative closest point matching to find corresponding landmarks that will be used for landmark transform calculation
     *
@@ -180,6 +195,8 @@ namespace mitk {
 
     QuaternionTransformType::Pointer m_QuatLandmarkTransform; ///< transform needed to rotate orientation
     QuaternionTransformType::Pointer m_QuatTransform;         ///< further transform needed to rotate orientation
+    QuaternionTransformType::Pointer m_SampleQuatLandmarkTransform; ///< m_QuatLandmarkTransform of ProcessSamples()
+    QuaternionTransformType::Pointer m_SampleQuatTransform;         ///< m_QuatTransform of ProcessSamples()
 
     ErrorVector m_Errors; ///< stores the euclidean distance of each transformed source landmark and its respective target landmark
     bool m_UseICPInitialization; ///< find source <--> target point correspondences with iterative closest point optimization
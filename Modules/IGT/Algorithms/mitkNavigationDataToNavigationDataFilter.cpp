@@ -31,6 +31,12 @@ mitk::NavigationDataToNavigationDataFilter::~NavigationDataToNavigationDataFilte
 }
 
 
+bool mitk::NavigationDataToNavigationDataFilter::ProcessSamples(unsigned int /*idx*/, NavigationDataSample* /*samples*/, unsigned int /*count*/)
+{
+  return false;
+}
+
+
 void mitk::NavigationDataToNavigationDataFilter::SetInput( const NavigationData* nd )
 {
   this->SetInput(0, nd);
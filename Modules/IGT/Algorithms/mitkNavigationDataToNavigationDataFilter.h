@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define MITKNNAVIGATIONDATATONAVIGATIONDATAFILTER_H_HEADER_INCLUDED_
 
 #include <mitkNavigationDataSource.h>
+#include <mitkNavigationDataSample.h>
 
 namespace mitk
 {
@@ -93,6 +94,21 @@ namespace mitk
   */
   virtual void ConnectTo(mitk::NavigationDataSource * UpstreamFilter);
 
+  /**
+  *\brief Applies this filter in place to a batch of samples of the input with index idx,
+  * bypassing the ITK pipeline.
+  *
+  * This is the lightweight path for high tracking rates (see mitk::TrackingDeviceSource::AcquireSamples()):
+  * the samples of a tool are passed through the filters one after the other by calling this method
+  * of each filter. Filters that support it do not allocate memory and may process samples in another
+  * thread than the one calling Update(), as long as their parameters are not changed meanwhile.
+  * Invalid samples are not changed.
+  *
+  * \return false if this filter does not support samples, in which case the samples are not changed.
+  * The default implementation returns false.
+  */
+  virtual bool ProcessSamples(unsigned int idx, NavigationDataSample* samples, unsigned int count);
+
   protected:
     NavigationDataToNavigationDataFilter();
     virtual ~NavigationDataToNavigationDataFilter();
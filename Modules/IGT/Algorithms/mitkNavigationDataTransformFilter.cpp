@@ -22,6 +22,8 @@ mitk::NavigationDataTransformFilter::NavigationDataTransformFilter()
 {
   m_Rigid3DTransform = NULL;
   m_Precompose = false;
+  m_ComposedTransform = TransformType::New();
+  m_SampleComposedTransform = TransformType::New();
 }
 
 
@@ -57,33 +59,18 @@ void mitk::NavigationDataTransformFilter::GenerateData()
         continue;
       }
 
-      // Get input position/orientation as float numbers
+      // Cast the input NavigationData to double precision
       const NavigationData::PositionType    pInF = input->GetPosition();
       const NavigationData::OrientationType oInF = input->GetOrientation();
+      double position[3] = { pInF[0], pInF[1], pInF[2] };
+      double orientation[4] = { oInF.x(), oInF.y(), oInF.z(), oInF.r() };
 
-      // Cast the input NavigationData to double precision
-      TransformType::OutputVectorType pInD;
-      FillVector3D(pInD, pInF[0], pInF[1], pInF[2]);
-      TransformType::VersorType oInD;
-      oInD.Set(oInF.x(), oInF.y(), oInF.z(), oInF.r());
-
-      TransformType::Pointer composedTransform = TransformType::New();
-      // SetRotation+SetOffset defines the Tip-to-World coordinate frame
-      // transformation ("World" is used in the generic sense)
-      composedTransform->SetRotation(oInD);
-      composedTransform->SetOffset(pInD);
-      // If !m_Precompose: The resulting transform is Tip-to-UserWorld
-      // If m_Precompose:  The resulting transform is UserTip-to-World
-      composedTransform->Compose(m_Rigid3DTransform, m_Precompose);
-
-      // Transformed position/orientation as double numbers
-      const TransformType::OutputVectorType  pOutD = composedTransform->GetOffset();
-      const TransformType::VersorType        oOutD = composedTransform->GetVersor();
+      this->TransformPose(m_ComposedTransform, position, orientation);
 
       // Cast to transformed NavigationData back to float precision
-      NavigationData::OrientationType oOutF(oOutD.GetX(), oOutD.GetY(), oOutD.GetZ(), oOutD.GetW());
+      NavigationData::OrientationType oOutF(orientation[0], orientation[1], orientation[2], orientation[3]);
       NavigationData::PositionType pOutF;
-      FillVector3D(pOutF, pOutD[0], pOutD[1], pOutD[2]);
+      FillVector3D(pOutF, position[0], position[1], position[2]);
 
       output->SetOrientation(oOutF);
       output->SetPosition(pOutF);
@@ -91,3 +78,46 @@ void mitk::NavigationDataTransformFilter::GenerateData()
     }
   }
 }
+
+bool mitk::NavigationDataTransformFilter::ProcessSamples(unsigned int /*idx*/, NavigationDataSample* samples, unsigned int count)
+{
+  if (m_Rigid3DTransform.IsNull())
+  {
+    itkExceptionMacro("Invalid parameter: Transform was not set!  Use SetRigid3DTransform() before processing samples.");
+  }
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (samples[i].DataValid)
+      this->TransformPose(m_SampleComposedTransform, samples[i].Position, samples[i].Orientation);
+  }
+  return true;
+}
+
+void mitk::NavigationDataTransformFilter::TransformPose(TransformType* composedTransform, double position[3], double orientation[4]) const
+{
+  TransformType::OutputVectorType pInD;
+  FillVector3D(pInD, position[0], position[1], position[2]);
+  TransformType::VersorType oInD;
+  oInD.Set(orientation[0], orientation[1], orientation[2], orientation[3]);
+
+  composedTransform->SetIdentity();
+  // SetRotation+SetOffset defines the Tip-to-World coordinate frame
+  // transformation ("World" is used in the generic sense)
+  composedTransform->SetRotation(oInD);
+  composedTransform->SetOffset(pInD);
+  // If !m_Precompose: The resulting transform is Tip-to-UserWorld
+  // If m_Precompose:  The resulting transform is UserTip-to-World
+  composedTransform->Compose(m_Rigid3DTransform, m_Precompose);
+
+  // Transformed position/orientation as double numbers
+  const TransformType::OutputVectorType pOutD = composedTransform->GetOffset();
+  const TransformType::VersorType       oOutD = composedTransform->GetVersor();
+
+  for (unsigned int i = 0; i < 3; ++i)
+    position[i] = pOutD[i];
+  orientation[0] = oOutD.GetX();
+  orientation[1] = oOutD.GetY();
+  orientation[2] = oOutD.GetZ();
+  orientation[3] = oOutD.GetW();
+}
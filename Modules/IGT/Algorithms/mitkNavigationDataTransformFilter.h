@@ -69,6 +69,11 @@ namespace mitk {
     itkGetMacro(Precompose, bool);
     itkBooleanMacro(Precompose);
 
+    /**Documentation
+    * \brief transforms the samples, see NavigationDataToNavigationDataFilter::ProcessSamples()
+    */
+    virtual bool ProcessSamples(unsigned int idx, NavigationDataSample* samples, unsigned int count) override;
+
   protected:
 
     NavigationDataTransformFilter();
@@ -81,8 +86,18 @@ namespace mitk {
     */
     virtual void GenerateData() override;
 
+    /**Documentation
+    * \brief applies m_Rigid3DTransform to the pose given by position and orientation (in place)
+    *
+    * composedTransform is overwritten, so that no transform has to be created per pose.
+    */
+    void TransformPose(TransformType* composedTransform, double position[3], double orientation[4]) const;
+
     TransformType::Pointer m_Rigid3DTransform; ///< transform which will be applied on navigation data(s)
     bool m_Precompose;
+
+    TransformType::Pointer m_ComposedTransform;       ///< reused by GenerateData()
+    TransformType::Pointer m_SampleComposedTransform; ///< reused by ProcessSamples()
   };
 } // namespace mitk
 
@@ -0,0 +1,159 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#include "mitkNavigationDataLatencyStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+mitk::NavigationDataLatencyStatistics::NavigationDataLatencyStatistics()
+  : m_Samples(1000, 0.0), m_NextSample(0), m_NumberOfSamples(0), m_TotalNumberOfSamples(0)
+{
+}
+
+mitk::NavigationDataLatencyStatistics::~NavigationDataLatencyStatistics()
+{
+}
+
+void mitk::NavigationDataLatencyStatistics::SetWindowSize(unsigned int windowSize)
+{
+  if (windowSize == 0)
+  {
+    itkExceptionMacro("The window size must be greater than zero.");
+  }
+
+  m_Mutex.Lock();
+  m_Samples.assign(windowSize, 0.0);
+  m_NextSample = 0;
+  m_NumberOfSamples = 0;
+  m_TotalNumberOfSamples = 0;
+  m_Mutex.Unlock();
+
+  this->Modified();
+}
+
+unsigned int mitk::NavigationDataLatencyStatistics::GetWindowSize() const
+{
+  m_Mutex.Lock();
+  unsigned int windowSize = m_Samples.size();
+  m_Mutex.Unlock();
+  return windowSize;
+}
+
+void mitk::NavigationDataLatencyStatistics::AddSample(double latency)
+{
+  m_Mutex.Lock();
+  m_Samples[m_NextSample] = latency;
+  m_NextSample = (m_NextSample + 1) % m_Samples.size();
+  if (m_NumberOfSamples < m_Samples.size())
+  {
+    ++m_NumberOfSamples;
+  }
+  ++m_TotalNumberOfSamples;
+  m_Mutex.Unlock();
+}
+
+void mitk::NavigationDataLatencyStatistics::Reset()
+{
+  m_Mutex.Lock();
+  m_NextSample = 0;
+  m_NumberOfSamples = 0;
+  m_TotalNumberOfSamples = 0;
+  m_Mutex.Unlock();
+}
+
+unsigned int mitk::NavigationDataLatencyStatistics::GetNumberOfSamples() const
+{
+  m_Mutex.Lock();
+  unsigned int numberOfSamples = m_NumberOfSamples;
+  m_Mutex.Unlock();
+  return numberOfSamples;
+}
+
+unsigned long mitk::NavigationDataLatencyStatistics::GetTotalNumberOfSamples() const
+{
+  m_Mutex.Lock();
+  unsigned long totalNumberOfSamples = m_TotalNumberOfSamples;
+  m_Mutex.Unlock();
+  return totalNumberOfSamples;
+}
+
+double mitk::NavigationDataLatencyStatistics::GetPercentile(double percentile) const
+{
+  // the samples are copied so that the tracking thread is not blocked while sorting
+  m_Mutex.Lock();
+  std::vector<double> samples(m_Samples.begin(), m_Samples.begin() + m_NumberOfSamples);
+  m_Mutex.Unlock();
+
+  if (samples.empty())
+  {
+    return 0.0;
+  }
+
+  percentile = std::max(0.0, std::min(100.0, percentile));
+  std::size_t rank = static_cast<std::size_t>(std::ceil(percentile / 100.0 * samples.size()));
+  std::size_t index = rank > 0 ? rank - 1 : 0;
+
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+double mitk::NavigationDataLatencyStatistics::GetMedian() const
+{
+  return this->GetPercentile(50.0);
+}
+
+double mitk::NavigationDataLatencyStatistics::GetMean() const
+{
+  m_Mutex.Lock();
+  double sum = 0.0;
+  for (unsigned int i = 0; i < m_NumberOfSamples; ++i)
+  {
+    sum += m_Samples[i];
+  }
+  double mean = m_NumberOfSamples > 0 ? sum / m_NumberOfSamples : 0.0;
+  m_Mutex.Unlock();
+  return mean;
+}
+
+double mitk::NavigationDataLatencyStatistics::GetMinimum() const
+{
+  m_Mutex.Lock();
+  double minimum = m_NumberOfSamples > 0
+    ? *std::min_element(m_Samples.begin(), m_Samples.begin() + m_NumberOfSamples) : 0.0;
+  m_Mutex.Unlock();
+  return minimum;
+}
+
+double mitk::NavigationDataLatencyStatistics::GetMaximum() const
+{
+  m_Mutex.Lock();
+  double maximum = m_NumberOfSamples > 0
+    ? *std::max_element(m_Samples.begin(), m_Samples.begin() + m_NumberOfSamples) : 0.0;
+  m_Mutex.Unlock();
+  return maximum;
+}
+
+void mitk::NavigationDataLatencyStatistics::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Samples: " << this->GetNumberOfSamples() << " of " << this->GetTotalNumberOfSamples() << std::endl;
+  os << indent << "Mean: " << this->GetMean() << " ms" << std::endl;
+  os << indent << "Median: " << this->GetMedian() << " ms" << std::endl;
+  os << indent << "95th percentile: " << this->GetPercentile(95.0) << " ms" << std::endl;
+  os << indent << "Maximum: " << this->GetMaximum() << " ms" << std::endl;
+}
@@ -0,0 +1,100 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKNAVIGATIONDATALATENCYSTATISTICS_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATALATENCYSTATISTICS_H_HEADER_INCLUDED_
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkSimpleFastMutexLock.h>
+#include <MitkIGTExports.h>
+#include <mitkCommon.h>
+
+#include <vector>
+
+namespace mitk {
+
+  /**
+  * \brief Collects latency samples (in milliseconds) of a stage of the navigation data pipeline
+  *
+  * Keeps the last GetWindowSize() samples and computes percentiles, mean, minimum and
+  * maximum of them. AddSample() does not allocate memory, so it can be called on every
+  * update of the pipeline. All methods may be called from different threads, e.g.
+  * samples are added by the tracking thread and read by the GUI.
+  *
+  * Every mitk::NavigationDataSource owns an instance of this class, see
+  * mitk::NavigationDataSource::SetLatencyMeasurement().
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT NavigationDataLatencyStatistics : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataLatencyStatistics, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Sets the number of most recent samples the statistics are computed of. Default is 1000.
+    * All samples collected so far are discarded.
+    */
+    void SetWindowSize(unsigned int windowSize);
+    unsigned int GetWindowSize() const;
+
+    void AddSample(double latency);
+
+    /**
+    * \brief Discards all samples.
+    */
+    void Reset();
+
+    /**
+    * \brief Returns the number of samples the statistics are currently computed of.
+    */
+    unsigned int GetNumberOfSamples() const;
+
+    /**
+    * \brief Returns the number of samples added since the last Reset(), including the ones
+    * that already left the window.
+    */
+    unsigned long GetTotalNumberOfSamples() const;
+
+    /**
+    * \brief Returns the given percentile (0 to 100, nearest rank) of the samples, or 0 if there are none.
+    */
+    double GetPercentile(double percentile) const;
+
+    double GetMedian() const;
+    double GetMean() const;
+    double GetMinimum() const;
+    double GetMaximum() const;
+
+  protected:
+    NavigationDataLatencyStatistics();
+    virtual ~NavigationDataLatencyStatistics();
+
+    void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+    std::vector<double> m_Samples; ///< ring buffer of the most recent samples
+    unsigned int m_NextSample;
+    unsigned int m_NumberOfSamples;
+    unsigned long m_TotalNumberOfSamples;
+
+    mutable itk::SimpleFastMutexLock m_Mutex;
+  };
+} // namespace mitk
+
+#endif /* MITKNAVIGATIONDATALATENCYSTATISTICS_H_HEADER_INCLUDED_ */
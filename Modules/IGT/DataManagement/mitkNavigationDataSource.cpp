@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkNavigationDataSource.h"
 #include "mitkUIDGenerator.h"
+#include "mitkRealTimeClock.h"
 
 
 //Microservices
@@ -29,8 +30,20 @@ const std::string mitk::NavigationDataSource::US_PROPKEY_DEVICENAME = US_INTERFA
 const std::string mitk::NavigationDataSource::US_PROPKEY_ID = US_INTERFACE_NAME + ".id";
 const std::string mitk::NavigationDataSource::US_PROPKEY_ISACTIVE = US_INTERFACE_NAME + ".isActive";
 
+namespace
+{
+  /** all sources share one clock so that the stamps of different stages are comparable */
+  double GetLatencyClockStamp()
+  {
+    static mitk::RealTimeClock::Pointer clock = mitk::RealTimeClock::New();
+    return clock->GetCurrentStamp();
+  }
+}
+
 mitk::NavigationDataSource::NavigationDataSource()
-: itk::ProcessObject(), m_Name("NavigationDataSource (no defined type)"), m_IsFrozen(false)
+: itk::ProcessObject(), m_Name("NavigationDataSource (no defined type)"), m_IsFrozen(false),
+  m_LatencyMeasurement(false), m_LatencyStatistics(mitk::NavigationDataLatencyStatistics::New()),
+  m_StageLatencyStatistics(mitk::NavigationDataLatencyStatistics::New())
 {
 }
 
@@ -154,3 +167,71 @@ void mitk::NavigationDataSource::UnFreeze()
 {
   m_IsFrozen = false;
 }
+
+void mitk::NavigationDataSource::SetLatencyMeasurement(bool enable)
+{
+  if (m_LatencyMeasurement == enable)
+    return;
+
+  m_LatencyMeasurement = enable;
+  if (!enable)
+  {
+    // stale stamps would falsify the measurement of downstream filters
+    for (DataObjectPointerArraySizeType i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+    {
+      mitk::NavigationData* output = dynamic_cast<mitk::NavigationData*>(this->ProcessObject::GetOutput(i));
+      if (output != nullptr)
+        output->ClearLatencyStamps();
+    }
+  }
+  this->Modified();
+}
+
+mitk::NavigationDataLatencyStatistics* mitk::NavigationDataSource::GetLatencyStatistics() const
+{
+  return m_LatencyStatistics;
+}
+
+mitk::NavigationDataLatencyStatistics* mitk::NavigationDataSource::GetStageLatencyStatistics() const
+{
+  return m_StageLatencyStatistics;
+}
+
+void mitk::NavigationDataSource::UpdateOutputData(itk::DataObject *output)
+{
+  Superclass::UpdateOutputData(output);
+
+  if (m_LatencyMeasurement)
+    this->StampOutputs();
+}
+
+void mitk::NavigationDataSource::StampOutputs()
+{
+  const double now = GetLatencyClockStamp();
+  const DataObjectPointerArraySizeType numberOfInputs = this->GetNumberOfIndexedInputs();
+
+  for (DataObjectPointerArraySizeType i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+  {
+    mitk::NavigationData* output = dynamic_cast<mitk::NavigationData*>(this->ProcessObject::GetOutput(i));
+    if (output == nullptr)
+      continue;
+
+    const mitk::NavigationData* input = i < numberOfInputs
+      ? dynamic_cast<const mitk::NavigationData*>(this->ProcessObject::GetInput(i)) : nullptr;
+
+    if (input == nullptr || input->GetNumberOfLatencyStamps() == 0)
+    {
+      // the measurement starts here
+      output->ClearLatencyStamps();
+      output->AddLatencyStamp(now);
+      continue;
+    }
+
+    // filters do not graft invalid inputs, so the stamps are always taken from the input
+    output->CopyLatencyStamps(input);
+    output->AddLatencyStamp(now);
+
+    m_LatencyStatistics->AddSample(now - input->GetLatencyStamp(0));
+    m_StageLatencyStatistics->AddSample(now - input->GetLatencyStamp(input->GetNumberOfLatencyStamps() - 1));
+  }
+}
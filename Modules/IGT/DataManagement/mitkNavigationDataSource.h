@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkProcessObject.h>
 #include "mitkNavigationData.h"
+#include "mitkNavigationDataLatencyStatistics.h"
 #include "mitkPropertyList.h"
 #include "MitkIGTExports.h"
 
@@ -167,15 +168,49 @@ namespace mitk {
     /** @return Returns whether the data source is currently frozen. */
     itkGetMacro(IsFrozen,bool);
 
+    /**
+    * \brief Enables or disables the latency measurement of this source.
+    *
+    * If enabled, the outputs get a latency stamp (see mitk::NavigationData::AddLatencyStamp())
+    * each time this source generated new data. A source or filter whose input carries no stamps
+    * (e.g. a tracking device source or a player) starts a new measurement with the first stamp.
+    * Filters whose inputs carry stamps append their stamp and add the latency since the first
+    * stamp to GetLatencyStatistics() and the time since the previous stage to
+    * GetStageLatencyStatistics(). Enable it on all filters of a pipeline to measure each stage.
+    * Disabling it removes the stamps of the outputs. The default is false.
+    */
+    virtual void SetLatencyMeasurement(bool enable);
+    itkGetMacro(LatencyMeasurement, bool);
+    itkBooleanMacro(LatencyMeasurement);
+
+    /** @return Returns the latencies from the first measuring stage of the pipeline up to this filter. */
+    NavigationDataLatencyStatistics* GetLatencyStatistics() const;
+    /** @return Returns the latencies from the previous measuring stage of the pipeline up to this filter. */
+    NavigationDataLatencyStatistics* GetStageLatencyStatistics() const;
+
+    /**
+    * \brief Calls GenerateData() and adds the latency stamps if the latency measurement is enabled.
+    */
+    virtual void UpdateOutputData(itk::DataObject *output) override;
+
 
   protected:
     NavigationDataSource();
     virtual ~NavigationDataSource();
 
+    /**
+    * \brief Adds the latency stamps to all outputs, see SetLatencyMeasurement().
+    */
+    void StampOutputs();
+
     std::string m_Name;
 
     bool m_IsFrozen;
 
+    bool m_LatencyMeasurement;
+    NavigationDataLatencyStatistics::Pointer m_LatencyStatistics;
+    NavigationDataLatencyStatistics::Pointer m_StageLatencyStatistics;
+
 
   private:
     us::ServiceRegistration<Self> m_ServiceRegistration;
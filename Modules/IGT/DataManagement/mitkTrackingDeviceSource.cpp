@@ -22,8 +22,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIGTTimeStamp.h"
 #include "mitkIGTException.h"
 
+#include <algorithm>
+
 mitk::TrackingDeviceSource::TrackingDeviceSource()
-  : mitk::NavigationDataSource(), m_TrackingDevice(NULL)
+  : mitk::NavigationDataSource(), m_TrackingDevice(NULL), m_SampleBufferCapacity(1024), m_NumberOfDroppedSamples(0)
 {
 }
 
@@ -69,29 +71,84 @@ void mitk::TrackingDeviceSource::GenerateData()
   {
     mitk::NavigationData* nd = this->GetOutput(i);
     assert(nd);
-    mitk::TrackingTool* t = m_TrackingDevice->GetTool(i);
-    assert(t);
 
-    if ((t->IsEnabled() == false) || (t->IsDataValid() == false))
+    NavigationDataSample sample;
+    if (!this->ReadToolSample(i, sample))
     {
       nd->SetDataValid(false);
       continue;
     }
-    nd->SetDataValid(true);
-    mitk::NavigationData::PositionType p;
-    t->GetPosition(p);
-    nd->SetPosition(p);
-
-    mitk::NavigationData::OrientationType o;
-    t->GetOrientation(o);
-    nd->SetOrientation(o);
-    nd->SetOrientationAccuracy(t->GetTrackingError());
-    nd->SetPositionAccuracy(t->GetTrackingError());
-    nd->SetIGTTimeStamp(t->GetIGTTimeStamp());
-
-    //for backward compatibility: check if the timestamp was set, if not create a default timestamp
-    if (nd->GetIGTTimeStamp()==0) nd->SetIGTTimeStamp(mitk::IGTTimeStamp::GetInstance()->GetElapsed());
+    nd->SetSample(sample);
+  }
+}
+
+bool mitk::TrackingDeviceSource::ReadToolSample(unsigned int toolIndex, NavigationDataSample& sample) const
+{
+  mitk::TrackingTool* t = m_TrackingDevice->GetTool(toolIndex);
+  assert(t);
+
+  if ((t->IsEnabled() == false) || (t->IsDataValid() == false))
+  {
+    sample.DataValid = false;
+    return false;
   }
+
+  mitk::NavigationData::PositionType p;
+  t->GetPosition(p);
+  mitk::NavigationData::OrientationType o;
+  t->GetOrientation(o);
+  for (unsigned int j = 0; j < 3; ++j)
+    sample.Position[j] = p[j];
+  for (unsigned int j = 0; j < 4; ++j)
+    sample.Orientation[j] = o[j];
+  sample.TrackingError = t->GetTrackingError();
+  sample.IGTTimeStamp = t->GetIGTTimeStamp();
+  sample.DataValid = true;
+  sample.HasPosition = true;
+  sample.HasOrientation = true;
+
+  //for backward compatibility: check if the timestamp was set, if not create a default timestamp
+  if (sample.IGTTimeStamp == 0) sample.IGTTimeStamp = mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+
+  return true;
+}
+
+unsigned int mitk::TrackingDeviceSource::AcquireSamples()
+{
+  if (m_TrackingDevice.IsNull())
+    return 0;
+
+  unsigned int toolCount = std::min<unsigned int>(m_TrackingDevice->GetToolCount(), m_SampleBuffers.size());
+  unsigned int numberOfSamples = 0;
+  for (unsigned int i = 0; i < toolCount; ++i)
+  {
+    NavigationDataSample sample;
+    if (!this->ReadToolSample(i, sample) || sample.IGTTimeStamp == m_LastSampleTimeStamps[i])
+      continue;
+
+    m_LastSampleTimeStamps[i] = sample.IGTTimeStamp;
+    if (m_SampleBuffers[i]->TryPush(sample))
+      ++numberOfSamples;
+    else
+      ++m_NumberOfDroppedSamples;
+  }
+  return numberOfSamples;
+}
+
+unsigned int mitk::TrackingDeviceSource::PopSamples(unsigned int toolIndex, NavigationDataSample* samples, unsigned int maxCount)
+{
+  if (toolIndex >= m_SampleBuffers.size())
+    return 0;
+
+  unsigned int count = 0;
+  while (count < maxCount && m_SampleBuffers[toolIndex]->TryPop(samples[count]))
+    ++count;
+  return count;
+}
+
+unsigned long mitk::TrackingDeviceSource::GetNumberOfDroppedSamples() const
+{
+  return m_NumberOfDroppedSamples;
 }
 
 void mitk::TrackingDeviceSource::SetTrackingDevice( mitk::TrackingDevice* td )
@@ -116,6 +173,9 @@ void mitk::TrackingDeviceSource::CreateOutputs(){
     this->Modified();
   }
 
+  m_SampleBuffers.clear();
+  m_LastSampleTimeStamps.clear();
+
   //fill the outputs if a valid tracking device is set
   if (m_TrackingDevice.IsNull())
     return;
@@ -134,6 +194,13 @@ void mitk::TrackingDeviceSource::CreateOutputs(){
       this->Modified();
     }
   }
+
+  // the sample buffers are allocated here once, AcquireSamples() only copies into them
+  for (unsigned int idx = 0; idx < m_TrackingDevice->GetToolCount(); ++idx)
+  {
+    m_SampleBuffers.push_back(std::unique_ptr<SampleBufferType>(new SampleBufferType(m_SampleBufferCapacity)));
+  }
+  m_LastSampleTimeStamps.assign(m_TrackingDevice->GetToolCount(), -1.0);
 }
 
 void mitk::TrackingDeviceSource::Connect()
@@ -18,8 +18,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define MITKTRACKINGDEVICESOURCE_H_HEADER_INCLUDED_
 
 #include <mitkNavigationDataSource.h>
+#include <mitkNavigationDataSample.h>
+#include <mitkLockFreeRingBuffer.h>
 #include "mitkTrackingDevice.h"
 
+#include <atomic>
+#include <memory>
+
 namespace mitk {
   /**Documentation
   * \brief Connects a mitk::TrackingDevice to a MITK-IGT NavigationData-Filterpipeline
@@ -108,6 +113,41 @@ namespace mitk {
     */
     virtual void UpdateOutputInformation() override;
 
+    /**
+    * \brief Number of samples each per-tool buffer of AcquireSamples() can hold. Default is 1024.
+    * Takes effect when the outputs are created, i.e. on the next call of SetTrackingDevice().
+    */
+    itkSetMacro(SampleBufferCapacity, unsigned int);
+    itkGetMacro(SampleBufferCapacity, unsigned int);
+
+    /**
+    * \brief Stores the current state of all tools as mitk::NavigationDataSample in one buffer per tool.
+    *
+    * This is the lightweight alternative to Update() for high tracking rates and many tools:
+    * no ITK pipeline is executed and no memory is allocated, the buffers are preallocated when
+    * the outputs are created. A sample is only stored if the time stamp of the tool changed since
+    * the last call, so the method can be polled faster than the tracking rate. If a buffer is
+    * full, the sample is dropped and counted (see GetNumberOfDroppedSamples()).
+    *
+    * AcquireSamples() must always be called from the same thread and PopSamples() from one other
+    * (or the same) thread. Update() can still be called at any time, e.g. at display rate, to
+    * update the NavigationData outputs for visualization.
+    * @return the number of stored samples
+    */
+    unsigned int AcquireSamples();
+
+    /**
+    * \brief Moves up to maxCount buffered samples of the given tool, oldest first, to samples.
+    * Process them in batch with mitk::NavigationDataToNavigationDataFilter::ProcessSamples().
+    * @return the number of samples written to samples
+    */
+    unsigned int PopSamples(unsigned int toolIndex, NavigationDataSample* samples, unsigned int maxCount);
+
+    /**
+    * \brief Returns the number of samples AcquireSamples() dropped because a buffer was full.
+    */
+    unsigned long GetNumberOfDroppedSamples() const;
+
   protected:
     TrackingDeviceSource();
     virtual ~TrackingDeviceSource();
@@ -129,7 +169,19 @@ namespace mitk {
     **/
     void CreateOutputs();
 
+    /**
+    * \brief Reads the current state of a tool, returns false if the tool is disabled or its data is invalid.
+    */
+    bool ReadToolSample(unsigned int toolIndex, NavigationDataSample& sample) const;
+
+    typedef LockFreeRingBuffer<NavigationDataSample> SampleBufferType;
+
     mitk::TrackingDevice::Pointer m_TrackingDevice;  ///< the tracking device that is used as a source for this filter object
+
+    unsigned int m_SampleBufferCapacity;
+    std::vector<std::unique_ptr<SampleBufferType>> m_SampleBuffers;  ///< one buffer per tool, filled by AcquireSamples()
+    std::vector<double> m_LastSampleTimeStamps;                       ///< time stamp of the last acquired sample per tool
+    std::atomic<unsigned long> m_NumberOfDroppedSamples;
   };
 } // namespace mitk
 #endif /* MITKTrackingDeviceSource_H_HEADER_INCLUDED_ */
\ No newline at end of file
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itksys/SystemTools.hxx>
 #include <mitkIGTTimeStamp.h>
 #include <fstream>
+#include <algorithm>
 
 #include "mitkIGTException.h"
 
@@ -37,7 +38,7 @@ mitk::NavigationDataPlayer::~NavigationDataPlayer()
 
 void mitk::NavigationDataPlayer::GenerateData()
 {
-  if ( m_NavigationDataSet->Size() == 0 )
+  if ( this->GetNumberOfSnapshots() == 0 )
   {
     MITK_WARN << "Cannot do anything with empty set of navigation datas.";
     return;
@@ -58,30 +59,16 @@ void mitk::NavigationDataPlayer::GenerateData()
   // imediatly with the first navigation data (not to wait till the first time
   // stamp is reached)
   TimeStampType timeStampSinceStartWithOffset = m_TimeStampSinceStart
-      + m_NavigationDataSet->Begin()->at(0)->GetIGTTimeStamp();
+      + this->GetSnapshotTimeStamp(0);
 
-  // iterate through all NavigationData objects of the given tool index
-  // till the timestamp of the NavigationData is greater then the given timestamp
-  for (; m_NavigationDataSetIterator != m_NavigationDataSet->End(); ++m_NavigationDataSetIterator)
-  {
-    // test if the timestamp of the successor is greater than the time stamp
-    if ( m_NavigationDataSetIterator+1 == m_NavigationDataSet->End() ||
-        (m_NavigationDataSetIterator+1)->at(0)->GetIGTTimeStamp() > timeStampSinceStartWithOffset )
-    {
-      break;
-    }
-  }
+  // search the last NavigationData objects whose timestamp is not greater than the given
+  // timestamp; the player never goes back while it is running
+  m_CurrentSnapshot = std::max(m_CurrentSnapshot, this->FindSnapshot(timeStampSinceStartWithOffset));
 
-  for (unsigned int index = 0; index < GetNumberOfOutputs(); index++)
-  {
-    mitk::NavigationData* output = this->GetOutput(index);
-    if( !output ) { mitkThrowException(mitk::IGTException) << "Output of index "<<index<<" is null."; }
-
-    output->Graft(m_NavigationDataSetIterator->at(index));
-  }
+  this->GraftSnapshot(m_CurrentSnapshot);
 
   // stop playing if the last NavigationData objects were grafted
-  if (m_NavigationDataSetIterator+1 == m_NavigationDataSet->End())
+  if (m_CurrentSnapshot+1 == this->GetNumberOfSnapshots())
   {
     this->StopPlaying();
 
@@ -101,9 +88,9 @@ void mitk::NavigationDataPlayer::StartPlaying()
   // make sure that player is initialized before playing starts
   this->InitPlayer();
 
-  // set state and iterator for playing from start
+  // set state and snapshot for playing from start
   m_CurPlayerState = PlayerRunning;
-  m_NavigationDataSetIterator = m_NavigationDataSet->Begin();
+  m_CurrentSnapshot = 0;
 
   // reset playing timestamps
   m_PauseTimeStamp = 0;
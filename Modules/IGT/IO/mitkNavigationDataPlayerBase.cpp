@@ -19,8 +19,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 // include for exceptions
 #include "mitkIGTException.h"
 
+#include <algorithm>
+
 mitk::NavigationDataPlayerBase::NavigationDataPlayerBase()
-  : m_Repeat(false)
+  : m_Repeat(false), m_CurrentSnapshot(0)
 {
   this->SetName("Navigation Data Player Source");
 }
@@ -37,30 +39,95 @@ void mitk::NavigationDataPlayerBase::UpdateOutputInformation()
 
 bool mitk::NavigationDataPlayerBase::IsAtEnd()
 {
-  return m_NavigationDataSetIterator == m_NavigationDataSet->End();
+  return m_CurrentSnapshot >= this->GetNumberOfSnapshots();
 }
 
 void mitk::NavigationDataPlayerBase::SetNavigationDataSet(NavigationDataSet::Pointer navigationDataSet)
 {
   m_NavigationDataSet = navigationDataSet;
-  m_NavigationDataSetIterator = navigationDataSet->Begin();
+  m_NavigationDataFile = nullptr;
+  m_CurrentSnapshot = 0;
+
+  this->InitPlayer();
+}
+
+void mitk::NavigationDataPlayerBase::SetNavigationDataFile(NavigationDataMappedFile::Pointer navigationDataFile)
+{
+  m_NavigationDataFile = navigationDataFile;
+  m_NavigationDataSet = nullptr;
+  m_CurrentSnapshot = 0;
 
   this->InitPlayer();
 }
 
 unsigned int mitk::NavigationDataPlayerBase::GetNumberOfSnapshots()
 {
+  if (m_NavigationDataFile.IsNotNull())
+    return m_NavigationDataFile->GetNumberOfSnapshots();
+
   return m_NavigationDataSet.IsNull() ? 0 : m_NavigationDataSet->Size();
 }
 
 unsigned int mitk::NavigationDataPlayerBase::GetCurrentSnapshotNumber()
 {
-  return m_NavigationDataSet.IsNull() ? 0 : m_NavigationDataSetIterator - m_NavigationDataSet->Begin();
+  return m_CurrentSnapshot;
+}
+
+unsigned int mitk::NavigationDataPlayerBase::GetNumberOfTools()
+{
+  if (m_NavigationDataFile.IsNotNull())
+    return m_NavigationDataFile->GetNumberOfTools();
+
+  return m_NavigationDataSet.IsNull() ? 0 : m_NavigationDataSet->GetNumberOfTools();
+}
+
+mitk::NavigationData::TimeStampType mitk::NavigationDataPlayerBase::GetSnapshotTimeStamp(unsigned int snapshot)
+{
+  if (m_NavigationDataFile.IsNotNull())
+    return m_NavigationDataFile->GetTimeStamp(snapshot);
+
+  return (m_NavigationDataSet->Begin() + snapshot)->at(0)->GetIGTTimeStamp();
+}
+
+unsigned int mitk::NavigationDataPlayerBase::FindSnapshot(NavigationData::TimeStampType timeStamp)
+{
+  if (m_NavigationDataFile.IsNotNull())
+    return m_NavigationDataFile->FindSnapshot(timeStamp);
+
+  // time stamps are strictly increasing (see NavigationDataSet::AddNavigationDatas())
+  mitk::NavigationDataSet::NavigationDataSetConstIterator next = std::upper_bound(
+    m_NavigationDataSet->Begin(), m_NavigationDataSet->End(), timeStamp,
+    [](NavigationData::TimeStampType value, const std::vector<NavigationData::Pointer> &snapshot)
+    { return value < snapshot.at(0)->GetIGTTimeStamp(); });
+
+  return next == m_NavigationDataSet->Begin() ? 0 : (next - m_NavigationDataSet->Begin()) - 1;
+}
+
+void mitk::NavigationDataPlayerBase::GraftSnapshot(unsigned int snapshot)
+{
+  const std::vector<NavigationData::Pointer> *datas;
+  if (m_NavigationDataFile.IsNotNull())
+  {
+    m_NavigationDataFile->ReadSnapshot(snapshot, m_FileSnapshot);
+    datas = &m_FileSnapshot;
+  }
+  else
+  {
+    datas = &*(m_NavigationDataSet->Begin() + snapshot);
+  }
+
+  for (unsigned int index = 0; index < GetNumberOfOutputs(); index++)
+  {
+    mitk::NavigationData* output = this->GetOutput(index);
+    if( !output ) { mitkThrowException(mitk::IGTException) << "Output of index "<<index<<" is null."; }
+
+    output->Graft(datas->at(index));
+  }
 }
 
 void mitk::NavigationDataPlayerBase::InitPlayer()
 {
-  if ( m_NavigationDataSet.IsNull() )
+  if ( m_NavigationDataSet.IsNull() && m_NavigationDataFile.IsNull() )
   {
     mitkThrowException(mitk::IGTException)
       << "NavigationDataSet has to be set before initializing player.";
@@ -68,7 +135,7 @@ void mitk::NavigationDataPlayerBase::InitPlayer()
 
   if (GetNumberOfOutputs() == 0)
   {
-    int requiredOutputs = m_NavigationDataSet->GetNumberOfTools();
+    int requiredOutputs = this->GetNumberOfTools();
     this->SetNumberOfRequiredOutputs(requiredOutputs);
 
     for (unsigned int n = this->GetNumberOfOutputs(); n < requiredOutputs; ++n)
@@ -78,7 +145,7 @@ void mitk::NavigationDataPlayerBase::InitPlayer()
       this->Modified();
     }
   }
-  else if (GetNumberOfOutputs() != m_NavigationDataSet->GetNumberOfTools())
+  else if (GetNumberOfOutputs() != this->GetNumberOfTools())
   {
     mitkThrowException(mitk::IGTException)
       << "Number of tools cannot be changed in existing player. Please create "
@@ -91,7 +158,7 @@ void mitk::NavigationDataPlayerBase::InitPlayer()
 
 void mitk::NavigationDataPlayerBase::GraftEmptyOutput()
 {
-  for (unsigned int index = 0; index < m_NavigationDataSet->GetNumberOfTools(); index++)
+  for (unsigned int index = 0; index < this->GetNumberOfTools(); index++)
   {
     mitk::NavigationData* output = this->GetOutput(index);
     assert(output);
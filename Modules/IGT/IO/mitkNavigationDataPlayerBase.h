@@ -19,11 +19,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkNavigationDataSource.h"
 #include "mitkNavigationDataSet.h"
+#include "mitkNavigationDataMappedFile.h"
 
 namespace mitk{
   /**
   * \brief Base class for using mitk::NavigationData as a filter source.
-  * Subclasses can play objects of mitk::NavigationDataSet.
+  * Subclasses can play objects of mitk::NavigationDataSet or binary recordings
+  * which are read directly from a mitk::NavigationDataMappedFile.
   *
   * Each subclass has to check the state of m_Repeat and do or do not repeat
   * the playing accordingly.
@@ -63,8 +65,20 @@ namespace mitk{
     */
     void SetNavigationDataSet(NavigationDataSet::Pointer navigationDataSet);
 
+    itkGetMacro(NavigationDataFile, NavigationDataMappedFile::Pointer)
+
+    /**
+    * \brief Set an opened binary recording for playing.
+    * Time steps are decoded from the file only when they are played, so a recording
+    * of any length can be played without loading it into memory. Replaces a
+    * mitk::NavigationDataSet given before and vice versa.
+    *
+    * @param navigationDataFile mitk::NavigationDataMappedFile which will be played by this player.
+    */
+    void SetNavigationDataFile(NavigationDataMappedFile::Pointer navigationDataFile);
+
     /**
-    * \brief Getter for the size of the mitk::NavigationDataSet used in this object.
+    * \brief Getter for the size of the mitk::NavigationDataSet or file used in this object.
     *
     * @return Returns the number of navigation data snapshots available in the player.
     */
@@ -101,6 +115,28 @@ namespace mitk{
     */
     void GraftEmptyOutput();
 
+    /**
+    * \brief Returns the number of tools of the mitk::NavigationDataSet or file.
+    */
+    unsigned int GetNumberOfTools();
+
+    /**
+    * \brief Returns the time stamp of the first tool at the given snapshot.
+    */
+    NavigationData::TimeStampType GetSnapshotTimeStamp(unsigned int snapshot);
+
+    /**
+    * \brief Returns the last snapshot whose time stamp is not greater than \a timeStamp,
+    * or 0 if all snapshots are later. Uses a binary search.
+    */
+    unsigned int FindSnapshot(NavigationData::TimeStampType timeStamp);
+
+    /**
+    * \brief Copies the navigation datas of the given snapshot to the outputs.
+    * @throw mitk::IGTException if an output is null.
+    */
+    void GraftSnapshot(unsigned int snapshot);
+
     /**
     * \brief If the player should repeat outputs. Default is false.
     */
@@ -108,10 +144,18 @@ namespace mitk{
 
     NavigationDataSet::Pointer m_NavigationDataSet;
 
+    NavigationDataMappedFile::Pointer m_NavigationDataFile;
+
+    /**
+    * \brief Index of the snapshot which is in the outputs at the moment.
+    * Equals GetNumberOfSnapshots() if the player is at the end.
+    */
+    unsigned int m_CurrentSnapshot;
+
     /**
-    * \brief Iterator always points to the NavigationData object which is in the outputs at the moment.
+    * \brief Time step decoded from m_NavigationDataFile, reused for every snapshot.
     */
-    mitk::NavigationDataSet::NavigationDataSetConstIterator m_NavigationDataSetIterator;
+    std::vector<NavigationData::Pointer> m_FileSnapshot;
   };
 } // namespace mitk
 
@@ -24,6 +24,8 @@ mitk::NavigationDataRecorder::NavigationDataRecorder()
   m_Recording = false;
   m_StandardizedTimeInitialized = false;
   m_RecordCountLimit = -1;
+  m_KeepNavigationDataSet = true;
+  m_StreamWriter = mitk::NavigationDataBinaryStreamWriter::New();
 }
 
 mitk::NavigationDataRecorder::~NavigationDataRecorder()
@@ -39,6 +41,12 @@ void mitk::NavigationDataRecorder::GenerateData()
   //This vector will hold the NavigationDatas that are copied from the inputs
   std::vector< mitk::NavigationData::Pointer > clonedDatas;
 
+  // without a data set, the copies are only streamed and can be reused for the next time step
+  if (m_Recording && !m_KeepNavigationDataSet)
+  {
+    m_StreamDatas.resize(inputs.size());
+  }
+
   // For each input
   for (unsigned int index=0; index < inputs.size(); index++)
   {
@@ -49,7 +57,15 @@ void mitk::NavigationDataRecorder::GenerateData()
     if (! m_Recording) continue;
 
     // Clone a Navigation Data
-    mitk::NavigationData::Pointer clone = mitk::NavigationData::New();
+    mitk::NavigationData::Pointer clone;
+    if (m_KeepNavigationDataSet || m_StreamDatas[index].IsNull())
+    {
+      clone = mitk::NavigationData::New();
+    }
+    else
+    {
+      clone = m_StreamDatas[index];
+    }
     clone->Graft(this->GetInput(index));
     clonedDatas.push_back(clone);
 
@@ -61,10 +77,21 @@ void mitk::NavigationDataRecorder::GenerateData()
   }
 
   // if limitation is set and has been reached, stop recording
-  if ((m_RecordCountLimit > 0) && (m_NavigationDataSet->Size() >= m_RecordCountLimit)) m_Recording = false;
+  if ((m_RecordCountLimit > 0) && (this->GetNumberOfRecordedSteps() >= m_RecordCountLimit)) m_Recording = false;
   // We can skip the rest of the method, if recording is deactivated
   if  (!m_Recording) return;
 
+  // Queue data for the stream file, the stream writer stores it in the background
+  if (m_StreamWriter->IsOpen())
+  {
+    m_StreamWriter->Write(clonedDatas);
+  }
+
+  if (!m_KeepNavigationDataSet)
+  {
+    m_StreamDatas = clonedDatas;
+    return;
+  }
 
   // Add data to set
   m_NavigationDataSet->AddNavigationDatas(clonedDatas);
@@ -77,6 +104,11 @@ void mitk::NavigationDataRecorder::StartRecording()
     MITK_WARN << "Already recording please stop before start new recording session";
     return;
   }
+
+  // A resumed recording is appended to the open stream file
+  if (!m_StreamWriter->IsOpen())
+    this->OpenStreamFile();
+
   m_Recording = true;
 
   // The first time this StartRecording is called, we initialize the standardized time.
@@ -96,14 +128,21 @@ void mitk::NavigationDataRecorder::StopRecording()
     return;
   }
   m_Recording = false;
+
+  if (!m_StreamWriter->Flush())
+    MITK_WARN << "The recording could not be written completely to " << m_StreamFileName;
 }
 
 void mitk::NavigationDataRecorder::ResetRecording()
 {
   m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
 
+  m_StreamWriter->Close();
+  m_StreamDatas.clear();
+
   if (m_Recording)
   {
+    this->OpenStreamFile();
     mitk::IGTTimeStamp::GetInstance()->Stop(this);
     mitk::IGTTimeStamp::GetInstance()->Start(this);
   }
@@ -111,5 +150,21 @@ void mitk::NavigationDataRecorder::ResetRecording()
 
 int mitk::NavigationDataRecorder::GetNumberOfRecordedSteps()
 {
+  if (!m_KeepNavigationDataSet)
+    return m_StreamWriter->GetNumberOfSnapshots();
+
   return m_NavigationDataSet->Size();
-}
\ No newline at end of file
+}
+
+void mitk::NavigationDataRecorder::OpenStreamFile()
+{
+  if (m_StreamFileName.empty())
+    return;
+
+  std::vector<std::string> toolNames;
+  for (unsigned int index = 0; index < GetNumberOfIndexedInputs(); index++)
+  {
+    toolNames.push_back(this->GetInput(index)->GetName());
+  }
+  m_StreamWriter->Open(m_StreamFileName, toolNames);
+}
@@ -20,6 +20,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkNavigationDataToNavigationDataFilter.h"
 #include "mitkNavigationData.h"
 #include "mitkNavigationDataSet.h"
+#include "mitkNavigationDataBinaryStreamWriter.h"
 
 namespace mitk
 {
@@ -31,6 +32,10 @@ namespace mitk
   * With StopRecording() the stream is stopped, but can be resumed anytime.
   * To start recording to a new NavigationDataSet, call ResetRecording();
   *
+  * If a stream file name is set, the recorded data is additionally written to this file in the
+  * binary format of mitk::NavigationDataBinaryFormat while recording (see mitk::NavigationDataBinaryStreamWriter).
+  * For long recordings, SetKeepNavigationDataSet(false) stops collecting the data in memory.
+  *
   * \warning Do not add inputs while the recorder ist recording. The recorder can't handle that and will cause a nullpointer exception.
   * \ingroup IGT
   */
@@ -70,6 +75,22 @@ namespace mitk
     */
     itkSetMacro(StandardizeTime, bool);
 
+    /**
+    * \brief Sets a file the recorded data is streamed to (binary format, extension "ndb"). An empty name,
+    * which is the default, disables streaming. Takes effect when a new recording is started, i.e. on the
+    * first call of StartRecording() or after ResetRecording().
+    */
+    itkSetStringMacro(StreamFileName);
+    itkGetStringMacro(StreamFileName);
+
+    /**
+    * \brief If set to false, the recorded data is only streamed to the stream file and not collected
+    * in the NavigationDataSet. Default is true.
+    */
+    itkSetMacro(KeepNavigationDataSet, bool);
+    itkGetMacro(KeepNavigationDataSet, bool);
+    itkBooleanMacro(KeepNavigationDataSet);
+
     /**
     * \brief Starts recording NavigationData into the NAvigationDataSet
     */
@@ -80,6 +101,7 @@ namespace mitk
     *
     * Recording can be resumed to the same Dataset by just calling StartRecording() again.
     * Call ResetRecording() to start recording to a new Dataset;
+    * All data recorded so far is written to the stream file, if one is set.
     */
     virtual void StopRecording();
 
@@ -87,6 +109,7 @@ namespace mitk
     * \brief Resets the Datasets and the timestamp, so a new recording can happen.
     *
     * Do not forget to save the old Dataset, it will be lost after calling this function.
+    * The stream file is closed and will be overwritten by the next recording.
     */
     virtual void ResetRecording();
 
@@ -100,6 +123,12 @@ namespace mitk
 
     virtual void GenerateData() override;
 
+    /**
+    * \brief Opens the stream file, if one is set, for the current inputs.
+    * @throw mitk::IGTIOException if the file cannot be created.
+    */
+    void OpenStreamFile();
+
     NavigationDataRecorder();
 
     virtual ~NavigationDataRecorder();
@@ -115,6 +144,14 @@ namespace mitk
     bool m_StandardizedTimeInitialized; //< set to true the first time start recording is called.
 
     int m_RecordCountLimit; ///< limits the number of frames, recording will be stopped if the limit is reached. -1 disables the limit
+
+    std::string m_StreamFileName; ///< binary file the recorded data is streamed to, empty if streaming is disabled
+
+    bool m_KeepNavigationDataSet; ///< indicates whether the recorded data is collected in m_NavigationDataSet
+
+    mitk::NavigationDataBinaryStreamWriter::Pointer m_StreamWriter;
+
+    std::vector<mitk::NavigationData::Pointer> m_StreamDatas; ///< reused for every time step if the data set is not kept
   };
 }
 #endif // #define _MITK_POINT_SET_SOURCE_H
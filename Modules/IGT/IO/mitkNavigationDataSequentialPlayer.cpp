@@ -40,8 +40,8 @@ void mitk::NavigationDataSequentialPlayer::GoToSnapshot(unsigned int i)
     mitkThrowException(mitk::IGTException) << "Snapshot " << i << " does not exist and repat is off: can't go to that snapshot!";
   }
 
-  // set iterator to given position (modulo for allowing repeat)
-  m_NavigationDataSetIterator = m_NavigationDataSet->Begin() + ( i % this->GetNumberOfSnapshots() );
+  // set snapshot to given position (modulo for allowing repeat)
+  m_CurrentSnapshot = i % this->GetNumberOfSnapshots();
 
   // set outputs to selected snapshot
   this->GenerateData();
@@ -49,18 +49,18 @@ void mitk::NavigationDataSequentialPlayer::GoToSnapshot(unsigned int i)
 
 bool mitk::NavigationDataSequentialPlayer::GoToNextSnapshot()
 {
-  if (m_NavigationDataSetIterator == m_NavigationDataSet->End())
+  if (this->IsAtEnd())
   {
     MITK_WARN("NavigationDataSequentialPlayer") << "Cannot go to next snapshot, already at end of NavigationDataset. Ignoring...";
     return false;
   }
-  ++m_NavigationDataSetIterator;
-  if ( m_NavigationDataSetIterator == m_NavigationDataSet->End() )
+  ++m_CurrentSnapshot;
+  if ( this->IsAtEnd() )
   {
     if ( m_Repeat )
     {
       // set data back to start if repeat is enabled
-      m_NavigationDataSetIterator = m_NavigationDataSet->Begin();
+      m_CurrentSnapshot = 0;
     }
     else
     {
@@ -73,20 +73,14 @@ bool mitk::NavigationDataSequentialPlayer::GoToNextSnapshot()
 
 void mitk::NavigationDataSequentialPlayer::GenerateData()
 {
-  if ( m_NavigationDataSetIterator == m_NavigationDataSet->End() )
+  if ( this->IsAtEnd() )
   {
     // no more data available
     this->GraftEmptyOutput();
   }
   else
   {
-    for (unsigned int index = 0; index < GetNumberOfOutputs(); index++)
-    {
-      mitk::NavigationData* output = this->GetOutput(index);
-      if( !output ) { mitkThrowException(mitk::IGTException) << "Output of index "<<index<<" is null."; }
-
-      output->Graft(m_NavigationDataSetIterator->at(index));
-    }
+    this->GraftSnapshot(m_CurrentSnapshot);
   }
 }
 
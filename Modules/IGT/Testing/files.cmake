@@ -21,7 +21,9 @@ set(MODULE_TESTS
    mitkInternalTrackingToolTest.cpp
    mitkNavigationDataDisplacementFilterTest.cpp
    mitkNavigationDataLandmarkTransformFilterTest.cpp
+   mitkNavigationDataLatencyBenchmarkTest.cpp
    mitkNavigationDataObjectVisualizationFilterTest.cpp
+   mitkNavigationDataSampleTest.cpp
    mitkNavigationDataSetTest.cpp
    mitkNavigationDataTest.cpp
    mitkNavigationDataRecorderTest.cpp
@@ -29,6 +31,7 @@ set(MODULE_TESTS
    mitkNavigationDataSequentialPlayerTest.cpp
    mitkNavigationDataSetReaderWriterXMLTest.cpp
    mitkNavigationDataSetReaderWriterCSVTest.cpp
+   mitkNavigationDataSetReaderWriterBinaryTest.cpp
    mitkNavigationDataSourceTest.cpp
    mitkNavigationDataToMessageFilterTest.cpp
    mitkNavigationDataToNavigationDataFilterTest.cpp
@@ -0,0 +1,367 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+//testing headers
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkNavigationData.h>
+#include <mitkNavigationDataSet.h>
+#include <mitkNavigationDataLatencyStatistics.h>
+#include <mitkNavigationDataSequentialPlayer.h>
+#include <mitkNavigationDataSmoothingFilter.h>
+#include <mitkNavigationDataTransformFilter.h>
+#include <mitkNavigationDataLandmarkTransformFilter.h>
+#include <mitkNavigationDataObjectVisualizationFilter.h>
+#include <mitkTrackingDeviceSource.h>
+#include <mitkVirtualTrackingDevice.h>
+#include <mitkPointSet.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <cstdlib>
+
+/**
+* Unit tests of the latency measurement of the navigation data pipeline and a benchmark of the
+* pipeline Smoothing -> Transform -> LandmarkTransform -> ObjectVisualization, driven by recorded
+* data and by a virtual tracking device. The benchmark fails if the 99th percentile of the
+* end-to-end latency exceeds MAXIMUM_LATENCY, so latency regressions can be detected without
+* tracking hardware. The measured percentiles are printed for each filter.
+*
+* The default limit is generous because the timings depend on the load of the test machine. It can
+* be overridden by the environment variable MITK_IGT_MAXIMUM_LATENCY (in milliseconds).
+*/
+class mitkNavigationDataLatencyBenchmarkTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataLatencyBenchmarkTestSuite);
+  MITK_TEST(TestLatencyStamps);
+  MITK_TEST(TestStatistics);
+  MITK_TEST(TestStatisticsWindow);
+  MITK_TEST(TestDisabledMeasurement);
+  MITK_TEST(BenchmarkRecordedData);
+  MITK_TEST(BenchmarkVirtualTrackingDevice);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  static const unsigned int NUMBER_OF_TOOLS = 2;
+  static const unsigned int NUMBER_OF_UPDATES = 500;
+
+  /** default upper bound of the 99th percentile of the end-to-end latency in milliseconds */
+  static const double MAXIMUM_LATENCY;
+
+  std::vector<mitk::NavigationDataSource::Pointer> m_Filters;
+  std::vector<mitk::PointSet::Pointer> m_RepresentationObjects;
+
+public:
+
+  void setUp() override
+  {
+  }
+
+  void tearDown() override
+  {
+    m_Filters.clear();
+    m_RepresentationObjects.clear();
+  }
+
+  /** Connects the filter chain to source and enables the latency measurement of all stages. */
+  void CreatePipeline(mitk::NavigationDataSource* source)
+  {
+    m_Filters.clear();
+    m_Filters.push_back(source);
+
+    mitk::NavigationDataSmoothingFilter::Pointer smoothing = mitk::NavigationDataSmoothingFilter::New();
+    smoothing->SetNumerOfValues(5);
+    smoothing->ConnectTo(source);
+    m_Filters.push_back(smoothing.GetPointer());
+
+    mitk::NavigationDataTransformFilter::TransformType::Pointer transform =
+      mitk::NavigationDataTransformFilter::TransformType::New();
+    mitk::NavigationDataTransformFilter::TransformType::OutputVectorType translation;
+    translation.Fill(10.0);
+    transform->SetTranslation(translation);
+    mitk::NavigationDataTransformFilter::Pointer transformFilter = mitk::NavigationDataTransformFilter::New();
+    transformFilter->SetRigid3DTransform(transform);
+    transformFilter->ConnectTo(smoothing);
+    m_Filters.push_back(transformFilter.GetPointer());
+
+    mitk::PointSet::Pointer sourcePoints = mitk::PointSet::New();
+    mitk::PointSet::Pointer targetPoints = mitk::PointSet::New();
+    for (int i = 0; i < 4; ++i)
+    {
+      mitk::Point3D point;
+      mitk::FillVector3D(point, i == 1 ? 1.0 : 0.0, i == 2 ? 1.0 : 0.0, i == 3 ? 1.0 : 0.0);
+      sourcePoints->SetPoint(i, point);
+      point[0] += 5.0;
+      targetPoints->SetPoint(i, point);
+    }
+    mitk::NavigationDataLandmarkTransformFilter::Pointer landmarkFilter = mitk::NavigationDataLandmarkTransformFilter::New();
+    landmarkFilter->SetSourceLandmarks(sourcePoints);
+    landmarkFilter->SetTargetLandmarks(targetPoints);
+    landmarkFilter->ConnectTo(transformFilter);
+    m_Filters.push_back(landmarkFilter.GetPointer());
+
+    mitk::NavigationDataObjectVisualizationFilter::Pointer visualization = mitk::NavigationDataObjectVisualizationFilter::New();
+    visualization->ConnectTo(landmarkFilter);
+    m_RepresentationObjects.clear();
+    for (unsigned int i = 0; i < visualization->GetNumberOfIndexedOutputs(); ++i)
+    {
+      m_RepresentationObjects.push_back(mitk::PointSet::New());
+      visualization->SetRepresentationObject(i, m_RepresentationObjects.back());
+    }
+    m_Filters.push_back(visualization.GetPointer());
+
+    for (auto filter = m_Filters.begin(); filter != m_Filters.end(); ++filter)
+    {
+      (*filter)->LatencyMeasurementOn();
+    }
+  }
+
+  void UpdatePipeline()
+  {
+    // generates the data of all outputs
+    m_Filters.back()->Update();
+  }
+
+  /** Checks the stamps of the last filter and prints the statistics of all filters. */
+  void CheckPipeline(const std::string& name, unsigned int numberOfUpdates)
+  {
+    mitk::NavigationDataSource* last = m_Filters.back();
+    for (unsigned int i = 0; i < last->GetNumberOfIndexedOutputs(); ++i)
+    {
+      const mitk::NavigationData* output = last->GetOutput(i);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Each stage adds one stamp", static_cast<unsigned int>(m_Filters.size()),
+                                   output->GetNumberOfLatencyStamps());
+      for (unsigned int stage = 1; stage < output->GetNumberOfLatencyStamps(); ++stage)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Stamps increase along the pipeline",
+                               output->GetLatencyStamp(stage) >= output->GetLatencyStamp(stage - 1));
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("The source starts the measurement", 0u,
+                                 m_Filters.front()->GetLatencyStatistics()->GetNumberOfSamples());
+
+    for (std::size_t i = 1; i < m_Filters.size(); ++i)
+    {
+      mitk::NavigationDataLatencyStatistics* latency = m_Filters[i]->GetLatencyStatistics();
+      mitk::NavigationDataLatencyStatistics* stageLatency = m_Filters[i]->GetStageLatencyStatistics();
+
+      MITK_INFO << name << " " << m_Filters[i]->GetNameOfClass() << ": end-to-end latency median "
+                << latency->GetMedian() << " ms, 95th percentile " << latency->GetPercentile(95.0)
+                << " ms, 99th percentile " << latency->GetPercentile(99.0) << " ms, maximum "
+                << latency->GetMaximum() << " ms; stage latency median " << stageLatency->GetMedian() << " ms";
+
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("One sample per update and tool",
+                                   static_cast<unsigned long>(numberOfUpdates * NUMBER_OF_TOOLS),
+                                   latency->GetTotalNumberOfSamples());
+      CPPUNIT_ASSERT_MESSAGE("Latencies are not negative", latency->GetMinimum() >= 0.0);
+      CPPUNIT_ASSERT_MESSAGE("End-to-end latency includes the stage latency",
+                             latency->GetMaximum() >= stageLatency->GetMinimum());
+    }
+
+    double maximumLatency = GetMaximumLatency();
+    double p99 = m_Filters.back()->GetLatencyStatistics()->GetPercentile(99.0);
+    MITK_INFO << name << ": 99th percentile of the end-to-end latency " << p99 << " ms, limit " << maximumLatency << " ms";
+    CPPUNIT_ASSERT_MESSAGE("99th percentile of the end-to-end latency is within the limit", p99 <= maximumLatency);
+  }
+
+  /** Returns MITK_IGT_MAXIMUM_LATENCY if it is set to a positive number, MAXIMUM_LATENCY otherwise. */
+  static double GetMaximumLatency()
+  {
+    std::string value;
+    if (itksys::SystemTools::GetEnv("MITK_IGT_MAXIMUM_LATENCY", value))
+    {
+      char* end = nullptr;
+      double limit = std::strtod(value.c_str(), &end);
+      if (end != value.c_str() && limit > 0.0)
+      {
+        return limit;
+      }
+      MITK_WARN << "Ignoring invalid MITK_IGT_MAXIMUM_LATENCY \"" << value << "\"";
+    }
+    return MAXIMUM_LATENCY;
+  }
+
+  void TestLatencyStamps()
+  {
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    CPPUNIT_ASSERT_EQUAL(0u, nd->GetNumberOfLatencyStamps());
+
+    nd->AddLatencyStamp(1.0);
+    nd->AddLatencyStamp(2.5);
+    CPPUNIT_ASSERT_EQUAL(2u, nd->GetNumberOfLatencyStamps());
+    CPPUNIT_ASSERT_EQUAL(2.5, nd->GetLatencyStamp(1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Missing stages return 0", 0.0, nd->GetLatencyStamp(2));
+
+    mitk::NavigationData::Pointer grafted = mitk::NavigationData::New();
+    grafted->Graft(nd);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Graft copies the stamps", 2u, grafted->GetNumberOfLatencyStamps());
+    CPPUNIT_ASSERT_EQUAL(1.0, grafted->GetLatencyStamp(0));
+
+    mitk::NavigationData::Pointer clone = nd->Clone();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Clone copies the stamps", 2u, clone->GetNumberOfLatencyStamps());
+
+    for (unsigned int i = 0; i < 2 * mitk::NavigationData::MAXIMUM_NUMBER_OF_LATENCY_STAMPS; ++i)
+    {
+      nd->AddLatencyStamp(i);
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Stamps are limited",
+                                 static_cast<unsigned int>(mitk::NavigationData::MAXIMUM_NUMBER_OF_LATENCY_STAMPS),
+                                 nd->GetNumberOfLatencyStamps());
+
+    nd->ClearLatencyStamps();
+    CPPUNIT_ASSERT_EQUAL(0u, nd->GetNumberOfLatencyStamps());
+  }
+
+  void TestStatistics()
+  {
+    mitk::NavigationDataLatencyStatistics::Pointer statistics = mitk::NavigationDataLatencyStatistics::New();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Empty statistics", 0.0, statistics->GetPercentile(50.0));
+
+    // add 1 ... 100 in mixed order
+    for (int i = 0; i < 100; ++i)
+    {
+      statistics->AddSample((i * 37) % 100 + 1);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(100u, statistics->GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(50.0, statistics->GetMedian());
+    CPPUNIT_ASSERT_EQUAL(95.0, statistics->GetPercentile(95.0));
+    CPPUNIT_ASSERT_EQUAL(100.0, statistics->GetPercentile(100.0));
+    CPPUNIT_ASSERT_EQUAL(1.0, statistics->GetPercentile(0.0));
+    CPPUNIT_ASSERT_EQUAL(1.0, statistics->GetMinimum());
+    CPPUNIT_ASSERT_EQUAL(100.0, statistics->GetMaximum());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(50.5, statistics->GetMean(), mitk::eps);
+
+    statistics->Reset();
+    CPPUNIT_ASSERT_EQUAL(0u, statistics->GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(0.0, statistics->GetMaximum());
+  }
+
+  void TestStatisticsWindow()
+  {
+    mitk::NavigationDataLatencyStatistics::Pointer statistics = mitk::NavigationDataLatencyStatistics::New();
+    statistics->SetWindowSize(10);
+
+    for (int i = 1; i <= 25; ++i)
+    {
+      statistics->AddSample(i);
+    }
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Only the window is kept", 10u, statistics->GetNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL(25ul, statistics->GetTotalNumberOfSamples());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Old samples left the window", 16.0, statistics->GetMinimum());
+    CPPUNIT_ASSERT_EQUAL(25.0, statistics->GetMaximum());
+
+    CPPUNIT_ASSERT_THROW(statistics->SetWindowSize(0), itk::ExceptionObject);
+  }
+
+  void TestDisabledMeasurement()
+  {
+    mitk::NavigationData::Pointer input = mitk::NavigationData::New();
+    input->SetDataValid(true);
+
+    mitk::NavigationDataTransformFilter::Pointer filter = mitk::NavigationDataTransformFilter::New();
+    filter->SetRigid3DTransform(mitk::NavigationDataTransformFilter::TransformType::New());
+    filter->SetInput(input);
+
+    filter->GetOutput()->Update();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("No stamps without measurement", 0u, filter->GetOutput()->GetNumberOfLatencyStamps());
+
+    filter->LatencyMeasurementOn();
+    filter->GetOutput()->Update();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Filter with an unstamped input starts the measurement", 1u,
+                                 filter->GetOutput()->GetNumberOfLatencyStamps());
+    CPPUNIT_ASSERT_EQUAL(0u, filter->GetLatencyStatistics()->GetNumberOfSamples());
+
+    filter->LatencyMeasurementOff();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Disabling removes the stamps", 0u, filter->GetOutput()->GetNumberOfLatencyStamps());
+  }
+
+  void BenchmarkRecordedData()
+  {
+    mitk::NavigationDataSet::Pointer recording = mitk::NavigationDataSet::New(NUMBER_OF_TOOLS);
+    for (unsigned int step = 0; step < NUMBER_OF_UPDATES; ++step)
+    {
+      std::vector<mitk::NavigationData::Pointer> datas;
+      for (unsigned int tool = 0; tool < NUMBER_OF_TOOLS; ++tool)
+      {
+        mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+        mitk::NavigationData::PositionType position;
+        mitk::FillVector3D(position, step * 0.1, tool, -1.0 * step);
+        nd->SetPosition(position);
+        nd->SetDataValid(true);
+        nd->SetIGTTimeStamp(step * 20.0);
+        datas.push_back(nd);
+      }
+      recording->AddNavigationDatas(datas);
+    }
+
+    mitk::NavigationDataSequentialPlayer::Pointer player = mitk::NavigationDataSequentialPlayer::New();
+    player->SetNavigationDataSet(recording);
+    this->CreatePipeline(player);
+
+    unsigned int numberOfUpdates = 0;
+    do
+    {
+      this->UpdatePipeline();
+      ++numberOfUpdates;
+    } while (player->GoToNextSnapshot());
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(NUMBER_OF_UPDATES), numberOfUpdates);
+    this->CheckPipeline("Recorded data", numberOfUpdates);
+  }
+
+  void BenchmarkVirtualTrackingDevice()
+  {
+    mitk::VirtualTrackingDevice::Pointer tracker = mitk::VirtualTrackingDevice::New();
+    tracker->SetRefreshRate(10);
+    for (unsigned int tool = 0; tool < NUMBER_OF_TOOLS; ++tool)
+    {
+      std::stringstream name;
+      name << "Tool" << tool;
+      tracker->AddTool(name.str().c_str());
+    }
+
+    mitk::TrackingDeviceSource::Pointer source = mitk::TrackingDeviceSource::New();
+    source->SetTrackingDevice(tracker);
+    source->Connect();
+    source->StartTracking();
+
+    this->CreatePipeline(source);
+
+    for (unsigned int i = 0; i < NUMBER_OF_UPDATES; ++i)
+    {
+      this->UpdatePipeline();
+      if (i % 50 == 0)
+      {
+        itksys::SystemTools::Delay(1); // let the tracking thread move the tools
+      }
+    }
+
+    source->StopTracking();
+    source->Disconnect();
+
+    this->CheckPipeline("Virtual tracking device", NUMBER_OF_UPDATES);
+  }
+};
+
+const double mitkNavigationDataLatencyBenchmarkTestSuite::MAXIMUM_LATENCY = 100.0;
+
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataLatencyBenchmark)
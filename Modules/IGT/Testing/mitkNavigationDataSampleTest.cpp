@@ -0,0 +1,224 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+//testing headers
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkNavigationData.h>
+#include <mitkNavigationDataSample.h>
+#include <mitkNavigationDataDisplacementFilter.h>
+#include <mitkNavigationDataLandmarkTransformFilter.h>
+#include <mitkNavigationDataSmoothingFilter.h>
+#include <mitkNavigationDataTransformFilter.h>
+#include <mitkTrackingDeviceSource.h>
+#include <mitkVirtualTrackingDevice.h>
+#include <mitkPointSet.h>
+
+#include <itksys/SystemTools.hxx>
+
+class mitkNavigationDataSampleTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataSampleTestSuite);
+  MITK_TEST(TestConversion);
+  MITK_TEST(TestAcquireSamples);
+  MITK_TEST(TestDisplacementFilter);
+  MITK_TEST(TestTransformFilter);
+  MITK_TEST(TestLandmarkTransformFilter);
+  MITK_TEST(TestUnsupportedFilter);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::NavigationData::Pointer m_Input;
+
+public:
+
+  void setUp() override
+  {
+    m_Input = mitk::NavigationData::New();
+    mitk::NavigationData::PositionType position;
+    mitk::FillVector3D(position, 1.5, -2.0, 30.0);
+    m_Input->SetPosition(position);
+    mitk::NavigationData::OrientationType orientation(0.5, 0.5, 0.5, 0.5);
+    m_Input->SetOrientation(orientation);
+    m_Input->SetPositionAccuracy(0.25);
+    m_Input->SetOrientationAccuracy(0.25);
+    m_Input->SetIGTTimeStamp(1234.5);
+    m_Input->SetDataValid(true);
+  }
+
+  void tearDown() override
+  {
+    m_Input = nullptr;
+  }
+
+  /** Checks that processing a sample of the input gives the same result as updating the filter. */
+  void CheckFilter(mitk::NavigationDataToNavigationDataFilter* filter)
+  {
+    filter->SetInput(m_Input);
+    filter->Update();
+
+    mitk::NavigationDataSample samples[2];
+    m_Input->GetSample(samples[0]);
+    m_Input->GetSample(samples[1]);
+    samples[1].DataValid = false;
+
+    CPPUNIT_ASSERT_MESSAGE("Filter supports samples", filter->ProcessSamples(0, samples, 2));
+
+    // not all filters graft their inputs, so only the pose is compared
+    mitk::NavigationData::Pointer processed = mitk::NavigationData::New();
+    processed->SetSample(samples[0]);
+    CPPUNIT_ASSERT_MESSAGE("Position is processed like the pipeline output",
+                           mitk::Equal(filter->GetOutput()->GetPosition(), processed->GetPosition(), 1e-5, true));
+    CPPUNIT_ASSERT_MESSAGE("Orientation is processed like the pipeline output",
+                           mitk::Equal(filter->GetOutput()->GetOrientation(), processed->GetOrientation(), 1e-5));
+
+    mitk::NavigationData::Pointer invalid = mitk::NavigationData::New();
+    invalid->SetSample(samples[1]);
+    invalid->SetDataValid(true);
+    CPPUNIT_ASSERT_MESSAGE("Invalid sample is not changed", mitk::Equal(*m_Input, *invalid, mitk::eps, true));
+  }
+
+  void TestConversion()
+  {
+    mitk::NavigationDataSample sample;
+    m_Input->GetSample(sample);
+    CPPUNIT_ASSERT_EQUAL(30.0, sample.Position[2]);
+    CPPUNIT_ASSERT_EQUAL(0.5, sample.Orientation[3]);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.25, sample.TrackingError, mitk::eps);
+    CPPUNIT_ASSERT_EQUAL(1234.5, sample.IGTTimeStamp);
+    CPPUNIT_ASSERT(sample.DataValid);
+
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    nd->SetSample(sample);
+    CPPUNIT_ASSERT_MESSAGE("Conversion is lossless", mitk::Equal(*m_Input, *nd, mitk::eps, true));
+  }
+
+  void TestAcquireSamples()
+  {
+    mitk::VirtualTrackingDevice::Pointer tracker = mitk::VirtualTrackingDevice::New();
+    tracker->SetRefreshRate(10);
+    tracker->AddTool("T0");
+    tracker->AddTool("T1");
+
+    mitk::TrackingDeviceSource::Pointer source = mitk::TrackingDeviceSource::New();
+    source->SetSampleBufferCapacity(64);
+    source->SetTrackingDevice(tracker);
+    source->Connect();
+    source->StartTracking();
+
+    unsigned int acquired = 0;
+    for (int i = 0; i < 200 && acquired < 20; ++i)
+    {
+      acquired += source->AcquireSamples();
+      itksys::SystemTools::Delay(5);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Samples are acquired while tracking", acquired >= 20);
+    CPPUNIT_ASSERT_EQUAL(0ul, source->GetNumberOfDroppedSamples());
+
+    unsigned int popped = 0;
+    mitk::NavigationDataSample samples[8];
+    for (unsigned int tool = 0; tool < 2; ++tool)
+    {
+      double lastTimeStamp = -1.0;
+      unsigned int count;
+      while ((count = source->PopSamples(tool, samples, 8)) > 0)
+      {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+          CPPUNIT_ASSERT_MESSAGE("Samples are valid", samples[i].DataValid);
+          CPPUNIT_ASSERT_MESSAGE("Only new samples are stored", samples[i].IGTTimeStamp > lastTimeStamp);
+          lastTimeStamp = samples[i].IGTTimeStamp;
+        }
+        popped += count;
+      }
+    }
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("All samples are popped", acquired, popped);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Unknown tool", 0u, source->PopSamples(2, samples, 8));
+
+    // the outputs are still updated on demand
+    source->Update();
+    CPPUNIT_ASSERT(source->GetOutput(0)->IsDataValid());
+
+    source->StopTracking();
+    source->Disconnect();
+  }
+
+  void TestDisplacementFilter()
+  {
+    mitk::NavigationDataDisplacementFilter::Pointer filter = mitk::NavigationDataDisplacementFilter::New();
+    mitk::Vector3D offset;
+    mitk::FillVector3D(offset, 1.0, 2.0, -3.0);
+    filter->SetOffset(offset);
+    this->CheckFilter(filter);
+  }
+
+  void TestTransformFilter()
+  {
+    mitk::NavigationDataTransformFilter::TransformType::Pointer transform =
+      mitk::NavigationDataTransformFilter::TransformType::New();
+    mitk::NavigationDataTransformFilter::TransformType::OutputVectorType translation;
+    mitk::FillVector3D(translation, 10.0, 0.0, -5.0);
+    transform->SetTranslation(translation);
+    mitk::NavigationDataTransformFilter::TransformType::VersorType rotation;
+    rotation.Set(0.0, 0.0, std::sin(0.3), std::cos(0.3));
+    transform->SetRotation(rotation);
+
+    mitk::NavigationDataTransformFilter::Pointer filter = mitk::NavigationDataTransformFilter::New();
+    CPPUNIT_ASSERT_THROW_MESSAGE("Transform is required", filter->ProcessSamples(0, nullptr, 0), itk::ExceptionObject);
+
+    filter->SetRigid3DTransform(transform);
+    this->CheckFilter(filter);
+
+    filter->PrecomposeOn();
+    this->CheckFilter(filter);
+  }
+
+  void TestLandmarkTransformFilter()
+  {
+    mitk::PointSet::Pointer sourcePoints = mitk::PointSet::New();
+    mitk::PointSet::Pointer targetPoints = mitk::PointSet::New();
+    for (int i = 0; i < 4; ++i)
+    {
+      mitk::Point3D point;
+      mitk::FillVector3D(point, i == 1 ? 1.0 : 0.0, i == 2 ? 1.0 : 0.0, i == 3 ? 1.0 : 0.0);
+      sourcePoints->SetPoint(i, point);
+      // rotate by 90 degrees about z and translate
+      mitk::Point3D target;
+      mitk::FillVector3D(target, -point[1] + 2.0, point[0], point[2] + 1.0);
+      targetPoints->SetPoint(i, target);
+    }
+
+    mitk::NavigationDataLandmarkTransformFilter::Pointer filter = mitk::NavigationDataLandmarkTransformFilter::New();
+    filter->SetSourceLandmarks(sourcePoints);
+    filter->SetTargetLandmarks(targetPoints);
+    this->CheckFilter(filter);
+  }
+
+  void TestUnsupportedFilter()
+  {
+    mitk::NavigationDataSmoothingFilter::Pointer filter = mitk::NavigationDataSmoothingFilter::New();
+    mitk::NavigationDataSample sample;
+    m_Input->GetSample(sample);
+    CPPUNIT_ASSERT_MESSAGE("Filters without sample support return false", !filter->ProcessSamples(0, &sample, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Sample is not changed", 30.0, sample.Position[2]);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataSample)
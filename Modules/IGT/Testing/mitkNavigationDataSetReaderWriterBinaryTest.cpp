@@ -0,0 +1,229 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+//testing headers
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkNavigationData.h>
+#include <mitkNavigationDataSet.h>
+#include <mitkNavigationDataBinaryStreamWriter.h>
+#include <mitkNavigationDataMappedFile.h>
+#include <mitkNavigationDataSequentialPlayer.h>
+#include <mitkIOUtil.h>
+
+#include <cstdio>
+#include <sstream>
+
+//for exceptions
+#include "mitkIGTException.h"
+#include "mitkIGTIOException.h"
+
+class mitkNavigationDataSetReaderWriterBinaryTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataSetReaderWriterBinaryTestSuite);
+  MITK_TEST(TestReadWrite);
+  MITK_TEST(TestStreamWriter);
+  MITK_TEST(TestFindSnapshot);
+  MITK_TEST(TestIncompleteRecord);
+  MITK_TEST(TestSequentialPlayerWithFile);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_FileName;
+  std::vector<std::string> m_ToolNames;
+  mitk::NavigationDataSet::Pointer m_Set;
+
+  static const unsigned int NUMBER_OF_STEPS = 100;
+
+public:
+
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::GetTempPath() + "NavigationDataSetReaderWriterBinaryTest.ndb";
+
+    m_ToolNames.clear();
+    m_ToolNames.push_back("Pointer");
+    m_ToolNames.push_back("Reference");
+    m_ToolNames.push_back("");
+
+    m_Set = mitk::NavigationDataSet::New(m_ToolNames.size());
+    for (unsigned int step = 0; step < NUMBER_OF_STEPS; ++step)
+    {
+      m_Set->AddNavigationDatas(this->CreateStep(step));
+    }
+  }
+
+  void tearDown() override
+  {
+    std::remove(m_FileName.c_str());
+    m_Set = nullptr;
+  }
+
+  std::vector<mitk::NavigationData::Pointer> CreateStep(unsigned int step)
+  {
+    std::vector<mitk::NavigationData::Pointer> datas;
+    for (unsigned int tool = 0; tool < m_ToolNames.size(); ++tool)
+    {
+      mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+      nd->SetName(m_ToolNames[tool].c_str());
+      nd->SetIGTTimeStamp(1000.0 + 20.0 * step);
+
+      mitk::NavigationData::PositionType position;
+      mitk::FillVector3D(position, step + 0.25, tool - 3.5, step * tool / 7.0);
+      nd->SetPosition(position);
+      nd->SetOrientation(mitk::NavigationData::OrientationType(0.1 * tool, 0.2, 0.3, 0.5 + step / 1000.0));
+      nd->SetPositionAccuracy(0.1 + tool);
+      nd->SetOrientationAccuracy(0.01 * step);
+      nd->SetDataValid(tool != 2);
+      datas.push_back(nd);
+    }
+    return datas;
+  }
+
+  void AssertStepsEqual(const std::vector<mitk::NavigationData::Pointer> &expected,
+                        const std::vector<mitk::NavigationData::Pointer> &actual)
+  {
+    CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+    for (unsigned int tool = 0; tool < expected.size(); ++tool)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Navigation data is restored", mitk::Equal(*expected[tool], *actual[tool], mitk::eps, true));
+      CPPUNIT_ASSERT_EQUAL(expected[tool]->GetIGTTimeStamp(), actual[tool]->GetIGTTimeStamp());
+    }
+  }
+
+  void TestReadWrite()
+  {
+    mitk::IOUtil::Save(m_Set, m_FileName);
+
+    mitk::NavigationDataSet::Pointer readSet =
+      dynamic_cast<mitk::NavigationDataSet*>(mitk::IOUtil::LoadBaseData(m_FileName).GetPointer());
+    CPPUNIT_ASSERT_MESSAGE("Testing whether something was read at all", readSet.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(m_Set->Size(), readSet->Size());
+    CPPUNIT_ASSERT_EQUAL(m_Set->GetNumberOfTools(), readSet->GetNumberOfTools());
+
+    for (unsigned int step = 0; step < m_Set->Size(); ++step)
+    {
+      this->AssertStepsEqual(m_Set->GetTimeStep(step), readSet->GetTimeStep(step));
+    }
+  }
+
+  void TestStreamWriter()
+  {
+    mitk::NavigationDataBinaryStreamWriter::Pointer writer = mitk::NavigationDataBinaryStreamWriter::New();
+    writer->SetBufferCapacity(16);
+    writer->Open(m_FileName, m_ToolNames);
+    CPPUNIT_ASSERT(writer->IsOpen());
+
+    unsigned int written = 0;
+    for (auto step = m_Set->Begin(); step != m_Set->End(); ++step)
+    {
+      // retry until the writer thread made space in the small buffer
+      while (!writer->Write(*step))
+      {
+      }
+      ++written;
+      if (written == NUMBER_OF_STEPS / 2)
+      {
+        CPPUNIT_ASSERT_MESSAGE("Flush succeeds", writer->Flush());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Flushed time steps are stored", written, writer->GetNumberOfStoredSnapshots());
+
+        mitk::NavigationDataMappedFile::Pointer file = mitk::NavigationDataMappedFile::New();
+        file->Open(m_FileName);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Flushed time steps can be read while recording", written,
+                                     file->GetNumberOfSnapshots());
+      }
+    }
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(NUMBER_OF_STEPS), writer->GetNumberOfSnapshots());
+    CPPUNIT_ASSERT(!writer->Write(std::vector<mitk::NavigationData::Pointer>(1)));
+
+    writer->Close();
+    CPPUNIT_ASSERT(!writer->IsOpen());
+
+    mitk::NavigationDataMappedFile::Pointer file = mitk::NavigationDataMappedFile::New();
+    file->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(NUMBER_OF_STEPS), file->GetNumberOfSnapshots());
+    CPPUNIT_ASSERT(m_ToolNames == file->GetToolNames());
+
+    std::vector<mitk::NavigationData::Pointer> datas;
+    for (unsigned int step = 0; step < NUMBER_OF_STEPS; ++step)
+    {
+      file->ReadSnapshot(step, datas);
+      this->AssertStepsEqual(m_Set->GetTimeStep(step), datas);
+    }
+
+    CPPUNIT_ASSERT_THROW(file->ReadSnapshot(NUMBER_OF_STEPS, datas), mitk::IGTException);
+  }
+
+  void TestFindSnapshot()
+  {
+    mitk::IOUtil::Save(m_Set, m_FileName);
+
+    mitk::NavigationDataMappedFile::Pointer file = mitk::NavigationDataMappedFile::New();
+    file->Open(m_FileName);
+
+    CPPUNIT_ASSERT_EQUAL(0u, file->FindSnapshot(0.0));
+    CPPUNIT_ASSERT_EQUAL(0u, file->FindSnapshot(1000.0));
+    CPPUNIT_ASSERT_EQUAL(0u, file->FindSnapshot(1019.9));
+    CPPUNIT_ASSERT_EQUAL(1u, file->FindSnapshot(1020.0));
+    CPPUNIT_ASSERT_EQUAL(42u, file->FindSnapshot(1000.0 + 20.0 * 42 + 10.0));
+    CPPUNIT_ASSERT_EQUAL(NUMBER_OF_STEPS - 1, file->FindSnapshot(1.0e9));
+    CPPUNIT_ASSERT_EQUAL(1000.0 + 20.0 * 17, file->GetTimeStamp(17));
+  }
+
+  void TestIncompleteRecord()
+  {
+    mitk::IOUtil::Save(m_Set, m_FileName);
+
+    // simulate a recording that was interrupted while a time step was written
+    std::ofstream out(m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+    out.write("incomplete", 10);
+    out.close();
+
+    mitk::NavigationDataMappedFile::Pointer file = mitk::NavigationDataMappedFile::New();
+    file->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(NUMBER_OF_STEPS), file->GetNumberOfSnapshots());
+
+    std::ofstream invalid(m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    invalid << "no recording";
+    invalid.close();
+    CPPUNIT_ASSERT_THROW(file->Open(m_FileName), mitk::IGTIOException);
+    CPPUNIT_ASSERT(!file->IsOpen());
+  }
+
+  void TestSequentialPlayerWithFile()
+  {
+    mitk::IOUtil::Save(m_Set, m_FileName);
+
+    mitk::NavigationDataMappedFile::Pointer file = mitk::NavigationDataMappedFile::New();
+    file->Open(m_FileName);
+
+    mitk::NavigationDataSequentialPlayer::Pointer player = mitk::NavigationDataSequentialPlayer::New();
+    player->SetNavigationDataFile(file);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(NUMBER_OF_STEPS), player->GetNumberOfSnapshots());
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(m_ToolNames.size()), player->GetNumberOfOutputs());
+
+    player->GoToSnapshot(63);
+    CPPUNIT_ASSERT_EQUAL(63u, player->GetCurrentSnapshotNumber());
+    CPPUNIT_ASSERT(mitk::Equal(*m_Set->GetNavigationDataForIndex(63, 1), *player->GetOutput(1)));
+
+    player->GoToNextSnapshot();
+    CPPUNIT_ASSERT(mitk::Equal(*m_Set->GetNavigationDataForIndex(64, 0), *player->GetOutput(0)));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataSetReaderWriterBinary)
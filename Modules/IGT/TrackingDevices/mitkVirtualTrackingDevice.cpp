@@ -265,6 +265,7 @@ void mitk::VirtualTrackingDevice::TrackTools()
       // TODO: rotate once per cycle around a fixed rotation vector
 
       currentTool->SetTrackingError(2 * (rand() / (RAND_MAX + 1.0)));  // tracking error in 0 .. 2 Range
+      currentTool->SetIGTTimeStamp(mitk::IGTTimeStamp::GetInstance()->GetElapsed());
       currentTool->SetDataValid(true);
       currentTool->Modified();
     }
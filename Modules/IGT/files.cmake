@@ -16,6 +16,7 @@ set(CPP_FILES
   Algorithms/mitkIGTLMessageToNavigationDataFilter.cpp
 
   Common/mitkIGTTimeStamp.cpp
+  Common/mitkNavigationDataLatencyStatistics.cpp
   Common/mitkSerialCommunication.cpp
 
   DataManagement/mitkNavigationDataSource.cpp
@@ -0,0 +1,49 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNavigationDataReaderBinary_H_HEADER_INCLUDED_
+#define MITKNavigationDataReaderBinary_H_HEADER_INCLUDED_
+
+#include <mitkAbstractFileReader.h>
+#include <mitkNavigationDataSet.h>
+
+namespace mitk {
+  /** This class reads binary navigation data recordings (see mitk::NavigationDataBinaryFormat)
+   *  and returns the navigation data set.
+   *
+   *  To play long recordings without decoding them completely, open them with
+   *  mitk::NavigationDataMappedFile instead.
+   */
+  class NavigationDataReaderBinary : public AbstractFileReader
+  {
+  public:
+
+    NavigationDataReaderBinary();
+    virtual ~NavigationDataReaderBinary();
+
+    using AbstractFileReader::Read;
+    virtual std::vector<itk::SmartPointer<BaseData>> Read() override;
+
+  protected:
+
+    NavigationDataReaderBinary(const NavigationDataReaderBinary& other);
+
+    virtual mitk::NavigationDataReaderBinary* Clone() const override;
+
+  };
+}
+
+#endif // MITKNavigationDataReaderBinary_H_HEADER_INCLUDED_
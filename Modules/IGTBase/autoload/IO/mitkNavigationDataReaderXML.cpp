@@ -115,6 +115,11 @@ mitk::NavigationDataSet::Pointer mitk::NavigationDataReaderXML::Read(std::string
   return navigationDataSet;
 }
 
+bool mitk::NavigationDataReaderXML::CanReadStream() const
+{
+  return true;
+}
+
 mitk::NavigationDataSet::Pointer mitk::NavigationDataReaderXML::Read(std::istream* stream)
 {
   //define own locale
@@ -38,6 +38,9 @@ namespace mitk {
     using AbstractFileReader::Read;
     virtual std::vector<itk::SmartPointer<BaseData>> Read() override;
 
+    /** The xml document is parsed element by element from the input stream. */
+    virtual bool CanReadStream() const override;
+
   protected:
 
     NavigationDataReaderXML(const NavigationDataReaderXML& other);
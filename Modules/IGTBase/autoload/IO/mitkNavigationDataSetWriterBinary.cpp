@@ -0,0 +1,88 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataSetWriterBinary.h"
+#include <mitkIGTMimeTypes.h>
+#include <mitkIGTIOException.h>
+#include <mitkNavigationDataBinaryFormat.h>
+
+#include <fstream>
+
+mitk::NavigationDataSetWriterBinary::NavigationDataSetWriterBinary() : AbstractFileWriter(NavigationDataSet::GetStaticNameOfClass(),
+  mitk::IGTMimeTypes::NAVIGATIONDATASETBINARY_MIMETYPE(),
+  "MITK NavigationDataSet Writer (binary)")
+{
+  RegisterService();
+}
+
+mitk::NavigationDataSetWriterBinary::~NavigationDataSetWriterBinary()
+{}
+
+mitk::NavigationDataSetWriterBinary::NavigationDataSetWriterBinary(const mitk::NavigationDataSetWriterBinary& other) : AbstractFileWriter(other)
+{
+}
+
+mitk::NavigationDataSetWriterBinary* mitk::NavigationDataSetWriterBinary::Clone() const
+{
+  return new NavigationDataSetWriterBinary(*this);
+}
+
+void mitk::NavigationDataSetWriterBinary::Write()
+{
+  std::ostream* out = GetOutputStream();
+  std::ofstream file;
+  if (out == nullptr)
+  {
+    file.open(GetOutputLocation().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+      mitkThrowException(mitk::IGTIOException) << "File '" << GetOutputLocation()
+                                               << "' could not be opened for writing.";
+    }
+    out = &file;
+  }
+  mitk::NavigationDataSet::ConstPointer data = dynamic_cast<const NavigationDataSet*> (this->GetInput());
+
+  unsigned int numberOfTools = data->GetNumberOfTools();
+
+  // the tool names are taken from the first time step
+  std::vector<std::string> toolNames(numberOfTools);
+  if (data->Size() > 0)
+  {
+    std::vector<mitk::NavigationData::Pointer> firstStep = data->GetTimeStep(0);
+    for (unsigned int toolIndex = 0; toolIndex < numberOfTools; toolIndex++)
+    {
+      toolNames[toolIndex] = firstStep.at(toolIndex)->GetName();
+    }
+  }
+
+  std::string header = mitk::NavigationDataBinaryFormat::CreateHeader(toolNames);
+  out->write(header.data(), header.size());
+
+  std::vector<char> record(mitk::NavigationDataBinaryFormat::GetRecordSize(numberOfTools));
+  for (auto step = data->Begin(); step != data->End(); ++step)
+  {
+    mitk::NavigationDataBinaryFormat::EncodeRecord(*step, record.data());
+    out->write(record.data(), record.size());
+  }
+
+  out->flush();
+  if (!out->good())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Navigation data could not be written to '"
+                                             << GetOutputLocation() << "'.";
+  }
+}
@@ -4,6 +4,9 @@ set(CPP_FILES
   mitkRealTimeClock.cpp
   mitkNavigationData.cpp
   mitkNavigationDataSet.cpp
+  mitkNavigationDataBinaryFormat.cpp
+  mitkNavigationDataMappedFile.cpp
+  mitkNavigationDataBinaryStreamWriter.cpp
   mitkStaticIGTHelperFunctions.cpp
   mitkQuaternionAveraging.cpp
   mitkIGTMimeTypes.cpp
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkIGTBaseExports.h>
 #include <mitkCommon.h>
 #include <mitkNumericTypes.h>
+#include "mitkNavigationDataSample.h"
 
 namespace mitk {
 
@@ -129,6 +130,52 @@ namespace mitk {
       */
       itkGetStringMacro(Name);
 
+      /**
+      * \brief sets position, orientation, validity, time stamp and accuracy from a sample
+      *
+      * The name, the latency stamps and the HasPosition/HasOrientation flags are not changed,
+      * i.e. HasPosition and HasOrientation of the sample are ignored.
+      */
+      void SetSample(const NavigationDataSample& sample);
+      /**
+      * \brief writes position, orientation, validity and time stamp of this object to sample
+      *
+      * The tracking error of the sample is the position accuracy, i.e. the square root of
+      * the first diagonal element of the covariance matrix.
+      */
+      void GetSample(NavigationDataSample& sample) const;
+
+      /**
+      * \brief maximum number of latency stamps a NavigationData object can carry
+      */
+      static const unsigned int MAXIMUM_NUMBER_OF_LATENCY_STAMPS = 16;
+      /**
+      * \brief appends the time (in milliseconds of mitk::RealTimeClock) at which a pipeline stage
+      * finished processing this NavigationData object
+      *
+      * The first stamp is set by the stage at which the measurement starts, each following stage
+      * appends one stamp. Stamps exceeding MAXIMUM_NUMBER_OF_LATENCY_STAMPS are ignored. Adding a
+      * stamp does not modify the object, so it does not trigger pipeline updates.
+      * See mitk::NavigationDataSource::SetLatencyMeasurement().
+      */
+      void AddLatencyStamp(TimeStampType time);
+      /**
+      * \brief returns the number of latency stamps of this NavigationData object
+      */
+      unsigned int GetNumberOfLatencyStamps() const;
+      /**
+      * \brief returns the latency stamp of the given stage, or 0 if there is no such stamp
+      */
+      TimeStampType GetLatencyStamp(unsigned int stage) const;
+      /**
+      * \brief copies all latency stamps of data to this object
+      */
+      void CopyLatencyStamps(const NavigationData* data);
+      /**
+      * \brief removes all latency stamps of this NavigationData object
+      */
+      void ClearLatencyStamps();
+
       /**
       * \brief Graft the data and information from one NavigationData to another.
       *
@@ -266,6 +313,11 @@ namespace mitk {
       * \brief name of the navigation data
       */
       std::string m_Name;
+      /**
+      * \brief times at which the pipeline stages processed this object (see AddLatencyStamp())
+      */
+      TimeStampType m_LatencyStamps[MAXIMUM_NUMBER_OF_LATENCY_STAMPS];
+      unsigned int m_NumberOfLatencyStamps;
 
     private:
 
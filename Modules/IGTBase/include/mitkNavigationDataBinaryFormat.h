@@ -0,0 +1,95 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATABINARYFORMAT_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATABINARYFORMAT_H_HEADER_INCLUDED_
+
+#include <MitkIGTBaseExports.h>
+#include "mitkNavigationData.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace mitk {
+  /**
+  * \brief Layout of binary NavigationDataSet recordings.
+  *
+  * A file consists of a header followed by one fixed-size record per time step.
+  * A record holds one block per tool:
+  * time stamp, position (3), orientation (x, y, z, r), the upper triangle of the
+  * 6x6 covariance matrix (21 values, row major) as doubles and a 64 bit flag field
+  * (valid, has position, has orientation).
+  *
+  * The header contains the magic string "MITKNDB", the format version, a byte order
+  * mark, the number of tools, the record size and the tool names; it is padded to
+  * a multiple of 8 bytes. Values are stored in the byte order of the writing machine;
+  * readers reject files with a different byte order.
+  *
+  * As all records have the same size, the number of time steps follows from the
+  * file size and a record can be accessed directly by its index. A recording that was
+  * interrupted (e.g. by a crash) stays readable up to the last complete record.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataBinaryFormat
+  {
+  public:
+    static const unsigned int VERSION = 1;
+
+    /** \brief Size of the data of one tool within a record, in bytes. */
+    static const std::size_t TOOL_BLOCK_SIZE = 30 * sizeof(double);
+
+    /** \brief Size of the record of one time step, in bytes. */
+    static std::size_t GetRecordSize(unsigned int numberOfTools);
+
+    /** \brief Returns the file header for the given tools. Its size is a multiple of 8 bytes. */
+    static std::string CreateHeader(const std::vector<std::string> &toolNames);
+
+    /**
+    * \brief Reads the header from the beginning of a file.
+    *
+    * @param data Beginning of the file.
+    * @param size Number of bytes available at \a data.
+    * @param toolNames Receives the tool names (and thereby the number of tools).
+    * @param headerSize Receives the size of the header, i.e. the offset of the first record.
+    * @throw mitk::IGTIOException if the header is invalid or incomplete.
+    */
+    static void ParseHeader(const char *data, std::size_t size, std::vector<std::string> &toolNames,
+                            std::size_t &headerSize);
+
+    /**
+    * \brief Writes the navigation datas of one time step to \a record.
+    *
+    * \a record must provide GetRecordSize(datas.size()) bytes.
+    */
+    static void EncodeRecord(const std::vector<mitk::NavigationData::Pointer> &datas, char *record);
+
+    /**
+    * \brief Reads one time step from \a record into \a datas.
+    *
+    * Existing objects in \a datas are reused, missing ones are created. The name of
+    * each navigation data is set to the corresponding entry of \a toolNames.
+    */
+    static void DecodeRecord(const char *record, const std::vector<std::string> &toolNames,
+                             std::vector<mitk::NavigationData::Pointer> &datas);
+
+    /** \brief Returns the time stamp of the first tool of a record without decoding it. */
+    static mitk::NavigationData::TimeStampType GetTimeStamp(const char *record);
+  };
+}
+
+#endif // MITKNAVIGATIONDATABINARYFORMAT_H_HEADER_INCLUDED_
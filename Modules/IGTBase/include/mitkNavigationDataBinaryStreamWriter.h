@@ -0,0 +1,128 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATABINARYSTREAMWRITER_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATABINARYSTREAMWRITER_H_HEADER_INCLUDED_
+
+#include <MitkIGTBaseExports.h>
+#include "mitkNavigationData.h"
+
+#include <mitkBackgroundFileWriter.h>
+#include <mitkLockFreeRingBuffer.h>
+
+#include <itkObject.h>
+
+#include <atomic>
+#include <memory>
+
+namespace mitk {
+  /**
+  * \brief Writes navigation data incrementally to a binary recording (see mitk::NavigationDataBinaryFormat).
+  *
+  * Write() encodes a time step into a preallocated slot of a lock-free ring buffer and
+  * returns immediately; a background thread (see mitk::BackgroundFileWriter) appends the
+  * buffered time steps to the file.
+  * Thus the thread that records (usually the tracking or pipeline update thread) never
+  * waits for the disk and does not allocate memory per time step.
+  *
+  * Write() must always be called from the same thread. If the disk cannot keep up and
+  * the buffer is full, time steps are dropped and counted (see GetNumberOfDroppedSnapshots()).
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataBinaryStreamWriter : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataBinaryStreamWriter, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Number of time steps the buffer can hold before the writer thread stores them. Default is 8192.
+    * Takes effect on the next call of Open().
+    */
+    itkSetMacro(BufferCapacity, unsigned int);
+    itkGetMacro(BufferCapacity, unsigned int);
+
+    /**
+    * \brief Creates the file, writes its header and starts the writer thread.
+    * A previously opened file is closed.
+    * @throw mitk::IGTIOException if the file cannot be created.
+    */
+    void Open(const std::string &fileName, const std::vector<std::string> &toolNames);
+
+    /**
+    * \brief Writes all buffered time steps, stops the writer thread and closes the file.
+    */
+    void Close();
+
+    bool IsOpen() const;
+
+    /**
+    * \brief Queues one time step for writing.
+    *
+    * @param datas One navigation data per tool, in the order of the tool names given to Open().
+    * @return false if the writer is not open, the number of datas does not match or the buffer is full.
+    */
+    bool Write(const std::vector<NavigationData::Pointer> &datas);
+
+    /**
+    * \brief Blocks until all time steps queued so far are written to the file.
+    * @return false if writing to the file failed, see HasFailed().
+    */
+    bool Flush();
+
+    /**
+    * \brief Returns true if writing to the file failed since Open(). The failure is logged,
+    * time steps written afterwards are discarded.
+    */
+    bool HasFailed() const;
+
+    /**
+    * \brief Returns the number of time steps written by Write() since Open(), including buffered ones.
+    */
+    unsigned int GetNumberOfSnapshots() const;
+
+    /**
+    * \brief Returns the number of time steps that were dropped because the buffer was full.
+    */
+    unsigned int GetNumberOfDroppedSnapshots() const;
+
+    /**
+    * \brief Returns the number of time steps stored in the file successfully.
+    */
+    unsigned int GetNumberOfStoredSnapshots() const;
+
+  protected:
+    NavigationDataBinaryStreamWriter();
+    virtual ~NavigationDataBinaryStreamWriter();
+
+    /** \brief Stores all buffered time steps, called by the thread of m_FileWriter. */
+    unsigned int WriteBufferedSnapshots();
+
+    typedef LockFreeRingBuffer<std::vector<char>> BufferType;
+
+    std::unique_ptr<BufferType> m_Buffer;
+    std::vector<char> m_Record; ///< encoding buffer of the writing thread
+    BackgroundFileWriter m_FileWriter;
+    unsigned int m_NumberOfTools;
+    unsigned int m_BufferCapacity;
+
+    std::atomic<unsigned int> m_NumberOfSnapshots;
+    std::atomic<unsigned int> m_NumberOfDroppedSnapshots;
+  };
+}
+
+#endif // MITKNAVIGATIONDATABINARYSTREAMWRITER_H_HEADER_INCLUDED_
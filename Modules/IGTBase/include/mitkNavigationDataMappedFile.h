@@ -0,0 +1,111 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKNAVIGATIONDATAMAPPEDFILE_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATAMAPPEDFILE_H_HEADER_INCLUDED_
+
+#include <MitkIGTBaseExports.h>
+#include "mitkNavigationDataSet.h"
+
+#include <itkObject.h>
+
+namespace mitk {
+  /**
+  * \brief Read-only access to a binary NavigationDataSet recording (see mitk::NavigationDataBinaryFormat)
+  * via a memory mapping of the file.
+  *
+  * Opening a recording is independent of its length: time steps are only decoded
+  * when they are requested, and the operating system loads the touched pages of
+  * the file on demand. FindSnapshot() locates a time stamp by a binary search on
+  * the mapped records.
+  *
+  * Use mitk::NavigationDataPlayer or mitk::NavigationDataSequentialPlayer to play
+  * a recording directly from the file.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGTBASE_EXPORT NavigationDataMappedFile : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataMappedFile, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Maps the given recording. A previously opened file is closed.
+    * @throw mitk::IGTIOException if the file cannot be mapped or is no valid recording.
+    */
+    void Open(const std::string &fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    itkGetStringMacro(FileName);
+
+    unsigned int GetNumberOfTools() const;
+
+    const std::vector<std::string> &GetToolNames() const;
+
+    /**
+    * \brief Returns the number of complete time steps in the file.
+    */
+    unsigned int GetNumberOfSnapshots() const;
+
+    /**
+    * \brief Returns the time stamp of the first tool at the given time step.
+    */
+    NavigationData::TimeStampType GetTimeStamp(unsigned int snapshot) const;
+
+    /**
+    * \brief Returns the last time step whose time stamp (of the first tool) is not
+    * greater than \a timeStamp, or 0 if all time steps are later.
+    */
+    unsigned int FindSnapshot(NavigationData::TimeStampType timeStamp) const;
+
+    /**
+    * \brief Decodes the given time step into \a datas, one object per tool.
+    *
+    * Objects already contained in \a datas are reused, so no memory is allocated
+    * when the same vector is passed for subsequent calls.
+    */
+    void ReadSnapshot(unsigned int snapshot, std::vector<NavigationData::Pointer> &datas) const;
+
+    /**
+    * \brief Decodes the whole file into a new mitk::NavigationDataSet.
+    */
+    NavigationDataSet::Pointer CreateNavigationDataSet() const;
+
+  protected:
+    NavigationDataMappedFile();
+    virtual ~NavigationDataMappedFile();
+
+    const char *GetRecord(unsigned int snapshot) const;
+
+    std::string m_FileName;
+    std::vector<std::string> m_ToolNames;
+
+    const char *m_Data;
+    std::size_t m_Size;
+    std::size_t m_HeaderSize;
+    std::size_t m_RecordSize;
+    unsigned int m_NumberOfSnapshots;
+
+    void *m_FileHandle;    ///< file handle (Windows only)
+    void *m_MappingHandle; ///< file mapping handle (Windows only)
+  };
+}
+
+#endif // MITKNAVIGATIONDATAMAPPEDFILE_H_HEADER_INCLUDED_
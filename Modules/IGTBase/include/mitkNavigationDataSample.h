@@ -0,0 +1,49 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKNAVIGATIONDATASAMPLE_H_HEADER_INCLUDED_
+#define MITKNAVIGATIONDATASAMPLE_H_HEADER_INCLUDED_
+
+namespace mitk {
+  /**
+  * \brief Plain pose of one tool at one point in time
+  *
+  * Lightweight counterpart of mitk::NavigationData for high-rate processing: it can be
+  * copied with memcpy, stored in preallocated buffers (see
+  * mitk::TrackingDeviceSource::AcquireSamples()) and transformed in batches by the
+  * navigation data filters (see mitk::NavigationDataToNavigationDataFilter::ProcessSamples())
+  * without creating or updating ITK objects. Use NavigationData::SetSample() and
+  * NavigationData::GetSample() to convert between both representations.
+  *
+  * The error characterization is reduced to a single tracking error, which is applied to
+  * position and orientation (see NavigationData::SetPositionAccuracy()).
+  *
+  * \ingroup IGT
+  */
+  struct NavigationDataSample
+  {
+    double Position[3];
+    double Orientation[4]; ///< quaternion in the order x, y, z, r
+    double TrackingError;
+    double IGTTimeStamp;
+    bool DataValid;
+    bool HasPosition;
+    bool HasOrientation;
+  };
+} // namespace mitk
+
+#endif /* MITKNAVIGATIONDATASAMPLE_H_HEADER_INCLUDED_ */
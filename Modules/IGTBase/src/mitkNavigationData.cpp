@@ -18,10 +18,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vnl/vnl_det.h"
 #include "mitkException.h"
 
+#include <algorithm>
+#include <cmath>
+
 mitk::NavigationData::NavigationData() : itk::DataObject(),
 m_Position(), m_Orientation(0.0, 0.0, 0.0, 1.0), m_CovErrorMatrix(),
 m_HasPosition(true), m_HasOrientation(true), m_DataValid(false), m_IGTTimeStamp(0.0),
-m_Name()
+m_Name(), m_NumberOfLatencyStamps(0)
 {
   m_Position.Fill(0.0);
   m_CovErrorMatrix.SetIdentity();
@@ -31,8 +34,11 @@ m_Name()
 mitk::NavigationData::NavigationData(const mitk::NavigationData& toCopy) : itk::DataObject(),
     m_Position(toCopy.GetPosition()), m_Orientation(toCopy.GetOrientation()), m_CovErrorMatrix(toCopy.GetCovErrorMatrix()),
         m_HasPosition(toCopy.GetHasPosition()), m_HasOrientation(toCopy.GetHasOrientation()), m_DataValid(toCopy.IsDataValid()), m_IGTTimeStamp(toCopy.GetIGTTimeStamp()),
-        m_Name(toCopy.GetName())
-{/* TODO SW: Graft does the same, remove code duplications, set Graft to deprecated, remove duplication in tescode */}
+        m_Name(toCopy.GetName()), m_NumberOfLatencyStamps(0)
+{
+  /* TODO SW: Graft does the same, remove code duplications, set Graft to deprecated, remove duplication in tescode */
+  this->CopyLatencyStamps(&toCopy);
+}
 
 mitk::NavigationData::~NavigationData()
 {
@@ -71,6 +77,7 @@ void mitk::NavigationData::Graft( const DataObject *data )
   this->SetHasOrientation(nd->GetHasOrientation());
   this->SetCovErrorMatrix(nd->GetCovErrorMatrix());
   this->SetName(nd->GetName());
+  this->CopyLatencyStamps(nd);
 }
 
 
@@ -80,6 +87,66 @@ bool mitk::NavigationData::IsDataValid() const
 }
 
 
+void mitk::NavigationData::SetSample(const NavigationDataSample& sample)
+{
+  PositionType position;
+  mitk::FillVector3D(position, sample.Position[0], sample.Position[1], sample.Position[2]);
+  this->SetPosition(position);
+  this->SetOrientation(OrientationType(sample.Orientation[0], sample.Orientation[1], sample.Orientation[2], sample.Orientation[3]));
+  this->SetPositionAccuracy(sample.TrackingError);
+  this->SetOrientationAccuracy(sample.TrackingError);
+  this->SetIGTTimeStamp(sample.IGTTimeStamp);
+  this->SetDataValid(sample.DataValid);
+}
+
+
+void mitk::NavigationData::GetSample(NavigationDataSample& sample) const
+{
+  for (unsigned int i = 0; i < 3; ++i)
+    sample.Position[i] = m_Position[i];
+  for (unsigned int i = 0; i < 4; ++i)
+    sample.Orientation[i] = m_Orientation[i];
+  sample.TrackingError = std::sqrt(m_CovErrorMatrix[0][0]);
+  sample.IGTTimeStamp = m_IGTTimeStamp;
+  sample.DataValid = m_DataValid;
+  sample.HasPosition = m_HasPosition;
+  sample.HasOrientation = m_HasOrientation;
+}
+
+void mitk::NavigationData::AddLatencyStamp(TimeStampType time)
+{
+  if (m_NumberOfLatencyStamps < MAXIMUM_NUMBER_OF_LATENCY_STAMPS)
+  {
+    m_LatencyStamps[m_NumberOfLatencyStamps++] = time;
+  }
+}
+
+
+unsigned int mitk::NavigationData::GetNumberOfLatencyStamps() const
+{
+  return m_NumberOfLatencyStamps;
+}
+
+
+mitk::NavigationData::TimeStampType mitk::NavigationData::GetLatencyStamp(unsigned int stage) const
+{
+  return stage < m_NumberOfLatencyStamps ? m_LatencyStamps[stage] : 0.0;
+}
+
+
+void mitk::NavigationData::CopyLatencyStamps(const NavigationData* data)
+{
+  m_NumberOfLatencyStamps = data->m_NumberOfLatencyStamps;
+  std::copy(data->m_LatencyStamps, data->m_LatencyStamps + m_NumberOfLatencyStamps, m_LatencyStamps);
+}
+
+
+void mitk::NavigationData::ClearLatencyStamps()
+{
+  m_NumberOfLatencyStamps = 0;
+}
+
+
 void mitk::NavigationData::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   this->Superclass::PrintSelf(os, indent);
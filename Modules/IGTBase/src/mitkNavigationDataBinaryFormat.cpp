@@ -0,0 +1,227 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataBinaryFormat.h"
+#include "mitkIGTIOException.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+  const char MAGIC[8] = { 'M', 'I', 'T', 'K', 'N', 'D', 'B', '\0' };
+  const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+  const std::size_t FIXED_HEADER_SIZE = sizeof(MAGIC) + 6 * sizeof(std::uint32_t);
+
+  const std::uint64_t FLAG_VALID = 1;
+  const std::uint64_t FLAG_HAS_POSITION = 2;
+  const std::uint64_t FLAG_HAS_ORIENTATION = 4;
+
+  void AppendUInt32(std::string &buffer, std::uint32_t value)
+  {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  std::uint32_t ReadUInt32(const char *data)
+  {
+    std::uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  void WriteDouble(char *&position, double value)
+  {
+    std::memcpy(position, &value, sizeof(value));
+    position += sizeof(value);
+  }
+
+  double ReadDouble(const char *&position)
+  {
+    double value;
+    std::memcpy(&value, position, sizeof(value));
+    position += sizeof(value);
+    return value;
+  }
+}
+
+std::size_t mitk::NavigationDataBinaryFormat::GetRecordSize(unsigned int numberOfTools)
+{
+  return numberOfTools * TOOL_BLOCK_SIZE;
+}
+
+std::string mitk::NavigationDataBinaryFormat::CreateHeader(const std::vector<std::string> &toolNames)
+{
+  std::string header(MAGIC, sizeof(MAGIC));
+  AppendUInt32(header, VERSION);
+  AppendUInt32(header, BYTE_ORDER_MARK);
+  AppendUInt32(header, static_cast<std::uint32_t>(toolNames.size()));
+  AppendUInt32(header, static_cast<std::uint32_t>(GetRecordSize(toolNames.size())));
+  AppendUInt32(header, 0); // header size, set below
+  AppendUInt32(header, 0); // reserved
+
+  for (auto toolName = toolNames.begin(); toolName != toolNames.end(); ++toolName)
+  {
+    AppendUInt32(header, static_cast<std::uint32_t>(toolName->size()));
+    header.append(*toolName);
+  }
+
+  // records start 8 byte aligned
+  header.resize((header.size() + 7) / 8 * 8, '\0');
+
+  std::uint32_t headerSize = static_cast<std::uint32_t>(header.size());
+  std::memcpy(&header[sizeof(MAGIC) + 4 * sizeof(std::uint32_t)], &headerSize, sizeof(headerSize));
+
+  return header;
+}
+
+void mitk::NavigationDataBinaryFormat::ParseHeader(const char *data, std::size_t size,
+                                                   std::vector<std::string> &toolNames, std::size_t &headerSize)
+{
+  if (size < FIXED_HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Not a binary NavigationDataSet recording.";
+  }
+
+  const char *field = data + sizeof(MAGIC);
+  std::uint32_t version = ReadUInt32(field);
+  std::uint32_t byteOrderMark = ReadUInt32(field + 4);
+  std::uint32_t numberOfTools = ReadUInt32(field + 8);
+  std::uint32_t recordSize = ReadUInt32(field + 12);
+  headerSize = ReadUInt32(field + 16);
+
+  if (version != VERSION)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Unsupported version " << version
+                                             << " of binary NavigationDataSet recording.";
+  }
+  if (byteOrderMark != BYTE_ORDER_MARK)
+  {
+    mitkThrowException(mitk::IGTIOException)
+      << "Binary NavigationDataSet recording was written with another byte order.";
+  }
+  if (recordSize != GetRecordSize(numberOfTools) || headerSize > size || headerSize < FIXED_HEADER_SIZE)
+  {
+    mitkThrowException(mitk::IGTIOException) << "Corrupt header of binary NavigationDataSet recording.";
+  }
+
+  toolNames.clear();
+  std::size_t offset = FIXED_HEADER_SIZE;
+  for (std::uint32_t i = 0; i < numberOfTools; ++i)
+  {
+    if (offset + sizeof(std::uint32_t) > headerSize)
+    {
+      mitkThrowException(mitk::IGTIOException) << "Corrupt tool names in binary NavigationDataSet recording.";
+    }
+    std::uint32_t length = ReadUInt32(data + offset);
+    offset += sizeof(std::uint32_t);
+
+    if (offset + length > headerSize)
+    {
+      mitkThrowException(mitk::IGTIOException) << "Corrupt tool names in binary NavigationDataSet recording.";
+    }
+    toolNames.push_back(std::string(data + offset, length));
+    offset += length;
+  }
+}
+
+void mitk::NavigationDataBinaryFormat::EncodeRecord(const std::vector<mitk::NavigationData::Pointer> &datas,
+                                                    char *record)
+{
+  char *position = record;
+  for (auto data = datas.begin(); data != datas.end(); ++data)
+  {
+    const mitk::NavigationData *nd = data->GetPointer();
+
+    WriteDouble(position, nd->GetIGTTimeStamp());
+
+    const mitk::NavigationData::PositionType &point = nd->GetPosition();
+    for (unsigned int i = 0; i < 3; ++i)
+      WriteDouble(position, point[i]);
+
+    const mitk::NavigationData::OrientationType &orientation = nd->GetOrientation();
+    for (unsigned int i = 0; i < 4; ++i)
+      WriteDouble(position, orientation[i]);
+
+    const mitk::NavigationData::CovarianceMatrixType &covariance = nd->GetCovErrorMatrix();
+    for (unsigned int row = 0; row < 6; ++row)
+      for (unsigned int column = row; column < 6; ++column)
+        WriteDouble(position, covariance[row][column]);
+
+    std::uint64_t flags = 0;
+    if (nd->IsDataValid())
+      flags |= FLAG_VALID;
+    if (nd->GetHasPosition())
+      flags |= FLAG_HAS_POSITION;
+    if (nd->GetHasOrientation())
+      flags |= FLAG_HAS_ORIENTATION;
+    std::memcpy(position, &flags, sizeof(flags));
+    position += sizeof(flags);
+  }
+}
+
+void mitk::NavigationDataBinaryFormat::DecodeRecord(const char *record, const std::vector<std::string> &toolNames,
+                                                    std::vector<mitk::NavigationData::Pointer> &datas)
+{
+  datas.resize(toolNames.size());
+
+  const char *position = record;
+  for (std::size_t tool = 0; tool < toolNames.size(); ++tool)
+  {
+    if (datas[tool].IsNull())
+    {
+      datas[tool] = mitk::NavigationData::New();
+    }
+    mitk::NavigationData *nd = datas[tool];
+
+    nd->SetIGTTimeStamp(ReadDouble(position));
+
+    mitk::NavigationData::PositionType point;
+    for (unsigned int i = 0; i < 3; ++i)
+      point[i] = ReadDouble(position);
+    nd->SetPosition(point);
+
+    double x = ReadDouble(position);
+    double y = ReadDouble(position);
+    double z = ReadDouble(position);
+    double r = ReadDouble(position);
+    nd->SetOrientation(mitk::NavigationData::OrientationType(x, y, z, r));
+
+    mitk::NavigationData::CovarianceMatrixType covariance;
+    for (unsigned int row = 0; row < 6; ++row)
+    {
+      for (unsigned int column = row; column < 6; ++column)
+      {
+        covariance[row][column] = ReadDouble(position);
+        covariance[column][row] = covariance[row][column];
+      }
+    }
+    nd->SetCovErrorMatrix(covariance);
+
+    std::uint64_t flags;
+    std::memcpy(&flags, position, sizeof(flags));
+    position += sizeof(flags);
+    nd->SetDataValid((flags & FLAG_VALID) != 0);
+    nd->SetHasPosition((flags & FLAG_HAS_POSITION) != 0);
+    nd->SetHasOrientation((flags & FLAG_HAS_ORIENTATION) != 0);
+
+    nd->SetName(toolNames[tool].c_str());
+  }
+}
+
+mitk::NavigationData::TimeStampType mitk::NavigationDataBinaryFormat::GetTimeStamp(const char *record)
+{
+  return ReadDouble(record);
+}
@@ -0,0 +1,130 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataBinaryStreamWriter.h"
+#include "mitkNavigationDataBinaryFormat.h"
+#include "mitkIGTIOException.h"
+
+mitk::NavigationDataBinaryStreamWriter::NavigationDataBinaryStreamWriter()
+  : m_NumberOfTools(0), m_BufferCapacity(8192), m_NumberOfSnapshots(0), m_NumberOfDroppedSnapshots(0)
+{
+}
+
+mitk::NavigationDataBinaryStreamWriter::~NavigationDataBinaryStreamWriter()
+{
+  this->Close();
+}
+
+void mitk::NavigationDataBinaryStreamWriter::Open(const std::string &fileName,
+                                                  const std::vector<std::string> &toolNames)
+{
+  this->Close();
+
+  std::string header = NavigationDataBinaryFormat::CreateHeader(toolNames);
+  if (!m_FileWriter.Open(fileName, header.data(), header.size()))
+  {
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' could not be opened for writing.";
+  }
+
+  m_NumberOfTools = toolNames.size();
+  m_NumberOfSnapshots = 0;
+  m_NumberOfDroppedSnapshots = 0;
+
+  // all slots get their final size here, Write() only copies into them
+  m_Record.assign(NavigationDataBinaryFormat::GetRecordSize(m_NumberOfTools), '\0');
+  m_Buffer.reset(new BufferType(m_BufferCapacity, m_Record));
+
+  m_FileWriter.Start([this]() { return this->WriteBufferedSnapshots(); });
+
+  this->Modified();
+}
+
+void mitk::NavigationDataBinaryStreamWriter::Close()
+{
+  if (m_FileWriter.IsOpen())
+  {
+    m_FileWriter.Close();
+    this->Modified();
+  }
+
+  m_Buffer.reset();
+}
+
+bool mitk::NavigationDataBinaryStreamWriter::IsOpen() const
+{
+  return m_FileWriter.IsOpen();
+}
+
+bool mitk::NavigationDataBinaryStreamWriter::Write(const std::vector<mitk::NavigationData::Pointer> &datas)
+{
+  if (m_Buffer == nullptr || datas.size() != m_NumberOfTools)
+  {
+    return false;
+  }
+
+  NavigationDataBinaryFormat::EncodeRecord(datas, m_Record.data());
+
+  if (!m_Buffer->TryPush(m_Record))
+  {
+    ++m_NumberOfDroppedSnapshots;
+    return false;
+  }
+
+  m_FileWriter.RecordQueued();
+  ++m_NumberOfSnapshots;
+  return true;
+}
+
+bool mitk::NavigationDataBinaryStreamWriter::Flush()
+{
+  return m_FileWriter.Flush();
+}
+
+bool mitk::NavigationDataBinaryStreamWriter::HasFailed() const
+{
+  return m_FileWriter.HasFailed();
+}
+
+unsigned int mitk::NavigationDataBinaryStreamWriter::GetNumberOfSnapshots() const
+{
+  return m_NumberOfSnapshots;
+}
+
+unsigned int mitk::NavigationDataBinaryStreamWriter::GetNumberOfDroppedSnapshots() const
+{
+  return m_NumberOfDroppedSnapshots;
+}
+
+unsigned int mitk::NavigationDataBinaryStreamWriter::GetNumberOfStoredSnapshots() const
+{
+  return m_FileWriter.GetNumberOfStoredRecords();
+}
+
+unsigned int mitk::NavigationDataBinaryStreamWriter::WriteBufferedSnapshots()
+{
+  unsigned int taken = 0;
+
+  const std::vector<char> *record;
+  while ((record = m_Buffer->Front()) != nullptr)
+  {
+    // after a failure the records are still taken from the buffer, BackgroundFileWriter discards them
+    m_FileWriter.Write(record->data(), record->size());
+    m_Buffer->PopFront();
+    ++taken;
+  }
+
+  return taken;
+}
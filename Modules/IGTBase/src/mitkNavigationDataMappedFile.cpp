@@ -0,0 +1,223 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkNavigationDataMappedFile.h"
+#include "mitkNavigationDataBinaryFormat.h"
+#include "mitkIGTIOException.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mitk::NavigationDataMappedFile::NavigationDataMappedFile()
+  : m_Data(nullptr), m_Size(0), m_HeaderSize(0), m_RecordSize(0), m_NumberOfSnapshots(0),
+  m_FileHandle(nullptr), m_MappingHandle(nullptr)
+{
+}
+
+mitk::NavigationDataMappedFile::~NavigationDataMappedFile()
+{
+  this->Close();
+}
+
+void mitk::NavigationDataMappedFile::Open(const std::string &fileName)
+{
+  this->Close();
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' could not be opened.";
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(file);
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' is empty.";
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const void *data = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (data == nullptr)
+  {
+    if (mapping != nullptr)
+      CloseHandle(mapping);
+    CloseHandle(file);
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' could not be mapped.";
+  }
+
+  m_FileHandle = file;
+  m_MappingHandle = mapping;
+  m_Size = static_cast<std::size_t>(size.QuadPart);
+#else
+  int file = open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+  {
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' could not be opened.";
+  }
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+  {
+    close(file);
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' is empty.";
+  }
+
+  void *data = mmap(nullptr, static_cast<std::size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, file, 0);
+  close(file); // the mapping keeps its own reference to the file
+  if (data == MAP_FAILED)
+  {
+    mitkThrowException(mitk::IGTIOException) << "File '" << fileName << "' could not be mapped.";
+  }
+
+  m_Size = static_cast<std::size_t>(fileStatus.st_size);
+#endif
+
+  m_Data = static_cast<const char *>(data);
+  m_FileName = fileName;
+
+  try
+  {
+    NavigationDataBinaryFormat::ParseHeader(m_Data, m_Size, m_ToolNames, m_HeaderSize);
+  }
+  catch (...)
+  {
+    this->Close();
+    throw;
+  }
+
+  m_RecordSize = NavigationDataBinaryFormat::GetRecordSize(m_ToolNames.size());
+  // an incomplete last record (e.g. of an interrupted recording) is ignored
+  m_NumberOfSnapshots = m_RecordSize > 0 ? static_cast<unsigned int>((m_Size - m_HeaderSize) / m_RecordSize) : 0;
+
+  this->Modified();
+}
+
+void mitk::NavigationDataMappedFile::Close()
+{
+  if (m_Data == nullptr)
+  {
+    return;
+  }
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_Data);
+  CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+  CloseHandle(static_cast<HANDLE>(m_FileHandle));
+  m_MappingHandle = nullptr;
+  m_FileHandle = nullptr;
+#else
+  munmap(const_cast<char *>(m_Data), m_Size);
+#endif
+
+  m_Data = nullptr;
+  m_Size = 0;
+  m_HeaderSize = 0;
+  m_RecordSize = 0;
+  m_NumberOfSnapshots = 0;
+  m_ToolNames.clear();
+  m_FileName.clear();
+
+  this->Modified();
+}
+
+bool mitk::NavigationDataMappedFile::IsOpen() const
+{
+  return m_Data != nullptr;
+}
+
+unsigned int mitk::NavigationDataMappedFile::GetNumberOfTools() const
+{
+  return m_ToolNames.size();
+}
+
+const std::vector<std::string> &mitk::NavigationDataMappedFile::GetToolNames() const
+{
+  return m_ToolNames;
+}
+
+unsigned int mitk::NavigationDataMappedFile::GetNumberOfSnapshots() const
+{
+  return m_NumberOfSnapshots;
+}
+
+const char *mitk::NavigationDataMappedFile::GetRecord(unsigned int snapshot) const
+{
+  if (snapshot >= m_NumberOfSnapshots)
+  {
+    mitkThrowException(mitk::IGTException) << "Snapshot " << snapshot << " does not exist in '" << m_FileName
+                                           << "', which has " << m_NumberOfSnapshots << " snapshots.";
+  }
+
+  return m_Data + m_HeaderSize + static_cast<std::size_t>(snapshot) * m_RecordSize;
+}
+
+mitk::NavigationData::TimeStampType mitk::NavigationDataMappedFile::GetTimeStamp(unsigned int snapshot) const
+{
+  return NavigationDataBinaryFormat::GetTimeStamp(this->GetRecord(snapshot));
+}
+
+unsigned int mitk::NavigationDataMappedFile::FindSnapshot(NavigationData::TimeStampType timeStamp) const
+{
+  // time stamps are strictly increasing (see NavigationDataSet::AddNavigationDatas()),
+  // search the first snapshot later than timeStamp
+  unsigned int first = 0;
+  unsigned int count = m_NumberOfSnapshots;
+  while (count > 0)
+  {
+    unsigned int step = count / 2;
+    unsigned int middle = first + step;
+    if (NavigationDataBinaryFormat::GetTimeStamp(m_Data + m_HeaderSize + middle * m_RecordSize) <= timeStamp)
+    {
+      first = middle + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+
+  return first > 0 ? first - 1 : 0;
+}
+
+void mitk::NavigationDataMappedFile::ReadSnapshot(unsigned int snapshot,
+                                                  std::vector<NavigationData::Pointer> &datas) const
+{
+  NavigationDataBinaryFormat::DecodeRecord(this->GetRecord(snapshot), m_ToolNames, datas);
+}
+
+mitk::NavigationDataSet::Pointer mitk::NavigationDataMappedFile::CreateNavigationDataSet() const
+{
+  NavigationDataSet::Pointer navigationDataSet = NavigationDataSet::New(this->GetNumberOfTools());
+
+  for (unsigned int snapshot = 0; snapshot < m_NumberOfSnapshots; ++snapshot)
+  {
+    std::vector<NavigationData::Pointer> datas;
+    this->ReadSnapshot(snapshot, datas);
+    navigationDataSet->AddNavigationDatas(datas);
+  }
+
+  return navigationDataSet;
+}
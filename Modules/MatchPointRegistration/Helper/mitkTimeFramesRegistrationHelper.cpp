@@ -23,6 +23,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkMaskedAlgorithmHelper.h>
 #include <mitkAlgorithmHelper.h>
 
+#include <itkMutexLockHolder.h>
+
+#include <mapMetaPropertyAlgorithmInterface.h>
+
+#include <algorithm>
+#include <exception>
+
 mitk::Image::Pointer
 mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
     mitk::TimePointType timePoint) const
@@ -36,6 +43,60 @@ mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
   return frameImage;
 };
 
+struct mitk::TimeFramesRegistrationHelper::FrameRegistrationJob
+{
+  TimeFramesRegistrationHelper* Helper;
+  const mitk::Image* TargetFrame;
+  const mitk::Image* TargetMask;
+
+  /** One algorithm per thread, indexed by the thread id.*/
+  std::vector<RegistrationAlgorithmPointer> Algorithms;
+  FrameChunkListType Chunks;
+
+  itk::SimpleFastMutexLock Mutex;
+  std::size_t NextChunk;
+  std::exception_ptr Error;
+};
+
+ITK_THREAD_RETURN_TYPE
+mitk::TimeFramesRegistrationHelper::FrameRegistrationThread(void* arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType* infoStruct = static_cast<ThreadInfoType*>(arg);
+  FrameRegistrationJob* job = static_cast<FrameRegistrationJob*>(infoStruct->UserData);
+
+  RegistrationAlgorithmBaseType* algorithm = job->Algorithms[infoStruct->ThreadID];
+
+  while (true)
+  {
+    std::size_t chunk;
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(job->Mutex);
+      // stop all threads after the first failure, the error is rethrown by Generate()
+      if (job->Error || job->NextChunk >= job->Chunks.size())
+      {
+        break;
+      }
+      chunk = job->NextChunk++;
+    }
+
+    try
+    {
+      job->Helper->ProcessFrames(algorithm, job->Chunks[chunk], job->TargetFrame, job->TargetMask);
+    }
+    catch (...)
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(job->Mutex);
+      if (!job->Error)
+      {
+        job->Error = std::current_exception();
+      }
+    }
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 void
 mitk::TimeFramesRegistrationHelper::Generate()
 {
@@ -44,7 +105,12 @@ mitk::TimeFramesRegistrationHelper::Generate()
   //prepare processing
   mitk::Image::Pointer targetFrame = GetFrameImage(this->m_4DImage, 0);
 
-  this->m_Registered4DImage = this->m_4DImage->Clone();
+  //allocate the result only, the registered frames are stored into it directly. Only
+  //the target frame and the ignored frames are copied from the input image.
+  this->m_Registered4DImage = mitk::Image::New();
+  this->m_Registered4DImage->Initialize(this->m_4DImage);
+  this->m_Registered4DImage->SetPropertyList(this->m_4DImage->GetPropertyList()->Clone());
+  this->CopyFrame(0);
 
   Image::ConstPointer mask;
 
@@ -60,51 +126,196 @@ mitk::TimeFramesRegistrationHelper::Generate()
     }
   }
 
-  double progressDelta = 1.0 / ((this->m_4DImage->GetTimeSteps() - 1) * 3.0);
+  m_ProgressDelta = 1.0 / ((this->m_4DImage->GetTimeSteps() - 1) * 3.0);
   m_Progress = 0.0;
 
-  //process the frames
+  IgnoreListType frames;
+
   for (unsigned int i = 1; i < this->m_4DImage->GetTimeSteps(); ++i)
   {
-    Image::Pointer movingFrame = GetFrameImage(this->m_4DImage, i);
-    Image::Pointer mappedFrame;
-
     IgnoreListType::iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
 
-
     if (finding == m_IgnoreList.end())
     {
-      //frame should be processed
-      RegistrationPointer reg = DoFrameRegistration(movingFrame, targetFrame, mask);
+      frames.push_back(i);
+    }
+    else
+    {
+      this->CopyFrame(i);
 
-      m_Progress += progressDelta;
-      this->InvokeEvent(::mitk::FrameRegistrationEvent(0,
-                        "Registred frame #" +::map::core::convert::toStr(i)));
+      m_Progress += 3 * m_ProgressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
+    }
+  }
 
-      mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
+  //set up one algorithm per thread
+  FrameRegistrationJob job;
+  job.Helper = this;
+  job.TargetFrame = targetFrame;
+  job.TargetMask = mask;
+  job.NextChunk = 0;
+  job.Algorithms.push_back(m_Algorithm);
 
-      m_Progress += progressDelta;
-      this->InvokeEvent(::mitk::FrameMappingEvent(0,
-                        "Mapped frame #" + ::map::core::convert::toStr(i)));
+  if (m_ConcurrentFrameRegistration)
+  {
+    const std::size_t numberOfThreads = std::min<std::size_t>(
+      itk::MultiThreader::GetGlobalDefaultNumberOfThreads(), frames.size());
 
-      mitk::ImageReadAccessor accessor(mappedFrame, mappedFrame->GetVolumeData(0, 0, nullptr,
-                                       mitk::Image::ReferenceMemory));
+    while (job.Algorithms.size() < numberOfThreads)
+    {
+      RegistrationAlgorithmPointer clone = this->CloneAlgorithm();
+      if (clone.IsNull())
+      {
+        MITK_WARN << "Cannot create copies of the registration algorithm. Frames are registered sequentially.";
+        job.Algorithms.resize(1);
+        break;
+      }
+      job.Algorithms.push_back(clone);
+    }
+  }
 
+  //With warm start every thread gets a contiguous range of frames, as each frame starts from the result
+  //of its predecessor. Otherwise the frames are handed out one by one to balance the load.
+  if (m_WarmStartFunction)
+  {
+    const std::size_t numberOfChunks = job.Algorithms.size();
+    for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      job.Chunks.push_back(IgnoreListType(frames.begin() + frames.size() * chunk / numberOfChunks,
+                                          frames.begin() + frames.size() * (chunk + 1) / numberOfChunks));
+    }
+  }
+  else
+  {
+    for (IgnoreListType::const_iterator pos = frames.begin(); pos != frames.end(); ++pos)
+    {
+      job.Chunks.push_back(IgnoreListType(1, *pos));
+    }
+  }
 
-      this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
-      this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(mappedFrame->GetGeometry(), i);
+  //process the frames
+  if (job.Algorithms.size() > 1)
+  {
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(job.Algorithms.size());
+    threader->SetSingleMethod(FrameRegistrationThread, &job);
+    threader->SingleMethodExecute();
 
-      m_Progress += progressDelta;
+    if (job.Error)
+    {
+      std::rethrow_exception(job.Error);
     }
-    else
+  }
+  else
+  {
+    for (FrameChunkListType::const_iterator pos = job.Chunks.begin(); pos != job.Chunks.end(); ++pos)
     {
-      m_Progress += 3 * progressDelta;
+      this->ProcessFrames(m_Algorithm, *pos, targetFrame, mask);
     }
+  }
+};
 
-    this->InvokeEvent(::itk::ProgressEvent());
+void
+mitk::TimeFramesRegistrationHelper::ProcessFrames(RegistrationAlgorithmBaseType* algorithm,
+    const IgnoreListType& frames, const mitk::Image* targetFrame, const mitk::Image* targetMask)
+{
+  RegistrationPointer previousReg;
 
+  for (IgnoreListType::const_iterator pos = frames.begin(); pos != frames.end(); ++pos)
+  {
+    Image::Pointer movingFrame;
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ResultMutex);
+      movingFrame = GetFrameImage(this->m_4DImage, *pos);
+    }
+
+    if (m_WarmStartFunction && previousReg.IsNotNull())
+    {
+      m_WarmStartFunction(algorithm, previousReg);
+    }
+
+    RegistrationPointer reg = DoFrameRegistration(algorithm, movingFrame, targetFrame, targetMask);
+
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ResultMutex);
+      m_Progress += m_ProgressDelta;
+      this->InvokeEvent(::mitk::FrameRegistrationEvent(0,
+                        "Registred frame #" +::map::core::convert::toStr(*pos)));
+    }
+
+    Image::Pointer mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
+
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ResultMutex);
+      m_Progress += m_ProgressDelta;
+      this->InvokeEvent(::mitk::FrameMappingEvent(0,
+                        "Mapped frame #" + ::map::core::convert::toStr(*pos)));
+
+      StoreFrame(mappedFrame, *pos);
+
+      m_Progress += m_ProgressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
+    }
+
+    previousReg = reg;
+  }
+};
+
+void
+mitk::TimeFramesRegistrationHelper::CopyFrame(mitk::TimeStepType frame)
+{
+  mitk::ImageReadAccessor accessor(this->m_4DImage, this->m_4DImage->GetVolumeData(frame));
+  this->m_Registered4DImage->SetVolume(accessor.GetData(), frame);
+};
+
+void
+mitk::TimeFramesRegistrationHelper::StoreFrame(const mitk::Image* frameImage, mitk::TimeStepType frame)
+{
+  mitk::ImageReadAccessor accessor(frameImage, frameImage->GetVolumeData(0, 0, nullptr,
+                                   mitk::Image::ReferenceMemory));
+
+  this->m_Registered4DImage->SetVolume(accessor.GetData(), frame);
+  this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(frameImage->GetGeometry(), frame);
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer
+mitk::TimeFramesRegistrationHelper::CloneAlgorithm() const
+{
+  //the configuration of the algorithm is only accessible via its meta properties, without them
+  //a copy would not be configured like m_Algorithm
+  typedef ::map::algorithm::facet::MetaPropertyAlgorithmInterface MetaInterfaceType;
+  MetaInterfaceType* source = dynamic_cast<MetaInterfaceType*>(m_Algorithm.GetPointer());
+
+  if (!source)
+  {
+    return nullptr;
+  }
+
+  RegistrationAlgorithmPointer clone =
+    dynamic_cast<RegistrationAlgorithmBaseType*>(m_Algorithm->CreateAnother().GetPointer());
+  MetaInterfaceType* destination = dynamic_cast<MetaInterfaceType*>(clone.GetPointer());
+
+  if (!destination)
+  {
+    return nullptr;
+  }
+
+  MetaInterfaceType::MetaPropertyVectorType infos = source->getPropertyInfos();
+
+  for (MetaInterfaceType::MetaPropertyVectorType::const_iterator pos = infos.begin(); pos != infos.end(); ++pos)
+  {
+    if ((*pos)->isReadable() && (*pos)->isWritable())
+    {
+      MetaInterfaceType::MetaPropertyPointer prop = source->getProperty(*pos);
+
+      if (prop.IsNull() || !destination->setProperty(*pos, prop))
+      {
+        return nullptr;
+      }
+    }
   }
 
+  return clone;
 };
 
 mitk::Image::Pointer
@@ -126,6 +337,19 @@ SetIgnoreList(const IgnoreListType& il)
   this->Modified();
 }
 
+void
+mitk::TimeFramesRegistrationHelper::SetWarmStartFunction(const WarmStartFunctionType& function)
+{
+  m_WarmStartFunction = function;
+  this->Modified();
+}
+
+const mitk::TimeFramesRegistrationHelper::WarmStartFunctionType&
+mitk::TimeFramesRegistrationHelper::GetWarmStartFunction() const
+{
+  return m_WarmStartFunction;
+}
+
 void
 mitk::TimeFramesRegistrationHelper::ClearIgnoreList()
 {
@@ -138,13 +362,20 @@ mitk::TimeFramesRegistrationHelper::RegistrationPointer
 mitk::TimeFramesRegistrationHelper::DoFrameRegistration(const mitk::Image* movingFrame,
     const mitk::Image* targetFrame, const mitk::Image* targetMask) const
 {
-  mitk::MITKAlgorithmHelper algHelper(m_Algorithm);
+  return DoFrameRegistration(m_Algorithm, movingFrame, targetFrame, targetMask);
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationPointer
+mitk::TimeFramesRegistrationHelper::DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm,
+    const mitk::Image* movingFrame, const mitk::Image* targetFrame, const mitk::Image* targetMask) const
+{
+  mitk::MITKAlgorithmHelper algHelper(algorithm);
   algHelper.SetAllowImageCasting(true);
   algHelper.SetData(movingFrame, targetFrame);
 
   if (targetMask)
   {
-    mitk::MaskedAlgorithmHelper maskHelper(m_Algorithm);
+    mitk::MaskedAlgorithmHelper maskHelper(algorithm);
     maskHelper.SetMasks(NULL, targetMask);
   }
 
@@ -26,6 +26,11 @@
 #include <mapRegistrationBase.h>
 #include <mapEvents.h>
 
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <functional>
+
 #include "MitkMatchPointRegistrationExports.h"
 
 namespace mitk
@@ -43,6 +48,15 @@ namespace mitk
    * - mitk::FrameRegistrationEvent: when ever a frame was registered.
    * - mitk::FrameMappingEvent: when ever a frame was mapped registered.
    * - itk::ProgressEvent: when ever a new frame was added to the result image.
+   *
+   * If ConcurrentFrameRegistration is on, the frames are registered by several threads, each with its own
+   * copy of the algorithm (created by CreateAnother() and configured with the meta properties of the set
+   * algorithm). Algorithms without meta properties cannot be copied, their frames are registered sequentially.
+   * The global ITK default number of threads is not changed, so the ITK filters used by the algorithms and the
+   * mapping of each thread may use all of them. Observers of the set algorithm do not receive the algorithm events
+   * of the copies, the events of the helper itself are invoked one at a time but possibly from worker threads.
+   * If a warm start function is set, frames are processed in ascending order in contiguous chunks (one per
+   * thread) and the function is called before each frame with the registration of the preceding frame of the chunk.
    */
   class MITKMATCHPOINTREGISTRATION_EXPORT TimeFramesRegistrationHelper : public itk::Object
   {
@@ -58,6 +72,10 @@ namespace mitk
 
     typedef std::vector<mitk::TimeStepType> IgnoreListType;
 
+    /** Function that prepares the algorithm for the registration of a frame with the registration of
+     * the preceding frame, e.g. by setting the initial transform of the algorithm.*/
+    typedef std::function<void(RegistrationAlgorithmBaseType*, const RegistrationType*)> WarmStartFunctionType;
+
     itkSetConstObjectMacro(4DImage, Image);
     itkGetConstObjectMacro(4DImage, Image);
 
@@ -82,6 +100,15 @@ namespace mitk
     itkSetMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
     itkGetConstMacro(InterpolatorType, mitk::ImageMappingInterpolator::Type);
 
+    itkSetMacro(ConcurrentFrameRegistration, bool);
+    itkGetConstMacro(ConcurrentFrameRegistration, bool);
+    itkBooleanMacro(ConcurrentFrameRegistration);
+
+    /** Sets the function used to warm start the registration of a frame. Pass an empty function to
+     * register every frame from the initial state of the algorithm (default).*/
+    void SetWarmStartFunction(const WarmStartFunctionType& function);
+    const WarmStartFunctionType& GetWarmStartFunction() const;
+
     /** cleares the ignore list. Therefore all frames will be processed.*/
     void ClearIgnoreList();
     void SetIgnoreList(const IgnoreListType& il);
@@ -108,8 +135,9 @@ namespace mitk
     Image::Pointer GetRegisteredImage();
 
   protected:
-    TimeFramesRegistrationHelper() : m_Progress(0), m_AllowUndefPixels(true), m_PaddingValue(0),
-      m_AllowUnregPixels(true), m_ErrorValue(0), m_InterpolatorType(mitk::ImageMappingInterpolator::Linear)
+    TimeFramesRegistrationHelper() : m_AllowUndefPixels(true), m_PaddingValue(0),
+      m_AllowUnregPixels(true), m_ErrorValue(0), m_InterpolatorType(mitk::ImageMappingInterpolator::Linear),
+      m_ConcurrentFrameRegistration(false), m_Progress(0), m_ProgressDelta(0)
     {
       m_4DImage = NULL;
       m_TargetMask = NULL;
@@ -121,6 +149,10 @@ namespace mitk
     RegistrationPointer DoFrameRegistration(const mitk::Image* movingFrame,
                                             const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
 
+    /** Registers the frame with the passed algorithm instead of m_Algorithm.*/
+    RegistrationPointer DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm, const mitk::Image* movingFrame,
+                                            const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
+
     mitk::Image::Pointer DoFrameMapping(const mitk::Image* movingFrame, const RegistrationType* reg,
                                         const mitk::Image* targetFrame) const;
 
@@ -131,9 +163,25 @@ namespace mitk
 
     mitk::Image::Pointer GetFrameImage(const mitk::Image* image, mitk::TimePointType timePoint) const;
 
+    /** Creates a new instance of the algorithm type with the meta properties of m_Algorithm.
+     * Returns NULL if the algorithm cannot be copied, e.g. because it has no meta properties.*/
+    RegistrationAlgorithmPointer CloneAlgorithm() const;
+
     RegistrationAlgorithmPointer m_Algorithm;
 
   private:
+    typedef std::vector<IgnoreListType> FrameChunkListType;
+    struct FrameRegistrationJob;
+
+    /** Registers and maps the frames of the chunk in the given order and stores them in the result image.*/
+    void ProcessFrames(RegistrationAlgorithmBaseType* algorithm, const IgnoreListType& frames,
+                       const mitk::Image* targetFrame, const mitk::Image* targetMask);
+    /** Copies the frame of the input image into the result image.*/
+    void CopyFrame(mitk::TimeStepType frame);
+    void StoreFrame(const mitk::Image* frameImage, mitk::TimeStepType frame);
+
+    static ITK_THREAD_RETURN_TYPE FrameRegistrationThread(void* arg);
+
     Image::ConstPointer m_4DImage;
     Image::ConstPointer m_TargetMask;
     Image::Pointer m_Registered4DImage;
@@ -151,7 +199,13 @@ namespace mitk
     /** Type of interpolator. Only relevant for images and if m_doGeometryRefinement is false. */
     mitk::ImageMappingInterpolator::Type m_InterpolatorType;
 
+    bool m_ConcurrentFrameRegistration;
+    WarmStartFunctionType m_WarmStartFunction;
+
     double m_Progress;
+    double m_ProgressDelta;
+    /** Guards the result image, the progress and the invocation of events while frames are processed concurrently.*/
+    itk::SimpleFastMutexLock m_ResultMutex;
   };
 
 }
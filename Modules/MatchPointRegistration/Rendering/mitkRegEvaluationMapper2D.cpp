@@ -66,12 +66,54 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 //ITK
 #include <itkRGBAPixel.h>
+#include <itkLinearInterpolateImageFunction.h>
 #include <mitkRenderingModeProperty.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <cmath>
+#include <limits>
 
 //MatchPoint
 #include <mitkRegEvaluationObject.h>
 #include <mitkImageMappingHelper.h>
 
+namespace
+{
+  /** number of slices per renderer whose sampled registration kernel is kept*/
+  const std::size_t MAXIMUM_NUMBER_OF_CACHED_SLICES = 4;
+
+  template <typename TPixelType, unsigned int VImageDimension>
+  void SampleMovingSlice(const itk::Image<TPixelType, VImageDimension>* input,
+    const std::vector< itk::Point<float, 3> >* points, mitk::Image* result)
+  {
+    typedef itk::Image<TPixelType, VImageDimension> ImageType;
+    typedef itk::LinearInterpolateImageFunction<ImageType, double> InterpolatorType;
+
+    typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+    interpolator->SetInputImage(input);
+
+    mitk::ImageWriteAccessor accessor(result);
+    TPixelType* pixel = static_cast<TPixelType*>(accessor.GetData());
+
+    typename InterpolatorType::PointType point;
+    for (std::vector< itk::Point<float, 3> >::const_iterator pos = points->begin(); pos != points->end(); ++pos, ++pixel)
+    {
+      point.CastFrom(*pos);
+
+      //pixels that are not mapped or outside of the moving image get the padding/error value 0
+      if (!std::isnan(point[0]) && interpolator->IsInsideBuffer(point))
+      {
+        *pixel = static_cast<TPixelType>(interpolator->Evaluate(point));
+      }
+      else
+      {
+        *pixel = TPixelType(0);
+      }
+    }
+  }
+}
+
 mitk::RegEvaluationMapper2D::RegEvaluationMapper2D()
 {
 }
@@ -286,8 +328,12 @@ void mitk::RegEvaluationMapper2D::GenerateDataForRenderer( mitk::BaseRenderer *r
     movingInput->GetMTime() > localStorage->m_LastUpdateTime ||
     reg->GetMTime() > localStorage->m_LastUpdateTime)
   {
-    //Map moving image
-    localStorage->m_slicedMappedImage = mitk::ImageMappingHelper::map(movingInput,reg,false,0,localStorage->m_slicedTargetImage->GetGeometry(),false,0);
+    //Map moving image. Only the visible slice is resampled directly; the generic mapping
+    //is used for the data the direct path does not support.
+    if (!this->MapMovingSlice(localStorage, movingInput, reg))
+    {
+      localStorage->m_slicedMappedImage = mitk::ImageMappingHelper::map(movingInput,reg,false,0,localStorage->m_slicedTargetImage->GetGeometry(),false,0);
+    }
     updated = true;
   }
 
@@ -449,6 +495,99 @@ void mitk::RegEvaluationMapper2D::GenerateDataForRenderer( mitk::BaseRenderer *r
 }
 
 
+bool mitk::RegEvaluationMapper2D::MapMovingSlice(LocalStorage* localStorage, const mitk::Image* movingInput, const mitk::MAPRegistrationWrapper* reg)
+{
+  if (reg->GetMovingDimensions() != 3 || reg->GetTargetDimensions() != 3
+    || movingInput->GetDimension() != 3 || movingInput->GetPixelType().GetNumberOfComponents() != 1)
+  {
+    return false;
+  }
+
+  const LocalStorage::MovingSlicePoints& slicePoints = this->GetMovingSlicePoints(localStorage, reg);
+
+  mitk::Image::Pointer mappedImage = mitk::Image::New();
+  mappedImage->Initialize(movingInput->GetPixelType(), *(localStorage->m_slicedTargetImage->GetGeometry()));
+
+  try
+  {
+    AccessFixedDimensionByItk_n(movingInput, SampleMovingSlice, 3, (&slicePoints.m_Points, mappedImage.GetPointer()));
+  }
+  catch (const mitk::AccessByItkException&)
+  {
+    return false;
+  }
+
+  localStorage->m_slicedMappedImage = mappedImage;
+  return true;
+}
+
+const mitk::RegEvaluationMapper2D::LocalStorage::MovingSlicePoints& mitk::RegEvaluationMapper2D::GetMovingSlicePoints(LocalStorage* localStorage, const mitk::MAPRegistrationWrapper* reg)
+{
+  if (localStorage->m_SampledRegistration != reg || localStorage->m_SampledRegistrationMTime != reg->GetMTime())
+  {
+    localStorage->m_MovingSlicePoints.clear();
+    localStorage->m_SampledRegistration = reg;
+    localStorage->m_SampledRegistrationMTime = reg->GetMTime();
+  }
+
+  const mitk::BaseGeometry* sliceGeometry = localStorage->m_slicedTargetImage->GetGeometry();
+
+  for (std::deque<LocalStorage::MovingSlicePoints>::iterator pos = localStorage->m_MovingSlicePoints.begin(); pos != localStorage->m_MovingSlicePoints.end(); ++pos)
+  {
+    if (mitk::Equal(*(pos->m_SliceGeometry), *sliceGeometry, mitk::eps, false))
+    {
+      if (pos != localStorage->m_MovingSlicePoints.begin())
+      {
+        std::swap(*pos, localStorage->m_MovingSlicePoints.front());
+      }
+      return localStorage->m_MovingSlicePoints.front();
+    }
+  }
+
+  //evaluate the inverse kernel for each pixel of the slice
+  LocalStorage::MovingSlicePoints slicePoints;
+  slicePoints.m_SliceGeometry = sliceGeometry->Clone();
+
+  const unsigned int width = localStorage->m_slicedTargetImage->GetDimension(0);
+  const unsigned int height = localStorage->m_slicedTargetImage->GetDimension(1);
+  slicePoints.m_Points.resize(width * height);
+
+  itk::Point<float, 3> unmappedPoint;
+  unmappedPoint.Fill(std::numeric_limits<float>::quiet_NaN());
+
+  mitk::Point3D index;
+  mitk::Point3D targetPoint;
+  mitk::Point3D movingPoint;
+  index[2] = 0;
+
+  for (unsigned int y = 0; y < height; ++y)
+  {
+    index[1] = y;
+    for (unsigned int x = 0; x < width; ++x)
+    {
+      index[0] = x;
+      sliceGeometry->IndexToWorld(index, targetPoint);
+
+      if (reg->MapPointInverse(targetPoint, movingPoint))
+      {
+        slicePoints.m_Points[y * width + x].CastFrom(movingPoint);
+      }
+      else
+      {
+        slicePoints.m_Points[y * width + x] = unmappedPoint;
+      }
+    }
+  }
+
+  localStorage->m_MovingSlicePoints.push_front(slicePoints);
+  if (localStorage->m_MovingSlicePoints.size() > MAXIMUM_NUMBER_OF_CACHED_SLICES)
+  {
+    localStorage->m_MovingSlicePoints.pop_back();
+  }
+
+  return localStorage->m_MovingSlicePoints.front();
+}
+
 void mitk::RegEvaluationMapper2D::PrepareContour( mitk::DataNode* datanode, LocalStorage * localStorage )
 {
   bool targetContour = true;
@@ -797,7 +936,7 @@ mitk::RegEvaluationMapper2D::LocalStorage::~LocalStorage()
 {
 }
 
-mitk::RegEvaluationMapper2D::LocalStorage::LocalStorage()
+mitk::RegEvaluationMapper2D::LocalStorage::LocalStorage() : m_SampledRegistration(NULL), m_SampledRegistrationMTime(0)
 {
   m_TargetLevelWindowFilter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
   m_MappedLevelWindowFilter = vtkSmartPointer<vtkMitkLevelWindowFilter>::New();
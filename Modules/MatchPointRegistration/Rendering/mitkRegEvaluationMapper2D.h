@@ -33,6 +33,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkSmartPointer.h>
 #include <vtkPropAssembly.h>
 
+#include <deque>
+#include <vector>
+
 //MITK
 #include "MitkMatchPointRegistrationExports.h"
 
@@ -126,6 +129,21 @@ public:
      geometry*/
     mitk::Image::Pointer m_slicedMappedImage;
 
+    /** \brief The inverse registration kernel sampled at the pixels of one target slice.*/
+    struct MovingSlicePoints
+    {
+      mitk::BaseGeometry::Pointer m_SliceGeometry;
+      /** position of each slice pixel in the moving space, NaN if the registration does not map the pixel*/
+      std::vector< itk::Point<float, 3> > m_Points;
+    };
+
+    /** \brief Sampled kernels of the recently rendered slices, most recent first. Going back to one
+      * of these slices does not evaluate the registration again.*/
+    std::deque<MovingSlicePoints> m_MovingSlicePoints;
+    /** \brief Registration (and its modification time) the sampled kernels belong to.*/
+    const mitk::MAPRegistrationWrapper* m_SampledRegistration;
+    unsigned long m_SampledRegistrationMTime;
+
     /** \brief Timestamp of last update of stored data. */
     itk::TimeStamp m_LastUpdateTime;
 
@@ -198,6 +216,16 @@ protected:
     */
   virtual void GenerateDataForRenderer(mitk::BaseRenderer *renderer);
 
+  /** \brief Maps the moving image into the geometry of m_slicedTargetImage by resampling it
+    * directly at the sampled kernel positions of the slice (see GetMovingSlicePoints()).
+    * Returns false if this is not supported for the data (only 3D registrations and 3D moving
+    * images with one time step and scalar pixels are), the caller then has to use ImageMappingHelper.*/
+  bool MapMovingSlice(LocalStorage* localStorage, const mitk::Image* movingInput, const mitk::MAPRegistrationWrapper* reg);
+
+  /** \brief Returns the positions of the pixels of m_slicedTargetImage in the moving space.
+    * The result is cached per slice and registration.*/
+  const LocalStorage::MovingSlicePoints& GetMovingSlicePoints(LocalStorage* localStorage, const mitk::MAPRegistrationWrapper* reg);
+
   void PrepareContour( mitk::DataNode* datanode, LocalStorage * localStorage );
 
   void PrepareDifference( LocalStorage * localStorage );
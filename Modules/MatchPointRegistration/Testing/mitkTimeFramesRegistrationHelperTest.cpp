@@ -18,6 +18,47 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTestFixture.h"
 
 #include "mitkTimeFramesRegistrationHelper.h"
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkStringProperty.h>
+
+#include <mapDummyImageRegistrationAlgorithm.h>
+#include <mapDiscreteElements.h>
+#include <mapMetaPropertyAlgorithmBase.h>
+
+namespace
+{
+  typedef map::core::discrete::Elements<3>::InternalImageType TestImageType;
+
+  mapGenerateAlgorithmUIDPolicyMacro(TestIdentityUIDPolicy, "de.dkfz.dipp", "TestIdentity", "1.0.0", "");
+
+  /** Identity registration with meta properties, so that the helper can copy it for concurrent frames.
+   * The results of the frames are deterministic and can be compared between sequential and concurrent runs.*/
+  class TestIdentityRegistrationAlgorithm
+    : public map::algorithm::DummyImageRegistrationAlgorithm<TestImageType, TestImageType, TestIdentityUIDPolicy>,
+      public map::algorithm::MetaPropertyAlgorithmBase
+  {
+  public:
+    typedef TestIdentityRegistrationAlgorithm Self;
+    typedef map::algorithm::DummyImageRegistrationAlgorithm<TestImageType, TestImageType, TestIdentityUIDPolicy>
+      Superclass;
+    typedef ::itk::SmartPointer<Self> Pointer;
+    typedef ::itk::SmartPointer<const Self> ConstPointer;
+
+    itkTypeMacro(TestIdentityRegistrationAlgorithm, DummyImageRegistrationAlgorithm);
+    mapNewAlgorithmMacro(Self);
+
+  protected:
+    TestIdentityRegistrationAlgorithm() {}
+    ~TestIdentityRegistrationAlgorithm() override {}
+
+    void compileInfos(MetaPropertyVectorType &) const override {}
+
+    MetaPropertyPointer doGetProperty(const MetaPropertyNameType &) const override { return nullptr; }
+
+    void doSetProperty(const MetaPropertyNameType &, const MetaPropertyType *) override {}
+  };
+}
 
 class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
 {
@@ -29,11 +70,40 @@ class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
   MITK_TEST(SetAllowUnregPixels_GetAllowUnregPixels);
   MITK_TEST(SetInterpolatorType_GetInterpolatorType);
   MITK_TEST(Set_Get_Clear_IgnoreList);
+  MITK_TEST(SetConcurrentFrameRegistration_GetConcurrentFrameRegistration);
+  MITK_TEST(SetWarmStartFunction_GetWarmStartFunction);
+  MITK_TEST(Generate_ConcurrentFrameRegistration_EqualsSequential);
   CPPUNIT_TEST_SUITE_END();
 private:
   mitk::TimeFramesRegistrationHelper::Pointer frameRegHelper;
   mitk::TimeFramesRegistrationHelper::IgnoreListType ignoreList;
 
+  mitk::Image::Pointer Generate4DImage() const
+  {
+    mitk::Image::Pointer frame = mitk::ImageGenerator::GenerateGradientImage<float>(16, 16, 8);
+    mitk::ImageReadAccessor frameAccessor(frame);
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(frame->GetPixelType(), *(frame->GetGeometry()), 1, 5);
+
+    for (unsigned int t = 0; t < image->GetTimeSteps(); ++t)
+    {
+      image->SetVolume(frameAccessor.GetData(), t);
+    }
+
+    image->SetProperty("name", mitk::StringProperty::New("dynamic image"));
+    return image;
+  }
+
+  mitk::Image::Pointer RegisterFrames(const mitk::Image* image, bool concurrent) const
+  {
+    mitk::TimeFramesRegistrationHelper::Pointer helper = mitk::TimeFramesRegistrationHelper::New();
+    helper->Set4DImage(image);
+    helper->SetAlgorithm(TestIdentityRegistrationAlgorithm::New());
+    helper->SetConcurrentFrameRegistration(concurrent);
+    return helper->GetRegisteredImage();
+  }
+
 public:
   void setUp() override
   {
@@ -106,6 +176,50 @@ public:
     CPPUNIT_ASSERT(frameRegHelper->GetIgnoreList().empty());
   }
 
+  void SetConcurrentFrameRegistration_GetConcurrentFrameRegistration()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on default value", false,
+                                 frameRegHelper->GetConcurrentFrameRegistration());
+    frameRegHelper->ConcurrentFrameRegistrationOn();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check getter on changed value", true,
+                                 frameRegHelper->GetConcurrentFrameRegistration());
+  }
+
+  void SetWarmStartFunction_GetWarmStartFunction()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Check getter on default value", !frameRegHelper->GetWarmStartFunction());
+
+    bool called = false;
+    itk::ModifiedTimeType mtime = frameRegHelper->GetMTime();
+    frameRegHelper->SetWarmStartFunction(
+      [&called](mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmBaseType*,
+                const mitk::TimeFramesRegistrationHelper::RegistrationType*) { called = true; });
+    CPPUNIT_ASSERT(mtime < frameRegHelper->GetMTime());
+    CPPUNIT_ASSERT(frameRegHelper->GetWarmStartFunction());
+
+    frameRegHelper->GetWarmStartFunction()(nullptr, nullptr);
+    CPPUNIT_ASSERT(called);
+
+    frameRegHelper->SetWarmStartFunction(mitk::TimeFramesRegistrationHelper::WarmStartFunctionType());
+    CPPUNIT_ASSERT(!frameRegHelper->GetWarmStartFunction());
+  }
+
+  void Generate_ConcurrentFrameRegistration_EqualsSequential()
+  {
+    mitk::Image::Pointer image = this->Generate4DImage();
+
+    mitk::Image::Pointer sequential = this->RegisterFrames(image, false);
+    mitk::Image::Pointer concurrent = this->RegisterFrames(image, true);
+
+    CPPUNIT_ASSERT(sequential.IsNotNull());
+    CPPUNIT_ASSERT(concurrent.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(image->GetTimeSteps(), concurrent->GetTimeSteps());
+    CPPUNIT_ASSERT_MESSAGE("Check concurrent registration result equals sequential result",
+                           mitk::Equal(*sequential, *concurrent, mitk::eps, true));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Check properties of the input are kept", std::string("dynamic image"),
+                                 concurrent->GetProperty("name")->GetValueAsString());
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTimeFramesRegistrationHelper)
\ No newline at end of file
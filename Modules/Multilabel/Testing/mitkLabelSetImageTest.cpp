@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
+#include <algorithm>
+
 class mitkLabelSetImageTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkLabelSetImageTestSuite);
@@ -38,6 +40,7 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestLabelStatistics);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -443,6 +446,56 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  void TestLabelStatistics()
+  {
+    mitk::Image::Pointer image = mitk::IOUtil::LoadImage(GetTestDataFilePath("Multilabel/LabelSetTestInitializeImage.nrrd"));
+    m_LabelSetImage = 0;
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    m_LabelSetImage->InitializeByLabeledImage(image);
+
+    const mitk::LabelSetImage::LabelStatistics *statistics = m_LabelSetImage->GetLabelStatistics(7);
+    CPPUNIT_ASSERT_MESSAGE("No statistics for label 7", statistics != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Wrong voxel count for label 7", statistics->VoxelCount == 823);
+    const mitk::LabelSetImage::LabelStatistics label7 = *statistics;
+
+    statistics = m_LabelSetImage->GetLabelStatistics(6);
+    CPPUNIT_ASSERT_MESSAGE("No statistics for label 6", statistics != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Wrong voxel count for label 6", statistics->VoxelCount == 507);
+    const mitk::LabelSetImage::LabelStatistics label6 = *statistics;
+
+    // the center of mass of an inactive layer is computed from that layer
+    m_LabelSetImage->AddLayer();
+    m_LabelSetImage->UpdateCenterOfMass(7, 0);
+    CPPUNIT_ASSERT_MESSAGE("Wrong center of mass of a label in an inactive layer",
+                           mitk::Equal(m_LabelSetImage->GetLabel(7, 0)->GetCenterOfMassIndex(),
+                                       label7.GetCenterOfMassIndex(), mitk::eps, true));
+    m_LabelSetImage->SetActiveLayer(0);
+
+    // statistics are updated incrementally by the merge
+    m_LabelSetImage->MergeLabel(6, 7);
+    CPPUNIT_ASSERT_MESSAGE("Merged label still has statistics", m_LabelSetImage->GetLabelStatistics(7) == nullptr);
+
+    const mitk::LabelSetImage::LabelStatistics merged = *m_LabelSetImage->GetLabelStatistics(6);
+    CPPUNIT_ASSERT_MESSAGE("Wrong voxel count after merge", merged.VoxelCount == 1330);
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Wrong bounding box after merge",
+                             merged.MinIndex[d] == std::min(label6.MinIndex[d], label7.MinIndex[d]) &&
+                               merged.MaxIndex[d] == std::max(label6.MaxIndex[d], label7.MaxIndex[d]));
+    }
+
+    // a full update yields the same result
+    m_LabelSetImage->UpdateLabelStatistics();
+    const mitk::LabelSetImage::LabelStatistics recomputed = *m_LabelSetImage->GetLabelStatistics(6);
+    CPPUNIT_ASSERT_MESSAGE("Incremental voxel count differs from full update", recomputed.VoxelCount == merged.VoxelCount);
+    CPPUNIT_ASSERT_MESSAGE("Incremental center of mass differs from full update",
+                           mitk::Equal(recomputed.GetCenterOfMassIndex(), merged.GetCenterOfMassIndex(), mitk::eps, true));
+
+    m_LabelSetImage->EraseLabel(6);
+    CPPUNIT_ASSERT_MESSAGE("Erased label still has statistics", m_LabelSetImage->GetLabelStatistics(6) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Label 6 was not erased from the image", m_LabelSetImage->GetStatistics()->GetScalarValueMax() < 6);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
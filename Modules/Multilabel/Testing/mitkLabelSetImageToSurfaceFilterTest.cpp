@@ -0,0 +1,142 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkMutexLockHolder.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <cstring>
+#include <map>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+  MITK_TEST(TestSingleLabel);
+  MITK_TEST(TestAllLabels);
+  MITK_TEST(TestMissingLabel);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  // the events are sent from the worker threads, so they are only recorded and checked afterwards
+  itk::SimpleFastMutexLock m_GeneratedLabelsMutex;
+  std::map<mitk::LabelSetImage::PixelType, vtkIdType> m_GeneratedLabels;
+
+  void FillCube(mitk::ImagePixelWriteAccessor<mitk::LabelSetImage::PixelType, 3> &accessor,
+                int lower,
+                int upper,
+                mitk::LabelSetImage::PixelType value)
+  {
+    itk::Index<3> index;
+    for (index[2] = lower; index[2] <= upper; ++index[2])
+      for (index[1] = lower; index[1] <= upper; ++index[1])
+        for (index[0] = lower; index[0] <= upper; ++index[0])
+          accessor.SetPixelByIndexSafe(index, value);
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::Image::New();
+    unsigned int dimensions[3] = {40, 40, 40};
+    m_Image->Initialize(mitk::MakeScalarPixelType<mitk::LabelSetImage::PixelType>(), 3, dimensions);
+
+    mitk::ImagePixelWriteAccessor<mitk::LabelSetImage::PixelType, 3> accessor(m_Image);
+    std::memset(accessor.GetData(), 0, 40 * 40 * 40 * sizeof(mitk::LabelSetImage::PixelType));
+    this->FillCube(accessor, 5, 12, 1);
+    this->FillCube(accessor, 20, 30, 3);
+
+    m_GeneratedLabels.clear();
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void OnSurfaceGenerated(mitk::LabelSetImage::PixelType label, mitk::Surface *surface)
+  {
+    const vtkIdType numberOfPoints =
+      surface != nullptr && surface->GetVtkPolyData() != nullptr ? surface->GetVtkPolyData()->GetNumberOfPoints() : 0;
+
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_GeneratedLabelsMutex);
+    m_GeneratedLabels[label] = numberOfPoints;
+  }
+
+  void TestSingleLabel()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(3);
+    filter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Single label mode produced more than one output",
+                           filter->GetNumberOfIndexedOutputs() == 1);
+    CPPUNIT_ASSERT_MESSAGE("Output is not assigned to the requested label", filter->GetLabelOfOutput(0) == 3);
+
+    vtkPolyData *polydata = filter->GetOutput()->GetVtkPolyData();
+    CPPUNIT_ASSERT_MESSAGE("No surface generated", polydata != nullptr && polydata->GetNumberOfPoints() > 0);
+
+    double bounds[6];
+    polydata->GetBounds(bounds);
+    CPPUNIT_ASSERT_MESSAGE("Surface is not located at the label", bounds[0] > 15.0 && bounds[1] < 35.0);
+  }
+
+  void TestAllLabels()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->GenerateAllLabelsOn();
+    filter->SurfaceGeneratedEvent +=
+      mitk::MessageDelegate2<mitkLabelSetImageToSurfaceFilterTestSuite, mitk::LabelSetImage::PixelType, mitk::Surface *>(
+        this, &mitkLabelSetImageToSurfaceFilterTestSuite::OnSurfaceGenerated);
+    filter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of outputs", filter->GetNumberOfIndexedOutputs() == 2);
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of events", m_GeneratedLabels.size() == 2);
+    for (auto generated = m_GeneratedLabels.cbegin(); generated != m_GeneratedLabels.cend(); ++generated)
+      CPPUNIT_ASSERT_MESSAGE("Surface sent with event is empty", generated->second > 0);
+
+    const mitk::LabelSetImageToSurfaceFilter::LabelMapType &labels = filter->GetAvailableLabels();
+    CPPUNIT_ASSERT_MESSAGE("Wrong voxel count for label 1", labels.at(1) == 8 * 8 * 8);
+    CPPUNIT_ASSERT_MESSAGE("Wrong voxel count for label 3", labels.at(3) == 11 * 11 * 11);
+
+    for (unsigned int idx = 0; idx < 2; ++idx)
+    {
+      vtkPolyData *polydata = filter->GetOutput(idx)->GetVtkPolyData();
+      CPPUNIT_ASSERT_MESSAGE("No surface generated", polydata != nullptr && polydata->GetNumberOfPoints() > 0);
+
+      double bounds[6];
+      polydata->GetBounds(bounds);
+      if (filter->GetLabelOfOutput(idx) == 1)
+        CPPUNIT_ASSERT_MESSAGE("Surface of label 1 is misplaced", bounds[0] > 0.0 && bounds[1] < 17.0);
+      else
+        CPPUNIT_ASSERT_MESSAGE("Surface of label 3 is misplaced", bounds[0] > 15.0 && bounds[1] < 35.0);
+    }
+  }
+
+  void TestMissingLabel()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_Image);
+    filter->SetRequestedLabel(2);
+    CPPUNIT_ASSERT_THROW(filter->Update(), itk::ExceptionObject);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
@@ -29,20 +29,130 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransformPolyDataFilter.h>
 
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <itkQuadEdgeMesh.h>
 #include <itkTriangleMeshToBinaryImageFilter.h>
 //#include <itkRelabelComponentImageFilter.h>
 
 #include <itkCommand.h>
 
+#include <algorithm>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
   source->FillBuffer(0);
 }
 
+namespace
+{
+  typedef mitk::LabelSetImage::LabelStatistics LabelStatisticsType;
+  typedef mitk::LabelSetImage::LabelStatisticsMapType LabelStatisticsMapType;
+
+  template <typename TIndex>
+  itk::Index<3> ToIndex3D(const TIndex &index)
+  {
+    itk::Index<3> result;
+    result.Fill(0);
+    for (unsigned int d = 0; d < TIndex::GetIndexDimension() && d < 3; ++d)
+      result[d] = index[d];
+    return result;
+  }
+
+  void AddVoxel(LabelStatisticsType &statistics, const itk::Index<3> &index)
+  {
+    if (statistics.VoxelCount == 0)
+    {
+      statistics.MinIndex = index;
+      statistics.MaxIndex = index;
+    }
+    else
+    {
+      for (unsigned int d = 0; d < 3; ++d)
+      {
+        statistics.MinIndex[d] = std::min(statistics.MinIndex[d], index[d]);
+        statistics.MaxIndex[d] = std::max(statistics.MaxIndex[d], index[d]);
+      }
+    }
+
+    ++statistics.VoxelCount;
+    for (unsigned int d = 0; d < 3; ++d)
+      statistics.IndexSum[d] += index[d];
+  }
+
+  void MergeStatistics(LabelStatisticsType &target, const LabelStatisticsType &source)
+  {
+    if (source.VoxelCount == 0)
+      return;
+
+    if (target.VoxelCount == 0)
+    {
+      target = source;
+      return;
+    }
+
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      target.MinIndex[d] = std::min(target.MinIndex[d], source.MinIndex[d]);
+      target.MaxIndex[d] = std::max(target.MaxIndex[d], source.MaxIndex[d]);
+    }
+
+    target.VoxelCount += source.VoxelCount;
+    target.IndexSum += source.IndexSum;
+  }
+
+  void MergeStatistics(LabelStatisticsMapType &target, const LabelStatisticsMapType &source)
+  {
+    for (auto it = source.begin(); it != source.end(); ++it)
+      MergeStatistics(target[it->first], it->second);
+  }
+
+  template <typename TRegion>
+  int GetNumberOfSlices(const TRegion &region)
+  {
+    return static_cast<int>(region.GetSize(TRegion::GetImageDimension() - 1));
+  }
+
+  /** Returns the sub-region of region that covers only its sliceIdx-th slice along the last axis. */
+  template <typename TRegion>
+  TRegion GetSliceRegion(const TRegion &region, int sliceIdx)
+  {
+    const unsigned int sliceDimension = TRegion::GetImageDimension() - 1;
+    TRegion sliceRegion = region;
+    sliceRegion.SetIndex(sliceDimension, region.GetIndex(sliceDimension) + sliceIdx);
+    sliceRegion.SetSize(sliceDimension, 1);
+    return sliceRegion;
+  }
+}
+
+mitk::LabelSetImage::LabelStatistics::LabelStatistics() : VoxelCount(0)
+{
+  MinIndex.Fill(0);
+  MaxIndex.Fill(0);
+  IndexSum.Fill(0.0);
+}
+
+mitk::Point3D mitk::LabelSetImage::LabelStatistics::GetCenterOfMassIndex() const
+{
+  mitk::Point3D center;
+  center.Fill(0.0);
+
+  if (VoxelCount > 0)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+      center[d] = IndexSum[d] / VoxelCount;
+  }
+
+  return center;
+}
+
 mitk::LabelSetImage::LabelSetImage()
-  : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
+  : mitk::Image(),
+    m_ActiveLayer(0),
+    m_activeLayerInvalid(false),
+    m_ExteriorLabel(nullptr),
+    m_LabelStatisticsMTime(0),
+    m_LabelStatisticsLayer(-1)
 {
   // Iniitlaize Background Label
   mitk::Color color;
@@ -59,7 +169,9 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
   : Image(other),
     m_ActiveLayer(other.GetActiveLayer()),
     m_activeLayerInvalid(false),
-    m_ExteriorLabel(other.GetExteriorLabel()->Clone())
+    m_ExteriorLabel(other.GetExteriorLabel()->Clone()),
+    m_LabelStatisticsMTime(0),
+    m_LabelStatisticsLayer(-1)
 {
   for (unsigned int i = 0; i < other.GetNumberOfLayers(); i++)
   {
@@ -388,6 +500,7 @@ bool mitk::LabelSetImage::ExistLabelSet(unsigned int layer) const
 
 void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue, unsigned int layer)
 {
+  this->DiscardOutdatedLabelStatistics();
   try
   {
     AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
@@ -398,10 +511,12 @@ void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixel
   }
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
   Modified();
+  this->LabelStatisticsUpdated();
 }
 
 void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer)
 {
+  this->DiscardOutdatedLabelStatistics();
   try
   {
     for (unsigned int idx = 0; idx < vectorOfSourcePixelValues.size(); idx++)
@@ -415,6 +530,7 @@ void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelTyp
   }
   GetLabelSet(layer)->SetActiveLabel(pixelValue);
   Modified();
+  this->LabelStatisticsUpdated();
 }
 
 void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
@@ -436,6 +552,7 @@ void mitk::LabelSetImage::EraseLabels(std::vector<PixelType> &VectorOfLabelPixel
 
 void mitk::LabelSetImage::EraseLabel(PixelType pixelValue, unsigned int layer)
 {
+  this->DiscardOutdatedLabelStatistics();
   try
   {
     AccessByItk_2(this, EraseLabelProcessing, pixelValue, layer);
@@ -445,6 +562,7 @@ void mitk::LabelSetImage::EraseLabel(PixelType pixelValue, unsigned int layer)
     mitkThrow() << e.GetDescription();
   }
   Modified();
+  this->LabelStatisticsUpdated();
 }
 
 mitk::Label *mitk::LabelSetImage::GetActiveLabel(unsigned int layer)
@@ -489,7 +607,108 @@ mitk::LabelSet *mitk::LabelSetImage::GetActiveLabelSet()
 
 void mitk::LabelSetImage::UpdateCenterOfMass(PixelType pixelValue, unsigned int layer)
 {
-  AccessByItk_2(this, CalculateCenterOfMassProcessing, pixelValue, layer);
+  mitk::Label *label = GetLabelSet(layer)->GetLabel(pixelValue);
+  if (!label)
+    return;
+
+  mitk::Point3D pos;
+  pos.Fill(0.0);
+
+  if (layer == this->GetActiveLayer())
+  {
+    const LabelStatistics *statistics = this->GetLabelStatistics(pixelValue);
+    if (statistics)
+      pos = statistics->GetCenterOfMassIndex();
+  }
+  else
+  {
+    // the cached statistics describe the active layer only, the voxels of other layers are in the layer container
+    LabelStatisticsMapType layerStatistics;
+    AccessByItk_1(this->GetLayerImage(layer), CalculateLabelStatisticsProcessing, &layerStatistics);
+
+    auto statistics = layerStatistics.find(pixelValue);
+    if (statistics != layerStatistics.end())
+      pos = statistics->second.GetCenterOfMassIndex();
+  }
+
+  label->SetCenterOfMassIndex(pos);
+  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
+  label->SetCenterOfMassCoordinates(pos);
+}
+
+void mitk::LabelSetImage::UpdateLabelStatistics()
+{
+  AccessByItk_1(this, CalculateLabelStatisticsProcessing, &m_LabelStatistics);
+  m_LabelStatisticsLayer = m_ActiveLayer;
+  this->LabelStatisticsUpdated();
+}
+
+const mitk::LabelSetImage::LabelStatistics *mitk::LabelSetImage::GetLabelStatistics(PixelType pixelValue)
+{
+  if (!this->IsLabelStatisticsValid())
+    this->UpdateLabelStatistics();
+
+  auto it = m_LabelStatistics.find(pixelValue);
+  if (it == m_LabelStatistics.end())
+    return nullptr;
+
+  return &it->second;
+}
+
+bool mitk::LabelSetImage::IsLabelStatisticsValid() const
+{
+  return this->HasLabelStatistics() && m_LabelStatisticsMTime == this->GetMTime();
+}
+
+void mitk::LabelSetImage::DiscardOutdatedLabelStatistics()
+{
+  if (!this->IsLabelStatisticsValid())
+  {
+    m_LabelStatistics.clear();
+    m_LabelStatisticsLayer = -1;
+  }
+}
+
+bool mitk::LabelSetImage::HasLabelStatistics() const
+{
+  return m_LabelStatisticsLayer == m_ActiveLayer;
+}
+
+void mitk::LabelSetImage::LabelStatisticsUpdated()
+{
+  if (this->HasLabelStatistics())
+    m_LabelStatisticsMTime = this->GetMTime();
+}
+
+template <typename ImageType>
+bool mitk::LabelSetImage::GetLabelRegion(const ImageType *itkImage,
+                                         PixelType pixelValue,
+                                         typename ImageType::RegionType &region) const
+{
+  region = itkImage->GetLargestPossibleRegion();
+
+  // the exterior label covers everything that is not labeled, so it is never restricted
+  if (pixelValue == 0 || !this->HasLabelStatistics())
+    return true;
+
+  auto it = m_LabelStatistics.find(pixelValue);
+  if (it == m_LabelStatistics.end())
+    return false;
+
+  typename ImageType::IndexType index = region.GetIndex();
+  typename ImageType::SizeType size = region.GetSize();
+  for (unsigned int d = 0; d < ImageType::ImageDimension && d < 3; ++d)
+  {
+    index[d] = it->second.MinIndex[d];
+    size[d] = static_cast<typename ImageType::SizeValueType>(it->second.MaxIndex[d] - it->second.MinIndex[d] + 1);
+  }
+
+  typename ImageType::RegionType labelRegion(index, size);
+  if (!labelRegion.Crop(region))
+    return false;
+
+  region = labelRegion;
+  return true;
 }
 
 unsigned int mitk::LabelSetImage::GetNumberOfLabels(unsigned int layer) const
@@ -525,7 +744,9 @@ void mitk::LabelSetImage::MaskStamp(mitk::Image *mask, bool forceOverwrite)
     if (paddedMask.IsNull())
       return;
 
+    this->DiscardOutdatedLabelStatistics();
     AccessByItk_2(this, MaskStampProcessing, paddedMask, forceOverwrite);
+    this->LabelStatisticsUpdated();
   }
   catch (...)
   {
@@ -553,6 +774,7 @@ mitk::Image::Pointer mitk::LabelSetImage::CreateLabelMask(PixelType index)
     auto geometry = this->GetTimeGeometry()->Clone();
     mask->SetTimeGeometry(geometry);
 
+    this->DiscardOutdatedLabelStatistics();
     AccessByItk_2(this, CreateLabelMaskProcessing, mask, index);
   }
   catch (...)
@@ -660,28 +882,77 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
   mitk::CastToItkImage(mask, itkMask);
 
   typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> TargetIteratorType;
 
-  SourceIteratorType sourceIter(itkMask, itkMask->GetLargestPossibleRegion());
-  sourceIter.GoToBegin();
+  const PixelType activeLabel = this->GetActiveLabel(GetActiveLayer())->GetValue();
 
-  TargetIteratorType targetIter(itkImage, itkImage->GetLargestPossibleRegion());
-  targetIter.GoToBegin();
+  const bool updateStatistics = this->HasLabelStatistics();
+  const typename ImageType::RegionType region = itkImage->GetLargestPossibleRegion();
+  const int numberOfSlices = GetNumberOfSlices(region);
 
-  int activeLabel = this->GetActiveLabel(GetActiveLayer())->GetValue();
-
-  while (!sourceIter.IsAtEnd())
+  // Slices are stamped in parallel. Each thread records the voxels it relabels and
+  // the changes are applied to the label statistics once the thread is done.
+#pragma omp parallel
   {
-    PixelType sourceValue = sourceIter.Get();
-    PixelType targetValue = targetIter.Get();
+    LabelStatisticsType addedVoxels;
+    LabelStatisticsMapType removedVoxels;
 
-    if ((sourceValue != 0) &&
-        (forceOverwrite || !this->GetLabel(targetValue)->GetLocked())) // skip exterior and locked labels
+#pragma omp for schedule(static)
+    for (int sliceIdx = 0; sliceIdx < numberOfSlices; ++sliceIdx)
     {
-      targetIter.Set(activeLabel);
+      const typename ImageType::RegionType sliceRegion = GetSliceRegion(region, sliceIdx);
+
+      SourceIteratorType sourceIter(itkMask, sliceRegion);
+      sourceIter.GoToBegin();
+
+      TargetIteratorType targetIter(itkImage, sliceRegion);
+      targetIter.GoToBegin();
+
+      while (!sourceIter.IsAtEnd())
+      {
+        PixelType sourceValue = sourceIter.Get();
+        PixelType targetValue = targetIter.Get();
+
+        if ((sourceValue != 0) &&
+            (forceOverwrite || !this->GetLabel(targetValue)->GetLocked())) // skip exterior and locked labels
+        {
+          targetIter.Set(activeLabel);
+
+          if (updateStatistics && targetValue != activeLabel)
+          {
+            const itk::Index<3> index = ToIndex3D(targetIter.GetIndex());
+            if (targetValue != 0)
+              AddVoxel(removedVoxels[targetValue], index);
+            if (activeLabel != 0)
+              AddVoxel(addedVoxels, index);
+          }
+        }
+        ++sourceIter;
+        ++targetIter;
+      }
+    }
+
+    if (updateStatistics)
+    {
+#pragma omp critical
+      {
+        MergeStatistics(m_LabelStatistics[activeLabel], addedVoxels);
+        if (m_LabelStatistics[activeLabel].VoxelCount == 0)
+          m_LabelStatistics.erase(activeLabel);
+
+        for (auto it = removedVoxels.begin(); it != removedVoxels.end(); ++it)
+        {
+          auto target = m_LabelStatistics.find(it->first);
+          if (target == m_LabelStatistics.end())
+            continue;
+
+          target->second.VoxelCount -= std::min(target->second.VoxelCount, it->second.VoxelCount);
+          target->second.IndexSum -= it->second.IndexSum;
+          if (target->second.VoxelCount == 0)
+            m_LabelStatistics.erase(target);
+        }
+      }
     }
-    ++sourceIter;
-    ++targetIter;
   }
 
   this->Modified();
@@ -696,10 +967,14 @@ void mitk::LabelSetImage::CreateLabelMaskProcessing(ImageType *itkImage, mitk::I
   typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
   typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
 
-  SourceIteratorType sourceIter(itkImage, itkImage->GetLargestPossibleRegion());
+  typename ImageType::RegionType region;
+  if (!this->GetLabelRegion(itkImage, index, region))
+    return;
+
+  SourceIteratorType sourceIter(itkImage, region);
   sourceIter.GoToBegin();
 
-  TargetIteratorType targetIter(itkMask, itkMask->GetLargestPossibleRegion());
+  TargetIteratorType targetIter(itkMask, region);
   targetIter.GoToBegin();
 
   while (!sourceIter.IsAtEnd())
@@ -715,45 +990,51 @@ void mitk::LabelSetImage::CreateLabelMaskProcessing(ImageType *itkImage, mitk::I
 }
 
 template <typename ImageType>
-void mitk::LabelSetImage::CalculateCenterOfMassProcessing(ImageType *itkImage, PixelType pixelValue, unsigned int layer)
+void mitk::LabelSetImage::CalculateLabelStatisticsProcessing(ImageType *itkImage,
+                                                              LabelStatisticsMapType *result) const
 {
-  // for now, we just retrieve the voxel in the middle
-  typedef itk::ImageRegionConstIterator<ImageType> IteratorType;
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
+  typedef itk::ImageRegionConstIteratorWithIndex<ImageType> IteratorType;
 
-  std::vector<typename ImageType::IndexType> indexVector;
+  const typename ImageType::RegionType region = itkImage->GetLargestPossibleRegion();
+  const int numberOfSlices = GetNumberOfSlices(region);
 
-  while (!iter.IsAtEnd())
+  LabelStatisticsMapType statistics;
+
+#pragma omp parallel
   {
-    // TODO fix comparison warning more effective
-    if (iter.Get() == pixelValue)
+    LabelStatisticsMapType localStatistics;
+
+#pragma omp for schedule(static)
+    for (int sliceIdx = 0; sliceIdx < numberOfSlices; ++sliceIdx)
     {
-      indexVector.push_back(iter.GetIndex());
-    }
-    ++iter;
-  }
+      IteratorType iter(itkImage, GetSliceRegion(region, sliceIdx));
+      iter.GoToBegin();
 
-  mitk::Point3D pos;
-  pos.Fill(0.0);
+      // labels form long runs of equal values, so the map is only searched when the value changes
+      PixelType currentValue = 0;
+      LabelStatisticsType *currentStatistics = nullptr;
 
-  if (!indexVector.empty())
-  {
-    typename itk::ImageRegionConstIteratorWithIndex<ImageType>::IndexType centerIndex;
-    centerIndex = indexVector.at(indexVector.size() / 2);
-    if (centerIndex.GetIndexDimension() == 3)
-    {
-      pos[0] = centerIndex[0];
-      pos[1] = centerIndex[1];
-      pos[2] = centerIndex[2];
+      while (!iter.IsAtEnd())
+      {
+        const PixelType value = iter.Get();
+        if (value != 0)
+        {
+          if (currentStatistics == nullptr || value != currentValue)
+          {
+            currentValue = value;
+            currentStatistics = &localStatistics[value];
+          }
+          AddVoxel(*currentStatistics, ToIndex3D(iter.GetIndex()));
+        }
+        ++iter;
+      }
     }
-    else
-      return;
+
+#pragma omp critical
+    MergeStatistics(statistics, localStatistics);
   }
 
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
-  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
+  result->swap(statistics);
 }
 
 template <typename ImageType>
@@ -848,7 +1129,11 @@ void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pi
 {
   typedef itk::ImageRegionIterator<ImageType> IteratorType;
 
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
+  typename ImageType::RegionType region;
+  if (!this->GetLabelRegion(itkImage, pixelValue, region))
+    return;
+
+  IteratorType iter(itkImage, region);
   iter.GoToBegin();
 
   while (!iter.IsAtEnd())
@@ -861,14 +1146,30 @@ void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pi
     }
     ++iter;
   }
+
+  if (this->HasLabelStatistics())
+    m_LabelStatistics.erase(pixelValue);
 }
 
 template <typename ImageType>
 void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pixelValue, PixelType index)
 {
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> IteratorType;
+
+  if (pixelValue == index)
+    return;
 
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
+  typename ImageType::RegionType region;
+  if (!this->GetLabelRegion(itkImage, index, region))
+    return;
+
+  const bool updateStatistics = this->HasLabelStatistics();
+
+  // the exterior label is not part of the statistics, so its voxels are added one by one
+  LabelStatisticsType addedVoxels;
+  const bool addVoxels = updateStatistics && index == 0;
+
+  IteratorType iter(itkImage, region);
   iter.GoToBegin();
 
   while (!iter.IsAtEnd())
@@ -876,9 +1177,24 @@ void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pi
     if (iter.Get() == index)
     {
       iter.Set(pixelValue);
+      if (addVoxels)
+        AddVoxel(addedVoxels, ToIndex3D(iter.GetIndex()));
     }
     ++iter;
   }
+
+  if (updateStatistics)
+  {
+    auto source = m_LabelStatistics.find(index);
+    if (source != m_LabelStatistics.end())
+    {
+      addedVoxels = source->second;
+      m_LabelStatistics.erase(source);
+    }
+
+    if (pixelValue != 0 && addedVoxels.VoxelCount > 0)
+      MergeStatistics(m_LabelStatistics[pixelValue], addedVoxels);
+  }
 }
 
 bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
@@ -22,6 +22,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <MitkMultilabelExports.h>
 
+#include <itkIndex.h>
+
+#include <map>
+
 namespace mitk
 {
   //##Documentation
@@ -37,6 +41,27 @@ namespace mitk
 
       typedef mitk::Label::PixelType PixelType;
 
+    /**
+    * \brief Spatial metadata of a label in the active layer.
+    *
+    * VoxelCount and IndexSum are exact. The bounding box (MinIndex, MaxIndex) is exact after a full
+    * update and is kept as a conservative bound by the write operations of this class, i.e. it may
+    * only grow until the next full update.
+    */
+    struct LabelStatistics
+    {
+      LabelStatistics();
+
+      unsigned long VoxelCount;
+      itk::Index<3> MinIndex;
+      itk::Index<3> MaxIndex;
+      Vector3D IndexSum;
+
+      Point3D GetCenterOfMassIndex() const;
+    };
+
+    typedef std::map<PixelType, LabelStatistics> LabelStatisticsMapType;
+
     /**
     * \brief BeforeChangeLayerEvent (e.g. used for GUI integration)
     * As soon as active labelset should be changed, the signal emits.
@@ -86,9 +111,24 @@ namespace mitk
     void MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer = 0);
 
     /**
-      * \brief  */
+      * \brief Sets the center of mass of the label in the given layer to the centroid of its voxels.
+      * For the active layer the cached label statistics are used, so no pass over the image is required
+      * unless the image was modified from outside since the last update. Other layers are scanned. */
     void UpdateCenterOfMass(PixelType pixelValue, unsigned int layer = 0);
 
+    /**
+     * @brief Recomputes voxel count, bounding box and center of mass of all labels of the active layer
+     *        in a single (multithreaded) pass over the image.
+     */
+    void UpdateLabelStatistics();
+
+    /**
+     * @brief Returns the statistics of a label in the active layer. The statistics are recomputed
+     *        if the image has been modified since they were last updated.
+     * @return the statistics or NULL if the label has no voxels in the active layer
+     */
+    const LabelStatistics *GetLabelStatistics(PixelType pixelValue);
+
     /**
      * @brief Removes labels from the mitk::LabelSet of given layer.
      *        Calls mitk::LabelSetImage::EraseLabels() which also removes the labels from within the image.
@@ -283,7 +323,32 @@ namespace mitk
     void ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer) const;
 
     template <typename ImageType>
-    void CalculateCenterOfMassProcessing(ImageType *input, PixelType index, unsigned int layer);
+    void CalculateLabelStatisticsProcessing(ImageType *input, LabelStatisticsMapType *result) const;
+
+    /**
+    * \brief Returns true if the cached label statistics describe the current content of the active layer. */
+    bool IsLabelStatisticsValid() const;
+
+    /**
+    * \brief Drops the cached label statistics if they are outdated. Write operations call this before
+    * modifying the image and only update the statistics incrementally if they are still kept afterwards. */
+    void DiscardOutdatedLabelStatistics();
+
+    /**
+    * \brief Returns true if label statistics are kept for the active layer (they might be outdated
+    * during a running write operation). */
+    bool HasLabelStatistics() const;
+
+    /**
+    * \brief Marks the kept label statistics as up to date with the current state of the image.
+    * Must be called after a write operation has updated the statistics incrementally. */
+    void LabelStatisticsUpdated();
+
+    /**
+    * \brief Restricts region to the bounding box of the given label if the label statistics are valid.
+    * \return false if the label is known to have no voxels, true otherwise */
+    template <typename ImageType>
+    bool GetLabelRegion(const ImageType *input, PixelType pixelValue, typename ImageType::RegionType &region) const;
 
     template <typename ImageType>
     void ClearBufferProcessing(ImageType *input);
@@ -317,6 +382,10 @@ namespace mitk
     bool m_activeLayerInvalid;
 
     mitk::Label::Pointer m_ExteriorLabel;
+
+    LabelStatisticsMapType m_LabelStatistics;
+    unsigned long m_LabelStatisticsMTime;
+    int m_LabelStatisticsLayer;
   };
 
   /**
@@ -21,13 +21,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // itk
 #include <itkAntiAliasBinaryImageFilter.h>
-#include <itkAutoCropLabelMapFilter.h>
 #include <itkBinaryThresholdImageFilter.h>
-#include <itkLabelImageToLabelMapFilter.h>
-#include <itkLabelMap.h>
-#include <itkLabelMapToLabelImageFilter.h>
-#include <itkLabelObject.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itkNumericTraits.h>
+#include <itkRegionOfInterestImageFilter.h>
 #include <itkSmoothingRecursiveGaussianImageFilter.h>
 
 // vtk
@@ -38,6 +35,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkMarchingCubes.h>
 #include <vtkSmartPointer.h>
 
+#include <algorithm>
+#include <exception>
+#include <vector>
+
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
   : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
 {
@@ -68,6 +69,15 @@ const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
   return static_cast<const mitk::Image *>(this->ProcessObject::GetInput(0));
 }
 
+mitk::LabelSetImageToSurfaceFilter::LabelType mitk::LabelSetImageToSurfaceFilter::GetLabelOfOutput(unsigned int idx) const
+{
+  auto it = m_IndexToLabels.find(idx);
+  if (it == m_IndexToLabels.end())
+    return static_cast<LabelType>(m_BackgroundLabel);
+
+  return it->second;
+}
+
 void mitk::LabelSetImageToSurfaceFilter::GenerateOutputInformation()
 {
   itkDebugMacro(<< "GenerateOutputInformation()");
@@ -91,13 +101,209 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
                                                             mitk::Surface * /*surface*/)
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef std::map<LabelType, typename ImageType::RegionType> RegionMapType;
+
+  RegionMapType regions;
+  this->ComputeLabelRegions(input, 3, regions);
+
+  m_IndexToLabels.clear();
+
+  if (!m_GenerateAllLabels)
+  {
+    typename RegionMapType::const_iterator it = regions.find(static_cast<LabelType>(m_RequestedLabel));
+    if (it == regions.end())
+      throw itk::ExceptionObject(__FILE__, __LINE__, "requested label is not present in the image.");
+
+    typename ImageType::Pointer labelImage = this->CropLabelRegion(input, it->second);
+    vtkSmartPointer<vtkPolyData> polydata =
+      this->ExtractLabelSurface(labelImage.GetPointer(), it->first, it->second, this->GetInput()->GetGeometry(), 0);
+
+    this->SetNumberOfIndexedOutputs(1);
+    m_IndexToLabels[0] = it->first;
+    mitk::Surface::Pointer output = this->GetOutput(0);
+    output->SetVtkPolyData(polydata, 0);
+    this->SurfaceGeneratedEvent.Send(it->first, output);
+    return;
+  }
+
+  std::vector<LabelType> labels;
+  std::vector<typename ImageType::RegionType> labelRegions;
+  for (typename RegionMapType::const_iterator it = regions.begin(); it != regions.end(); ++it)
+  {
+    labels.push_back(it->first);
+    labelRegions.push_back(it->second);
+  }
+
+  const int numberOfLabels = static_cast<int>(labels.size());
+  this->SetNumberOfIndexedOutputs(std::max(numberOfLabels, 1));
+  for (int i = 0; i < numberOfLabels; ++i)
+  {
+    if (this->GetOutput(i) == nullptr)
+      this->SetNthOutput(i, this->MakeOutput(i));
+    m_IndexToLabels[i] = labels[i];
+  }
+
+  if (numberOfLabels == 0)
+  {
+    this->GetOutput(0)->SetVtkPolyData(nullptr, 0);
+    return;
+  }
+
+  const mitk::BaseGeometry *inputGeometry = this->GetInput()->GetGeometry();
+
+  // Labels are meshed concurrently, so the ITK filters of a single label must not
+  // spawn threads on their own.
+  const int numberOfThreads = numberOfLabels > 1 ? 1 : 0;
+
+  // Exceptions must not leave the parallel region, the first one is rethrown after the loop.
+  std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < numberOfLabels; ++i)
+  {
+    try
+    {
+      vtkSmartPointer<vtkPolyData> polydata;
+      try
+      {
+        // Cropping sets the requested region of the shared input, so only one worker may
+        // crop at a time. The cropped image is disconnected, the rest runs concurrently.
+        typename ImageType::Pointer labelImage;
+#pragma omp critical(LabelSetImageToSurfaceFilterCrop)
+        {
+          labelImage = this->CropLabelRegion(input, labelRegions[i]);
+        }
+
+        polydata = this->ExtractLabelSurface(
+          labelImage.GetPointer(), labels[i], labelRegions[i], inputGeometry, numberOfThreads);
+      }
+      catch (const itk::ExceptionObject &e)
+      {
+#pragma omp critical
+        {
+          MITK_WARN << "Could not generate surface for label " << labels[i] << ": " << e.GetDescription();
+        }
+      }
+
+      mitk::Surface *output = this->GetOutput(i);
+      output->SetVtkPolyData(polydata, 0);
+
+      if (polydata != nullptr)
+        this->SurfaceGeneratedEvent.Send(labels[i], output);
+    }
+    catch (...)
+    {
+#pragma omp critical(LabelSetImageToSurfaceFilterError)
+      {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+template <typename TPixel, unsigned int VDimension>
+void mitk::LabelSetImageToSurfaceFilter::ComputeLabelRegions(
+  const itk::Image<TPixel, VDimension> *input,
+  unsigned int border,
+  std::map<LabelType, typename itk::Image<TPixel, VDimension>::RegionType> &regions)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef typename ImageType::IndexType IndexType;
+  typedef std::pair<IndexType, IndexType> BoundsType;
+
+  const typename ImageType::RegionType &largestRegion = input->GetLargestPossibleRegion();
+  const LabelType background = static_cast<LabelType>(m_BackgroundLabel);
+
+  std::map<LabelType, BoundsType> bounds;
+  m_AvailableLabels.clear();
+
+  // Label images consist of long runs of equal values, so the map entry of the
+  // previous voxel is reused as long as the label does not change.
+  typename std::map<LabelType, BoundsType>::iterator current = bounds.end();
+  typename LabelMapType::iterator currentCount = m_AvailableLabels.end();
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it(input, largestRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const LabelType label = static_cast<LabelType>(it.Get());
+    if (label == background)
+      continue;
+
+    const IndexType &index = it.GetIndex();
+
+    if (current == bounds.end() || current->first != label)
+    {
+      current = bounds.find(label);
+      if (current == bounds.end())
+      {
+        current = bounds.insert(std::make_pair(label, BoundsType(index, index))).first;
+        currentCount = m_AvailableLabels.insert(std::make_pair(label, 0ul)).first;
+      }
+      else
+      {
+        currentCount = m_AvailableLabels.find(label);
+      }
+    }
+
+    ++currentCount->second;
+
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      current->second.first[d] = std::min(current->second.first[d], index[d]);
+      current->second.second[d] = std::max(current->second.second[d], index[d]);
+    }
+  }
+
+  regions.clear();
+  for (typename std::map<LabelType, BoundsType>::const_iterator bit = bounds.begin(); bit != bounds.end(); ++bit)
+  {
+    IndexType lower = bit->second.first;
+    typename ImageType::SizeType size;
+    for (unsigned int d = 0; d < VDimension; ++d)
+    {
+      lower[d] -= static_cast<typename IndexType::IndexValueType>(border);
+      size[d] = static_cast<typename ImageType::SizeType::SizeValueType>(bit->second.second[d] - bit->second.first[d] + 1) +
+                2 * border;
+    }
+
+    typename ImageType::RegionType region(lower, size);
+    region.Crop(largestRegion);
+    regions[bit->first] = region;
+  }
+}
+
+template <typename TPixel, unsigned int VDimension>
+typename itk::Image<TPixel, VDimension>::Pointer mitk::LabelSetImageToSurfaceFilter::CropLabelRegion(
+  const itk::Image<TPixel, VDimension> *input, const typename itk::Image<TPixel, VDimension>::RegionType &region)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
+  typedef itk::RegionOfInterestImageFilter<ImageType, ImageType> RegionOfInterestFilterType;
+
+  typename RegionOfInterestFilterType::Pointer roiFilter = RegionOfInterestFilterType::New();
+  roiFilter->SetInput(input);
+  roiFilter->SetRegionOfInterest(region);
+  roiFilter->Update();
+
+  typename ImageType::Pointer labelImage = roiFilter->GetOutput();
+  labelImage->DisconnectPipeline();
+  return labelImage;
+}
+
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::ExtractLabelSurface(
+  const itk::Image<TPixel, VDimension> *labelImage,
+  LabelType label,
+  const typename itk::Image<TPixel, VDimension>::RegionType &region,
+  const mitk::BaseGeometry *inputGeometry,
+  int numberOfThreads)
+{
+  typedef itk::Image<TPixel, VDimension> ImageType;
 
   typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> BinaryThresholdFilterType;
-  typedef itk::LabelObject<TPixel, VDimension> LabelObjectType;
-  typedef itk::LabelMap<LabelObjectType> LabelMapType;
-  typedef itk::LabelImageToLabelMapFilter<ImageType, LabelMapType> Image2LabelMapType;
-  typedef itk::AutoCropLabelMapFilter<LabelMapType> AutoCropType;
-  typedef itk::LabelMapToLabelImageFilter<LabelMapType, ImageType> LabelMap2ImageType;
 
   typedef itk::Image<float, VDimension> RealImageType;
 
@@ -105,46 +311,34 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   typedef itk::SmoothingRecursiveGaussianImageFilter<RealImageType, RealImageType> GaussianFilterType;
 
   typename BinaryThresholdFilterType::Pointer thresholdFilter = BinaryThresholdFilterType::New();
-  thresholdFilter->SetInput(input);
-  thresholdFilter->SetLowerThreshold(m_RequestedLabel);
-  thresholdFilter->SetUpperThreshold(m_RequestedLabel);
+  thresholdFilter->SetInput(labelImage);
+  thresholdFilter->SetLowerThreshold(label);
+  thresholdFilter->SetUpperThreshold(label);
   thresholdFilter->SetOutsideValue(0);
   thresholdFilter->SetInsideValue(1);
-  //  thresholdFilter->ReleaseDataFlagOn();
-  thresholdFilter->Update();
-
-  typename Image2LabelMapType::Pointer image2label = Image2LabelMapType::New();
-  image2label->SetInput(thresholdFilter->GetOutput());
-
-  typename AutoCropType::SizeType border;
-  border[0] = 3;
-  border[1] = 3;
-  border[2] = 3;
-
-  typename AutoCropType::Pointer autoCropFilter = AutoCropType::New();
-  autoCropFilter->SetInput(image2label->GetOutput());
-  autoCropFilter->SetCropBorder(border);
-  autoCropFilter->InPlaceOn();
-
-  typename LabelMap2ImageType::Pointer label2image = LabelMap2ImageType::New();
-  label2image->SetInput(autoCropFilter->GetOutput());
-
-  label2image->Update();
 
   typename AntiAliasFilterType::Pointer antiAliasFilter = AntiAliasFilterType::New();
-  antiAliasFilter->SetInput(label2image->GetOutput());
+  antiAliasFilter->SetInput(thresholdFilter->GetOutput());
   antiAliasFilter->SetMaximumRMSError(0.001);
   antiAliasFilter->SetNumberOfLayers(3);
   antiAliasFilter->SetUseImageSpacing(false);
   antiAliasFilter->SetNumberOfIterations(40);
 
+  typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
+
+  if (numberOfThreads > 0)
+  {
+    thresholdFilter->SetNumberOfThreads(numberOfThreads);
+    antiAliasFilter->SetNumberOfThreads(numberOfThreads);
+    gaussianFilter->SetNumberOfThreads(numberOfThreads);
+  }
+
   antiAliasFilter->Update();
 
   typename RealImageType::Pointer result;
 
   if (m_UseSmoothing)
   {
-    typename GaussianFilterType::Pointer gaussianFilter = GaussianFilterType::New();
     gaussianFilter->SetSigma(m_Sigma);
     gaussianFilter->SetInput(antiAliasFilter->GetOutput());
     gaussianFilter->Update();
@@ -157,21 +351,18 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
 
   result->DisconnectPipeline();
 
-  typename ImageType::RegionType cropRegion;
-  cropRegion = autoCropFilter->GetOutput()->GetLargestPossibleRegion();
-
-  const typename ImageType::IndexType &cropIndex = cropRegion.GetIndex();
+  const typename ImageType::IndexType &cropIndex = region.GetIndex();
 
-  m_ResultImage = mitk::Image::New();
-  mitk::CastToMitkImage(result, m_ResultImage);
+  mitk::Image::Pointer resultImage = mitk::Image::New();
+  mitk::CastToMitkImage(result, resultImage);
 
-  mitk::BaseGeometry *newGeometry = m_ResultImage->GetSlicedGeometry();
+  mitk::BaseGeometry *newGeometry = resultImage->GetSlicedGeometry();
   mitk::Point3D origin;
   vtk2itk(cropIndex, origin);
-  this->GetInput()->GetGeometry()->IndexToWorld(origin, origin);
+  inputGeometry->IndexToWorld(origin, origin);
   newGeometry->SetOrigin(origin);
 
-  vtkImageData *vtkimage = const_cast<vtkImageData *>(m_ResultImage->GetVtkImageData(0));
+  vtkImageData *vtkimage = const_cast<vtkImageData *>(resultImage->GetVtkImageData(0));
 
   vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
     vtkSmartPointer<vtkImageChangeInformation>::New();
@@ -223,6 +414,5 @@ void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPi
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  mitk::Surface::Pointer output = this->GetOutput(0);
-  output->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), 0);
+  return cleanPolyDataFilter->GetOutput();
 }
@@ -20,9 +20,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkMultilabelExports.h"
 #include "mitkLabelSetImage.h"
 #include "mitkSurface.h"
+#include <mitkMessage.h>
 #include <mitkSurfaceSource.h>
 
 #include <vtkMatrix4x4.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 
 #include <itkImage.h>
 
@@ -34,6 +37,13 @@ namespace mitk
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
    * you may call GenerateAllLabelsOn().
+   *
+   * The bounding boxes of all labels are determined in a single pass over the
+   * image. Each label is then meshed on a sub-volume cropped to its bounding box,
+   * so the cost of a label depends on its extent rather than on the image size.
+   * In GenerateAllLabels mode the labels are meshed in parallel (if OpenMP is
+   * available) and output i holds the surface of label GetLabelOfOutput(i).
+   * SurfaceGeneratedEvent is sent as soon as the surface of a label is complete.
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -48,6 +58,12 @@ namespace mitk
 
     typedef std::map<unsigned int, LabelType> IndexToLabelMapType;
 
+    /**
+     * Sent whenever the surface of a label has been generated. In GenerateAllLabels
+     * mode the message is sent from the worker thread that meshed the label.
+     */
+    Message2<LabelType, Surface *> SurfaceGeneratedEvent;
+
     /**
     * Returns a const pointer to the labelset image set as input
     */
@@ -75,7 +91,8 @@ namespace mitk
 
     /**
      * Set the label you want to extract. This method only has an effect,
-     * if GenerateAllLabels() is set to false
+     * if GenerateAllLabels() is set to false. Updating the filter throws an
+     * itk::ExceptionObject if the label is not present in the input image.
      * @param _arg the label to extract, by default 1
      */
     itkSetMacro(RequestedLabel, int);
@@ -109,6 +126,18 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Returns the number of voxels of each label found in the last update
+     * (background excluded).
+     */
+    itkGetConstReferenceMacro(AvailableLabels, LabelMapType);
+
+    /**
+     * Returns the label whose surface is stored in output idx.
+     * @returns the background label if idx is not a valid output index
+     */
+    LabelType GetLabelOfOutput(unsigned int idx) const;
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -128,11 +157,40 @@ namespace mitk
       out[2] = z;
     }
 
-    mitk::Image::Pointer m_ResultImage;
-
     template <typename TPixel, unsigned int VImageDimension>
     void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
 
+    /**
+     * Determines voxel count and bounding box (padded by border voxels and clipped
+     * to the image) of every label in a single pass.
+     */
+    template <typename TPixel, unsigned int VImageDimension>
+    void ComputeLabelRegions(const itk::Image<TPixel, VImageDimension> *input,
+                             unsigned int border,
+                             std::map<LabelType, typename itk::Image<TPixel, VImageDimension>::RegionType> &regions);
+
+    /**
+     * Copies the region of the input into a new image which is disconnected from the
+     * pipeline. Not safe to be called concurrently, since it changes the requested
+     * region of the input.
+     */
+    template <typename TPixel, unsigned int VImageDimension>
+    typename itk::Image<TPixel, VImageDimension>::Pointer CropLabelRegion(
+      const itk::Image<TPixel, VImageDimension> *input,
+      const typename itk::Image<TPixel, VImageDimension>::RegionType &region);
+
+    /**
+     * Meshes a single label on a sub-volume of the input, cropped by CropLabelRegion()
+     * from the given region. Safe to be called concurrently for different labels.
+     */
+    template <typename TPixel, unsigned int VImageDimension>
+    vtkSmartPointer<vtkPolyData> ExtractLabelSurface(
+      const itk::Image<TPixel, VImageDimension> *labelImage,
+      LabelType label,
+      const typename itk::Image<TPixel, VImageDimension>::RegionType &region,
+      const mitk::BaseGeometry *inputGeometry,
+      int numberOfThreads);
+
     bool m_GenerateAllLabels;
 
     int m_RequestedLabel;
@@ -21,7 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1)
   {
   }
 
@@ -74,10 +74,19 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
+    bool generateAllLabels(false);
+    try
+    {
+      this->GetParameter("GenerateAllLabels", generateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+    }
+
     mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
     filter->SetInput(image);
     //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
+    filter->SetGenerateAllLabels(generateAllLabels);
     filter->SetRequestedLabel(m_RequestedLabel);
     filter->SetUseSmoothing(useSmoothing);
 
@@ -101,14 +110,19 @@ namespace mitk
       return false;
     }
 
-    m_Result = filter->GetOutput();
+    m_Results.clear();
 
-    if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
-      return false;
+    for (unsigned int idx = 0; idx < filter->GetNumberOfIndexedOutputs(); ++idx)
+    {
+      Surface::Pointer result = filter->GetOutput(idx);
+      if (result.IsNull() || !result->GetVtkPolyData())
+        continue;
 
-    m_Result->DisconnectPipeline();
+      result->DisconnectPipeline();
+      m_Results.push_back(std::make_pair(static_cast<int>(filter->GetLabelOfOutput(idx)), result));
+    }
 
-    return true;
+    return !m_Results.empty();
   }
 
   void LabelSetImageToSurfaceThreadedFilter::ThreadedUpdateSuccessful()
@@ -116,17 +130,24 @@ namespace mitk
     LabelSetImage::Pointer image;
     this->GetPointerParameter("Input", image);
 
-    std::string name = this->GetGroupNode()->GetName();
-    name.append("-surf");
+    for (auto it = m_Results.begin(); it != m_Results.end(); ++it)
+    {
+      mitk::Label *label = image->GetLabel(it->first, image->GetActiveLayer());
+
+      std::string name = this->GetGroupNode()->GetName();
+      if (m_Results.size() > 1 && label)
+        name.append("-").append(label->GetName());
+      name.append("-surf");
 
-    mitk::DataNode::Pointer node = mitk::DataNode::New();
-    node->SetData(m_Result);
-    node->SetName(name);
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetData(it->second);
+      node->SetName(name);
 
-    mitk::Color color = image->GetLabel(m_RequestedLabel, image->GetActiveLayer())->GetColor();
-    node->SetColor(color);
+      if (label)
+        node->SetColor(label->GetColor());
 
-    this->InsertBelowGroupNode(node);
+      this->InsertBelowGroupNode(node);
+    }
 
     Superclass::ThreadedUpdateSuccessful();
   }
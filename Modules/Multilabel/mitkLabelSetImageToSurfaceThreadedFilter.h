@@ -21,8 +21,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
+#include <utility>
+#include <vector>
+
 namespace mitk
 {
+  /**
+   * Generates the surface of the label given by the "RequestedLabel" parameter in
+   * a background thread. If the "GenerateAllLabels" parameter is set, the surfaces
+   * of all labels are generated in one batch and one node per label is inserted
+   * below the group node.
+   */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceThreadedFilter : public SegmentationSink
   {
   public:
@@ -41,8 +50,10 @@ namespace mitk
     virtual void ThreadedUpdateSuccessful() override; // will be called from a thread after calling StartAlgorithm
 
   private:
+    typedef std::vector<std::pair<int, Surface::Pointer>> ResultVectorType;
+
     int m_RequestedLabel;
-    Surface::Pointer m_Result;
+    ResultVectorType m_Results;
   };
 
 } // namespace
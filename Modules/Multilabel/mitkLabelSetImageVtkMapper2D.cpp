@@ -56,6 +56,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <algorithm>
+#include <limits>
+
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
 {
 }
@@ -96,15 +99,21 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   float opacity = 1.0f;
   node->GetOpacity(opacity, renderer, "opacity");
 
-  if (numberOfLayers != localStorage->m_NumberOfLayers)
+  bool fused = false;
+  node->GetBoolProperty("labelset.layers.fused", fused, renderer);
+
+  if (numberOfLayers != localStorage->m_NumberOfLayers || fused != localStorage->m_Fused)
   {
     localStorage->m_NumberOfLayers = numberOfLayers;
+    localStorage->m_Fused = fused;
     localStorage->m_ReslicedImageVector.clear();
     localStorage->m_ReslicerVector.clear();
     localStorage->m_LayerTextureVector.clear();
     localStorage->m_LevelWindowFilterVector.clear();
     localStorage->m_LayerMapperVector.clear();
     localStorage->m_LayerActorVector.clear();
+    localStorage->m_ReslicedLayerImageVector.clear();
+    localStorage->m_LayerUpdateTimeVector.clear();
 
     localStorage->m_Actors = vtkSmartPointer<vtkPropAssembly>::New();
 
@@ -116,6 +125,8 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
       localStorage->m_LevelWindowFilterVector.push_back(vtkSmartPointer<vtkMitkLevelWindowFilter>::New());
       localStorage->m_LayerMapperVector.push_back(vtkSmartPointer<vtkPolyDataMapper>::New());
       localStorage->m_LayerActorVector.push_back(vtkSmartPointer<vtkActor>::New());
+      localStorage->m_ReslicedLayerImageVector.push_back(nullptr);
+      localStorage->m_LayerUpdateTimeVector.push_back(itk::TimeStamp());
 
       // do not repeat the texture (the image)
       localStorage->m_LayerTextureVector[lidx]->RepeatOff();
@@ -123,9 +134,13 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
       // set corresponding mappers for the actors
       localStorage->m_LayerActorVector[lidx]->SetMapper(localStorage->m_LayerMapperVector[lidx]);
 
-      localStorage->m_Actors->AddPart(localStorage->m_LayerActorVector[lidx]);
+      if (!fused)
+        localStorage->m_Actors->AddPart(localStorage->m_LayerActorVector[lidx]);
     }
 
+    if (fused)
+      localStorage->m_Actors->AddPart(localStorage->m_FusedActor);
+
     localStorage->m_Actors->AddPart(localStorage->m_OutlineShadowActor);
     localStorage->m_Actors->AddPart(localStorage->m_OutlineActor);
   }
@@ -140,13 +155,26 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     for (int lidx = 0; lidx < numberOfLayers; ++lidx)
     {
       localStorage->m_ReslicedImageVector[lidx] = NULL;
+      localStorage->m_ReslicedLayerImageVector[lidx] = nullptr;
       localStorage->m_LayerMapperVector[lidx]->SetInputData(localStorage->m_EmptyPolyData);
       localStorage->m_OutlineActor->SetVisibility(false);
       localStorage->m_OutlineShadowActor->SetVisibility(false);
     }
+    localStorage->m_FusedMapper->SetInputData(localStorage->m_EmptyPolyData);
     return;
   }
 
+  // in fused mode slices are only resliced again if the plane or the layer data changed
+  const bool sliceGeometryChanged =
+    localStorage->m_LastTimeStep != static_cast<int>(this->GetTimestep()) ||
+    std::any_of(localStorage->m_LayerUpdateTimeVector.begin(),
+                localStorage->m_LayerUpdateTimeVector.end(),
+                [renderer, worldGeometry](const itk::TimeStamp &updateTime) {
+                  return updateTime < renderer->GetCurrentWorldPlaneGeometryUpdateTime() ||
+                         updateTime < worldGeometry->GetMTime();
+                });
+  localStorage->m_LastTimeStep = this->GetTimestep();
+
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
   {
     mitk::Image *layerImage = NULL;
@@ -157,6 +185,13 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     else
       layerImage = image->GetLayerImage(lidx);
 
+    if (fused && !sliceGeometryChanged && localStorage->m_ReslicedImageVector[lidx] != nullptr &&
+        localStorage->m_ReslicedLayerImageVector[lidx] == layerImage &&
+        layerImage->GetMTime() < localStorage->m_LayerUpdateTimeVector[lidx])
+    {
+      continue;
+    }
+
     localStorage->m_ReslicerVector[lidx]->SetInput(layerImage);
     localStorage->m_ReslicerVector[lidx]->SetWorldGeometry(worldGeometry);
     localStorage->m_ReslicerVector[lidx]->SetTimeStep(this->GetTimestep());
@@ -199,6 +234,13 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_ReslicerVector[lidx]->UpdateLargestPossibleRegion();
     localStorage->m_ReslicedImageVector[lidx] = localStorage->m_ReslicerVector[lidx]->GetVtkOutput();
 
+    if (fused)
+    {
+      localStorage->m_ReslicedLayerImageVector[lidx] = layerImage;
+      localStorage->m_LayerUpdateTimeVector[lidx].Modified();
+      continue;
+    }
+
     const PlaneGeometry *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
 
     double textureClippingBounds[6];
@@ -250,6 +292,39 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_LayerActorVector[lidx]->GetProperty()->SetOpacity(opacity);
   }
 
+  if (fused)
+  {
+    const PlaneGeometry *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
+
+    double textureClippingBounds[6];
+    for (auto &textureClippingBound : textureClippingBounds)
+    {
+      textureClippingBound = 0.0;
+    }
+
+    // all layers share the geometry of the image
+    mitk::PlaneClipping::CalculateClippedPlaneBounds(image->GetGeometry(), planeGeometry, textureClippingBounds);
+
+    textureClippingBounds[0] = static_cast<int>(textureClippingBounds[0] / localStorage->m_mmPerPixel[0] + 0.5);
+    textureClippingBounds[1] = static_cast<int>(textureClippingBounds[1] / localStorage->m_mmPerPixel[0] + 0.5);
+    textureClippingBounds[2] = static_cast<int>(textureClippingBounds[2] / localStorage->m_mmPerPixel[1] + 0.5);
+    textureClippingBounds[3] = static_cast<int>(textureClippingBounds[3] / localStorage->m_mmPerPixel[1] + 0.5);
+
+    this->ComposeLayers(renderer, image, textureClippingBounds);
+
+    bool textureInterpolation = false;
+    node->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
+    localStorage->m_FusedTexture->SetInterpolate(textureInterpolation);
+    localStorage->m_FusedTexture->SetInputData(localStorage->m_FusedImage);
+    localStorage->m_FusedTexture->Modified();
+
+    this->TransformActor(renderer);
+
+    localStorage->m_FusedMapper->SetInputConnection(localStorage->m_Plane->GetOutputPort());
+    localStorage->m_FusedActor->SetTexture(localStorage->m_FusedTexture);
+    localStorage->m_FusedActor->GetProperty()->SetOpacity(opacity);
+  }
+
   mitk::Label* activeLabel = image->GetActiveLabel(activeLayer);
   if (nullptr != activeLabel)
   {
@@ -282,6 +357,94 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   localStorage->m_OutlineShadowActor->SetVisibility(false);
 }
 
+void mitk::LabelSetImageVtkMapper2D::ComposeLayers(mitk::BaseRenderer *renderer,
+                                                   mitk::LabelSetImage *image,
+                                                   const double *textureClippingBounds)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+
+  vtkImageData *referenceSlice = localStorage->m_ReslicedImageVector[0];
+  if (referenceSlice == nullptr)
+    return;
+
+  int extent[6];
+  referenceSlice->GetExtent(extent);
+  int fusedExtent[6];
+  localStorage->m_FusedImage->GetExtent(fusedExtent);
+
+  if (!std::equal(extent, extent + 6, fusedExtent) || localStorage->m_FusedImage->GetNumberOfScalarComponents() != 4 ||
+      localStorage->m_FusedImage->GetScalarPointer() == nullptr)
+  {
+    localStorage->m_FusedImage->SetExtent(extent);
+    localStorage->m_FusedImage->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  }
+  localStorage->m_FusedImage->SetSpacing(referenceSlice->GetSpacing());
+  localStorage->m_FusedImage->SetOrigin(referenceSlice->GetOrigin());
+
+  const int width = extent[1] - extent[0] + 1;
+  const int height = extent[3] - extent[2] + 1;
+  const vtkIdType numberOfPixels = static_cast<vtkIdType>(width) * height;
+
+  unsigned char *output = static_cast<unsigned char *>(localStorage->m_FusedImage->GetScalarPointer());
+  std::fill(output, output + 4 * numberOfPixels, 0);
+
+  // pixels outside of the clipping bounds stay transparent (see vtkMitkLevelWindowFilter)
+  const int xBegin = std::max(0, static_cast<int>(textureClippingBounds[0]) - extent[0]);
+  const int xEnd = std::min(width, static_cast<int>(textureClippingBounds[1]) - extent[0]);
+  const int yBegin = std::max(0, static_cast<int>(textureClippingBounds[2]) - extent[2]);
+  const int yEnd = std::min(height, static_cast<int>(textureClippingBounds[3]) - extent[2]);
+
+  const vtkIdType numberOfLabelValues =
+    static_cast<vtkIdType>(std::numeric_limits<mitk::Label::PixelType>::max()) + 1;
+
+  for (int lidx = 0; lidx < localStorage->m_NumberOfLayers; ++lidx)
+  {
+    vtkImageData *slice = localStorage->m_ReslicedImageVector[lidx];
+    if (slice == nullptr || slice->GetScalarType() != VTK_UNSIGNED_SHORT || slice->GetNumberOfPoints() != numberOfPixels)
+      continue;
+
+    const mitk::Label::PixelType *input = static_cast<const mitk::Label::PixelType *>(slice->GetScalarPointer());
+
+    // the label set lookup tables map each label value to exactly one table entry, so the
+    // colors can be read from the table directly instead of calling MapValue() per pixel
+    vtkLookupTable *lookupTable = image->GetLabelSet(lidx)->GetLookupTable()->GetVtkLookupTable();
+    const double *tableRange = lookupTable->GetTableRange();
+    const bool directLookup = lookupTable->GetNumberOfTableValues() == numberOfLabelValues && tableRange[0] == 0.0 &&
+                              tableRange[1] == static_cast<double>(numberOfLabelValues);
+    const unsigned char *table = directLookup ? lookupTable->GetPointer(0) : nullptr;
+
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+      const mitk::Label::PixelType *inputRow = input + static_cast<vtkIdType>(y) * width;
+      unsigned char *outputRow = output + 4 * static_cast<vtkIdType>(y) * width;
+
+      for (int x = xBegin; x < xEnd; ++x)
+      {
+        const unsigned char *color = table ? table + 4 * inputRow[x] : lookupTable->MapValue(inputRow[x]);
+        const unsigned int alpha = color[3];
+        if (alpha == 0)
+          continue;
+
+        unsigned char *target = outputRow + 4 * x;
+        if (alpha == 255 || target[3] == 0)
+        {
+          std::copy(color, color + 4, target);
+          continue;
+        }
+
+        // "over" operator: the current layer is drawn on top of the layers below
+        const unsigned int below = target[3] * (255 - alpha) / 255;
+        const unsigned int outputAlpha = alpha + below;
+        for (int c = 0; c < 3; ++c)
+          target[c] = static_cast<unsigned char>((color[c] * alpha + target[c] * below + outputAlpha / 2) / outputAlpha);
+        target[3] = static_cast<unsigned char>(outputAlpha);
+      }
+    }
+  }
+
+  localStorage->m_FusedImage->Modified();
+}
+
 bool mitk::LabelSetImageVtkMapper2D::RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry,
                                                                       SlicedGeometry3D *imageGeometry)
 {
@@ -591,6 +754,10 @@ void mitk::LabelSetImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer
     localStorage->m_LayerActorVector[lidx]->SetPosition(
       -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
   }
+  // same for the fused actor
+  localStorage->m_FusedActor->SetUserTransform(trans);
+  localStorage->m_FusedActor->SetPosition(
+    -0.5 * localStorage->m_mmPerPixel[0], -0.5 * localStorage->m_mmPerPixel[1], 0.0);
   // same for outline actor
   localStorage->m_OutlineActor->SetUserTransform(trans);
   localStorage->m_OutlineActor->SetPosition(
@@ -621,6 +788,7 @@ void mitk::LabelSetImageVtkMapper2D::SetDefaultProperties(mitk::DataNode *node,
 
   node->SetProperty("labelset.contour.active", BoolProperty::New(true), renderer);
   node->SetProperty("labelset.contour.width", FloatProperty::New(2.0), renderer);
+  node->SetProperty("labelset.layers.fused", BoolProperty::New(false), renderer);
 
   Superclass::SetDefaultProperties(node, renderer, overwrite);
 }
@@ -641,6 +809,18 @@ mitk::LabelSetImageVtkMapper2D::LocalStorage::LocalStorage()
   m_OutlineShadowActor = vtkSmartPointer<vtkActor>::New();
 
   m_NumberOfLayers = 0;
+  m_Fused = false;
+  m_LastTimeStep = -1;
+
+  m_FusedImage = vtkSmartPointer<vtkImageData>::New();
+  m_FusedTexture = vtkSmartPointer<vtkNeverTranslucentTexture>::New();
+  m_FusedMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  m_FusedActor = vtkSmartPointer<vtkActor>::New();
+
+  // the fused image already holds the colors, do not repeat it
+  m_FusedTexture->RepeatOff();
+  m_FusedTexture->MapColorScalarsThroughLookupTableOff();
+  m_FusedActor->SetMapper(m_FusedMapper);
 
   m_OutlineActor->SetMapper(m_OutlineMapper);
   m_OutlineShadowActor->SetMapper(m_OutlineMapper);
@@ -51,11 +51,15 @@ namespace mitk
    *
    *   - \b "labelset.contour.active": (BoolProperty) whether to show only the active label as a contour or not
    *   - \b "labelset.contour.width": (FloatProperty) line width of the contour
+   *   - \b "labelset.layers.fused": (BoolProperty) whether to composite all layers into a single texture
+   *     instead of rendering one textured plane per layer. Slices of layers whose data did not change
+   *     are not resliced again in this mode.
 
    * The default properties are:
 
    *   - \b "labelset.contour.active", mitk::BoolProperty::New( true ), renderer, overwrite )
    *   - \b "labelset.contour.width", mitk::FloatProperty::New( 2.0 ), renderer, overwrite )
+   *   - \b "labelset.layers.fused", mitk::BoolProperty::New( false ), renderer, overwrite )
 
    * \ingroup Mapper
    */
@@ -120,6 +124,20 @@ namespace mitk
 
       int m_NumberOfLayers;
 
+      /** \brief Whether the actors are assembled for the fused mode ("labelset.layers.fused"). */
+      bool m_Fused;
+
+      /** \brief The composition of all layers (fused mode only). */
+      vtkSmartPointer<vtkImageData> m_FusedImage;
+      vtkSmartPointer<vtkNeverTranslucentTexture> m_FusedTexture;
+      vtkSmartPointer<vtkPolyDataMapper> m_FusedMapper;
+      vtkSmartPointer<vtkActor> m_FusedActor;
+
+      /** \brief The image each layer slice was resliced from and the time of reslicing (fused mode only). */
+      std::vector<const mitk::Image *> m_ReslicedLayerImageVector;
+      std::vector<itk::TimeStamp> m_LayerUpdateTimeVector;
+      int m_LastTimeStep;
+
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       // vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
       std::vector<vtkSmartPointer<vtkMitkLevelWindowFilter>> m_LevelWindowFilterVector;
@@ -194,6 +212,14 @@ namespace mitk
       */
     virtual void GenerateDataForRenderer(mitk::BaseRenderer *renderer) override;
 
+    /** \brief Composites the resliced slices of all layers into the RGBA image of the fused mode.
+      *
+      * The label colors are looked up directly in the label set lookup tables and blended
+      * ("over" operator) in layer order, so upper layers are drawn on top of lower ones.
+      * Pixels outside the texture clipping bounds stay transparent.
+      */
+    void ComposeLayers(mitk::BaseRenderer *renderer, mitk::LabelSetImage *image, const double *textureClippingBounds);
+
     /** \brief This method uses the vtkCamera clipping range and the layer property
       * to calcualte the depth of the object (e.g. image or contour). The depth is used
       * to keep the correct order for the final VTK rendering.*/
@@ -0,0 +1,159 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+#include <mitkIGTLMessageQueue.h>
+
+#include <igtlStatusMessage.h>
+#include <igtlTransformMessage.h>
+
+#include <thread>
+
+class mitkOpenIGTLinkMessageQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkOpenIGTLinkMessageQueueTestSuite);
+  MITK_TEST(Test_PushAndPull_SortedByType);
+  MITK_TEST(Test_InfiniteBuffering_KeepsOrder);
+  MITK_TEST(Test_NoBuffering_ReturnsLatest);
+  MITK_TEST(Test_Default_ReturnsLatest);
+  MITK_TEST(Test_FullBuffer_DropsOldestMessages);
+  MITK_TEST(Test_ConcurrentPushAndPull_NoMessageLost);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::IGTLMessageQueue::Pointer m_Queue;
+
+  igtl::MessageBase::Pointer CreateTransformMessage(const std::string &name)
+  {
+    igtl::TransformMessage::Pointer message = igtl::TransformMessage::New();
+    message->SetDeviceName(name.c_str());
+    return message.GetPointer();
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Queue = mitk::IGTLMessageQueue::New();
+  }
+
+  void tearDown() override
+  {
+    m_Queue = nullptr;
+  }
+
+  void Test_PushAndPull_SortedByType()
+  {
+    m_Queue->PushMessage(this->CreateTransformMessage("transform"));
+    m_Queue->PushMessage(igtl::StatusMessage::New().GetPointer());
+    CPPUNIT_ASSERT_EQUAL(2, m_Queue->GetSize());
+
+    CPPUNIT_ASSERT(m_Queue->PullTrackingMessage().IsNull());
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNotNull());
+    CPPUNIT_ASSERT(m_Queue->PullMiscMessage().IsNotNull());
+    CPPUNIT_ASSERT(m_Queue->PullMiscMessage().IsNull());
+    CPPUNIT_ASSERT_EQUAL(0, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::string("STATUS"), m_Queue->GetLatestMsgDeviceType());
+  }
+
+  void Test_InfiniteBuffering_KeepsOrder()
+  {
+    m_Queue->EnableInfiniteBuffering(true);
+    m_Queue->PushMessage(this->CreateTransformMessage("first"));
+    m_Queue->PushMessage(this->CreateTransformMessage("second"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("first"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT_EQUAL(std::string("second"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+  }
+
+  void Test_NoBuffering_ReturnsLatest()
+  {
+    m_Queue->EnableInfiniteBuffering(false);
+    m_Queue->PushMessage(this->CreateTransformMessage("first"));
+    m_Queue->PushMessage(this->CreateTransformMessage("second"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("second"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+  }
+
+  void Test_Default_ReturnsLatest()
+  {
+    m_Queue->PushMessage(this->CreateTransformMessage("first"));
+    m_Queue->PushMessage(this->CreateTransformMessage("second"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("second"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+  }
+
+  void Test_FullBuffer_DropsOldestMessages()
+  {
+    m_Queue->EnableInfiniteBuffering(true);
+
+    const unsigned int numberOfMessages = mitk::IGTLMessageQueue::BUFFER_CAPACITY + 10;
+    for (unsigned int i = 0; i < numberOfMessages; ++i)
+    {
+      m_Queue->PushMessage(this->CreateTransformMessage(std::to_string(i)));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(10u, m_Queue->GetNumberOfDroppedMessages());
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(mitk::IGTLMessageQueue::BUFFER_CAPACITY), m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::string("10"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+  }
+
+  void Test_ConcurrentPushAndPull_NoMessageLost()
+  {
+    const unsigned int numberOfMessages = 10000;
+    m_Queue->EnableInfiniteBuffering(true);
+
+    std::thread receiver([this, numberOfMessages]() {
+      for (unsigned int i = 0; i < numberOfMessages; ++i)
+      {
+        igtl::MessageBase::Pointer message = this->CreateTransformMessage(std::to_string(i));
+        // wait for the consumer instead of dropping, as a network receiver would be throttled by TCP
+        while (m_Queue->GetSize() >= static_cast<int>(mitk::IGTLMessageQueue::BUFFER_CAPACITY))
+        {
+          std::this_thread::yield();
+        }
+        m_Queue->PushMessage(message);
+      }
+    });
+
+    unsigned int received = 0;
+    bool inOrder = true;
+    while (received < numberOfMessages)
+    {
+      igtl::TransformMessage::Pointer message = m_Queue->PullTransformMessage();
+      if (message.IsNull())
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      inOrder = inOrder && std::to_string(received) == message->GetDeviceName();
+      ++received;
+    }
+    receiver.join();
+
+    CPPUNIT_ASSERT_MESSAGE("Messages are pulled in the order they were pushed", inOrder);
+
+    CPPUNIT_ASSERT_EQUAL(0u, m_Queue->GetNumberOfDroppedMessages());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkOpenIGTLinkMessageQueue)
@@ -18,295 +18,229 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <string>
 #include "igtlMessageBase.h"
 
-void mitk::IGTLMessageQueue::PushSendMessage(igtl::MessageBase::Pointer message)
+template <typename TMessage>
+void mitk::IGTLMessageQueue::PushToBuffer(MessageBuffer<TMessage> &buffer, TMessage *message)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-    m_SendQueue.clear();
+  // only the pushing thread fills the buffer, so the retry succeeds once a message was removed
+  while (!buffer.Push(message))
+  {
+    if (buffer.DropOldest() && m_NumberOfDroppedMessages++ == 0)
+    {
+      MITK_WARN("IGTLMessageQueue") << "Message buffer is full, the oldest messages are dropped.";
+    }
+  }
+}
 
-  m_SendQueue.push_back(message);
-  this->m_Mutex->Unlock();
+bool mitk::IGTLMessageQueue::IsLatestOnly() const
+{
+  return m_BufferingType == IGTLMessageQueue::NoBuffering;
 }
 
-void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+void mitk::IGTLMessageQueue::PushSendMessage(igtl::MessageBase::Pointer message)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-    m_CommandQueue.clear();
+  // only producers are serialized here, the send thread pulls without locking
+  m_SendMutex.Lock();
+  this->PushToBuffer(m_SendQueue, message.GetPointer());
+  m_SendMutex.Unlock();
+}
 
-  m_CommandQueue.push_back(message);
-  this->m_Mutex->Unlock();
+void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+{
+  this->PushToBuffer(m_CommandQueue, message.GetPointer());
 }
 
 void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
 {
-  this->m_Mutex->Lock();
-
-  std::stringstream infolog;
-
-  infolog << "Received message of type ";
+  const char* type;
 
-  if (dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()) != nullptr)
+  if (igtl::TrackingDataMessage* trackingDataMsg = dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_TrackingDataQueue.clear();
+    this->PushToBuffer(m_TrackingDataQueue, trackingDataMsg);
 
-    this->m_TrackingDataQueue.push_back(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()));
-
-    infolog << "TDATA";
+    type = "TDATA";
   }
-  else if (dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::TransformMessage* transformMsg = dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_TransformQueue.clear();
-
-    this->m_TransformQueue.push_back(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()));
+    this->PushToBuffer(m_TransformQueue, transformMsg);
 
-    infolog << "TRANSFORM";
+    type = "TRANSFORM";
   }
-  else if (dynamic_cast<igtl::StringMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::StringMessage* stringMsg = dynamic_cast<igtl::StringMessage*>(msg.GetPointer()))
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_StringQueue.clear();
-
-    this->m_StringQueue.push_back(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()));
+    this->PushToBuffer(m_StringQueue, stringMsg);
 
-    infolog << "STRING";
+    type = "STRING";
   }
-  else if (dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()) != nullptr)
+  else if (igtl::ImageMessage* imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()))
   {
-    igtl::ImageMessage::Pointer imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer());
-    int* dim = new int[3];
+    int dim[3];
     imageMsg->GetDimensions(dim);
     if (dim[2] > 1)
     {
-      if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-        m_Image3dQueue.clear();
+      this->PushToBuffer(m_Image3dQueue, imageMsg);
 
-      this->m_Image3dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE3D";
+      type = "IMAGE3D";
     }
     else
     {
-      if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-        m_Image2dQueue.clear();
-
-      this->m_Image2dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
+      this->PushToBuffer(m_Image2dQueue, imageMsg);
 
-      infolog << "IMAGE2D";
+      type = "IMAGE2D";
     }
   }
   else
   {
-    if (this->m_BufferingType == IGTLMessageQueue::Infinit)
-      m_MiscQueue.clear();
-
-    this->m_MiscQueue.push_back(msg);
+    this->PushToBuffer(m_MiscQueue, msg.GetPointer());
 
-    infolog << "OTHER";
+    type = "OTHER";
   }
 
+  m_LatestMessageMutex.Lock();
   m_Latest_Message = msg;
+  m_LatestMessageMutex.Unlock();
 
-  MITK_INFO << infolog.str();
-
-  this->m_Mutex->Unlock();
+  MITK_DEBUG << "Received message of type " << type;
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullSendMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_SendQueue.size() > 0)
-  {
-    ret = this->m_SendQueue.front();
-    this->m_SendQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_SendQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_MiscQueue.size() > 0)
-  {
-    ret = this->m_MiscQueue.front();
-    this->m_MiscQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_MiscQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage2dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image2dQueue.size() > 0)
-  {
-    ret = this->m_Image2dQueue.front();
-    this->m_Image2dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image2dQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage3dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image3dQueue.size() > 0)
-  {
-    ret = this->m_Image3dQueue.front();
-    this->m_Image3dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image3dQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::TrackingDataMessage::Pointer mitk::IGTLMessageQueue::PullTrackingMessage()
 {
-  igtl::TrackingDataMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TrackingDataQueue.size() > 0)
-  {
-    ret = this->m_TrackingDataQueue.front();
-    this->m_TrackingDataQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TrackingDataQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullCommandMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_CommandQueue.size() > 0)
-  {
-    ret = this->m_CommandQueue.front();
-    this->m_CommandQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_CommandQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::StringMessage::Pointer mitk::IGTLMessageQueue::PullStringMessage()
 {
-  igtl::StringMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_StringQueue.size() > 0)
-  {
-    ret = this->m_StringQueue.front();
-    this->m_StringQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_StringQueue.Pull(this->IsLatestOnly());
 }
 
 igtl::TransformMessage::Pointer mitk::IGTLMessageQueue::PullTransformMessage()
 {
-  igtl::TransformMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TransformQueue.size() > 0)
-  {
-    ret = this->m_TransformQueue.front();
-    this->m_TransformQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TransformQueue.Pull(this->IsLatestOnly());
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
 {
-  this->m_Mutex->Lock();
+  // the pointer is copied so that the receive thread is not blocked during formatting
+  igtl::MessageBase::Pointer latestMessage = this->GetLatestMessage();
   std::stringstream s;
-  if (this->m_Latest_Message != nullptr)
+  if (latestMessage != nullptr)
   {
-    s << "Device Type: " << this->m_Latest_Message->GetDeviceType() << std::endl;
-    s << "Device Name: " << this->m_Latest_Message->GetDeviceName() << std::endl;
+    s << "Device Type: " << latestMessage->GetDeviceType() << std::endl;
+    s << "Device Name: " << latestMessage->GetDeviceName() << std::endl;
   }
   else
   {
     s << "No Msg";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgDeviceType()
 {
-  this->m_Mutex->Lock();
+  // the pointer is copied so that the receive thread is not blocked during formatting
+  igtl::MessageBase::Pointer latestMessage = this->GetLatestMessage();
   std::stringstream s;
-  if (m_Latest_Message != nullptr)
+  if (latestMessage != nullptr)
   {
-    s << this->m_Latest_Message->GetDeviceType();
+    s << latestMessage->GetDeviceType();
   }
   else
   {
     s << "";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetLatestMsgInformationString()
 {
-  this->m_Mutex->Lock();
+  // the pointer is copied so that the receive thread is not blocked during formatting
+  igtl::MessageBase::Pointer latestMessage = this->GetLatestMessage();
   std::stringstream s;
-  if (m_Latest_Message != nullptr)
+  if (latestMessage != nullptr)
   {
-    s << "Device Type: " << this->m_Latest_Message->GetDeviceType() << std::endl;
-    s << "Device Name: " << this->m_Latest_Message->GetDeviceName() << std::endl;
+    s << "Device Type: " << latestMessage->GetDeviceType() << std::endl;
+    s << "Device Name: " << latestMessage->GetDeviceName() << std::endl;
   }
   else
   {
     s << "No Msg";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
 {
-  this->m_Mutex->Lock();
+  // the pointer is copied so that the receive thread is not blocked during formatting
+  igtl::MessageBase::Pointer latestMessage = this->GetLatestMessage();
   std::stringstream s;
-  if (m_Latest_Message != nullptr)
+  if (latestMessage != nullptr)
   {
-    s << this->m_Latest_Message->GetDeviceType();
+    s << latestMessage->GetDeviceType();
   }
   else
   {
     s << "";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
+igtl::MessageBase::Pointer mitk::IGTLMessageQueue::GetLatestMessage()
+{
+  m_LatestMessageMutex.Lock();
+  igtl::MessageBase::Pointer latestMessage = m_Latest_Message;
+  m_LatestMessageMutex.Unlock();
+  return latestMessage;
+}
+
 int mitk::IGTLMessageQueue::GetSize()
 {
-  return (this->m_CommandQueue.size() + this->m_Image2dQueue.size() + this->m_Image3dQueue.size() + this->m_MiscQueue.size()
-    + this->m_StringQueue.size() + this->m_TrackingDataQueue.size() + this->m_TransformQueue.size());
+  return (this->m_CommandQueue.GetSize() + this->m_Image2dQueue.GetSize() + this->m_Image3dQueue.GetSize()
+    + this->m_MiscQueue.GetSize() + this->m_StringQueue.GetSize() + this->m_TrackingDataQueue.GetSize()
+    + this->m_TransformQueue.GetSize());
+}
+
+unsigned int mitk::IGTLMessageQueue::GetNumberOfDroppedMessages() const
+{
+  return m_NumberOfDroppedMessages;
 }
 
 void mitk::IGTLMessageQueue::EnableInfiniteBuffering(bool enable)
 {
-  this->m_Mutex->Lock();
   if (enable)
     this->m_BufferingType = IGTLMessageQueue::BufferingType::Infinit;
   else
     this->m_BufferingType = IGTLMessageQueue::BufferingType::NoBuffering;
-  this->m_Mutex->Unlock();
 }
 
 mitk::IGTLMessageQueue::IGTLMessageQueue()
+  : m_NumberOfDroppedMessages(0), m_BufferingType(IGTLMessageQueue::NoBuffering)
 {
-  this->m_Mutex = itk::FastMutexLock::New();
-  this->m_BufferingType = IGTLMessageQueue::Infinit;
 }
 
 mitk::IGTLMessageQueue::~IGTLMessageQueue()
 {
-  this->m_Mutex->Unlock();
 }
\ No newline at end of file
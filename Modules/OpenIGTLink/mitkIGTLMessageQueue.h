@@ -20,10 +20,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "MitkOpenIGTLinkExports.h"
 
 #include "itkObject.h"
-#include "itkFastMutexLock.h"
+#include "itkSimpleFastMutexLock.h"
 #include "mitkCommon.h"
+#include "mitkLockFreeRingBuffer.h"
 
-#include <deque>
+#include <atomic>
 
 //OpenIGTLink
 #include "igtlMessageBase.h"
@@ -37,6 +38,15 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * Each message type is stored in its own lock-free ring buffer (see mitk::LockFreeRingBuffer),
+  * so the receive thread of a mitk::IGTLDevice never waits for a thread that pulls messages
+  * and messages are passed on by pointer without copying their content. The received
+  * messages must be pushed by one thread only (the receive thread); pulling is thread safe.
+  *
+  * Depending on the buffering type, a pull returns the newest message, discarding older ones
+  * (latest-only, the default) or the oldest message (infinite buffering). Each buffer holds up to
+  * BUFFER_CAPACITY messages; when a buffer is full, its oldest message is dropped and counted.
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -48,11 +58,19 @@ namespace mitk {
 
       /**
        * \brief Different buffering types
-       * Infinit buffering means that you can push as many messages as you want
-       * NoBuffering means that the queue just stores a single message
+       * Infinit buffering means that all messages are kept until they are pulled (lossless)
+       * NoBuffering means that a pull returns the latest message and discards older ones (latest-only)
        */
     enum BufferingType { Infinit, NoBuffering };
 
+    /**
+    * \brief Number of messages each of the per-type buffers can hold.
+    */
+    static const unsigned int BUFFER_CAPACITY = 256;
+
+    /**
+    * \brief Adds the message to the send queue. Can be called from any thread.
+    */
     void PushSendMessage(igtl::MessageBase::Pointer message);
 
     /**
@@ -81,6 +99,11 @@ namespace mitk {
     */
     int GetSize();
 
+    /**
+    * \brief Returns the number of messages that were dropped because a buffer was full.
+    */
+    unsigned int GetNumberOfDroppedMessages() const;
+
     /**
     * \brief Returns a string with information about the oldest message in the
     * queue
@@ -105,7 +128,7 @@ namespace mitk {
 
     /**
     * \brief Sets infinite buffering on/off.
-    * Initiale value is enabled.
+    * Initial value is disabled, i.e. a pull returns the latest message.
     */
     void EnableInfiniteBuffering(bool enable);
 
@@ -113,31 +136,98 @@ namespace mitk {
     IGTLMessageQueue();
     virtual ~IGTLMessageQueue();
 
-  protected:
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Ring buffer for messages of one type. Pushing is lock-free as long as the
+    * buffer is not full, concurrent pulls are serialized by a mutex.
+    */
+    template <typename TMessage>
+    class MessageBuffer
+    {
+    public:
+      MessageBuffer() : m_Buffer(BUFFER_CAPACITY) {}
+
+      bool Push(const typename TMessage::Pointer &message) { return m_Buffer.TryPush(message); }
+
+      /**
+      * \brief Removes the oldest message to make space for a push. Only called by the pushing thread.
+      */
+      bool DropOldest()
+      {
+        typename TMessage::Pointer oldest;
+
+        m_PullMutex.Lock();
+        const bool dropped = m_Buffer.TryPop(oldest);
+        m_PullMutex.Unlock();
+
+        return dropped;
+      }
+
+      typename TMessage::Pointer Pull(bool latestOnly)
+      {
+        typename TMessage::Pointer message;
+        typename TMessage::Pointer next;
+
+        m_PullMutex.Lock();
+        while (m_Buffer.TryPop(next))
+        {
+          message = next;
+          if (!latestOnly)
+            break;
+        }
+        m_PullMutex.Unlock();
+
+        return message;
+      }
+
+      std::size_t GetSize() const { return m_Buffer.GetSize(); }
+
+    private:
+      LockFreeRingBuffer<typename TMessage::Pointer> m_Buffer;
+      itk::SimpleFastMutexLock m_PullMutex;
+    };
+
+    /**
+    * \brief Pushes the message to the given buffer. If the buffer is full, its oldest
+    * message is dropped and counted.
     */
-    itk::FastMutexLock::Pointer m_Mutex;
+    template <typename TMessage>
+    void PushToBuffer(MessageBuffer<TMessage> &buffer, TMessage *message);
+
+    bool IsLatestOnly() const;
+
+    igtl::MessageBase::Pointer GetLatestMessage();
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief the buffers that store pointer to the inserted messages
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    MessageBuffer< igtl::MessageBase > m_CommandQueue;
+    MessageBuffer< igtl::ImageMessage > m_Image2dQueue;
+    MessageBuffer< igtl::ImageMessage > m_Image3dQueue;
+    MessageBuffer< igtl::TransformMessage > m_TransformQueue;
+    MessageBuffer< igtl::TrackingDataMessage > m_TrackingDataQueue;
+    MessageBuffer< igtl::StringMessage > m_StringQueue;
+    MessageBuffer< igtl::MessageBase > m_MiscQueue;
 
-    std::deque< igtl::MessageBase::Pointer> m_SendQueue;
+    MessageBuffer< igtl::MessageBase > m_SendQueue;
+
+    /**
+    * \brief Serializes the threads that push messages to the send queue
+    */
+    itk::SimpleFastMutexLock m_SendMutex;
 
     igtl::MessageBase::Pointer m_Latest_Message;
 
+    /**
+    * \brief Protects m_Latest_Message, only held to copy the pointer
+    */
+    itk::SimpleFastMutexLock m_LatestMessageMutex;
+
+    std::atomic<unsigned int> m_NumberOfDroppedMessages;
+
     /**
     * \brief defines the kind of buffering
     */
-    BufferingType m_BufferingType;
+    std::atomic<BufferingType> m_BufferingType;
   };
 }
 
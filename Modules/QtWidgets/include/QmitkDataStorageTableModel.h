@@ -115,6 +115,11 @@ public:
   ///
   virtual void AddNode(const mitk::DataNode *node);
   ///
+  /// Adds the nodes to this model like AddNode(), with one row insertion for all of them.
+  /// Called by the DataStorage for each single added node and for each batch of added nodes.
+  ///
+  virtual void AddNodes(const mitk::DataStorage::SetOfObjects *nodes);
+  ///
   /// Removes a node from this model. Also removes any event listener from the node.
   ///
   virtual void RemoveNode(const mitk::DataNode *node);
@@ -187,6 +192,10 @@ protected:
   /// in again.
   ///
   virtual void Reset();
+  ///
+  /// Checks the constraints of AddNode() and adds the event listeners if the node is accepted.
+  ///
+  bool AcceptNode(const mitk::DataNode *node);
 
   //#Protected MEMBER VARIABLES
 protected:
@@ -116,6 +116,11 @@ public:
   ///
   virtual void AddNode(const mitk::DataNode *node);
   ///
+  /// Adds the nodes to this model like AddNode(), but adjusts the layer properties only once.
+  /// Called by the DataStorage for each single added node and for each batch of added nodes.
+  ///
+  virtual void AddNodes(const mitk::DataStorage::SetOfObjects *nodes);
+  ///
   /// Removes a node from this model. Also removes any event listener from the node.
   ///
   virtual void RemoveNode(const mitk::DataNode *node);
@@ -258,6 +263,7 @@ protected:
   bool m_AllowHierarchyChange;
 
 private:
+  /// Inserts the node and its missing parents, the caller adjusts the layer properties
   void AddNodeInternal(const mitk::DataNode *);
   void RemoveNodeInternal(const mitk::DataNode *);
   ///
@@ -203,9 +203,9 @@ void QmitkDataStorageTableModel::SetDataStorage(mitk::DataStorage::Pointer _Data
     // if a data storage was set before remove old event listeners
     if (m_DataStorage.IsNotNull())
     {
-      this->m_DataStorage->AddNodeEvent.RemoveListener(
-        mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataNode *>(
-          this, &QmitkDataStorageTableModel::AddNode));
+      this->m_DataStorage->AddNodesEvent.RemoveListener(
+        mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataStorage::SetOfObjects *>(
+          this, &QmitkDataStorageTableModel::AddNodes));
 
       this->m_DataStorage->RemoveNodeEvent.RemoveListener(
         mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataNode *>(
@@ -219,9 +219,9 @@ void QmitkDataStorageTableModel::SetDataStorage(mitk::DataStorage::Pointer _Data
     if (m_DataStorage.IsNotNull())
     {
       // subscribe for node added/removed events
-      this->m_DataStorage->AddNodeEvent.AddListener(
-        mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataNode *>(
-          this, &QmitkDataStorageTableModel::AddNode));
+      this->m_DataStorage->AddNodesEvent.AddListener(
+        mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataStorage::SetOfObjects *>(
+          this, &QmitkDataStorageTableModel::AddNodes));
 
       this->m_DataStorage->RemoveNodeEvent.AddListener(
         mitk::MessageDelegate1<QmitkDataStorageTableModel, const mitk::DataNode *>(
@@ -236,34 +236,8 @@ void QmitkDataStorageTableModel::SetDataStorage(mitk::DataStorage::Pointer _Data
 void QmitkDataStorageTableModel::AddNode(const mitk::DataNode *node)
 {
   // garantuee no recursions when a new node event is thrown
-  if (!m_BlockEvents)
+  if (!m_BlockEvents && this->AcceptNode(node))
   {
-    // if we have a predicate, check node against predicate first
-    if (m_Predicate.IsNotNull() && !m_Predicate->CheckNode(node))
-      return;
-
-    // dont add nodes without data (formerly known as helper objects)
-    if (node->GetData() == nullptr)
-      return;
-
-    // create listener commands to listen to changes in the name or the visibility of the node
-    itk::MemberCommand<QmitkDataStorageTableModel>::Pointer propertyModifiedCommand =
-      itk::MemberCommand<QmitkDataStorageTableModel>::New();
-    propertyModifiedCommand->SetCallbackFunction(this, &QmitkDataStorageTableModel::PropertyModified);
-
-    mitk::BaseProperty *tempProperty = nullptr;
-
-    // add listener for properties
-    tempProperty = node->GetProperty("visible");
-    if (tempProperty)
-      m_VisiblePropertyModifiedObserverTags[tempProperty] =
-        tempProperty->AddObserver(itk::ModifiedEvent(), propertyModifiedCommand);
-
-    tempProperty = node->GetProperty("name");
-    if (tempProperty)
-      m_NamePropertyModifiedObserverTags[tempProperty] =
-        tempProperty->AddObserver(itk::ModifiedEvent(), propertyModifiedCommand);
-
     // emit beginInsertRows event
     beginInsertRows(QModelIndex(), m_NodeSet.size(), m_NodeSet.size());
 
@@ -275,6 +249,63 @@ void QmitkDataStorageTableModel::AddNode(const mitk::DataNode *node)
   }
 }
 
+void QmitkDataStorageTableModel::AddNodes(const mitk::DataStorage::SetOfObjects *nodes)
+{
+  // garantuee no recursions when a new node event is thrown
+  if (m_BlockEvents || nodes == nullptr)
+    return;
+
+  std::vector<mitk::DataNode *> acceptedNodes;
+  for (mitk::DataStorage::SetOfObjects::ConstIterator it = nodes->Begin(); it != nodes->End(); ++it)
+  {
+    if (this->AcceptNode(it.Value()))
+      acceptedNodes.push_back(it.Value());
+  }
+
+  if (acceptedNodes.empty())
+    return;
+
+  // emit one beginInsertRows event for the whole batch
+  beginInsertRows(QModelIndex(), m_NodeSet.size(), m_NodeSet.size() + acceptedNodes.size() - 1);
+
+  // add nodes
+  m_NodeSet.insert(m_NodeSet.end(), acceptedNodes.begin(), acceptedNodes.end());
+
+  // emit endInsertRows event
+  endInsertRows();
+}
+
+bool QmitkDataStorageTableModel::AcceptNode(const mitk::DataNode *node)
+{
+  // if we have a predicate, check node against predicate first
+  if (m_Predicate.IsNotNull() && !m_Predicate->CheckNode(node))
+    return false;
+
+  // dont add nodes without data (formerly known as helper objects)
+  if (node->GetData() == nullptr)
+    return false;
+
+  // create listener commands to listen to changes in the name or the visibility of the node
+  itk::MemberCommand<QmitkDataStorageTableModel>::Pointer propertyModifiedCommand =
+    itk::MemberCommand<QmitkDataStorageTableModel>::New();
+  propertyModifiedCommand->SetCallbackFunction(this, &QmitkDataStorageTableModel::PropertyModified);
+
+  mitk::BaseProperty *tempProperty = nullptr;
+
+  // add listener for properties
+  tempProperty = node->GetProperty("visible");
+  if (tempProperty)
+    m_VisiblePropertyModifiedObserverTags[tempProperty] =
+      tempProperty->AddObserver(itk::ModifiedEvent(), propertyModifiedCommand);
+
+  tempProperty = node->GetProperty("name");
+  if (tempProperty)
+    m_NamePropertyModifiedObserverTags[tempProperty] =
+      tempProperty->AddObserver(itk::ModifiedEvent(), propertyModifiedCommand);
+
+  return true;
+}
+
 void QmitkDataStorageTableModel::RemoveNode(const mitk::DataNode *node)
 {
   // garantuee no recursions when a new node event is thrown
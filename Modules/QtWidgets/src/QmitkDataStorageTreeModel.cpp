@@ -546,9 +546,9 @@ void QmitkDataStorageTreeModel::SetDataStorage(mitk::DataStorage *_DataStorage)
         this, &QmitkDataStorageTreeModel::SetDataStorageDeleted));
 
       // remove listeners for the nodes
-      m_DataStorage->AddNodeEvent.RemoveListener(
-        mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataNode *>(this,
-                                                                                  &QmitkDataStorageTreeModel::AddNode));
+      m_DataStorage->AddNodesEvent.RemoveListener(
+        mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataStorage::SetOfObjects *>(
+          this, &QmitkDataStorageTreeModel::AddNodes));
 
       m_DataStorage->ChangedNodeEvent.RemoveListener(
         mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataNode *>(
@@ -578,8 +578,9 @@ void QmitkDataStorageTreeModel::SetDataStorage(mitk::DataStorage *_DataStorage)
         this, &QmitkDataStorageTreeModel::SetDataStorageDeleted));
 
       // add listeners for the nodes
-      m_DataStorage->AddNodeEvent.AddListener(mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataNode *>(
-        this, &QmitkDataStorageTreeModel::AddNode));
+      m_DataStorage->AddNodesEvent.AddListener(
+        mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataStorage::SetOfObjects *>(
+          this, &QmitkDataStorageTreeModel::AddNodes));
 
       m_DataStorage->ChangedNodeEvent.AddListener(
         mitk::MessageDelegate1<QmitkDataStorageTreeModel, const mitk::DataNode *>(
@@ -617,7 +618,7 @@ void QmitkDataStorageTreeModel::AddNodeInternal(const mitk::DataNode *node)
     parentTreeItem = m_Root->Find(parentDataNode); // find the corresponding tree item
     if (!parentTreeItem)
     {
-      this->AddNode(parentDataNode);
+      this->AddNodeInternal(parentDataNode);
       parentTreeItem = m_Root->Find(parentDataNode);
       if (!parentTreeItem)
         return;
@@ -642,8 +643,6 @@ void QmitkDataStorageTreeModel::AddNodeInternal(const mitk::DataNode *node)
 
   // emit endInsertRows event
   endInsertRows();
-
-  this->AdjustLayerProperty();
 }
 
 void QmitkDataStorageTreeModel::AddNode(const mitk::DataNode *node)
@@ -653,6 +652,19 @@ void QmitkDataStorageTreeModel::AddNode(const mitk::DataNode *node)
     return;
 
   this->AddNodeInternal(node);
+  this->AdjustLayerProperty();
+}
+
+void QmitkDataStorageTreeModel::AddNodes(const mitk::DataStorage::SetOfObjects *nodes)
+{
+  if (nodes == 0 || m_BlockDataStorageEvents || m_DataStorage.IsNull())
+    return;
+
+  for (mitk::DataStorage::SetOfObjects::ConstIterator it = nodes->Begin(); it != nodes->End(); ++it)
+    this->AddNodeInternal(it.Value());
+
+  // setting the layers of all nodes is the expensive part, do it once per batch
+  this->AdjustLayerProperty();
 }
 
 void QmitkDataStorageTreeModel::SetPlaceNewNodesOnTop(bool _PlaceNewNodesOnTop)
@@ -1001,6 +1013,8 @@ void QmitkDataStorageTreeModel::Update()
       // save node
       this->AddNodeInternal(*it);
     }
+
+    this->AdjustLayerProperty();
   }
 }
 
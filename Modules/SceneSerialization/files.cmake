@@ -6,6 +6,7 @@ set(CPP_FILES
   mitkPointSetSerializer.cpp
   mitkPropertyListDeserializer.cpp
   mitkPropertyListDeserializerV1.cpp
+  mitkSceneArchive.cpp
   mitkSceneIO.cpp
   mitkSceneReader.cpp
   mitkSceneReaderV1.cpp
@@ -0,0 +1,82 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkSceneArchive_h_included
+#define mitkSceneArchive_h_included
+
+#include <MitkSceneSerializationExports.h>
+
+#include <Poco/Zip/ZipLocalFileHeader.h>
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * \brief Read access to the entries of a scene file (.mitk zip archive).
+   *
+   * The archive directory is read once on construction. Entries are then read
+   * directly from the archive without extracting the whole scene to disk.
+   * Every read opens its own stream on the scene file, so different entries
+   * can be read concurrently from multiple threads.
+   */
+  class MITKSCENESERIALIZATION_EXPORT SceneArchive
+  {
+  public:
+    explicit SceneArchive(const std::string &filename);
+
+    /** \brief True if the archive directory could be read. */
+    bool IsValid() const;
+
+    /** \brief Names of all file entries of the archive. */
+    std::vector<std::string> GetEntryNames() const;
+
+    bool HasEntry(const std::string &name) const;
+
+    /**
+     * \brief Decompresses the entry \a name into \a stream.
+     * \return false if the entry does not exist or could not be decompressed.
+     */
+    bool ReadEntry(const std::string &name, std::ostream &stream) const;
+
+    /**
+     * \brief Opens the entry \a name for reading, the data is decompressed while it is read.
+     *
+     * The returned stream cannot seek.
+     * \return nullptr if the entry does not exist or could not be opened.
+     */
+    std::unique_ptr<std::istream> OpenEntry(const std::string &name) const;
+
+    /**
+     * \brief Decompresses the entry \a name into the file \a targetFilename.
+     * \return false if the entry does not exist or could not be written.
+     */
+    bool ExtractEntry(const std::string &name, const std::string &targetFilename) const;
+
+  private:
+    typedef std::map<std::string, Poco::Zip::ZipLocalFileHeader> HeaderMapType;
+
+    std::string m_Filename;
+    HeaderMapType m_Headers;
+    bool m_Valid;
+  };
+}
+
+#endif
@@ -24,6 +24,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <Poco/Zip/ZipLocalFileHeader.h>
 
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+
 class TiXmlElement;
 
 namespace mitk
@@ -74,6 +77,32 @@ namespace mitk
                            const DataStorage *storage,
                            const std::string &filename);
 
+    /**
+     * \brief Save a scene of objects to file in a background thread
+     * \return True if the save was started, false if the arguments are invalid.
+     *
+     * Writes the property lists of the given nodes and copies their BaseData objects before returning.
+     * The copies are written to the scene file in a background thread, so the nodes may be modified
+     * while the scene is written. Call WaitForSave() to get the result; GetFailedNodes() and
+     * GetFailedProperties() are valid after WaitForSave() returned.
+     *
+     * A save or load started while a background save is running waits for it to finish.
+     */
+    virtual bool SaveSceneAsync(DataStorage::SetOfObjects::ConstPointer sceneNodes,
+                                const DataStorage *storage,
+                                const std::string &filename);
+
+    /**
+     * \brief True while a scene started by SaveSceneAsync() is being written.
+     */
+    bool IsSaving();
+
+    /**
+     * \brief Blocks until a scene started by SaveSceneAsync() is written.
+     * \return The result of the last background save (see SaveScene()).
+     */
+    bool WaitForSave();
+
     /**
      * \brief Get a list of nodes (BaseData containers) that failed to be read/written.
      *
@@ -101,7 +130,27 @@ namespace mitk
 
     std::string CreateEmptyTempDirectory();
 
-    TiXmlElement *SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error);
+    struct SaveJob;
+
+    bool PrepareSave(DataStorage::SetOfObjects::ConstPointer sceneNodes,
+                     const DataStorage *storage,
+                     const std::string &filename,
+                     bool snapshotData,
+                     SaveJob &job);
+    bool WriteScene(SaveJob &job);
+
+    static ITK_THREAD_RETURN_TYPE SaveDataThread(void *arg);
+    static ITK_THREAD_RETURN_TYPE SaveSceneThread(void *arg);
+
+    /**
+     * \brief Writes \a data to the working directory and returns the name of the written file.
+     *
+     * Does not modify the SceneIO object and may be called concurrently for different data objects.
+     * \a error is set if no serializer could write the data,
+     * \a serialized is set if a serializer ran without exception.
+     */
+    std::string SerializeBaseData(BaseData *data, const std::string &filenamehint, bool &error, bool &serialized) const;
+
     TiXmlElement *SavePropertyList(PropertyList *propertyList, const std::string &filenamehint);
 
     void OnUnzipError(const void *pSender, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string> &info);
@@ -112,6 +161,13 @@ namespace mitk
 
     std::string m_WorkingDirectory;
     unsigned int m_UnzipErrors;
+
+    itk::MultiThreader::Pointer m_SaveThreader;
+    int m_SaveThreadID;
+    SaveJob *m_SaveJob;
+    bool m_SaveResult;
+    bool m_Saving;
+    itk::SimpleFastMutexLock m_SaveMutex;
   };
 }
 
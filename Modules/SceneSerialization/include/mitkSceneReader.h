@@ -24,6 +24,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 namespace mitk
 {
+  class SceneArchive;
+
   class MITKSCENESERIALIZATION_EXPORT SceneReader : public itk::Object
   {
   public:
@@ -31,5 +33,17 @@ namespace mitk
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
       virtual bool LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage);
+
+    /**
+      \brief Loads the scene described by \a document.
+
+      If \a archive is given, data files referenced by the document are read
+      directly from the scene archive instead of from \a workingDirectory.
+      Files that are not part of the archive are still expected in \a workingDirectory.
+    */
+    virtual bool LoadScene(TiXmlDocument &document,
+                           const std::string &workingDirectory,
+                           DataStorage *storage,
+                           const SceneArchive *archive);
   };
 }
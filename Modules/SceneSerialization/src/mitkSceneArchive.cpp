@@ -0,0 +1,168 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSceneArchive.h"
+
+#include <mitkLogMacros.h>
+
+#include <Poco/StreamCopier.h>
+#include <Poco/Zip/ZipArchive.h>
+#include <Poco/Zip/ZipStream.h>
+
+#include <fstream>
+
+namespace
+{
+  // owns the file stream the zip stream reads from
+  class EntryInputStream : public std::istream
+  {
+  public:
+    EntryInputStream(const std::string &filename, const Poco::Zip::ZipLocalFileHeader &header)
+      : std::istream(nullptr), m_File(filename.c_str(), std::ios::binary), m_ZipStream(m_File, header, true)
+    {
+      this->rdbuf(m_ZipStream.rdbuf());
+      if (!m_File.good())
+      {
+        this->setstate(std::ios::failbit);
+      }
+    }
+
+  private:
+    std::ifstream m_File;
+    Poco::Zip::ZipInputStream m_ZipStream;
+  };
+}
+
+mitk::SceneArchive::SceneArchive(const std::string &filename) : m_Filename(filename), m_Valid(false)
+{
+  std::ifstream file(filename.c_str(), std::ios::binary);
+  if (!file.good())
+  {
+    return;
+  }
+
+  try
+  {
+    Poco::Zip::ZipArchive archive(file);
+    for (auto iter = archive.headerBegin(); iter != archive.headerEnd(); ++iter)
+    {
+      if (iter->second.isFile())
+      {
+        m_Headers.insert(std::make_pair(iter->first, iter->second));
+      }
+    }
+    m_Valid = true;
+  }
+  catch (const Poco::Exception &e)
+  {
+    MITK_ERROR << "Could not read the directory of scene file " << filename << ": " << e.displayText();
+  }
+  catch (const std::exception &e)
+  {
+    MITK_ERROR << "Could not read the directory of scene file " << filename << ": " << e.what();
+  }
+}
+
+bool mitk::SceneArchive::IsValid() const
+{
+  return m_Valid;
+}
+
+std::vector<std::string> mitk::SceneArchive::GetEntryNames() const
+{
+  std::vector<std::string> names;
+  names.reserve(m_Headers.size());
+  for (auto iter = m_Headers.begin(); iter != m_Headers.end(); ++iter)
+  {
+    names.push_back(iter->first);
+  }
+  return names;
+}
+
+bool mitk::SceneArchive::HasEntry(const std::string &name) const
+{
+  return m_Headers.find(name) != m_Headers.end();
+}
+
+bool mitk::SceneArchive::ReadEntry(const std::string &name, std::ostream &stream) const
+{
+  auto header = m_Headers.find(name);
+  if (header == m_Headers.end())
+  {
+    return false;
+  }
+
+  // a separate stream per call allows concurrent reads of different entries
+  std::ifstream file(m_Filename.c_str(), std::ios::binary);
+  if (!file.good())
+  {
+    return false;
+  }
+
+  try
+  {
+    Poco::Zip::ZipInputStream zipStream(file, header->second, true);
+    Poco::StreamCopier::copyStream(zipStream, stream);
+  }
+  catch (const Poco::Exception &)
+  {
+    return false;
+  }
+  catch (const std::exception &)
+  {
+    return false;
+  }
+
+  return stream.good();
+}
+
+bool mitk::SceneArchive::ExtractEntry(const std::string &name, const std::string &targetFilename) const
+{
+  std::ofstream target(targetFilename.c_str(), std::ios::binary);
+  if (!target.good())
+  {
+    return false;
+  }
+
+  return this->ReadEntry(name, target);
+}
+
+std::unique_ptr<std::istream> mitk::SceneArchive::OpenEntry(const std::string &name) const
+{
+  auto header = m_Headers.find(name);
+  if (header == m_Headers.end())
+  {
+    return nullptr;
+  }
+
+  try
+  {
+    std::unique_ptr<std::istream> stream(new EntryInputStream(m_Filename, header->second));
+    if (!stream->good())
+    {
+      return nullptr;
+    }
+    return stream;
+  }
+  catch (const Poco::Exception &)
+  {
+    return nullptr;
+  }
+  catch (const std::exception &)
+  {
+    return nullptr;
+  }
+}
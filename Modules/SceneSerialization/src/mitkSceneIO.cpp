@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBaseDataSerializer.h"
 #include "mitkPropertyListSerializer.h"
+#include "mitkSceneArchive.h"
 #include "mitkSceneIO.h"
 #include "mitkSceneReader.h"
 
@@ -36,18 +37,27 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <tinyxml.h>
 
+#include <algorithm>
 #include <fstream>
 #include <mitkIOUtil.h>
+#include <set>
 #include <sstream>
 
 #include "itksys/SystemTools.hxx"
 
-mitk::SceneIO::SceneIO() : m_WorkingDirectory(""), m_UnzipErrors(0)
+mitk::SceneIO::SceneIO()
+  : m_WorkingDirectory(""),
+    m_UnzipErrors(0),
+    m_SaveThreadID(-1),
+    m_SaveJob(nullptr),
+    m_SaveResult(true),
+    m_Saving(false)
 {
 }
 
 mitk::SceneIO::~SceneIO()
 {
+  this->WaitForSave();
 }
 
 std::string mitk::SceneIO::CreateEmptyTempDirectory()
@@ -89,6 +99,8 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
                                                     DataStorage *pStorage,
                                                     bool clearStorageFirst)
 {
+  this->WaitForSave();
+
   mitk::LocaleSwitch localeSwitch("C");
 
   // prepare data storage
@@ -133,37 +145,86 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
     return storage;
   }
 
-  // unzip all filenames contents to temp dir
+  // read the archive directory; the data files are later streamed
+  // directly from the archive instead of being unzipped to disk
   m_UnzipErrors = 0;
-  Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
-  unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
-  unzipper.decompressAllFiles();
-  unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
-    this, &SceneIO::OnUnzipError);
-  unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
-    this, &SceneIO::OnUnzipOk);
+  SceneArchive archive(filename);
+  TiXmlDocument document;
 
-  if (m_UnzipErrors)
+  if (archive.IsValid())
   {
-    MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename
-               << "'. Will attempt to read whatever could be unzipped.";
+    // parse index.xml with TinyXML
+    std::stringstream indexStream;
+    if (!archive.ReadEntry("index.xml", indexStream))
+    {
+      MITK_ERROR << "Could not read index.xml from '" << filename << "'";
+      return storage;
+    }
+
+    document.Parse(indexStream.str().c_str(), nullptr, TIXML_ENCODING_UTF8);
+    if (document.Error())
+    {
+      MITK_ERROR << "Could not parse index.xml of '" << filename << "'\nTinyXML reports: " << document.ErrorDesc()
+                 << std::endl;
+      return storage;
+    }
+
+    // only the (small) property lists are unzipped to the temp dir
+    std::set<std::string> dataFiles;
+    for (TiXmlElement *element = document.FirstChildElement("node"); element != NULL;
+         element = element->NextSiblingElement("node"))
+    {
+      TiXmlElement *dataElement = element->FirstChildElement("data");
+      if (dataElement && dataElement->Attribute("file"))
+      {
+        dataFiles.insert(dataElement->Attribute("file"));
+      }
+    }
+
+    std::vector<std::string> entries = archive.GetEntryNames();
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+    {
+      if (*entry != "index.xml" && dataFiles.find(*entry) == dataFiles.end() &&
+          !archive.ExtractEntry(*entry, m_WorkingDirectory + mitk::IOUtil::GetDirectorySeparator() + *entry))
+      {
+        MITK_ERROR << "Error while unzipping: " << *entry;
+        ++m_UnzipErrors;
+      }
+    }
+  }
+  else
+  {
+    // the archive directory could not be read, try to unzip whatever is possible to temp dir
+    Poco::Zip::Decompress unzipper(file, Poco::Path(m_WorkingDirectory));
+    unzipper.EError += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk += Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+    unzipper.decompressAllFiles();
+    unzipper.EError -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const std::string>>(
+      this, &SceneIO::OnUnzipError);
+    unzipper.EOk -= Poco::Delegate<SceneIO, std::pair<const Poco::Zip::ZipLocalFileHeader, const Poco::Path>>(
+      this, &SceneIO::OnUnzipOk);
+
+    // test if index.xml exists
+    // parse index.xml with TinyXML
+    const std::string indexFilename = m_WorkingDirectory + mitk::IOUtil::GetDirectorySeparator() + "index.xml";
+    if (!document.LoadFile(indexFilename.c_str()))
+    {
+      MITK_ERROR << "Could not open/read/parse " << m_WorkingDirectory << mitk::IOUtil::GetDirectorySeparator()
+                 << "index.xml\nTinyXML reports: " << document.ErrorDesc() << std::endl;
+      return storage;
+    }
   }
 
-  // test if index.xml exists
-  // parse index.xml with TinyXML
-  TiXmlDocument document(m_WorkingDirectory + mitk::IOUtil::GetDirectorySeparator() + "index.xml");
-  if (!document.LoadFile())
+  if (m_UnzipErrors)
   {
-    MITK_ERROR << "Could not open/read/parse " << m_WorkingDirectory << mitk::IOUtil::GetDirectorySeparator()
-               << "index.xml\nTinyXML reports: " << document.ErrorDesc() << std::endl;
-    return storage;
+    MITK_ERROR << "There were " << m_UnzipErrors << " errors unzipping '" << filename
+               << "'. Will attempt to read whatever could be unzipped.";
   }
 
   SceneReader::Pointer reader = SceneReader::New();
-  if (!reader->LoadScene(document, m_WorkingDirectory, storage))
+  if (!reader->LoadScene(document, m_WorkingDirectory, storage, archive.IsValid() ? &archive : nullptr))
   {
     MITK_ERROR << "There were errors while loading scene file " << filename << ". Your data may be corrupted";
   }
@@ -183,9 +244,159 @@ mitk::DataStorage::Pointer mitk::SceneIO::LoadScene(const std::string &filename,
   return storage;
 }
 
+namespace
+{
+  // files of these types are already compressed by their writers and stored in the scene file as they are
+  std::set<std::string> GetStoredExtensions()
+  {
+    std::set<std::string> extensions;
+    extensions.insert("gz");
+    extensions.insert("nrrd");
+    extensions.insert("vtp");
+    extensions.insert("zip");
+    return extensions;
+  }
+}
+
+struct mitk::SceneIO::SaveJob
+{
+  struct DataEntry
+  {
+    DataNode::Pointer Node;
+    BaseData::Pointer Data;
+    std::string FilenameHint;
+    TiXmlElement *Element;
+    std::string File;
+    bool Error;
+    bool Serialized;
+  };
+
+  SceneIO *Self;
+  std::string Filename;
+  std::string WorkingDirectory;
+  TiXmlDocument Document;
+  std::vector<DataEntry> DataEntries;
+  std::size_t NextEntry;
+  itk::SimpleFastMutexLock Mutex;
+};
+
 bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes,
                               const DataStorage *storage,
                               const std::string &filename)
+{
+  this->WaitForSave();
+
+  mitk::LocaleSwitch localeSwitch("C");
+
+  SaveJob job;
+  if (!this->PrepareSave(sceneNodes, storage, filename, false, job))
+  {
+    return false;
+  }
+
+  return this->WriteScene(job);
+}
+
+bool mitk::SceneIO::SaveSceneAsync(DataStorage::SetOfObjects::ConstPointer sceneNodes,
+                                   const DataStorage *storage,
+                                   const std::string &filename)
+{
+  this->WaitForSave();
+
+  mitk::LocaleSwitch localeSwitch("C");
+
+  m_SaveJob = new SaveJob;
+  if (!this->PrepareSave(sceneNodes, storage, filename, true, *m_SaveJob))
+  {
+    delete m_SaveJob;
+    m_SaveJob = nullptr;
+    return false;
+  }
+
+  m_SaveMutex.Lock();
+  m_Saving = true;
+  m_SaveMutex.Unlock();
+
+  if (m_SaveThreader.IsNull())
+  {
+    m_SaveThreader = itk::MultiThreader::New();
+  }
+  m_SaveThreadID = m_SaveThreader->SpawnThread(SaveSceneThread, this);
+
+  return true;
+}
+
+bool mitk::SceneIO::IsSaving()
+{
+  m_SaveMutex.Lock();
+  bool saving = m_Saving;
+  m_SaveMutex.Unlock();
+  return saving;
+}
+
+bool mitk::SceneIO::WaitForSave()
+{
+  if (m_SaveThreadID != -1)
+  {
+    m_SaveThreader->TerminateThread(m_SaveThreadID); // joins the thread
+    m_SaveThreadID = -1;
+
+    delete m_SaveJob;
+    m_SaveJob = nullptr;
+  }
+
+  return m_SaveResult;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::SceneIO::SaveSceneThread(void *arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+  SceneIO *sceneIO = static_cast<SceneIO *>(infoStruct->UserData);
+
+  // the writers rely on the "C" locale as well, see SaveScene()
+  mitk::LocaleSwitch localeSwitch("C");
+  bool result = sceneIO->WriteScene(*sceneIO->m_SaveJob);
+
+  sceneIO->m_SaveMutex.Lock();
+  sceneIO->m_SaveResult = result;
+  sceneIO->m_Saving = false;
+  sceneIO->m_SaveMutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::SceneIO::SaveDataThread(void *arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+  SaveJob *job = static_cast<SaveJob *>(infoStruct->UserData);
+
+  while (true)
+  {
+    job->Mutex.Lock();
+    std::size_t entryIndex = job->NextEntry++;
+    job->Mutex.Unlock();
+
+    if (entryIndex >= job->DataEntries.size())
+    {
+      break;
+    }
+
+    SaveJob::DataEntry &entry = job->DataEntries[entryIndex];
+    entry.File = job->Self->SerializeBaseData(entry.Data, entry.FilenameHint, entry.Error, entry.Serialized);
+
+    ProgressBar::GetInstance()->Progress();
+  }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool mitk::SceneIO::PrepareSave(DataStorage::SetOfObjects::ConstPointer sceneNodes,
+                                const DataStorage *storage,
+                                const std::string &filename,
+                                bool snapshotData,
+                                SaveJob &job)
 {
   if (!sceneNodes)
   {
@@ -205,15 +416,17 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
     return false;
   }
 
-  mitk::LocaleSwitch localeSwitch("C");
-
   try
   {
     m_FailedNodes = DataStorage::SetOfObjects::New();
     m_FailedProperties = PropertyList::New();
 
+    job.Self = this;
+    job.Filename = filename;
+    job.NextEntry = 0;
+
     // start XML DOM
-    TiXmlDocument document;
+    TiXmlDocument &document = job.Document;
     TiXmlDeclaration *decl = new TiXmlDeclaration(
       "1.0",
       "UTF-8",
@@ -226,164 +439,210 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
     version->SetAttribute("FileVersion", 1);
     document.LinkEndChild(version);
 
-    // DataStorage::SetOfObjects::ConstPointer sceneNodes = storage->GetSubset( predicate );
-
-    if (sceneNodes.IsNull())
+    if (sceneNodes->size() == 0)
     {
       MITK_WARN << "Saving empty scene to " << filename;
     }
-    else
-    {
-      if (sceneNodes->size() == 0)
-      {
-        MITK_WARN << "Saving empty scene to " << filename;
-      }
-
-      MITK_INFO << "Storing scene with " << sceneNodes->size() << " objects to " << filename;
 
-      m_WorkingDirectory = CreateEmptyTempDirectory();
-      if (m_WorkingDirectory.empty())
-      {
-        MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
-        return false;
-      }
+    MITK_INFO << "Storing scene with " << sceneNodes->size() << " objects to " << filename;
 
-      ProgressBar::GetInstance()->AddStepsToDo(sceneNodes->size());
+    m_WorkingDirectory = CreateEmptyTempDirectory();
+    if (m_WorkingDirectory.empty())
+    {
+      MITK_ERROR << "Could not create temporary directory. Cannot create scene files.";
+      return false;
+    }
+    job.WorkingDirectory = m_WorkingDirectory;
 
-      // find out about dependencies
-      typedef std::map<DataNode *, std::string> UIDMapType;
-      typedef std::map<DataNode *, std::list<std::string>> SourcesMapType;
+    // find out about dependencies
+    typedef std::map<DataNode *, std::string> UIDMapType;
+    typedef std::map<DataNode *, std::list<std::string>> SourcesMapType;
 
-      UIDMapType nodeUIDs;       // for dependencies: ID of each node
-      SourcesMapType sourceUIDs; // for dependencies: IDs of a node's parent nodes
+    UIDMapType nodeUIDs;       // for dependencies: ID of each node
+    SourcesMapType sourceUIDs; // for dependencies: IDs of a node's parent nodes
 
-      UIDGenerator nodeUIDGen("OBJECT_");
+    UIDGenerator nodeUIDGen("OBJECT_");
 
-      for (DataStorage::SetOfObjects::const_iterator iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+    for (DataStorage::SetOfObjects::const_iterator iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+    {
+      DataNode *node = iter->GetPointer();
+      if (!node)
+        continue; // unlikely event that we get a NULL pointer as an object for saving. just ignore
+
+      // generate UIDs for all source objects
+      DataStorage::SetOfObjects::ConstPointer sourceObjects = storage->GetSources(node);
+      for (mitk::DataStorage::SetOfObjects::const_iterator sourceIter = sourceObjects->begin();
+           sourceIter != sourceObjects->end();
+           ++sourceIter)
       {
-        DataNode *node = iter->GetPointer();
-        if (!node)
-          continue; // unlikely event that we get a NULL pointer as an object for saving. just ignore
-
-        // generate UIDs for all source objects
-        DataStorage::SetOfObjects::ConstPointer sourceObjects = storage->GetSources(node);
-        for (mitk::DataStorage::SetOfObjects::const_iterator sourceIter = sourceObjects->begin();
-             sourceIter != sourceObjects->end();
-             ++sourceIter)
-        {
-          if (std::find(sceneNodes->begin(), sceneNodes->end(), *sourceIter) == sceneNodes->end())
-            continue; // source is not saved, so don't generate a UID for this source
-
-          // create a uid for the parent object
-          if (nodeUIDs[*sourceIter].empty())
-          {
-            nodeUIDs[*sourceIter] = nodeUIDGen.GetUID();
-          }
-
-          // store this dependency for writing
-          sourceUIDs[node].push_back(nodeUIDs[*sourceIter]);
-        }
+        if (std::find(sceneNodes->begin(), sceneNodes->end(), *sourceIter) == sceneNodes->end())
+          continue; // source is not saved, so don't generate a UID for this source
 
-        if (nodeUIDs[node].empty())
+        // create a uid for the parent object
+        if (nodeUIDs[*sourceIter].empty())
         {
-          nodeUIDs[node] = nodeUIDGen.GetUID();
+          nodeUIDs[*sourceIter] = nodeUIDGen.GetUID();
         }
+
+        // store this dependency for writing
+        sourceUIDs[node].push_back(nodeUIDs[*sourceIter]);
       }
 
-      // write out objects, dependencies and properties
-      for (DataStorage::SetOfObjects::const_iterator iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+      if (nodeUIDs[node].empty())
       {
-        DataNode *node = iter->GetPointer();
+        nodeUIDs[node] = nodeUIDGen.GetUID();
+      }
+    }
+
+    // write out dependencies and properties, collect the objects
+    // the (expensive) BaseData objects are written by WriteScene()
+    for (DataStorage::SetOfObjects::const_iterator iter = sceneNodes->begin(); iter != sceneNodes->end(); ++iter)
+    {
+      DataNode *node = iter->GetPointer();
 
-        if (node)
+      if (node)
+      {
+        TiXmlElement *nodeElement = new TiXmlElement("node");
+        std::string filenameHint(node->GetName());
+        filenameHint = itksys::SystemTools::MakeCindentifier(
+          filenameHint.c_str()); // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
+
+        // store dependencies
+        UIDMapType::iterator searchUIDIter = nodeUIDs.find(node);
+        if (searchUIDIter != nodeUIDs.end())
         {
-          TiXmlElement *nodeElement = new TiXmlElement("node");
-          std::string filenameHint(node->GetName());
-          filenameHint = itksys::SystemTools::MakeCindentifier(
-            filenameHint.c_str()); // escape filename <-- only allow [A-Za-z0-9_], replace everything else with _
-
-          // store dependencies
-          UIDMapType::iterator searchUIDIter = nodeUIDs.find(node);
-          if (searchUIDIter != nodeUIDs.end())
-          {
-            // store this node's ID
-            nodeElement->SetAttribute("UID", searchUIDIter->second.c_str());
-          }
+          // store this node's ID
+          nodeElement->SetAttribute("UID", searchUIDIter->second.c_str());
+        }
 
-          SourcesMapType::iterator searchSourcesIter = sourceUIDs.find(node);
-          if (searchSourcesIter != sourceUIDs.end())
+        SourcesMapType::iterator searchSourcesIter = sourceUIDs.find(node);
+        if (searchSourcesIter != sourceUIDs.end())
+        {
+          // store all source IDs
+          for (std::list<std::string>::iterator sourceUIDIter = searchSourcesIter->second.begin();
+               sourceUIDIter != searchSourcesIter->second.end();
+               ++sourceUIDIter)
           {
-            // store all source IDs
-            for (std::list<std::string>::iterator sourceUIDIter = searchSourcesIter->second.begin();
-                 sourceUIDIter != searchSourcesIter->second.end();
-                 ++sourceUIDIter)
-            {
-              TiXmlElement *uidElement = new TiXmlElement("source");
-              uidElement->SetAttribute("UID", sourceUIDIter->c_str());
-              nodeElement->LinkEndChild(uidElement);
-            }
+            TiXmlElement *uidElement = new TiXmlElement("source");
+            uidElement->SetAttribute("UID", sourceUIDIter->c_str());
+            nodeElement->LinkEndChild(uidElement);
           }
+        }
 
-          // store basedata
-          if (BaseData *data = node->GetData())
+        // store basedata
+        if (BaseData *data = node->GetData())
+        {
+          TiXmlElement *dataElement = new TiXmlElement("data");
+          dataElement->SetAttribute("type", data->GetNameOfClass());
+
+          SaveJob::DataEntry entry;
+          entry.Node = node;
+          entry.Data = data;
+          entry.FilenameHint = filenameHint;
+          entry.Element = dataElement;
+          entry.Error = false;
+          entry.Serialized = false;
+
+          if (snapshotData)
           {
-            // std::string filenameHint( node->GetName() );
-            bool error(false);
-            TiXmlElement *dataElement(SaveBaseData(data, filenameHint, error)); // returns a reference to a file
-            if (error)
-            {
-              m_FailedNodes->push_back(node);
-            }
-
-            // store basedata properties
-            PropertyList *propertyList = data->GetPropertyList();
-            if (propertyList && !propertyList->IsEmpty())
+            // the copy is written in the background, so the original may be modified meanwhile
+            entry.Data = dynamic_cast<BaseData *>(data->Clone().GetPointer());
+            if (entry.Data.IsNull())
             {
-              TiXmlElement *baseDataPropertiesElement(
-                SavePropertyList(propertyList, filenameHint + "-data")); // returns a reference to a file
-              dataElement->LinkEndChild(baseDataPropertiesElement);
+              MITK_WARN << "Could not copy " << data->GetNameOfClass() << " of node " << node->GetName()
+                        << ". It is saved without a snapshot and must not be modified until saving finished.";
+              entry.Data = data;
             }
-
-            nodeElement->LinkEndChild(dataElement);
           }
 
-          // store all renderwindow specific propertylists
-          mitk::DataNode::PropertyListKeyNames propertyListKeys = node->GetPropertyListNames();
-          for (auto renderWindowName : propertyListKeys)
+          job.DataEntries.push_back(entry);
+
+          // store basedata properties
+          PropertyList *propertyList = data->GetPropertyList();
+          if (propertyList && !propertyList->IsEmpty())
           {
-            PropertyList *propertyList = node->GetPropertyList(renderWindowName);
-            if (propertyList && !propertyList->IsEmpty())
-            {
-              TiXmlElement *renderWindowPropertiesElement(
-                SavePropertyList(propertyList, filenameHint + "-" + renderWindowName)); // returns a reference to a file
-              renderWindowPropertiesElement->SetAttribute("renderwindow", renderWindowName);
-              nodeElement->LinkEndChild(renderWindowPropertiesElement);
-            }
+            TiXmlElement *baseDataPropertiesElement(
+              SavePropertyList(propertyList, filenameHint + "-data")); // returns a reference to a file
+            dataElement->LinkEndChild(baseDataPropertiesElement);
           }
 
-          // don't forget the renderwindow independent list
-          PropertyList *propertyList = node->GetPropertyList();
+          nodeElement->LinkEndChild(dataElement);
+        }
+
+        // store all renderwindow specific propertylists
+        mitk::DataNode::PropertyListKeyNames propertyListKeys = node->GetPropertyListNames();
+        for (auto renderWindowName : propertyListKeys)
+        {
+          PropertyList *propertyList = node->GetPropertyList(renderWindowName);
           if (propertyList && !propertyList->IsEmpty())
           {
-            TiXmlElement *propertiesElement(
-              SavePropertyList(propertyList, filenameHint + "-node")); // returns a reference to a file
-            nodeElement->LinkEndChild(propertiesElement);
+            TiXmlElement *renderWindowPropertiesElement(
+              SavePropertyList(propertyList, filenameHint + "-" + renderWindowName)); // returns a reference to a file
+            renderWindowPropertiesElement->SetAttribute("renderwindow", renderWindowName);
+            nodeElement->LinkEndChild(renderWindowPropertiesElement);
           }
-          document.LinkEndChild(nodeElement);
         }
-        else
+
+        // don't forget the renderwindow independent list
+        PropertyList *propertyList = node->GetPropertyList();
+        if (propertyList && !propertyList->IsEmpty())
         {
-          MITK_WARN << "Ignoring NULL node during scene serialization.";
+          TiXmlElement *propertiesElement(
+            SavePropertyList(propertyList, filenameHint + "-node")); // returns a reference to a file
+          nodeElement->LinkEndChild(propertiesElement);
         }
+        document.LinkEndChild(nodeElement);
+      }
+      else
+      {
+        MITK_WARN << "Ignoring NULL node during scene serialization.";
+      }
+    } // end for all nodes
 
-        ProgressBar::GetInstance()->Progress();
-      } // end for all nodes
-    }   // end if sceneNodes
+    ProgressBar::GetInstance()->AddStepsToDo(job.DataEntries.size());
+  }
+  catch (std::exception &e)
+  {
+    MITK_ERROR << "Caught exception during saving temporary files to disk. Error description: '" << e.what() << "'";
+    return false;
+  }
+
+  return true;
+}
+
+bool mitk::SceneIO::WriteScene(SaveJob &job)
+{
+  const std::string &filename = job.Filename;
+  const std::string &workingDirectory = job.WorkingDirectory;
+
+  try
+  {
+    // the BaseData objects are independent of each other and written concurrently
+    if (!job.DataEntries.empty())
+    {
+      itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+      threader->SetNumberOfThreads(
+        std::min(threader->GetNumberOfThreads(), static_cast<itk::ThreadIdType>(job.DataEntries.size())));
+      threader->SetSingleMethod(SaveDataThread, &job);
+      threader->SingleMethodExecute();
+    }
+
+    for (auto entry = job.DataEntries.begin(); entry != job.DataEntries.end(); ++entry)
+    {
+      if (entry->Serialized)
+      {
+        entry->Element->SetAttribute("file", entry->File);
+      }
+      if (entry->Error)
+      {
+        m_FailedNodes->push_back(entry->Node);
+      }
+    }
 
-    if (!document.SaveFile(m_WorkingDirectory + Poco::Path::separator() + "index.xml"))
+    if (!job.Document.SaveFile(workingDirectory + Poco::Path::separator() + "index.xml"))
     {
-      MITK_ERROR << "Could not write scene to " << m_WorkingDirectory << Poco::Path::separator() << "index.xml"
-                 << "\nTinyXML reports '" << document.ErrorDesc() << "'";
+      MITK_ERROR << "Could not write scene to " << workingDirectory << Poco::Path::separator() << "index.xml"
+                 << "\nTinyXML reports '" << job.Document.ErrorDesc() << "'";
       return false;
     }
     else
@@ -406,24 +665,25 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
         else
         {
           Poco::Zip::Compress zipper(file, true);
-          Poco::Path tmpdir(m_WorkingDirectory);
+          zipper.setStoreExtensions(GetStoredExtensions());
+          Poco::Path tmpdir(workingDirectory);
           zipper.addRecursive(tmpdir);
           zipper.close();
         }
         try
         {
-          Poco::File deleteDir(m_WorkingDirectory);
+          Poco::File deleteDir(workingDirectory);
           deleteDir.remove(true); // recursive
         }
         catch (...)
         {
-          MITK_ERROR << "Could not delete temporary directory " << m_WorkingDirectory;
+          MITK_ERROR << "Could not delete temporary directory " << workingDirectory;
           return false; // ok?
         }
       }
       catch (std::exception &e)
       {
-        MITK_ERROR << "Could not create ZIP file from " << m_WorkingDirectory << "\nReason: " << e.what();
+        MITK_ERROR << "Could not create ZIP file from " << workingDirectory << "\nReason: " << e.what();
         return false;
       }
       return true;
@@ -436,18 +696,20 @@ bool mitk::SceneIO::SaveScene(DataStorage::SetOfObjects::ConstPointer sceneNodes
   }
 }
 
-TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &filenamehint, bool &error)
+std::string mitk::SceneIO::SerializeBaseData(BaseData *data,
+                                             const std::string &filenamehint,
+                                             bool &error,
+                                             bool &serialized) const
 {
   assert(data);
   error = true;
+  serialized = false;
 
   // find correct serializer
   // the serializer must
   //  - create a file containing all information to recreate the BaseData object --> needs to know where to put this
   //  file (and a filename?)
   //  - TODO what to do about writers that creates one file per timestep?
-  TiXmlElement *element = new TiXmlElement("data");
-  element->SetAttribute("type", data->GetNameOfClass());
 
   // construct name of serializer class
   std::string serializername(data->GetNameOfClass());
@@ -460,6 +722,7 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
     MITK_ERROR << "No serializer found for " << data->GetNameOfClass() << ". Skipping object";
   }
 
+  std::string writtenfilename;
   for (std::list<itk::LightObject::Pointer>::iterator iter = thingsThatCanSerializeThis.begin();
        iter != thingsThatCanSerializeThis.end();
        ++iter)
@@ -471,8 +734,8 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
       serializer->SetWorkingDirectory(m_WorkingDirectory);
       try
       {
-        std::string writtenfilename = serializer->Serialize();
-        element->SetAttribute("file", writtenfilename);
+        writtenfilename = serializer->Serialize();
+        serialized = true;
         error = false;
       }
       catch (std::exception &e)
@@ -483,7 +746,7 @@ TiXmlElement *mitk::SceneIO::SaveBaseData(BaseData *data, const std::string &fil
     }
   }
 
-  return element;
+  return writtenfilename;
 }
 
 TiXmlElement *mitk::SceneIO::SavePropertyList(PropertyList *propertyList, const std::string &filenamehint)
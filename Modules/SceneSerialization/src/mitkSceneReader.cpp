@@ -17,6 +17,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkSceneReader.h"
 
 bool mitk::SceneReader::LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage)
+{
+  return this->LoadScene(document, workingDirectory, storage, nullptr);
+}
+
+bool mitk::SceneReader::LoadScene(TiXmlDocument &document,
+                                  const std::string &workingDirectory,
+                                  DataStorage *storage,
+                                  const SceneArchive *archive)
 {
   // find version node --> note version in some variable
   int fileVersion = 1;
@@ -49,7 +57,7 @@ bool mitk::SceneReader::LoadScene(TiXmlDocument &document, const std::string &wo
   {
     if (SceneReader *reader = dynamic_cast<SceneReader *>(iter->GetPointer()))
     {
-      if (!reader->LoadScene(document, workingDirectory, storage))
+      if (!reader->LoadScene(document, workingDirectory, storage, archive))
       {
         MITK_ERROR << "There were errors while loading scene file "
                    << workingDirectory + "/index.xml. Your data may be corrupted";
@@ -20,8 +20,23 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkIOUtil.h"
 #include "mitkProgressBar.h"
 #include "mitkPropertyListDeserializer.h"
+#include "mitkSceneArchive.h"
 #include "mitkSerializerMacros.h"
+#include <mitkCoreServices.h>
+#include <mitkFileReaderRegistry.h>
+#include <mitkIMimeTypeProvider.h>
 #include <mitkRenderingModeProperty.h>
+#include <mitkStringProperty.h>
+
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <itksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
 
 MITK_REGISTER_SERIALIZER(SceneReaderV1)
 
@@ -51,9 +66,196 @@ namespace
     // question clearly
     return left.first.GetPointer() < right.first.GetPointer();
   }
+
+  // a reader for the data of a <data> element, ranked like in mitk::FileReaderSelector
+  struct DataLoadReader
+  {
+    mitk::IFileReader *Reader;
+    mitk::MimeType MimeType;
+    mitk::FileReaderRegistry::ReaderReference Reference;
+    mitk::IFileReader::ConfidenceLevel ConfidenceLevel;
+  };
+
+  // sorts by confidence level, then by mime-type ranking and reader service ranking
+  bool DataLoadReaderIsLessThan(const DataLoadReader &left, const DataLoadReader &right)
+  {
+    if (left.ConfidenceLevel != right.ConfidenceLevel)
+    {
+      return left.ConfidenceLevel < right.ConfidenceLevel;
+    }
+    if (left.MimeType < right.MimeType)
+    {
+      return true;
+    }
+    if (right.MimeType < left.MimeType)
+    {
+      return false;
+    }
+    return left.Reference < right.Reference;
+  }
+
+  // reading the data of a single <data> element
+  struct DataLoadTask
+  {
+    std::string Filename;
+    std::string Path;
+    std::vector<DataLoadReader> Readers;
+    std::vector<mitk::BaseData::Pointer> Data;
+  };
+
+  // shared by all threads reading data; tasks are handed out one at a time
+  // so that a few large files do not end up in the same thread
+  struct DataLoadJob
+  {
+    std::vector<DataLoadTask> *Tasks;
+    const mitk::SceneArchive *Archive;
+    std::size_t NextTask;
+    itk::SimpleFastMutexLock Mutex;
+  };
+
+  // Readers that can read streams get a stream which decompresses the archive entry while it is read.
+  // All other readers would copy a stream to a temporary file anyway, so they get the entry extracted
+  // to a temporary file once instead of a stream.
+  bool SetReaderInput(mitk::IFileReader *reader,
+                      const DataLoadTask &task,
+                      const mitk::SceneArchive *archive,
+                      std::unique_ptr<std::istream> &stream,
+                      std::string &tmpFile)
+  {
+    if (archive == nullptr)
+    {
+      reader->SetInput(task.Path);
+      return true;
+    }
+
+    if (reader->CanReadStream())
+    {
+      stream = archive->OpenEntry(task.Filename);
+      if (!stream)
+      {
+        return false;
+      }
+      reader->SetInput(task.Path, stream.get());
+      return true;
+    }
+
+    if (tmpFile.empty())
+    {
+      std::ofstream tmpStream;
+      tmpFile = mitk::IOUtil::CreateTemporaryFile(
+        tmpStream,
+        std::ios_base::out | std::ios_base::trunc | std::ios_base::binary,
+        "XXXXXX" + itksys::SystemTools::GetFilenameExtension(task.Filename));
+      const bool extracted = archive->ReadEntry(task.Filename, tmpStream);
+      tmpStream.close();
+      if (!extracted)
+      {
+        std::remove(tmpFile.c_str());
+        tmpFile.clear();
+        return false;
+      }
+    }
+    reader->SetInput(tmpFile);
+    return true;
+  }
+
+  // Runs in a worker thread: must neither log through the GUI, report progress nor touch DataNodes.
+  // Failures are not reported here, the task is retried by LoadBaseDataFromDataTag() afterwards.
+  void LoadDataTask(DataLoadTask &task, const mitk::SceneArchive *archive)
+  {
+    std::unique_ptr<std::istream> stream;
+    std::string tmpFile;
+
+    for (auto &candidate : task.Readers)
+    {
+      candidate.ConfidenceLevel = mitk::IFileReader::Unsupported;
+      try
+      {
+        if (SetReaderInput(candidate.Reader, task, archive, stream, tmpFile))
+        {
+          candidate.ConfidenceLevel = candidate.Reader->GetConfidenceLevel();
+        }
+      }
+      catch (...)
+      {
+      }
+    }
+
+    // the best ranked reader first, the others only if it fails
+    std::sort(task.Readers.rbegin(), task.Readers.rend(), DataLoadReaderIsLessThan);
+
+    for (auto &candidate : task.Readers)
+    {
+      if (candidate.ConfidenceLevel == mitk::IFileReader::Unsupported)
+      {
+        break;
+      }
+
+      try
+      {
+        // checking the confidence level may have consumed a stream, so every read gets a new one
+        if (!SetReaderInput(candidate.Reader, task, archive, stream, tmpFile))
+        {
+          continue;
+        }
+
+        task.Data = candidate.Reader->Read();
+        task.Data.erase(std::remove(task.Data.begin(), task.Data.end(), mitk::BaseData::Pointer()), task.Data.end());
+        if (!task.Data.empty())
+        {
+          break;
+        }
+      }
+      catch (...)
+      {
+        task.Data.clear();
+      }
+    }
+
+    // the readers must not keep the stream or the temporary file
+    for (auto &candidate : task.Readers)
+    {
+      candidate.Reader->SetInput(task.Path);
+    }
+    if (!tmpFile.empty())
+    {
+      std::remove(tmpFile.c_str());
+    }
+  }
+
+  ITK_THREAD_RETURN_TYPE LoadDataThread(void *arg)
+  {
+    typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+    ThreadInfoType *infoStruct = static_cast<ThreadInfoType *>(arg);
+    DataLoadJob *job = static_cast<DataLoadJob *>(infoStruct->UserData);
+
+    while (true)
+    {
+      job->Mutex.Lock();
+      std::size_t taskIndex = job->NextTask++;
+      job->Mutex.Unlock();
+
+      if (taskIndex >= job->Tasks->size())
+      {
+        break;
+      }
+
+      LoadDataTask((*job->Tasks)[taskIndex], job->Archive);
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
 }
 
 bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &workingDirectory, DataStorage *storage)
+{
+  return this->LoadScene(document, workingDirectory, storage, nullptr);
+}
+
+bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document,
+                                    const std::string &workingDirectory,
+                                    DataStorage *storage,
+                                    const SceneArchive *archive)
 {
   assert(storage);
   bool error(false);
@@ -69,22 +271,17 @@ bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &
 
   // create a node for the tag "data" and test if node was created
   typedef std::vector<mitk::DataNode::Pointer> DataNodeVector;
-  DataNodeVector DataNodes;
-  unsigned int listSize = 0;
+  std::vector<TiXmlElement *> dataElements;
   for (TiXmlElement *element = document.FirstChildElement("node"); element != NULL;
        element = element->NextSiblingElement("node"))
   {
-    ++listSize;
+    dataElements.push_back(element->FirstChildElement("data"));
   }
 
-  ProgressBar::GetInstance()->AddStepsToDo(listSize * 2);
+  ProgressBar::GetInstance()->AddStepsToDo(dataElements.size() * 2);
 
-  for (TiXmlElement *element = document.FirstChildElement("node"); element != NULL;
-       element = element->NextSiblingElement("node"))
-  {
-    DataNodes.push_back(LoadBaseDataFromDataTag(element->FirstChildElement("data"), workingDirectory, error));
-    ProgressBar::GetInstance()->Progress();
-  }
+  // the data of all nodes is independent of each other and read concurrently
+  DataNodeVector DataNodes = LoadBaseDataFromDataTags(dataElements, workingDirectory, archive, error);
 
   // iterate all nodes
   // first level nodes should be <node> elements
@@ -177,6 +374,9 @@ bool mitk::SceneReaderV1::LoadScene(TiXmlDocument &document, const std::string &
     }
   }
 
+  // the observers of the DataStorage are notified once for the whole scene, also if adding a node fails
+  DataStorage::BatchScope batch(storage);
+
   // repeat the following loop ...
   //   ... for all created nodes
   unsigned int lastMapSize(0);
@@ -285,6 +485,99 @@ mitk::DataNode::Pointer mitk::SceneReaderV1::LoadBaseDataFromDataTag(TiXmlElemen
   return node;
 }
 
+std::vector<mitk::DataNode::Pointer> mitk::SceneReaderV1::LoadBaseDataFromDataTags(
+  const std::vector<TiXmlElement *> &dataElements,
+  const std::string &workingDirectory,
+  const SceneArchive *archive,
+  bool &error)
+{
+  // reader lookup uses the service registry and is done up front in this thread;
+  // every task gets its own reader instances, so the workers share nothing but the archive
+  FileReaderRegistry readerRegistry;
+  CoreServicePointer<IMimeTypeProvider> mimeTypeProvider(CoreServices::GetMimeTypeProvider());
+
+  std::vector<DataLoadTask> tasks(dataElements.size());
+  for (std::size_t i = 0; i < dataElements.size(); ++i)
+  {
+    const char *filename = dataElements[i] ? dataElements[i]->Attribute("file") : NULL;
+    if (filename == NULL || (archive != nullptr && !archive->HasEntry(filename)))
+    {
+      continue;
+    }
+
+    tasks[i].Filename = filename;
+    tasks[i].Path = workingDirectory + Poco::Path::separator() + filename;
+
+    std::vector<MimeType> mimeTypes = mimeTypeProvider->GetMimeTypesForFile(tasks[i].Path);
+    for (auto mimeType = mimeTypes.begin(); mimeType != mimeTypes.end(); ++mimeType)
+    {
+      std::vector<FileReaderRegistry::ReaderReference> references = FileReaderRegistry::GetReferences(*mimeType);
+      for (auto reference = references.begin(); reference != references.end(); ++reference)
+      {
+        DataLoadReader candidate;
+        candidate.Reader = readerRegistry.GetReader(*reference);
+        candidate.MimeType = *mimeType;
+        candidate.Reference = *reference;
+        candidate.ConfidenceLevel = IFileReader::Unsupported;
+        if (candidate.Reader != nullptr)
+        {
+          tasks[i].Readers.push_back(candidate);
+        }
+      }
+    }
+  }
+
+  const auto numberOfTasks = static_cast<itk::ThreadIdType>(
+    std::count_if(tasks.begin(), tasks.end(), [](const DataLoadTask &task) { return !task.Readers.empty(); }));
+
+  if (numberOfTasks > 0)
+  {
+    DataLoadJob job;
+    job.Tasks = &tasks;
+    job.Archive = archive;
+    job.NextTask = 0;
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(std::min(threader->GetNumberOfThreads(), numberOfTasks));
+    threader->SetSingleMethod(LoadDataThread, &job);
+    threader->SingleMethodExecute();
+  }
+
+  std::vector<DataNode::Pointer> nodes;
+  nodes.reserve(dataElements.size());
+  for (std::size_t i = 0; i < dataElements.size(); ++i)
+  {
+    DataLoadTask &task = tasks[i];
+    if (!task.Data.empty())
+    {
+      if (task.Data.size() > 1)
+      {
+        MITK_WARN << "Discarding multiple base data results from " << task.Filename << " except the first one.";
+      }
+      task.Data.front()->SetProperty("path", StringProperty::New(task.Path));
+
+      DataNode::Pointer node = DataNode::New();
+      node->SetData(task.Data.front());
+      nodes.push_back(node);
+    }
+    else
+    {
+      // no reader could read the entry: fall back to reading the file
+      // from the working directory, which also reports the actual errors
+      const char *filename = dataElements[i] ? dataElements[i]->Attribute("file") : NULL;
+      if (archive != nullptr && filename != NULL && archive->HasEntry(filename))
+      {
+        archive->ExtractEntry(filename, workingDirectory + Poco::Path::separator() + filename);
+      }
+      nodes.push_back(LoadBaseDataFromDataTag(dataElements[i], workingDirectory, error));
+    }
+
+    ProgressBar::GetInstance()->Progress();
+  }
+
+  return nodes;
+}
+
 void mitk::SceneReaderV1::ClearNodePropertyListWithExceptions(DataNode &node, PropertyList &propertyList)
 {
   // Basically call propertyList.Clear(), but implement exceptions (see bug 19354)
@@ -28,6 +28,11 @@ namespace mitk
                              const std::string &workingDirectory,
                              DataStorage *storage) override;
 
+    virtual bool LoadScene(TiXmlDocument &document,
+                           const std::string &workingDirectory,
+                           DataStorage *storage,
+                           const SceneArchive *archive) override;
+
   protected:
     /**
       \brief tries to create one DataNode from a given XML <node> element
@@ -36,6 +41,18 @@ namespace mitk
                                               const std::string &workingDirectory,
                                               bool &error);
 
+    /**
+      \brief reads the base data of all given <data> elements concurrently
+
+      Creates one DataNode per element (an empty one for NULL elements), in the order of \a dataElements.
+      Data is streamed from \a archive if given, otherwise read from \a workingDirectory.
+      Files that could not be read by a stream capable reader are loaded via LoadBaseDataFromDataTag().
+    */
+    std::vector<DataNode::Pointer> LoadBaseDataFromDataTags(const std::vector<TiXmlElement *> &dataElements,
+                                                            const std::string &workingDirectory,
+                                                            const SceneArchive *archive,
+                                                            bool &error);
+
     /**
       \brief reads all the properties from the XML document and recreates them in node
     */
@@ -82,6 +82,7 @@ class mitkSceneIOTest2Suite : public mitk::TestFixture
   CPPUNIT_TEST_SUITE(mitkSceneIOTest2Suite);
   MITK_TEST(Test_SceneIOInterfaces);
   MITK_TEST(Test_ReconstructionOfScenes);
+  MITK_TEST(Test_ReconstructionOfScenesSavedInBackground);
   CPPUNIT_TEST_SUITE_END();
 
   mitk::SceneIOTestScenarioProvider m_TestCaseProvider;
@@ -129,6 +130,44 @@ public:
     }
   }
 
+  void Test_ReconstructionOfScenesSavedInBackground()
+  {
+    std::string tempDir = mitk::IOUtil::CreateTemporaryDirectory("SceneIOTest_XXXXXX");
+
+    mitk::SceneIOTestScenarioProvider::ScenarioList scenarios = m_TestCaseProvider.GetAllScenarios();
+    for (auto scenario : scenarios)
+    {
+      MITK_TEST_OUTPUT(<< "\n===== Test_ReconstructionOfScenesSavedInBackground, scenario '" << scenario.key
+                       << "' =====");
+
+      std::string archiveFilename = mitk::IOUtil::CreateTemporaryFile("scene_XXXXXX.mitk", tempDir);
+      mitk::SceneIO::Pointer writer = mitk::SceneIO::New();
+      mitk::DataStorage::Pointer originalStorage = scenario.BuildDataStorage();
+      bool saved = writer->SaveSceneAsync(originalStorage->GetAll(), originalStorage, archiveFilename);
+      saved = writer->WaitForSave() && saved;
+      CPPUNIT_ASSERT_MESSAGE(std::string("Save test scenario '") + scenario.key + "' in background to '" +
+                               archiveFilename + "'",
+                             scenario.serializable == saved);
+      CPPUNIT_ASSERT(!writer->IsSaving());
+
+      if (scenario.serializable)
+      {
+        mitk::SceneIO::Pointer reader = mitk::SceneIO::New();
+        mitk::DataStorage::Pointer restoredStorage;
+        CPPUNIT_ASSERT_NO_THROW(restoredStorage = reader->LoadScene(archiveFilename));
+        CPPUNIT_ASSERT_MESSAGE(std::string("Comparing restored test scenario '") + scenario.key + "'",
+                               mitk::DataStorageCompare(originalStorage,
+                                                        restoredStorage,
+                                                        mitk::DataStorageCompare::CMP_Hierarchy |
+                                                          mitk::DataStorageCompare::CMP_Data |
+                                                          mitk::DataStorageCompare::CMP_Properties |
+                                                          mitk::DataStorageCompare::CMP_Mappers,
+                                                        scenario.comparisonPrecision)
+                                 .CompareVerbose());
+      }
+    }
+  }
+
 }; // class
 
 int mitkSceneIOTest2(int /*argc*/, char * /*argv*/ [])
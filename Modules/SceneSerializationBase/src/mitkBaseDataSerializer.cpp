@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkStandardFileLocations.h"
 #include <itksys/SystemTools.hxx>
 
+#include <atomic>
+
 mitk::BaseDataSerializer::BaseDataSerializer() : m_FilenameHint("unnamed"), m_WorkingDirectory("")
 {
 }
@@ -37,7 +39,8 @@ std::string mitk::BaseDataSerializer::Serialize()
 std::string mitk::BaseDataSerializer::GetUniqueFilenameInWorkingDirectory()
 {
   // tmpname
-  static unsigned long count = 0;
+  // (scenes are serialized by several threads at once, see SceneIO)
+  static std::atomic<unsigned long> count(0);
   unsigned long n = count++;
   std::ostringstream name;
   for (int i = 0; i < 6; ++i)
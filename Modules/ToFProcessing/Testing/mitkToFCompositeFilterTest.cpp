@@ -322,6 +322,57 @@ int mitkToFCompositeFilterTest(int /* argc */, char* /*argv*/[])
 //  MITK_TEST_CONDITION_REQUIRED(pipelineSuccess,"Test all filters in pipeline");
 
 
+//-------------------------------------------------------------------------------------------------------
+
+  //Apply the temporal median filter to a sequence of frames: the result has to be the median of the last frames
+  compositeFilter->SetApplyThresholdFilter(false);
+  compositeFilter->SetApplyMedianFilter(false);
+  compositeFilter->SetApplyBilateralFilter(false);
+  compositeFilter->SetApplyTemporalMedianFilter(true);
+  unsigned int numberOfMedianFrames = 5;
+  compositeFilter->SetTemporalMedianFilterParameter(numberOfMedianFrames);
+
+  std::vector<ItkImageType_2D::Pointer> frames;
+  bool temporalMedianSuccess = true;
+  for (unsigned int frame = 0; frame < 2*numberOfMedianFrames; frame++)
+  {
+    ItkImageType_2D::Pointer itkFrame = ItkImageType_2D::New();
+    mitk::Image::Pointer mitkFrame = mitk::Image::New();
+    CreateRandomDistanceImage(20,20,itkFrame,mitkFrame);
+    //make the frames differ, values jump up and down between the frames
+    ItkImageRegionIteratorType2D frameIterator(itkFrame,itkFrame->GetLargestPossibleRegion());
+    for (unsigned int pixel = 0; !frameIterator.IsAtEnd(); ++frameIterator, ++pixel)
+    {
+      frameIterator.Set((frame*7919 + pixel*104729) % 1000);
+    }
+    mitk::CastToMitkImage(itkFrame,mitkFrame);
+    frames.push_back(itkFrame);
+    compositeFilter->SetInput(mitkFrame);
+    mitkOutputImage->Update();
+
+    //reference: lower median of the frames in the current window
+    unsigned int firstFrame = frames.size() > numberOfMedianFrames ? frames.size() - numberOfMedianFrames : 0;
+    mitk::ImagePixelReadAccessor<ToFScalarType,2> outputAccess(mitkOutputImage, mitkOutputImage->GetSliceData());
+    itk::Index<2> index;
+    for (index[0] = 0; index[0] < 20; index[0]++)
+    {
+      for (index[1] = 0; index[1] < 20; index[1]++)
+      {
+        std::vector<ToFScalarType> window;
+        for (unsigned int k = firstFrame; k < frames.size(); k++)
+        {
+          window.push_back(frames[k]->GetPixel(index));
+        }
+        std::sort(window.begin(), window.end());
+        if (!mitk::Equal(window[(window.size()-1)/2], outputAccess.GetPixelByIndex(index)))
+        {
+          temporalMedianSuccess = false;
+        }
+      }
+    }
+  }
+  MITK_TEST_CONDITION_REQUIRED(temporalMedianSuccess, "Test temporal median filter over a sliding window of frames");
+
 //-------------------------------------------------------------------------------------------------------
 
   //Check set/get functions
@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkToFTestingCommon.h>
 #include <mitkIOUtil.h>
 
+#include <vtkIdList.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
@@ -379,6 +380,39 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  //Triangulation test: every quad of valid pixels yields two triangles, also across the rows processed by different threads
+  unsigned int expectedNumberOfTriangles = 0;
+  {
+    mitk::ImagePixelReadAccessor<float,2> readAccess(image, image->GetSliceData());
+    for (unsigned int j=1; j<dimY; j++)
+    {
+      for (unsigned int i=1; i<dimX; i++)
+      {
+        itk::Index<2> xy = {{ (int) i, (int) j }};
+        itk::Index<2> x_1y = {{ (int) i-1, (int) j }};
+        itk::Index<2> xy_1 = {{ (int) i, (int) j-1 }};
+        itk::Index<2> x_1y_1 = {{ (int) i-1, (int) j-1 }};
+        if (readAccess.GetPixelByIndex(xy) > mitk::eps && readAccess.GetPixelByIndex(x_1y) > mitk::eps &&
+            readAccess.GetPixelByIndex(xy_1) > mitk::eps && readAccess.GetPixelByIndex(x_1y_1) > mitk::eps)
+        {
+          expectedNumberOfTriangles += 2;
+        }
+      }
+    }
+  }
+  filter->SetGenerateTriangularMesh(true);
+  filter->SetTriangulationThreshold(0.0);
+  filter->Update();
+  vtkPolyData* resultPolyData = filter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(resultPolyData->GetNumberOfPolys() == expectedNumberOfTriangles, "Testing number of triangles of the surface");
+  vtkSmartPointer<vtkIdList> vertexIdList = filter->GetVertexIdList();
+  bool vertexIdsConsistent = (vertexIdList->GetNumberOfIds() == (vtkIdType) (dimX*dimY));
+  for (vtkIdType pixelID=1; vertexIdsConsistent && pixelID<vertexIdList->GetNumberOfIds(); pixelID++)
+  {
+    vertexIdsConsistent = vertexIdList->GetId(pixelID) >= vertexIdList->GetId(pixelID-1) && vertexIdList->GetId(pixelID) < resultPolyData->GetNumberOfPoints();
+  }
+  MITK_TEST_CONDITION_REQUIRED(vertexIdsConsistent, "Testing vertex id list of the surface");
+
   //clean up
   delete point;
   //  expectedResult->Delete();
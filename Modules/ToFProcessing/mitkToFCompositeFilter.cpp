@@ -17,25 +17,25 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkToFCompositeFilter.h>
 #include <mitkInstantiateAccessFunctions.h>
 #include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
 
 #include <itkImage.h>
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
 mitk::ToFCompositeFilter::ToFCompositeFilter() : m_SegmentationMask(nullptr), m_ImageWidth(0), m_ImageHeight(0), m_ImageSize(0),
-m_IplDistanceImage(nullptr), m_IplOutputImage(nullptr), m_ItkInputImage(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
-  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false), m_DataBuffer(nullptr),
-m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
+m_ItkInputImage(nullptr), m_BilateralFilter(nullptr), m_ApplyTemporalMedianFilter(false), m_ApplyAverageFilter(false),
+  m_ApplyMedianFilter(false), m_ApplyThresholdFilter(false), m_ApplyMaskSegmentation(false), m_ApplyBilateralFilter(false),
+m_DataBufferCurrentIndex(0), m_DataBufferMaxSize(0), m_DataBufferNumberOfFrames(0), m_TemporalMedianFilterNumOfFrames(10), m_ThresholdFilterMin(1),
 m_ThresholdFilterMax(7000), m_BilateralFilterDomainSigma(2), m_BilateralFilterRangeSigma(60), m_BilateralFilterKernelRadius(0)
 {
+  m_BilateralFilter = BilateralFilterType::New();
 }
 
 mitk::ToFCompositeFilter::~ToFCompositeFilter()
 {
-  cvReleaseImage(&(this->m_IplDistanceImage));
-  cvReleaseImage(&(this->m_IplOutputImage));
-  if (m_DataBuffer!=nullptr)
-  {
-    delete [] m_DataBuffer;
-  }
 }
 
 void mitk::ToFCompositeFilter::SetInput(  mitk::Image* distanceImage )
@@ -51,32 +51,6 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  mitk::Image* distanc
   }
   else
   {
-    if (idx==0) //create IPL image holding distance data
-    {
-      if (!distanceImage->IsEmpty())
-      {
-        this->m_ImageWidth = distanceImage->GetDimension(0);
-        this->m_ImageHeight = distanceImage->GetDimension(1);
-        this->m_ImageSize = this->m_ImageWidth * this->m_ImageHeight * sizeof(float);
-
-        if (this->m_IplDistanceImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplDistanceImage));
-        }
-        ImageReadAccessor distImgAcc(distanceImage, distanceImage->GetSliceData(0,0,0));
-        float* distanceFloatData = (float*) distImgAcc.GetData();
-        this->m_IplDistanceImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-        memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
-
-        if (this->m_IplOutputImage != nullptr)
-        {
-          cvReleaseImage(&(this->m_IplOutputImage));
-        }
-        this->m_IplOutputImage = cvCreateImage(cvSize(this->m_ImageWidth, this->m_ImageHeight), IPL_DEPTH_32F, 1);
-
-        CreateItkImage(this->m_ItkInputImage);
-      }
-    }
     this->ProcessObject::SetNthInput(idx, distanceImage);   // Process object is not const-correct so the const_cast is required here
   }
 
@@ -97,53 +71,73 @@ void mitk::ToFCompositeFilter::SetInput( unsigned int idx,  mitk::Image* distanc
 
 void mitk::ToFCompositeFilter::GenerateData()
 {
-  // copy input 1...n to output 1...n
+  // copy input 1...n to output 1...n, output 0 is written by the filters below
   for (unsigned int idx=0; idx<this->GetNumberOfOutputs(); idx++)
   {
     mitk::Image::Pointer outputImage = this->GetOutput(idx);
     mitk::Image::Pointer inputImage = this->GetInput(idx);
     if (outputImage.IsNotNull()&&inputImage.IsNotNull())
     {
-      ImageReadAccessor inputAcc(inputImage, inputImage->GetSliceData());
-      outputImage->CopyInformation(inputImage);
-      outputImage->Initialize(inputImage->GetPixelType(),inputImage->GetDimension(),inputImage->GetDimensions());
-      outputImage->SetSlice(inputAcc.GetData());
+      // only initialize the output if its layout changed, this keeps its buffer for the next frame
+      if (!outputImage->IsInitialized() || outputImage->GetPixelType() != inputImage->GetPixelType() ||
+          outputImage->GetDimension() != inputImage->GetDimension() ||
+          !std::equal(inputImage->GetDimensions(), inputImage->GetDimensions() + inputImage->GetDimension(), outputImage->GetDimensions()))
+      {
+        outputImage->CopyInformation(inputImage);
+        outputImage->Initialize(inputImage->GetPixelType(),inputImage->GetDimension(),inputImage->GetDimensions());
+      }
+      if (idx > 0)
+      {
+        ImageReadAccessor inputAcc(inputImage, inputImage->GetSliceData());
+        outputImage->SetSlice(inputAcc.GetData());
+      }
     }
   }
-  //mitk::Image::Pointer outputDistanceImage = this->GetOutput();
-  ImageReadAccessor outputAcc(this->GetOutput(), this->GetOutput()->GetSliceData(0, 0, 0) );
+
+  // the distance data is processed in the buffer of output 0, the helper buffers are only recreated if the size changed
+  int width = this->GetInput()->GetDimension(0);
+  int height = this->GetInput()->GetDimension(1);
+  if (width != this->m_ImageWidth || height != this->m_ImageHeight || this->m_ItkInputImage.IsNull())
+  {
+    this->m_ImageWidth = width;
+    this->m_ImageHeight = height;
+    this->m_ImageSize = this->m_ImageWidth * this->m_ImageHeight * sizeof(float);
+    CreateItkImage(this->m_ItkInputImage);
+  }
+
+  ImageWriteAccessor outputAcc(this->GetOutput(), this->GetOutput()->GetSliceData(0, 0, 0) );
   float* outputDistanceFloatData = (float*) outputAcc.GetData();
 
-  //mitk::Image::Pointer inputDistanceImage = this->GetInput();
   ImageReadAccessor inputAcc(this->GetInput(), this->GetInput()->GetSliceData(0, 0, 0) );
+  const float* distanceFloatData = (const float*)inputAcc.GetData();
+
+  // the only copy of the input: threshold and mask are applied on the way
+  ProcessSegmentation(distanceFloatData, outputDistanceFloatData);
 
-  // copy initial distance image to ipl image
-  float* distanceFloatData = (float*)inputAcc.GetData();
-  memcpy(this->m_IplDistanceImage->imageData, (void*)distanceFloatData, this->m_ImageSize);
-  if (m_ApplyThresholdFilter||m_ApplyMaskSegmentation)
-  {
-    ProcessSegmentation(this->m_IplDistanceImage);
-  }
   if (this->m_ApplyTemporalMedianFilter||this->m_ApplyAverageFilter)
   {
-    ProcessStreamedQuickSelectMedianImageFilter(this->m_IplDistanceImage);
+    ProcessStreamedTemporalMedianFilter(outputDistanceFloatData);
   }
+
+  // all further filters wrap the output buffer instead of copying it
+  cv::Mat outputMat(this->m_ImageHeight, this->m_ImageWidth, CV_32FC1, outputDistanceFloatData);
+  float* currentData = outputDistanceFloatData;
   if (this->m_ApplyMedianFilter)
   {
-    ProcessCVMedianFilter(this->m_IplDistanceImage, this->m_IplOutputImage);
-    memcpy( this->m_IplDistanceImage->imageData, this->m_IplOutputImage->imageData, this->m_ImageSize );
+    ProcessCVMedianFilter(outputMat, this->m_FilterBuffer);
+    currentData = this->m_FilterBuffer.ptr<float>();
   }
   if (this->m_ApplyBilateralFilter)
   {
-      float* itkFloatData = this->m_ItkInputImage->GetBufferPointer();
-      memcpy(itkFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
-      ItkImageType2D::Pointer itkOutputImage = ProcessItkBilateralFilter(this->m_ItkInputImage);
-      memcpy( this->m_IplDistanceImage->imageData, itkOutputImage->GetBufferPointer(), this->m_ImageSize );
+    ItkImageType2D* itkOutputImage = ProcessItkBilateralFilter(currentData);
+    currentData = itkOutputImage->GetBufferPointer();
 
-    //ProcessCVBilateralFilter(this->m_IplDistanceImage, this->m_OutputIplImage, domainSigma, rangeSigma, kernelRadius);
-    //memcpy( distanceFloatData, this->m_OutputIplImage->imageData, distanceImageSize );
+    //ProcessCVBilateralFilter(outputMat, this->m_FilterBuffer);
+  }
+  if (currentData != outputDistanceFloatData)
+  {
+    memcpy( outputDistanceFloatData, currentData, this->m_ImageSize );
   }
-  memcpy( outputDistanceFloatData, this->m_IplDistanceImage->imageData, this->m_ImageSize );
 }
 
 void mitk::ToFCompositeFilter::CreateOutputsForAllInputs()
@@ -172,191 +166,141 @@ void mitk::ToFCompositeFilter::GenerateOutputInformation()
   output->SetPropertyList(input->GetPropertyList()->Clone());
 }
 
-void mitk::ToFCompositeFilter::ProcessSegmentation(IplImage* inputIplImage)
+void mitk::ToFCompositeFilter::ProcessSegmentation(const float* inputData, float* outputData)
 {
-  char* segmentationMask;
-  if (m_SegmentationMask.IsNotNull())
+  const int numberOfPixels = this->m_ImageWidth*this->m_ImageHeight;
+
+  if (!this->m_ApplyThresholdFilter && !this->m_ApplyMaskSegmentation)
   {
-    ImageReadAccessor segMaskAcc(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0));
-    segmentationMask = (char*)segMaskAcc.GetData();
+    memcpy(outputData, inputData, this->m_ImageSize);
+    return;
   }
-  else
+
+  const char* segmentationMask = nullptr;
+  std::unique_ptr<ImageReadAccessor> segMaskAcc;
+  if (this->m_ApplyMaskSegmentation && m_SegmentationMask.IsNotNull())
   {
-    segmentationMask = nullptr;
+    segMaskAcc.reset(new ImageReadAccessor(m_SegmentationMask, m_SegmentationMask->GetSliceData(0,0,0)));
+    segmentationMask = (const char*)segMaskAcc->GetData();
   }
-  float *f = (float*)inputIplImage->imageData;
-  for(int i=0; i<this->m_ImageWidth*this->m_ImageHeight; i++)
+
+  for(int i=0; i<numberOfPixels; i++)
   {
-    if (this->m_ApplyThresholdFilter)
-    {
-      if (f[i]<=m_ThresholdFilterMin)
-      {
-        f[i] = 0.0;
-      }
-      else if (f[i]>=m_ThresholdFilterMax)
-      {
-        f[i] = 0.0;
-      }
-    }
-    if (this->m_ApplyMaskSegmentation)
-    {
-      if (segmentationMask)
-      {
-        if (segmentationMask[i]==0)
-        {
-          f[i] = 0.0;
-        }
-      }
-    }
+    const float value = inputData[i];
+    const bool inside = !this->m_ApplyThresholdFilter || (value > m_ThresholdFilterMin && value < m_ThresholdFilterMax);
+    outputData[i] = (inside && (!segmentationMask || segmentationMask[i]!=0)) ? value : 0.0f;
   }
 }
 
-ItkImageType2D::Pointer mitk::ToFCompositeFilter::ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage)
+ItkImageType2D* mitk::ToFCompositeFilter::ProcessItkBilateralFilter(float* inputData)
 {
-  ItkImageType2D::Pointer outputItkImage;
-  BilateralFilterType::Pointer bilateralFilter = BilateralFilterType::New();
-  bilateralFilter->SetInput(inputItkImage);
-  bilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
-  bilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
-  //bilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
-  outputItkImage = bilateralFilter->GetOutput();
-  outputItkImage->Update();
-  return outputItkImage;
+  m_ItkInputImage->GetPixelContainer()->SetImportPointer(inputData, this->m_ImageWidth*this->m_ImageHeight, false);
+  m_ItkInputImage->Modified();
+
+  m_BilateralFilter->SetInput(m_ItkInputImage);
+  m_BilateralFilter->SetDomainSigma(m_BilateralFilterDomainSigma);
+  m_BilateralFilter->SetRangeSigma(m_BilateralFilterRangeSigma);
+  //m_BilateralFilter->SetRadius(m_BilateralFilterKernelRadius);
+  m_BilateralFilter->Update();
+  return m_BilateralFilter->GetOutput();
 }
 
-void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage)
+void mitk::ToFCompositeFilter::ProcessCVBilateralFilter(const cv::Mat& inputImage, cv::Mat& outputImage)
 {
   int diameter = m_BilateralFilterKernelRadius;
   double sigmaColor = m_BilateralFilterRangeSigma;
   double sigmaSpace = m_BilateralFilterDomainSigma;
-  cvSmooth(inputIplImage, outputIplImage, CV_BILATERAL, diameter, 0, sigmaColor, sigmaSpace);
+  cv::bilateralFilter(inputImage, outputImage, diameter, sigmaColor, sigmaSpace);
 }
 
-void mitk::ToFCompositeFilter::ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius)
+void mitk::ToFCompositeFilter::ProcessCVMedianFilter(const cv::Mat& inputImage, cv::Mat& outputImage, int radius)
 {
-  cvSmooth(inputIplImage, outputIplImage, CV_MEDIAN, radius, 0, 0, 0);
+  // outputImage is only reallocated if its size changed
+  cv::medianBlur(inputImage, outputImage, radius);
 }
 
-void mitk::ToFCompositeFilter::ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage)
+void mitk::ToFCompositeFilter::ResetTemporalMedianFilterBuffers()
 {
-  float* data = (float*)inputIplImage->imageData;
-
-  int imageSize = inputIplImage->width * inputIplImage->height;
-  float* tmpArray;
+  const std::size_t numberOfPixels = this->m_ImageWidth * this->m_ImageHeight;
+  this->m_DataBufferMaxSize = m_TemporalMedianFilterNumOfFrames;
+  this->m_DataBuffer.resize(numberOfPixels * this->m_DataBufferMaxSize);
+  this->m_SortedDataBuffer.resize(numberOfPixels * this->m_DataBufferMaxSize);
+  this->m_DataBufferCurrentIndex = 0;
+  this->m_DataBufferNumberOfFrames = 0;
+}
 
-  if (this->m_TemporalMedianFilterNumOfFrames == 0)
+void mitk::ToFCompositeFilter::ProcessStreamedTemporalMedianFilter(float* data)
+{
+  if (this->m_TemporalMedianFilterNumOfFrames <= 0)
   {
     return;
   }
 
-  if (m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize) // reset
+  const std::size_t numberOfPixels = this->m_ImageWidth * this->m_ImageHeight;
+  if (m_TemporalMedianFilterNumOfFrames != this->m_DataBufferMaxSize ||
+      this->m_DataBuffer.size() != numberOfPixels * this->m_DataBufferMaxSize) // reset
   {
-    //delete current buffer
-    for( int i=0; i<this->m_DataBufferMaxSize; i++ ) {
-      delete[] this->m_DataBuffer[i];
-    }
-    if (this->m_DataBuffer != nullptr)
-    {
-      delete[] this->m_DataBuffer;
-    }
-
-    this->m_DataBufferMaxSize = m_TemporalMedianFilterNumOfFrames;
-
-    // create new buffer with current size
-    this->m_DataBuffer = new float*[this->m_DataBufferMaxSize];
-    for(int i=0; i<this->m_DataBufferMaxSize; i++)
-    {
-      this->m_DataBuffer[i] = nullptr;
-    }
-    this->m_DataBufferCurrentIndex = 0;
+    ResetTemporalMedianFilterBuffers();
   }
 
-  int currentBufferSize = this->m_DataBufferMaxSize;
-  tmpArray = new float[this->m_DataBufferMaxSize];
+  const int windowSize = this->m_DataBufferMaxSize;
+  const bool replace = this->m_DataBufferNumberOfFrames == windowSize;
+  const int numberOfFrames = replace ? windowSize : this->m_DataBufferNumberOfFrames + 1;
+  float* frame = &this->m_DataBuffer[this->m_DataBufferCurrentIndex * numberOfPixels];
 
-  // copy data to buffer
-  if (this->m_DataBuffer[this->m_DataBufferCurrentIndex] == nullptr)
+  for(std::size_t i=0; i<numberOfPixels; i++)
   {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex] = new float[imageSize];
-    currentBufferSize = this->m_DataBufferCurrentIndex + 1;
-  }
+    float* window = &this->m_SortedDataBuffer[i * windowSize];
+    const float value = data[i];
 
-  for(int j=0; j<imageSize; j++)
-  {
-    this->m_DataBuffer[this->m_DataBufferCurrentIndex][j] = data[j];
-  }
+    // position of the value that leaves the window, or the free slot at the end while the buffer fills
+    int position = numberOfFrames - 1;
+    if (replace)
+    {
+      const float oldValue = frame[i];
+      position = static_cast<int>(std::lower_bound(window, window + numberOfFrames, oldValue) - window);
+      if (position == numberOfFrames || !(window[position] == oldValue)) // not ordered, e.g. NaN
+      {
+        position = 0;
+        while (position < numberOfFrames - 1 && !(window[position] == oldValue) && !(window[position] != window[position] && oldValue != oldValue))
+        {
+          ++position;
+        }
+      }
+    }
+
+    // move the new value to its sorted position
+    while (position > 0 && window[position - 1] > value)
+    {
+      window[position] = window[position - 1];
+      --position;
+    }
+    while (position < numberOfFrames - 1 && window[position + 1] < value)
+    {
+      window[position] = window[position + 1];
+      ++position;
+    }
+    window[position] = value;
+    frame[i] = value;
 
-  float tmpValue = 0.0f;
-  for(int i=0; i<imageSize; i++)
-  {
     if (m_ApplyAverageFilter)
     {
-      tmpValue = 0.0f;
-      for(int j=0; j<currentBufferSize; j++)
+      float sum = 0.0f;
+      for(int j=0; j<numberOfFrames; j++)
       {
-          tmpValue+=this->m_DataBuffer[j][i];
+        sum += window[j];
       }
-      data[i] = tmpValue/currentBufferSize;
+      data[i] = sum/numberOfFrames;
     }
     else if (m_ApplyTemporalMedianFilter)
     {
-      for(int j=0; j<currentBufferSize; j++)
-      {
-        tmpArray[j] = this->m_DataBuffer[j][i];
-      }
-      data[i] = quick_select(tmpArray, currentBufferSize);
+      data[i] = window[(numberOfFrames - 1)/2];
     }
   }
 
+  this->m_DataBufferNumberOfFrames = numberOfFrames;
   this->m_DataBufferCurrentIndex = (this->m_DataBufferCurrentIndex + 1) % this->m_DataBufferMaxSize;
-
-  delete[] tmpArray;
-}
-
-#define ELEM_SWAP(a,b) { register float t=(a);(a)=(b);(b)=t; }
-float mitk::ToFCompositeFilter::quick_select(float arr[], int n)
-{
-  int low = 0;
-  int high = n-1;
-  int median = (low + high)/2;
-  int middle = 0;
-  int ll = 0;
-  int hh = 0;
-  for (;;) {
-    if (high <= low) /* One element only */
-      return arr[median] ;
-    if (high == low + 1) { /* Two elements only */
-      if (arr[low] > arr[high])
-        ELEM_SWAP(arr[low], arr[high]) ;
-      return arr[median] ;
-    }
-    /* Find median of low, middle and high items; swap into position low */
-    middle = (low + high) / 2;
-    if (arr[middle] > arr[high]) ELEM_SWAP(arr[middle], arr[high]) ;
-    if (arr[low] > arr[high]) ELEM_SWAP(arr[low], arr[high]) ;
-    if (arr[middle] > arr[low]) ELEM_SWAP(arr[middle], arr[low]) ;
-    /* Swap low item (now in position middle) into position (low+1) */
-    ELEM_SWAP(arr[middle], arr[low+1]) ;
-    /* Nibble from each end towards middle, swapping items when stuck */
-    ll = low + 1;
-    hh = high;
-    for (;;) {
-      do ll++; while (arr[low] > arr[ll]) ;
-      do hh--; while (arr[hh] > arr[low]) ;
-      if (hh < ll)
-        break;
-      ELEM_SWAP(arr[ll], arr[hh]) ;
-    }
-    /* Swap middle item (in position low) back into correct position */
-    ELEM_SWAP(arr[low], arr[hh]) ;
-    /* Re-set active partition */
-    if (hh <= median)
-      low = ll;
-    if (hh >= median)
-      high = hh - 1;
-  }
 }
-#undef ELEM_SWAP
 
 void mitk::ToFCompositeFilter::SetTemporalMedianFilterParameter(int tmporalMedianFilterNumOfFrames)
 {
@@ -393,6 +337,4 @@ void mitk::ToFCompositeFilter::CreateItkImage(ItkImageType2D::Pointer &itkInputI
   region.SetSize( size );
   region.SetIndex( startIndex );
   itkInputImage->SetRegions( region );
-  itkInputImage->Allocate();
-
 }
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <cv.h>
 #include <itkBilateralImageFilter.h>
 
+#include <vector>
+
 typedef itk::Image<float, 2> ItkImageType2D;
 typedef itk::Image<float, 3> ItkImageType3D;
 typedef itk::BilateralImageFilter<ItkImageType2D,ItkImageType2D> BilateralFilterType;
@@ -128,40 +130,41 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
     /*!
-    \brief Applies a mask and/or threshold segmentation to the input image.
+    \brief Copies the input data to the output buffer and applies a mask and/or threshold segmentation on the way.
     All pixels with values outside the mask, below the lower threshold (min) and above the upper threshold (max)
     are assigned the pixel value 0
     */
-    void ProcessSegmentation(IplImage* inputIplImage);
+    void ProcessSegmentation(const float* inputData, float* outputData);
     /*!
-    \brief Applies the ITK bilateral filter to the input image
+    \brief Applies the ITK bilateral filter to the given buffer of size m_ImageWidth*m_ImageHeight.
+    The buffer is wrapped by m_ItkInputImage, i.e. it is not copied. The returned image is owned by the filter
+    and reused for the next frame.
     See http://www.itk.org/Doxygen320/html/classitk_1_1BilateralImageFilter.html for more details.
     */
-    ItkImageType2D::Pointer ProcessItkBilateralFilter(ItkImageType2D::Pointer inputItkImage);
+    ItkImageType2D* ProcessItkBilateralFilter(float* inputData);
     /*!
     \brief Applies the OpenCV bilateral filter to the input image.
     See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
     */
-    void ProcessCVBilateralFilter(IplImage* inputIplImage, IplImage* outputIplImage);
+    void ProcessCVBilateralFilter(const cv::Mat& inputImage, cv::Mat& outputImage);
     /*!
     \brief Applies the OpenCV median filter to the input image.
     See http://opencv.willowgarage.com/documentation/c/image_filtering.html#smooth for more details
     */
-    void ProcessCVMedianFilter(IplImage* inputIplImage, IplImage* outputIplImage, int radius = 3);
+    void ProcessCVMedianFilter(const cv::Mat& inputImage, cv::Mat& outputImage, int radius = 3);
     /*!
-    \brief Performs temporal median filter on an image given the number of frames to be considered
+    \brief Performs the temporal median (or average) filter over the last m_TemporalMedianFilterNumOfFrames frames in place.
+    *
+    * Every pixel keeps its values of the last frames as a sorted window. A new frame replaces the value of the oldest
+    * frame in each window and moves it to its sorted position, so the median is read off instead of selected anew.
     */
-    void ProcessStreamedQuickSelectMedianImageFilter(IplImage* inputIplImage);
+    void ProcessStreamedTemporalMedianFilter(float* data);
     /*!
-    \brief Quickselect algorithm
-    * This Quickselect routine is based on the algorithm described in
-    * "Numerical recipes in C", Second Edition,
-    * Cambridge University Press, 1992, Section 8.5, ISBN 0-521-43108-5
-    * This code by Nicolas Devillard - 1998. Public domain.
+    \brief Resets the buffers of the temporal median filter to hold m_TemporalMedianFilterNumOfFrames frames of the current size
     */
-    float quick_select(float arr[], int n);
+    void ResetTemporalMedianFilterBuffers();
     /*!
-    \brief Initialize and allocate a 2D ITK image of dimension m_ImageWidth*m_ImageHeight
+    \brief Initialize a 2D ITK image of dimension m_ImageWidth*m_ImageHeight without allocating its buffer
     */
     void CreateItkImage(ItkImageType2D::Pointer &itkInputImage);
 
@@ -171,10 +174,10 @@ namespace mitk
     int m_ImageHeight; ///< y-dimension of the image
     int m_ImageSize; ///< size of the image in bytes
 
-    IplImage* m_IplDistanceImage; ///< OpenCV-representation of the distance image
-    IplImage* m_IplOutputImage; ///< OpenCV-representation of the output image
+    cv::Mat m_FilterBuffer; ///< Buffer receiving the result of the spatial median filter, reused for all frames
 
-    ItkImageType2D::Pointer m_ItkInputImage; ///< ITK representation of the distance image
+    ItkImageType2D::Pointer m_ItkInputImage; ///< ITK image wrapping the buffer passed to the bilateral filter
+    BilateralFilterType::Pointer m_BilateralFilter; ///< Bilateral filter, kept to reuse its output buffer
 
     bool m_ApplyTemporalMedianFilter; ///< Flag indicating if the temporal median filter is currently active for processing the distance image
     bool m_ApplyAverageFilter; ///< Flag indicating if the average filter is currently active for processing the distance image
@@ -183,9 +186,11 @@ namespace mitk
     bool m_ApplyMaskSegmentation; ///< Flag indicating if a mask segmentation is performed
     bool m_ApplyBilateralFilter; ///< Flag indicating if the bilateral filter is currently active for processing the distance image
 
-    float** m_DataBuffer; ///< Buffer used for calculating the pixel-wise median over the last n (m_TemporalMedianFilterNumOfFrames) number of frames
+    std::vector<float> m_DataBuffer; ///< Last n (m_TemporalMedianFilterNumOfFrames) frames, stored one after another as a ring buffer
+    std::vector<float> m_SortedDataBuffer; ///< Pixel-wise sorted values of the frames in m_DataBuffer, the m_DataBufferMaxSize values of a pixel are stored contiguously
     int m_DataBufferCurrentIndex; ///< Current index in the buffer of the temporal median filter
     int m_DataBufferMaxSize; ///< Maximal size for the buffer of the temporal median filter (m_DataBuffer)
+    int m_DataBufferNumberOfFrames; ///< Number of frames currently held by the buffer of the temporal median filter
 
     int m_TemporalMedianFilterNumOfFrames; ///< Number of frames to be used in the calculation of the temporal median
     int m_ThresholdFilterMin; ///< Lower threshold of the threshold filter. Pixels with values below will be assigned value 0 when applying the threshold filter
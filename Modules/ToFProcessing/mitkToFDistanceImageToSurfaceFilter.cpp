@@ -28,10 +28,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkFloatArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 
 #include <math.h>
 #include <vtkMath.h>
 
+#include <algorithm>
+#include <memory>
+
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
   m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
@@ -89,217 +93,345 @@ mitk::Image* mitk::ToFDistanceImageToSurfaceFilter::GetInput( unsigned int idx )
   return static_cast< mitk::Image*>(this->ProcessObject::GetInput(idx));
 }
 
+struct mitk::ToFDistanceImageToSurfaceFilter::ReconstructionJob
+{
+  ToFDistanceImageToSurfaceFilter* Filter;
+  itk::ThreadIdType NumberOfThreads;
+
+  int XDimension;
+  int YDimension;
+  const float* DistanceData;
+  const float* ScalarData;
+  mitk::ToFProcessingCommon::ToFPoint2D FocalLengthInPixelUnits;
+  mitk::ToFProcessingCommon::ToFScalarType FocalLengthInMm;
+  mitk::ToFProcessingCommon::ToFPoint2D PrincipalPoint;
+  mitk::Point3D Origin;
+  mitk::Vector3D Spacing;
+
+  // the arrays of the output, every valid pixel is written to its own tuple
+  const vtkIdType* VertexIds;
+  double* Points;
+  float* Scalars;
+  float* TextureCoords;
+
+  // cells of each thread in the layout of vtkCellArray (number of points followed by the point ids)
+  std::vector<std::vector<vtkIdType> > Polys;
+  std::vector<std::vector<vtkIdType> > Vertices;
+};
+
+namespace
+{
+  // images with fewer pixels per thread are processed by fewer threads
+  const int MINIMUM_NUMBER_OF_PIXELS_PER_THREAD = 16384;
+
+  vtkSmartPointer<vtkCellArray> CreateCellArray(const std::vector<std::vector<vtkIdType> >& cells, vtkIdType numberOfPointsPerCell)
+  {
+    std::size_t numberOfValues = 0;
+    for (auto threadCells = cells.cbegin(); threadCells != cells.cend(); ++threadCells)
+    {
+      numberOfValues += threadCells->size();
+    }
+
+    vtkSmartPointer<vtkIdTypeArray> ids = vtkSmartPointer<vtkIdTypeArray>::New();
+    ids->SetNumberOfValues(numberOfValues);
+    vtkIdType* idData = ids->GetPointer(0);
+    for (auto threadCells = cells.cbegin(); threadCells != cells.cend(); ++threadCells)
+    {
+      idData = std::copy(threadCells->cbegin(), threadCells->cend(), idData);
+    }
+
+    vtkSmartPointer<vtkCellArray> cellArray = vtkSmartPointer<vtkCellArray>::New();
+    cellArray->SetCells(numberOfValues / (numberOfPointsPerCell + 1), ids);
+    return cellArray;
+  }
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
 {
   mitk::Surface::Pointer output = this->GetOutput();
   assert(output);
   mitk::Image::Pointer input = this->GetInput();
   assert(input);
+
+  ReconstructionJob job;
+  job.Filter = this;
   // mesh points
-  int xDimension = input->GetDimension(0);
-  int yDimension = input->GetDimension(1);
-  unsigned int size = xDimension*yDimension; //size of the image-array
-  std::vector<bool> isPointValid;
-  isPointValid.resize(size);
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-  points->SetDataTypeToDouble();
-  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkCellArray> vertices = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
-  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
-  textureCoords->SetNumberOfComponents(2);
-  textureCoords->Allocate(size);
+  job.XDimension = input->GetDimension(0);
+  job.YDimension = input->GetDimension(1);
+  unsigned int size = job.XDimension*job.YDimension; //size of the image-array
+
+  std::unique_ptr<ImageReadAccessor> scalarAcc;
+  job.ScalarData = nullptr;
+  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
+  {
+    job.ScalarData = (float*)this->m_IplScalarImage->imageData;
+  }
+  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
+  {
+    scalarAcc.reset(new ImageReadAccessor(this->GetInput(m_TextureIndex)));
+    job.ScalarData = (const float*)scalarAcc->GetData();
+  }
+
+  ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
+  job.DistanceData = (const float*)inputAcc.GetData();
 
   //Make a vtkIdList to save the ID's of the polyData corresponding to the image
-  //pixel ID's. See below for more documentation.
+  //pixel ID's. VTK would insert empty points into the polydata if the pixel ID's
+  //were used as point ID's, so only the valid pixels get consecutive point ID's.
   m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
-  //Allocate the object once else it would automatically allocate new memory
-  //for every vertex and perform a copy which is expensive.
-  m_VertexIdList->Allocate(size);
   m_VertexIdList->SetNumberOfIds(size);
-  for(unsigned int i = 0; i < size; ++i)
+  vtkIdType* vertexIds = m_VertexIdList->GetPointer(0);
+  m_IsPointValid.resize(size);
+  vtkIdType numberOfPoints = 0;
+  for (unsigned int pixelID = 0; pixelID < size; ++pixelID)
   {
-    m_VertexIdList->SetId(i, 0);
+    //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+    m_IsPointValid[pixelID] = job.DistanceData[pixelID] > mitk::eps;
+    vertexIds[pixelID] = m_IsPointValid[pixelID] ? numberOfPoints++ : 0;
   }
+  job.VertexIds = vertexIds;
 
-  float* scalarFloatData = nullptr;
+  // the arrays are allocated once, the threads write the tuples of their rows
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numberOfPoints);
+  job.Points = static_cast<double*>(points->GetVoidPointer(0));
 
-  if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
-  {
-    scalarFloatData = (float*)this->m_IplScalarImage->imageData;
-  }
-  else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
+  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
+  job.Scalars = nullptr;
+  if (job.ScalarData)
   {
-    ImageReadAccessor inputAcc(this->GetInput(m_TextureIndex));
-    scalarFloatData = (float*)inputAcc.GetData();
+    scalarArray->SetNumberOfTuples(numberOfPoints);
+    job.Scalars = scalarArray->GetPointer(0);
   }
 
-  ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
-  float* inputFloatData = (float*)inputAcc.GetData();
+  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
+  textureCoords->SetNumberOfComponents(2);
+  textureCoords->SetNumberOfTuples(numberOfPoints);
+  job.TextureCoords = textureCoords->GetPointer(0);
+
   //calculate world coordinates
-  mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
-  mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm;
   if((m_ReconstructionMode == WithOutInterPixelDistance) || (m_ReconstructionMode == Kinect))
   {
-    focalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
-    focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
+    job.FocalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
+    job.FocalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
   }
   else if( m_ReconstructionMode == WithInterPixelDistance)
   {
     //convert focallength from pixel to mm
-    focalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
+    job.FocalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
+  }
+  else
+  {
+    MITK_ERROR << "Incorrect reconstruction mode!";
   }
 
-  mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
-  principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
-  principalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
+  job.PrincipalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
+  job.PrincipalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
+
+  job.Origin = input->GetGeometry()->GetOrigin();
+  job.Spacing = input->GetGeometry()->GetSpacing();
 
-  mitk::Point3D origin = input->GetGeometry()->GetOrigin();
-  mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
+  // the rows are split into contiguous blocks, concatenating the cells of the threads keeps the order of a single thread
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  job.NumberOfThreads = std::max<itk::ThreadIdType>(1, std::min<itk::ThreadIdType>(
+    std::min<itk::ThreadIdType>(threader->GetNumberOfThreads(), job.YDimension),
+    size / MINIMUM_NUMBER_OF_PIXELS_PER_THREAD));
+  job.Polys.resize(job.NumberOfThreads);
+  job.Vertices.resize(job.NumberOfThreads);
 
-  for (int j=0; j<yDimension; j++)
+  if (job.NumberOfThreads > 1)
   {
-    for (int i=0; i<xDimension; i++)
+    threader->SetNumberOfThreads(job.NumberOfThreads);
+    threader->SetSingleMethod(ReconstructRowsThread, &job);
+    threader->SingleMethodExecute();
+    // the triangles of a row need the points of the previous row, so all points have to be computed first
+    threader->SetSingleMethod(TriangulateRowsThread, &job);
+    threader->SingleMethodExecute();
+  }
+  else
+  {
+    this->ReconstructRows(job, 0, job.YDimension);
+    this->TriangulateRows(job, 0, job.YDimension, 0);
+  }
+
+  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
+  mesh->SetPoints(points);
+  mesh->SetPolys(CreateCellArray(job.Polys, 3));
+  mesh->SetVerts(CreateCellArray(job.Vertices, 1));
+  //Pass the scalars to the polydata (if they were set).
+  if (scalarArray->GetNumberOfTuples()>0)
+  {
+    mesh->GetPointData()->SetScalars(scalarArray);
+  }
+  //Pass the TextureCoords to the polydata anyway (to save them).
+  mesh->GetPointData()->SetTCoords(textureCoords);
+  output->SetVtkPolyData(mesh);
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::ReconstructRows(ReconstructionJob& job, int firstRow, int endRow)
+{
+  for (int j=firstRow; j<endRow; j++)
+  {
+    for (int i=0; i<job.XDimension; i++)
     {
-      unsigned int pixelID = i+j*xDimension;
+      unsigned int pixelID = i+j*job.XDimension;
+      if (!m_IsPointValid[pixelID])
+      {
+        continue;
+      }
 
-      mitk::ToFProcessingCommon::ToFScalarType distance = (double)inputFloatData[pixelID];
+      mitk::ToFProcessingCommon::ToFScalarType distance = (double)job.DistanceData[pixelID];
 
       /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
       * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
       * due to cropping or the spacing differes due to up- or downsampling.*/
-      unsigned int completeIndexX = i*spacing[0]+origin[0];
-      unsigned int completeIndexY = j*spacing[1]+origin[1];
+      unsigned int completeIndexX = i*job.Spacing[0]+job.Origin[0];
+      unsigned int completeIndexY = j*job.Spacing[1]+job.Origin[1];
 
       mitk::ToFProcessingCommon::ToFPoint3D cartesianCoordinates;
       switch (m_ReconstructionMode)
       {
       case WithOutInterPixelDistance:
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
+        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,job.FocalLengthInPixelUnits,job.PrincipalPoint);
         break;
       }
       case WithInterPixelDistance:
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,distance,focalLengthInMm,m_InterPixelDistance,principalPoint);
+        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,distance,job.FocalLengthInMm,m_InterPixelDistance,job.PrincipalPoint);
         break;
       }
       case Kinect:
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
+        cartesianCoordinates = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,job.FocalLengthInPixelUnits,job.PrincipalPoint);
         break;
       }
       default:
       {
-        MITK_ERROR << "Incorrect reconstruction mode!";
+        cartesianCoordinates.Fill(0.0);
+      }
+      }
+
+      vtkIdType pointID = job.VertexIds[pixelID];
+      std::copy(cartesianCoordinates.GetDataPointer(), cartesianCoordinates.GetDataPointer() + 3, job.Points + 3*pointID);
+
+      //Scalar values are necessary for mapping colors/texture onto the surface
+      if (job.Scalars)
+      {
+        job.Scalars[pointID] = job.ScalarData[pixelID];
+      }
+      //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
+      job.TextureCoords[2*pointID] = ((float)i)/job.XDimension; // correct video texture scale for kinect
+      job.TextureCoords[2*pointID+1] = ((float)j)/job.YDimension; //don't flip. we don't need to flip.
+    }
+  }
+}
+
+void mitk::ToFDistanceImageToSurfaceFilter::TriangulateRows(ReconstructionJob& job, int firstRow, int endRow, itk::ThreadIdType threadId)
+{
+  std::vector<vtkIdType>& polys = job.Polys[threadId];
+  std::vector<vtkIdType>& vertices = job.Vertices[threadId];
+  const int xDimension = job.XDimension;
+
+  for (int j=firstRow; j<endRow; j++)
+  {
+    for (int i=0; i<xDimension; i++)
+    {
+      unsigned int pixelID = i+j*xDimension;
+      if (!m_IsPointValid[pixelID])
+      {
+        continue;
       }
+
+      if (!m_GenerateTriangularMesh)
+      {
+        //We dont want triangulation, we only want vertices
+        vertices.push_back(1);
+        vertices.push_back(job.VertexIds[pixelID]);
+        continue;
+      }
+
+      //We can only start triangulation if we are at vertex (1,1),
+      //because we need the other 3 vertices near this one.
+      if((i < 1) || (j < 1))
+      {
+        continue;
+      }
+
+      //This little piece of art explains the ID's:
+      //
+      // P(x_1y_1)---P(xy_1)
+      // |           |
+      // |           |
+      // |           |
+      // P(x_1y)-----P(xy)
+      //
+      //To go one pixel line back in the image array, we have to
+      //subtract 1x xDimension.
+      vtkIdType xy = pixelID;
+      vtkIdType x_1y = pixelID-1;
+      vtkIdType xy_1 = pixelID-xDimension;
+      vtkIdType x_1y_1 = xy_1-1;
+
+      if (!(m_IsPointValid[x_1y]&&m_IsPointValid[x_1y_1]&&m_IsPointValid[xy_1])) // check if points of cell are valid
+      {
+        continue;
       }
-      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
-      if (distance<=mitk::eps)
+
+      //Find the corresponding vertex ID's in the saved vertexIdList:
+      vtkIdType xyV = job.VertexIds[xy];
+      vtkIdType x_1yV = job.VertexIds[x_1y];
+      vtkIdType xy_1V = job.VertexIds[xy_1];
+      vtkIdType x_1y_1V = job.VertexIds[x_1y_1];
+
+      const double* pointXY = job.Points + 3*xyV;
+      const double* pointX_1Y = job.Points + 3*x_1yV;
+      const double* pointXY_1 = job.Points + 3*xy_1V;
+      const double* pointX_1Y_1 = job.Points + 3*x_1y_1V;
+
+      if( (mitk::Equal(m_TriangulationThreshold, 0.0)) || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
+                                                           && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
+                                                           && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
+                                                           && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
       {
-        isPointValid[pixelID] = false;
+        const vtkIdType triangles[8] = { 3, x_1yV, xyV, x_1y_1V, 3, x_1y_1V, xyV, xy_1V };
+        polys.insert(polys.end(), triangles, triangles + 8);
       }
       else
       {
-        isPointValid[pixelID] = true;
-        //VTK would insert empty points into the polydata if we use
-        //points->InsertPoint(pixelID, cartesianCoordinates.GetDataPointer()).
-        //If we use points->InsertNextPoint(...) instead, the ID's do not
-        //correspond to the image pixel ID's. Thus, we have to save them
-        //in the vertexIdList.
-        m_VertexIdList->SetId(pixelID, points->InsertNextPoint(cartesianCoordinates.GetDataPointer()));
-
-        if (m_GenerateTriangularMesh)
-        {
-          if((i >= 1) && (j >= 1))
-          {
-            //This little piece of art explains the ID's:
-            //
-            // P(x_1y_1)---P(xy_1)
-            // |           |
-            // |           |
-            // |           |
-            // P(x_1y)-----P(xy)
-            //
-            //We can only start triangulation if we are at vertex (1,1),
-            //because we need the other 3 vertices near this one.
-            //To go one pixel line back in the image array, we have to
-            //subtract 1x xDimension.
-            vtkIdType xy = pixelID;
-            vtkIdType x_1y = pixelID-1;
-            vtkIdType xy_1 = pixelID-xDimension;
-            vtkIdType x_1y_1 = xy_1-1;
-
-            //Find the corresponding vertex ID's in the saved vertexIdList:
-            vtkIdType xyV = m_VertexIdList->GetId(xy);
-            vtkIdType x_1yV = m_VertexIdList->GetId(x_1y);
-            vtkIdType xy_1V = m_VertexIdList->GetId(xy_1);
-            vtkIdType x_1y_1V = m_VertexIdList->GetId(x_1y_1);
-
-            if (isPointValid[xy]&&isPointValid[x_1y]&&isPointValid[x_1y_1]&&isPointValid[xy_1]) // check if points of cell are valid
-            {
-              double pointXY[3], pointX_1Y[3], pointXY_1[3], pointX_1Y_1[3];
-
-              points->GetPoint(xyV, pointXY);
-              points->GetPoint(x_1yV, pointX_1Y);
-              points->GetPoint(xy_1V, pointXY_1);
-              points->GetPoint(x_1y_1V, pointX_1Y_1);
-
-              if( (mitk::Equal(m_TriangulationThreshold, 0.0)) || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
-              {
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1yV);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(x_1y_1V);
-
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1y_1V);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(xy_1V);
-              }
-              else
-              {
-                //We dont want triangulation, but we want to keep the vertex
-                vertices->InsertNextCell(1);
-                vertices->InsertCellPoint(xyV);
-              }
-            }
-          }
-        }
-        else
-        {
-          //We dont want triangulation, we only want vertices
-          vertices->InsertNextCell(1);
-          vertices->InsertCellPoint(m_VertexIdList->GetId(pixelID));
-        }
-        //Scalar values are necessary for mapping colors/texture onto the surface
-        if (scalarFloatData)
-        {
-          scalarArray->InsertTuple1(m_VertexIdList->GetId(pixelID), scalarFloatData[pixelID]);
-        }
-        //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
-        float xNorm = (((float)i)/xDimension);// correct video texture scale for kinect
-        float yNorm = ((float)j)/yDimension; //don't flip. we don't need to flip.
-        textureCoords->InsertTuple2(m_VertexIdList->GetId(pixelID), xNorm, yNorm);
+        //We dont want triangulation, but we want to keep the vertex
+        vertices.push_back(1);
+        vertices.push_back(xyV);
       }
     }
   }
+}
 
-  vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
-  mesh->SetPoints(points);
-  mesh->SetPolys(polys);
-  mesh->SetVerts(vertices);
-  //Pass the scalars to the polydata (if they were set).
-  if (scalarArray->GetNumberOfTuples()>0)
-  {
-    mesh->GetPointData()->SetScalars(scalarArray);
-  }
-  //Pass the TextureCoords to the polydata anyway (to save them).
-  mesh->GetPointData()->SetTCoords(textureCoords);
-  output->SetVtkPolyData(mesh);
+ITK_THREAD_RETURN_TYPE mitk::ToFDistanceImageToSurfaceFilter::ReconstructRowsThread(void* arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType* infoStruct = static_cast<ThreadInfoType*>(arg);
+  ReconstructionJob* job = static_cast<ReconstructionJob*>(infoStruct->UserData);
+
+  const int firstRow = job->YDimension * infoStruct->ThreadID / infoStruct->NumberOfThreads;
+  const int endRow = job->YDimension * (infoStruct->ThreadID + 1) / infoStruct->NumberOfThreads;
+  job->Filter->ReconstructRows(*job, firstRow, endRow);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE mitk::ToFDistanceImageToSurfaceFilter::TriangulateRowsThread(void* arg)
+{
+  typedef itk::MultiThreader::ThreadInfoStruct ThreadInfoType;
+  ThreadInfoType* infoStruct = static_cast<ThreadInfoType*>(arg);
+  ReconstructionJob* job = static_cast<ReconstructionJob*>(infoStruct->UserData);
+
+  const int firstRow = job->YDimension * infoStruct->ThreadID / infoStruct->NumberOfThreads;
+  const int endRow = job->YDimension * (infoStruct->ThreadID + 1) / infoStruct->NumberOfThreads;
+  job->Filter->TriangulateRows(*job, firstRow, endRow, infoStruct->ThreadID);
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 void mitk::ToFDistanceImageToSurfaceFilter::CreateOutputsForAllInputs()
@@ -26,9 +26,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkPointSet.h>
 #include <cv.h>
 
+#include <itkMultiThreader.h>
+
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 
+#include <vector>
+
 namespace mitk
 {
   /**
@@ -189,6 +193,23 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+  private:
+    struct ReconstructionJob;
+
+    /*!
+    \brief Computes the world coordinates, scalars and texture coordinates of the valid pixels in rows firstRow to endRow-1
+    */
+    void ReconstructRows(ReconstructionJob& job, int firstRow, int endRow);
+    /*!
+    \brief Creates the triangles (or vertices) of the rows firstRow to endRow-1 in the cell buffers of thread threadId
+    */
+    void TriangulateRows(ReconstructionJob& job, int firstRow, int endRow, itk::ThreadIdType threadId);
+
+    static ITK_THREAD_RETURN_TYPE ReconstructRowsThread(void* arg);
+    static ITK_THREAD_RETURN_TYPE TriangulateRowsThread(void* arg);
+
+    std::vector<bool> m_IsPointValid; ///< Pixels with a distance above zero, reused for all frames
+
   };
 } //END mitk namespace
 #endif
@@ -15,6 +15,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include "mitkUSImageLoggingFilter.h"
+#include "mitkUSImageStreamReader.h"
 #include <mitkTestingMacros.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingConfig.h>
@@ -25,9 +26,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIMimeTypeProvider.h>
 
 #include "mitkImageGenerator.h"
+#include <mitkImageReadAccessor.h>
 
 #include "itksys/SystemTools.hxx"
 
+#include <cstring>
+
 #include "Poco/File.h"
 
 class mitkUSImageLoggingFilterTestSuite : public mitk::TestFixture
@@ -40,6 +44,9 @@ class mitkUSImageLoggingFilterTestSuite : public mitk::TestFixture
   MITK_TEST(TestSavingAfterMupltipleUpdateCalls);
   MITK_TEST(TestFilterWithEmptyImages);
   MITK_TEST(TestFilterWithInvalidPath);
+  MITK_TEST(TestStreamingImages);
+  MITK_TEST(TestStreamingWithSmallFramePool);
+  MITK_TEST(TestStreamingToInvalidPath);
   //MITK_TEST(TestJpgFileExtension); //bug 19614
   CPPUNIT_TEST_SUITE_END();
 
@@ -162,6 +169,106 @@ public:
                                mitk::Exception);
   }
 
+  void TestStreamingImages()
+  {
+  std::string filename = m_TemporaryTestDirectory + "USImageLoggingFilterTestStream.usis";
+  m_TestFilter->SetInput(m_RandomSingleSliceImage);
+  m_TestFilter->StartStreaming(filename);
+  CPPUNIT_ASSERT_MESSAGE("Testing if filter is streaming",m_TestFilter->IsStreaming());
+
+  for(int i=0; i<5; i++)
+    {
+    m_RandomSingleSliceImage->Modified();
+    m_TestFilter->Update();
+    std::stringstream testmessage;
+    testmessage << "testmessage" << i;
+    m_TestFilter->AddMessageToCurrentImage(testmessage.str());
+    itksys::SystemTools::Delay(50);
+    }
+  m_TestFilter->StopStreaming();
+  CPPUNIT_ASSERT_MESSAGE("Testing if streaming was stopped",!m_TestFilter->IsStreaming());
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing if no image was dropped",0u,m_TestFilter->GetNumberOfDroppedImages());
+
+  mitk::USImageStreamReader::Pointer reader = mitk::USImageStreamReader::New();
+  reader->Read(filename);
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing if all images were streamed",5u,reader->GetNumberOfImages());
+
+  mitk::ImageReadAccessor expectedAccess(m_RandomSingleSliceImage);
+  const std::size_t size = m_RandomSingleSliceImage->GetDimension(0)*m_RandomSingleSliceImage->GetDimension(1)*sizeof(float);
+  for(unsigned int i=0; i<reader->GetNumberOfImages(); i++)
+    {
+    mitk::Image::Pointer image = reader->GetImage(i);
+    CPPUNIT_ASSERT_MESSAGE("Testing pixel type of streamed image",image->GetPixelType()==m_RandomSingleSliceImage->GetPixelType());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing dimension of streamed image",m_RandomSingleSliceImage->GetDimension(0),image->GetDimension(0));
+    mitk::ImageReadAccessor streamedAccess(image);
+    CPPUNIT_ASSERT_MESSAGE("Testing pixel data of streamed image",std::memcmp(expectedAccess.GetData(),streamedAccess.GetData(),size)==0);
+
+    std::stringstream testmessage;
+    testmessage << "testmessage" << i;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing message of streamed image",testmessage.str(),reader->GetMessage(i));
+    if (i > 0)
+      CPPUNIT_ASSERT_MESSAGE("Testing if time stamps increase",reader->GetTimeStamp(i) > reader->GetTimeStamp(i-1));
+    }
+
+  //clean up
+  reader = nullptr;
+  std::remove(filename.c_str());
+  }
+
+  void TestStreamingWithSmallFramePool()
+  {
+  std::string filename = m_TemporaryTestDirectory + "USImageLoggingFilterTestStreamSmallPool.usis";
+  m_TestFilter->SetInput(m_RandomRestImage1);
+  m_TestFilter->SetStreamingFramePoolSize(1);
+  m_TestFilter->StartStreaming(filename);
+
+  std::vector<std::string> expectedMessages;
+  for(int i=0; i<20; i++)
+    {
+    const unsigned int droppedImages = m_TestFilter->GetNumberOfDroppedImages();
+    m_RandomRestImage1->Modified();
+    m_TestFilter->Update();
+    std::stringstream testmessage;
+    testmessage << "testmessage" << i;
+    m_TestFilter->AddMessageToCurrentImage(testmessage.str());
+    if (m_TestFilter->GetNumberOfDroppedImages() == droppedImages)
+      expectedMessages.push_back(testmessage.str());
+    }
+  m_TestFilter->StopStreaming();
+
+  //depending on the speed of the disc images are dropped, but every image is either written or counted
+  mitk::USImageStreamReader::Pointer reader = mitk::USImageStreamReader::New();
+  reader->Read(filename);
+  CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing if every image was written or counted as dropped",
+                               20u,reader->GetNumberOfImages()+m_TestFilter->GetNumberOfDroppedImages());
+
+  //messages of dropped images must not be attached to the image before them
+  CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(expectedMessages.size()),reader->GetNumberOfImages());
+  for(unsigned int i=0; i<reader->GetNumberOfImages(); i++)
+    {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Testing message of streamed image",expectedMessages[i],reader->GetMessage(i));
+    }
+
+  //clean up
+  reader = nullptr;
+  std::remove(filename.c_str());
+  }
+
+  void TestStreamingToInvalidPath()
+  {
+  #ifdef WIN32
+  std::string filename = "XV:/342INVALID<>"; //invalid filename for windows
+  #else
+  std::string filename = "/dsfdsf:$342INVALID/stream.usis"; //invalid filename for linux
+  #endif
+
+  m_TestFilter->SetInput(m_RandomSingleSliceImage);
+  CPPUNIT_ASSERT_THROW_MESSAGE("Testing if correct exception if thrown if an invalid path is given.",
+                               m_TestFilter->StartStreaming(filename),
+                               mitk::Exception);
+  CPPUNIT_ASSERT_MESSAGE("Testing if filter is not streaming",!m_TestFilter->IsStreaming());
+  }
+
   void TestJpgFileExtension()
   {
   CPPUNIT_ASSERT_MESSAGE("Testing setting of jpg extension.",m_TestFilter->SetImageFilesExtension(".jpg"));
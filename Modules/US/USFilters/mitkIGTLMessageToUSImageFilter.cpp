@@ -17,6 +17,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkIGTLMessageToUSImageFilter.h>
 #include <igtlImageMessage.h>
 #include <itkByteSwapper.h>
+#include <mitkImageWriteAccessor.h>
 
 void mitk::IGTLMessageToUSImageFilter::GetNextRawImage(
   mitk::Image::Pointer& img)
@@ -78,22 +79,14 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
   igtl::ImageMessage* msg,
   bool big_endian)
 {
-  typedef itk::Image<TPixel, 3> ImageType;
-
-  typename ImageType::Pointer output = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::RegionType::SizeType size;
-  typename ImageType::RegionType::IndexType index;
-  typename ImageType::SpacingType spacing;
-  typename ImageType::PointType origin;
-
   // Copy dimensions
   int dims[3];
   msg->GetDimensions(dims);
+  unsigned int dimensions[3];
   size_t num_pixel = 1;
   for (size_t i = 0; i < 3; i++)
   {
-    size[i] = dims[i];
+    dimensions[i] = dims[i];
     num_pixel *= dims[i];
   }
 
@@ -110,58 +103,36 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
     }
   }
 
-  index.Fill(0);
-
-  float matF[4][4];
-  msg->GetMatrix(matF);
-  vtkMatrix4x4* vtkMatrix = vtkMatrix4x4::New();
-
-  for (size_t i = 0; i < 4; ++i)
-    for (size_t j = 0; j < 4; ++j)
-      vtkMatrix->SetElement(i, j, matF[i][j]);
-
   float spacingMsg[3];
-
   msg->GetSpacing(spacingMsg);
 
+  mitk::Vector3D spacing;
   for (int i = 0; i < 3; ++i)
     spacing[i] = spacingMsg[i];
 
-  region.SetSize(size);
-  region.SetIndex(index);
-  output->SetRegions(region);
-  output->SetSpacing(spacing);
-  output->Allocate();
+  img = mitk::Image::New();
+  img->Initialize(mitk::MakeScalarPixelType<TPixel>(), 3, dimensions);
+  img->GetGeometry()->SetSpacing(spacing);
+
+  // The pixels are copied once, directly from the received message body into the image.
+  // Each frame gets a new image because downstream consumers may keep previous frames.
+  img->SetImportVolume(msg->GetScalarPointer(), 0, 0, mitk::Image::CopyMemory);
 
-  TPixel* in = (TPixel*)msg->GetScalarPointer();
-  TPixel* out = (TPixel*)output->GetBufferPointer();
-  memcpy(out, in, num_pixel * sizeof(TPixel));
-  if (big_endian)
+  if (big_endian != itk::ByteSwapper<TPixel>::SystemIsBigEndian())
   {
+    mitk::ImageWriteAccessor accessor(img);
+    TPixel* out = static_cast<TPixel*>(accessor.GetData());
+
     // Even though this method is called "FromSystemToBigEndian", it also swaps
     // "FromBigEndianToSystem".
     // This makes sense, but might be confusing at first glance.
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
-  }
-  else
-  {
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
+    if (big_endian)
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
+    else
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
   }
 
-  img = mitk::Image::New();
-  img->InitializeByItk(output.GetPointer());
-  img->SetVolume(output->GetBufferPointer());
-  //img->GetGeometry()->SetIndexToWorldTransformByVtkMatrix(vtkMatrix);
   m_previousImage = img;
-  vtkMatrix->Delete();
-
-  float iorigin[3];
-  msg->GetOrigin(iorigin);
-  for (size_t i = 0; i < 3; i++)
-  {
-    origin[i] = iorigin[i];
-  }
-  output->SetOrigin(origin);
 }
 
 mitk::IGTLMessageToUSImageFilter::IGTLMessageToUSImageFilter()
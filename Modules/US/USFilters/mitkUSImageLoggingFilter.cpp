@@ -26,12 +26,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_StreamWriter(USImageStreamWriter::New())
 {
 }
 
 mitk::USImageLoggingFilter::~USImageLoggingFilter()
 {
+  this->StopStreaming();
 }
 
 void mitk::USImageLoggingFilter::GenerateData()
@@ -45,6 +47,13 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  //while streaming, the image is copied to a preallocated buffer and written by the stream writer's thread
+  if (m_StreamWriter->IsOpen())
+    {
+    m_StreamWriter->Write(inputImage, m_SystemTimeClock->GetCurrentStamp());
+    return;
+    }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -83,6 +92,13 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (m_StreamWriter->IsOpen())
+    {
+    //a message for a dropped image must not be attached to the image before it
+    if (m_StreamWriter->GetNumberOfFrames() > 0 && !m_StreamWriter->IsLastFrameDropped())
+      m_StreamWriter->AddMessage(m_StreamWriter->GetNumberOfFrames() - 1, message);
+    return;
+    }
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
@@ -163,3 +179,29 @@ bool mitk::USImageLoggingFilter::SetImageFilesExtension(std::string extension)
   }
   return false;
  }
+
+void mitk::USImageLoggingFilter::StartStreaming(const std::string& fileName)
+{
+  mitk::Image::ConstPointer inputImage = this->GetInput();
+  m_StreamWriter->Open(fileName, inputImage.GetPointer());
+}
+
+void mitk::USImageLoggingFilter::StopStreaming()
+{
+  m_StreamWriter->Close();
+}
+
+bool mitk::USImageLoggingFilter::IsStreaming() const
+{
+  return m_StreamWriter->IsOpen();
+}
+
+void mitk::USImageLoggingFilter::SetStreamingFramePoolSize(unsigned int size)
+{
+  m_StreamWriter->SetFramePoolSize(size);
+}
+
+unsigned int mitk::USImageLoggingFilter::GetNumberOfDroppedImages() const
+{
+  return m_StreamWriter->GetNumberOfDroppedFrames();
+}
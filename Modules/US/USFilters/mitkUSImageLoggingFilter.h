@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkUSExports.h>
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
+#include "mitkUSImageStreamWriter.h"
 
 
 namespace mitk {
@@ -29,6 +30,10 @@ namespace mitk {
    *  add messages. All data (images, timestamps and messages) is written to the harddisc when
    *  the method SaveImages(...) is called.
    *
+   *  For long recordings the images can instead be streamed to a single file while they are logged,
+   *  see StartStreaming(...). Then no images are kept in memory and a background thread writes
+   *  them to the harddisc, so Update() does not wait for the disc.
+   *
    *  Caution: only supports logging of one input at the moment, multiple inputs are ignored!
    *
    *  \ingroup US
@@ -76,6 +81,26 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Starts streaming all images which are logged from now on to the given file (see mitk::USImageStreamWriter).
+     *  Messages added by AddMessageToCurrentImage(...) are written to the file as well. The images are not
+     *  kept in memory and thus are not written by SaveImages(...). The file can be read by mitk::USImageStreamReader.
+     *  @throw mitk::Exception if the file cannot be created.
+     */
+    void StartStreaming(const std::string& fileName);
+
+    /** Writes all remaining images to the file and closes it. */
+    void StopStreaming();
+
+    bool IsStreaming() const;
+
+    /** Sets the number of images which may wait for the disc while streaming. If more images are logged
+     *  in the meantime, they are dropped. Default is 16, takes effect on the next call of StartStreaming(...).
+     */
+    void SetStreamingFramePoolSize(unsigned int size);
+
+    /** Returns the number of images which were dropped since StartStreaming(...) because the disc was too slow. */
+    unsigned int GetNumberOfDroppedImages() const;
+
 
   protected:
     USImageLoggingFilter();
@@ -89,6 +114,8 @@ namespace mitk {
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
 
+    mitk::USImageStreamWriter::Pointer m_StreamWriter; ///< writes the logged images to disc while streaming
+
   };
 } // namespace mitk
 #endif /* MITKUSImageSource_H_HEADER_INCLUDED_ */
@@ -0,0 +1,232 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#include "mitkUSImageStreamReader.h"
+#include "mitkUSImageStreamWriter.h"
+
+#include <itkRawImageIO.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+  template <typename T>
+  T ReadValue(std::istream& stream)
+  {
+    T value = T();
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return value;
+  }
+
+  struct FrameHeader
+  {
+    std::uint32_t Index;
+    double TimeStamp;
+    std::uint32_t Dimension;
+    unsigned int Dimensions[3];
+    double Spacing[3];
+    double Origin[3];
+    std::uint32_t ComponentType;
+    std::uint32_t PixelType;
+    std::uint32_t NumberOfComponents;
+    std::uint32_t BytesPerPixel;
+    std::uint64_t DataSize;
+  };
+
+  /** reads the frame record header following the record type */
+  FrameHeader ReadFrameHeader(std::istream& stream)
+  {
+    FrameHeader header;
+    header.Index = ReadValue<std::uint32_t>(stream);
+    header.TimeStamp = ReadValue<double>(stream);
+    header.Dimension = ReadValue<std::uint32_t>(stream);
+    for (unsigned int i = 0; i < 3; ++i)
+      header.Dimensions[i] = ReadValue<std::uint32_t>(stream);
+    for (unsigned int i = 0; i < 3; ++i)
+      header.Spacing[i] = ReadValue<double>(stream);
+    for (unsigned int i = 0; i < 3; ++i)
+      header.Origin[i] = ReadValue<double>(stream);
+    header.ComponentType = ReadValue<std::uint32_t>(stream);
+    header.PixelType = ReadValue<std::uint32_t>(stream);
+    header.NumberOfComponents = ReadValue<std::uint32_t>(stream);
+    header.BytesPerPixel = ReadValue<std::uint32_t>(stream);
+    header.DataSize = ReadValue<std::uint64_t>(stream);
+    return header;
+  }
+}
+
+mitk::USImageStreamReader::USImageStreamReader()
+{
+}
+
+mitk::USImageStreamReader::~USImageStreamReader()
+{
+}
+
+void mitk::USImageStreamReader::Read(const std::string& fileName)
+{
+  if (m_File.is_open())
+  {
+    m_File.close();
+  }
+  m_File.clear();
+  m_Frames.clear();
+  m_Messages.clear();
+  m_FileName = fileName;
+
+  m_File.open(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!m_File.is_open())
+  {
+    mitkThrow() << "File '" << fileName << "' could not be opened.";
+  }
+
+  m_File.seekg(0, std::ios::end);
+  const std::streamoff fileSize = m_File.tellg();
+  m_File.seekg(0, std::ios::beg);
+
+  char magic[sizeof(USImageStreamWriter::MAGIC)];
+  m_File.read(magic, sizeof(magic));
+  std::uint32_t version = ReadValue<std::uint32_t>(m_File);
+  std::uint32_t byteOrderMark = ReadValue<std::uint32_t>(m_File);
+  if (!m_File.good() || std::memcmp(magic, USImageStreamWriter::MAGIC, sizeof(magic)) != 0)
+  {
+    mitkThrow() << "File '" << fileName << "' is not an ultrasound image stream.";
+  }
+  if (version != USImageStreamWriter::VERSION)
+  {
+    mitkThrow() << "Unsupported version " << version << " of ultrasound image stream '" << fileName << "'.";
+  }
+  if (byteOrderMark != USImageStreamWriter::BYTE_ORDER_MARK)
+  {
+    mitkThrow() << "Ultrasound image stream '" << fileName << "' was written with another byte order.";
+  }
+
+  while (true)
+  {
+    const std::streamoff offset = m_File.tellg();
+    std::uint32_t type = ReadValue<std::uint32_t>(m_File);
+    if (!m_File.good())
+    {
+      break;
+    }
+
+    if (type == USImageStreamWriter::FrameRecord)
+    {
+      FrameHeader header = ReadFrameHeader(m_File);
+      if (!m_File.good() || m_File.tellg() + static_cast<std::streamoff>(header.DataSize) > fileSize)
+      {
+        break;
+      }
+      m_File.seekg(static_cast<std::streamoff>(header.DataSize), std::ios::cur);
+
+      FrameEntry entry;
+      entry.Offset = offset;
+      entry.TimeStamp = header.TimeStamp;
+      m_Frames.push_back(entry);
+    }
+    else if (type == USImageStreamWriter::MessageRecord)
+    {
+      std::uint32_t index = ReadValue<std::uint32_t>(m_File);
+      std::uint64_t length = ReadValue<std::uint64_t>(m_File);
+      if (!m_File.good() || m_File.tellg() + static_cast<std::streamoff>(length) > fileSize)
+      {
+        break;
+      }
+      std::string message(static_cast<std::size_t>(length), '\0');
+      m_File.read(&message[0], message.size());
+      m_Messages[index] = message;
+    }
+    else
+    {
+      MITK_WARN << "Unknown record in ultrasound image stream '" << fileName << "', ignoring the rest of the file.";
+      break;
+    }
+  }
+
+  m_File.clear();
+  this->Modified();
+}
+
+unsigned int mitk::USImageStreamReader::GetNumberOfImages() const
+{
+  return static_cast<unsigned int>(m_Frames.size());
+}
+
+mitk::Image::Pointer mitk::USImageStreamReader::GetImage(unsigned int index)
+{
+  if (index >= m_Frames.size())
+  {
+    mitkThrow() << "Image " << index << " does not exist in '" << m_FileName << "', which has " << m_Frames.size()
+                << " images.";
+  }
+
+  m_File.seekg(m_Frames[index].Offset + static_cast<std::streamoff>(sizeof(std::uint32_t)), std::ios::beg);
+  FrameHeader header = ReadFrameHeader(m_File);
+
+  // the raw image io only serves as description of the pixel type
+  typedef itk::RawImageIO<unsigned char, 3> PixelTypeDescriptionType;
+  PixelTypeDescriptionType::Pointer description = PixelTypeDescriptionType::New();
+  description->SetComponentType(static_cast<itk::ImageIOBase::IOComponentType>(header.ComponentType));
+  description->SetPixelType(static_cast<itk::ImageIOBase::IOPixelType>(header.PixelType));
+  description->SetNumberOfComponents(header.NumberOfComponents);
+  mitk::PixelType pixelType = mitk::MakePixelType(description.GetPointer());
+
+  if (pixelType.GetSize() != header.BytesPerPixel)
+  {
+    mitkThrow() << "Image " << index << " in '" << m_FileName << "' has an unsupported pixel type.";
+  }
+
+  std::vector<char> data(static_cast<std::size_t>(header.DataSize));
+  m_File.read(data.data(), data.size());
+  if (!m_File.good())
+  {
+    m_File.clear();
+    mitkThrow() << "Image " << index << " could not be read from '" << m_FileName << "'.";
+  }
+
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(pixelType, header.Dimension, header.Dimensions);
+  image->SetImportVolume(data.data(), 0, 0, mitk::Image::CopyMemory);
+
+  mitk::Vector3D spacing;
+  mitk::Point3D origin;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    spacing[i] = header.Spacing[i];
+    origin[i] = header.Origin[i];
+  }
+  image->SetSpacing(spacing);
+  image->SetOrigin(origin);
+
+  return image;
+}
+
+double mitk::USImageStreamReader::GetTimeStamp(unsigned int index) const
+{
+  if (index >= m_Frames.size())
+  {
+    mitkThrow() << "Image " << index << " does not exist in '" << m_FileName << "'.";
+  }
+  return m_Frames[index].TimeStamp;
+}
+
+std::string mitk::USImageStreamReader::GetMessage(unsigned int index) const
+{
+  auto message = m_Messages.find(index);
+  return message != m_Messages.end() ? message->second : std::string();
+}
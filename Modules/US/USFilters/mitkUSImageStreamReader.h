@@ -0,0 +1,78 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKUSIMAGESTREAMREADER_H_HEADER_INCLUDED_
+#define MITKUSIMAGESTREAMREADER_H_HEADER_INCLUDED_
+
+#include <MitkUSExports.h>
+#include <mitkImage.h>
+
+#include <itkObject.h>
+
+#include <fstream>
+#include <map>
+
+namespace mitk {
+  /** Reads a file written by mitk::USImageStreamWriter.
+   *
+   *  Read() only indexes the records of the file, the images are loaded from the file when they are
+   *  requested by GetImage(). An incomplete last record (e.g. of an interrupted recording) is ignored.
+   *
+   *  \ingroup US
+   */
+  class MITKUS_EXPORT USImageStreamReader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageStreamReader, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** Opens and indexes the given file. A previously read file is closed.
+     *  @throw mitk::Exception if the file cannot be opened or was not written by mitk::USImageStreamWriter.
+     */
+    void Read(const std::string& fileName);
+
+    unsigned int GetNumberOfImages() const;
+
+    /** Loads the image with the given index from the file.
+     *  @throw mitk::Exception if the index is out of range or the image cannot be read.
+     */
+    mitk::Image::Pointer GetImage(unsigned int index);
+
+    /** Returns the time stamp which was passed to mitk::USImageStreamWriter::Write() for the image. */
+    double GetTimeStamp(unsigned int index) const;
+
+    /** Returns the message of the image with the given index or an empty string if there is none. */
+    std::string GetMessage(unsigned int index) const;
+
+  protected:
+    USImageStreamReader();
+    virtual ~USImageStreamReader();
+
+    struct FrameEntry
+    {
+      std::streamoff Offset; ///< position of the frame record in the file
+      double TimeStamp;
+    };
+
+    std::ifstream m_File;
+    std::string m_FileName;
+    std::vector<FrameEntry> m_Frames;
+    std::map<unsigned int, std::string> m_Messages;
+  };
+} // namespace mitk
+
+#endif /* MITKUSIMAGESTREAMREADER_H_HEADER_INCLUDED_ */
@@ -0,0 +1,240 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#include "mitkUSImageStreamWriter.h"
+#include <mitkImageReadAccessor.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+const char mitk::USImageStreamWriter::MAGIC[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'I', 'S' };
+
+namespace
+{
+  const std::size_t FRAME_HEADER_SIZE = 6 * sizeof(std::uint32_t) + 7 * sizeof(double) + 4 * sizeof(std::uint32_t)
+                                        + sizeof(std::uint64_t);
+
+  template <typename T>
+  void Append(char *&position, T value)
+  {
+    std::memcpy(position, &value, sizeof(value));
+    position += sizeof(value);
+  }
+
+  std::size_t GetVolumeSize(const mitk::Image *image)
+  {
+    std::size_t size = image->GetPixelType().GetSize();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      size *= image->GetDimension(i);
+    }
+    return size;
+  }
+}
+
+mitk::USImageStreamWriter::USImageStreamWriter()
+  : m_FramePoolSize(16), m_NumberOfFrames(0), m_NumberOfDroppedFrames(0), m_LastFrameDropped(false)
+{
+}
+
+mitk::USImageStreamWriter::~USImageStreamWriter()
+{
+  this->Close();
+}
+
+void mitk::USImageStreamWriter::Open(const std::string& fileName, const mitk::Image* prototype)
+{
+  this->Close();
+
+  char header[sizeof(MAGIC) + 2 * sizeof(std::uint32_t)];
+  char* position = header;
+  std::memcpy(position, MAGIC, sizeof(MAGIC));
+  position += sizeof(MAGIC);
+  Append<std::uint32_t>(position, VERSION);
+  Append<std::uint32_t>(position, BYTE_ORDER_MARK);
+
+  if (!m_FileWriter.Open(fileName, header, sizeof(header)))
+  {
+    mitkThrow() << "File '" << fileName << "' could not be opened for writing.";
+  }
+
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_LastFrameDropped = false;
+
+  // with a prototype all slots get their final size here, Write() then only copies into them
+  RecordBufferType slotPrototype;
+  if (prototype != nullptr && prototype->IsInitialized())
+  {
+    slotPrototype.assign(FRAME_HEADER_SIZE + GetVolumeSize(prototype), '\0');
+  }
+  m_FramePool.reset(new FramePoolType(m_FramePoolSize, slotPrototype));
+
+  m_FileWriter.Start([this]() { return this->WriteBufferedRecords(); });
+
+  this->Modified();
+}
+
+void mitk::USImageStreamWriter::Close()
+{
+  if (m_FileWriter.IsOpen())
+  {
+    m_FileWriter.Close();
+    this->Modified();
+  }
+
+  m_FramePool.reset();
+  m_PendingMessages.clear();
+}
+
+bool mitk::USImageStreamWriter::IsOpen() const
+{
+  return m_FileWriter.IsOpen();
+}
+
+bool mitk::USImageStreamWriter::Write(const mitk::Image* image, double timeStamp)
+{
+  if (m_FramePool == nullptr || image == nullptr || !image->IsInitialized())
+  {
+    return false;
+  }
+
+  // reset when the frame was queued
+  m_LastFrameDropped = true;
+
+  RecordBufferType* record = m_FramePool->Back();
+  if (record == nullptr)
+  {
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  const mitk::PixelType pixelType = image->GetPixelType();
+  const mitk::Vector3D spacing = image->GetGeometry()->GetSpacing();
+  const mitk::Point3D origin = image->GetGeometry()->GetOrigin();
+  const std::size_t dataSize = GetVolumeSize(image);
+
+  // keeps the capacity of the slot, so nothing is allocated once a slot was used for a frame of this size
+  record->resize(FRAME_HEADER_SIZE + dataSize);
+
+  char* position = record->data();
+  Append<std::uint32_t>(position, FrameRecord);
+  Append<std::uint32_t>(position, m_NumberOfFrames);
+  Append<double>(position, timeStamp);
+  Append<std::uint32_t>(position, std::min(image->GetDimension(), 3u)); // only the first volume is written
+  for (unsigned int i = 0; i < 3; ++i)
+    Append<std::uint32_t>(position, image->GetDimension(i));
+  for (unsigned int i = 0; i < 3; ++i)
+    Append<double>(position, spacing[i]);
+  for (unsigned int i = 0; i < 3; ++i)
+    Append<double>(position, origin[i]);
+  Append<std::uint32_t>(position, pixelType.GetComponentType());
+  Append<std::uint32_t>(position, pixelType.GetPixelType());
+  Append<std::uint32_t>(position, pixelType.GetNumberOfComponents());
+  Append<std::uint32_t>(position, pixelType.GetSize());
+  Append<std::uint64_t>(position, dataSize);
+
+  try
+  {
+    mitk::ImageReadAccessor readAccess(image, image->GetVolumeData(0));
+    std::memcpy(position, readAccess.GetData(), dataSize);
+  }
+  catch (const mitk::Exception& e)
+  {
+    MITK_WARN << "Could not access image data, frame is not written: " << e.GetDescription();
+    return false;
+  }
+
+  m_FramePool->PushBack();
+  m_FileWriter.RecordQueued();
+  ++m_NumberOfFrames;
+  m_LastFrameDropped = false;
+  return true;
+}
+
+void mitk::USImageStreamWriter::AddMessage(unsigned int frameIndex, const std::string& message)
+{
+  if (m_FramePool == nullptr)
+  {
+    return;
+  }
+
+  RecordBufferType record(2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + message.size());
+  char* position = record.data();
+  Append<std::uint32_t>(position, MessageRecord);
+  Append<std::uint32_t>(position, frameIndex);
+  Append<std::uint64_t>(position, message.size());
+  std::memcpy(position, message.data(), message.size());
+
+  m_MessageMutex.Lock();
+  m_PendingMessages.push_back(std::move(record));
+  m_MessageMutex.Unlock();
+  m_FileWriter.RecordQueued();
+}
+
+bool mitk::USImageStreamWriter::Flush()
+{
+  return m_FileWriter.Flush();
+}
+
+bool mitk::USImageStreamWriter::HasFailed() const
+{
+  return m_FileWriter.HasFailed();
+}
+
+unsigned int mitk::USImageStreamWriter::GetNumberOfFrames() const
+{
+  return m_NumberOfFrames;
+}
+
+unsigned int mitk::USImageStreamWriter::GetNumberOfDroppedFrames() const
+{
+  return m_NumberOfDroppedFrames;
+}
+
+bool mitk::USImageStreamWriter::IsLastFrameDropped() const
+{
+  return m_LastFrameDropped;
+}
+
+unsigned int mitk::USImageStreamWriter::WriteBufferedRecords()
+{
+  unsigned int taken = 0;
+
+  // after a failure the records are still taken from the queues, BackgroundFileWriter discards them
+  const RecordBufferType* record;
+  while ((record = m_FramePool->Front()) != nullptr)
+  {
+    m_FileWriter.Write(record->data(), record->size());
+    m_FramePool->PopFront();
+    ++taken;
+  }
+
+  std::vector<RecordBufferType> messages;
+  m_MessageMutex.Lock();
+  messages.swap(m_PendingMessages);
+  m_MessageMutex.Unlock();
+
+  for (auto message = messages.begin(); message != messages.end(); ++message)
+  {
+    m_FileWriter.Write(message->data(), message->size());
+    ++taken;
+  }
+
+  return taken;
+}
@@ -0,0 +1,139 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+
+#ifndef MITKUSIMAGESTREAMWRITER_H_HEADER_INCLUDED_
+#define MITKUSIMAGESTREAMWRITER_H_HEADER_INCLUDED_
+
+#include <MitkUSExports.h>
+#include <mitkBackgroundFileWriter.h>
+#include <mitkImage.h>
+#include <mitkLockFreeRingBuffer.h>
+
+#include <itkObject.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <atomic>
+#include <memory>
+
+namespace mitk {
+  /** Writes images, e.g. the frames of an ultrasound device, together with time stamps and messages
+   *  to a single append-only file while they are acquired.
+   *
+   *  Write() copies the first time step of an image into a slot of a preallocated frame pool and
+   *  returns immediately, a mitk::BackgroundFileWriter appends the frames to the file. If the disk cannot
+   *  keep up and all slots are in use, frames are dropped and counted (see GetNumberOfDroppedFrames()).
+   *  Thus memory usage is bounded by the pool size, independent of the length of the recording.
+   *  Write() and AddMessage() must always be called from the same thread. If writing to the file fails,
+   *  the error is logged once and HasFailed() returns true.
+   *
+   *  The file starts with the 8 byte magic "MITKUSIS", a version and a byte order mark (uint32 each),
+   *  followed by records in native byte order. Each record starts with its type (uint32):
+   *   - frame record: frame index (uint32), time stamp (double), dimension and three dimensions (uint32),
+   *     spacing and origin (3 doubles each), component type, pixel type, number of components and
+   *     bytes per pixel (uint32 each), data size (uint64) and the pixel data
+   *   - message record: frame index (uint32), length (uint64) and the characters of the message
+   *
+   *  Messages are written independently of the frames and may precede the frame they refer to.
+   *
+   *  Use mitk::USImageStreamReader to read the file.
+   *
+   *  \ingroup US
+   */
+  class MITKUS_EXPORT USImageStreamWriter : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageStreamWriter, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    enum RecordType
+    {
+      FrameRecord = 1,
+      MessageRecord = 2
+    };
+
+    static const char MAGIC[8];
+    static const unsigned int VERSION = 1;
+    static const unsigned int BYTE_ORDER_MARK = 0x01020304;
+
+    /** Number of frames that can wait for the writer thread. Default is 16.
+     *  Takes effect on the next call of Open().
+     */
+    itkSetMacro(FramePoolSize, unsigned int);
+    itkGetMacro(FramePoolSize, unsigned int);
+
+    /** Creates the file and starts the writer thread. A previously opened file is closed.
+     *  If a prototype image is given, the frame pool is allocated for its size right away,
+     *  otherwise each slot is allocated when it is used the first time.
+     *  @throw mitk::Exception if the file cannot be created.
+     */
+    void Open(const std::string& fileName, const mitk::Image* prototype = nullptr);
+
+    /** Writes all buffered frames and messages, stops the writer thread and closes the file. */
+    void Close();
+
+    bool IsOpen() const;
+
+    /** Queues the first time step of image for writing.
+     *  @return false if the writer is not open or the frame was dropped because the pool is full.
+     */
+    bool Write(const mitk::Image* image, double timeStamp);
+
+    /** Queues a message that belongs to the frame with the given index. */
+    void AddMessage(unsigned int frameIndex, const std::string& message);
+
+    /** Blocks until all frames and messages queued so far are written to the file.
+     *  @return false if writing failed since Open().
+     */
+    bool Flush();
+
+    bool HasFailed() const;
+
+    /** Returns the number of frames queued by Write() since Open(), i.e. the index of the next frame. */
+    unsigned int GetNumberOfFrames() const;
+
+    /** Returns the number of frames that were dropped because the pool was full. */
+    unsigned int GetNumberOfDroppedFrames() const;
+
+    /** Returns true if the last call of Write() did not queue its frame. Messages for that frame
+     *  must not be added to the frame before it.
+     */
+    bool IsLastFrameDropped() const;
+
+  protected:
+    USImageStreamWriter();
+    virtual ~USImageStreamWriter();
+
+    /** Writes the queued frames and messages, called by the background file writer. */
+    unsigned int WriteBufferedRecords();
+
+    typedef std::vector<char> RecordBufferType;
+    typedef LockFreeRingBuffer<RecordBufferType> FramePoolType;
+
+    std::unique_ptr<FramePoolType> m_FramePool;
+    unsigned int m_FramePoolSize;
+    BackgroundFileWriter m_FileWriter;
+
+    std::vector<RecordBufferType> m_PendingMessages; ///< encoded message records, guarded by m_MessageMutex
+    itk::SimpleFastMutexLock m_MessageMutex;
+
+    std::atomic<unsigned int> m_NumberOfFrames;
+    std::atomic<unsigned int> m_NumberOfDroppedFrames;
+    bool m_LastFrameDropped; ///< only used by the thread that calls Write() and AddMessage()
+  };
+} // namespace mitk
+
+#endif /* MITKUSIMAGESTREAMWRITER_H_HEADER_INCLUDED_ */
@@ -15,6 +15,8 @@ USModel/mitkUSDevicePersistence.cpp
 
 ## Filters and Sources
 USFilters/mitkUSImageLoggingFilter.cpp
+USFilters/mitkUSImageStreamWriter.cpp
+USFilters/mitkUSImageStreamReader.cpp
 USFilters/mitkUSImageSource.cpp
 USFilters/mitkUSImageVideoSource.cpp
 USFilters/mitkIGTLMessageToUSImageFilter.cpp
@@ -161,7 +161,7 @@ struct SelListenerDeformableRegistration : ISelectionListener
 };
 
 QmitkDeformableRegistrationView::QmitkDeformableRegistrationView(QObject * /*parent*/, const char * /*name*/)
-: QmitkFunctionality() , m_MultiWidget(NULL), m_MovingNode(NULL), m_FixedNode(NULL), m_ShowRedGreen(false),
+: QmitkFunctionality() , m_MultiWidget(NULL), m_MovingNode(NULL), m_FixedNode(NULL), m_DemonsMovingNode(NULL), m_ShowRedGreen(false),
   m_Opacity(0.5), m_OriginalOpacity(1.0), m_Deactivated(false)
 {
   this->GetDataStorage()->RemoveNodeEvent.AddListener(mitk::MessageDelegate1<QmitkDeformableRegistrationView,
@@ -230,7 +230,11 @@ void QmitkDeformableRegistrationView::DataNodeHasBeenRemoved(const mitk::DataNod
     m_Controls.m_DeformableTransform->hide();
     m_Controls.m_CalculateTransformation->setEnabled(false);
   }
-
+  if (node == m_DemonsMovingNode)
+  {
+    // the results of the running registration are added without a parent
+    m_DemonsMovingNode = NULL;
+  }
 }
 
 void QmitkDeformableRegistrationView::ApplyDeformationField()
@@ -299,6 +303,7 @@ void QmitkDeformableRegistrationView::CreateConnections()
   connect((QObject*)(m_Controls.m_SwitchImages),SIGNAL(clicked()),this,SLOT(SwitchImages()));
   connect(this,SIGNAL(calculateBSplineRegistration()),m_Controls.m_QmitkBSplineRegistrationViewControls,SLOT(CalculateTransformation()));
   connect( m_Controls.m_WarpImageButton, SIGNAL(clicked()), this, SLOT(ApplyDeformationField()) );
+  connect(m_Controls.m_QmitkDemonsRegistrationViewControls, SIGNAL(transformationCalculated()), this, SLOT(DemonsRegistrationCalculated()));
 }
 
 void QmitkDeformableRegistrationView::Activated()
@@ -508,7 +513,8 @@ void QmitkDeformableRegistrationView::OpacityUpdate(int opacity)
 
 void QmitkDeformableRegistrationView::CheckCalculateEnabled()
 {
-  if (m_FixedNode.IsNotNull() && m_MovingNode.IsNotNull())
+  if (m_FixedNode.IsNotNull() && m_MovingNode.IsNotNull() &&
+      !m_Controls.m_QmitkDemonsRegistrationViewControls->IsCalculating())
   {
     m_Controls.m_CalculateTransformation->setEnabled(true);
   }
@@ -524,43 +530,12 @@ void QmitkDeformableRegistrationView::Calculate()
   {
     m_Controls.m_QmitkDemonsRegistrationViewControls->SetFixedNode(m_FixedNode);
     m_Controls.m_QmitkDemonsRegistrationViewControls->SetMovingNode(m_MovingNode);
-    try
-    {
-      m_Controls.m_QmitkDemonsRegistrationViewControls->CalculateTransformation();
-    }
-    catch (itk::ExceptionObject& excpt)
-    {
-      QMessageBox::information( NULL, "Registration exception", excpt.GetDescription(), QMessageBox::Ok );
-      return;
-    }
-    mitk::Image::Pointer resultImage = m_Controls.m_QmitkDemonsRegistrationViewControls->GetResultImage();
-    mitk::Image::Pointer resultDeformationField = m_Controls.m_QmitkDemonsRegistrationViewControls->GetResultDeformationfield();
-    if (resultImage.IsNotNull())
-    {
-      mitk::DataNode::Pointer resultImageNode = mitk::DataNode::New();
-      resultImageNode->SetData(resultImage);
-      mitk::LevelWindowProperty::Pointer levWinProp = mitk::LevelWindowProperty::New();
-      mitk::LevelWindow levelWindow;
-      levelWindow.SetAuto( resultImage );
-      levWinProp->SetLevelWindow(levelWindow);
-      resultImageNode->GetPropertyList()->SetProperty("levelwindow",levWinProp);
-      resultImageNode->SetStringProperty("name", "DeformableRegistrationResultImage");
-      this->GetDataStorage()->Add(resultImageNode, m_MovingNode);
-    }
-    if (resultDeformationField.IsNotNull())
+    // the registration runs in a background thread, the results are added by DemonsRegistrationCalculated()
+    m_DemonsMovingNode = m_MovingNode;
+    m_Controls.m_QmitkDemonsRegistrationViewControls->CalculateTransformation();
+    if (m_Controls.m_QmitkDemonsRegistrationViewControls->IsCalculating())
     {
-      mitk::DataNode::Pointer resultDeformationFieldNode = mitk::DataNode::New();
-      resultDeformationFieldNode->SetData(resultDeformationField);
-      mitk::LevelWindowProperty::Pointer levWinProp = mitk::LevelWindowProperty::New();
-      mitk::LevelWindow levelWindow;
-      levelWindow.SetAuto( resultDeformationField );
-      levWinProp->SetLevelWindow(levelWindow);
-      resultDeformationFieldNode->GetPropertyList()->SetProperty("levelwindow",levWinProp);
-      resultDeformationFieldNode->SetStringProperty("name", "DeformableRegistrationResultDeformationField");
-      mitk::VectorImageMapper2D::Pointer mapper = mitk::VectorImageMapper2D::New();
-      resultDeformationFieldNode->SetMapper(1, mapper);
-      resultDeformationFieldNode->SetVisibility(false);
-      this->GetDataStorage()->Add(resultDeformationFieldNode, m_MovingNode);
+      m_Controls.m_CalculateTransformation->setEnabled(false);
     }
   }
 
@@ -572,6 +547,43 @@ void QmitkDeformableRegistrationView::Calculate()
   }
 }
 
+void QmitkDeformableRegistrationView::DemonsRegistrationCalculated()
+{
+  mitk::DataNode::Pointer movingNode = m_DemonsMovingNode;
+  m_DemonsMovingNode = nullptr;
+  this->CheckCalculateEnabled();
+
+  mitk::Image::Pointer resultImage = m_Controls.m_QmitkDemonsRegistrationViewControls->GetResultImage();
+  mitk::Image::Pointer resultDeformationField = m_Controls.m_QmitkDemonsRegistrationViewControls->GetResultDeformationfield();
+  if (resultImage.IsNotNull())
+  {
+    mitk::DataNode::Pointer resultImageNode = mitk::DataNode::New();
+    resultImageNode->SetData(resultImage);
+    mitk::LevelWindowProperty::Pointer levWinProp = mitk::LevelWindowProperty::New();
+    mitk::LevelWindow levelWindow;
+    levelWindow.SetAuto( resultImage );
+    levWinProp->SetLevelWindow(levelWindow);
+    resultImageNode->GetPropertyList()->SetProperty("levelwindow",levWinProp);
+    resultImageNode->SetStringProperty("name", "DeformableRegistrationResultImage");
+    this->GetDataStorage()->Add(resultImageNode, movingNode);
+  }
+  if (resultDeformationField.IsNotNull())
+  {
+    mitk::DataNode::Pointer resultDeformationFieldNode = mitk::DataNode::New();
+    resultDeformationFieldNode->SetData(resultDeformationField);
+    mitk::LevelWindowProperty::Pointer levWinProp = mitk::LevelWindowProperty::New();
+    mitk::LevelWindow levelWindow;
+    levelWindow.SetAuto( resultDeformationField );
+    levWinProp->SetLevelWindow(levelWindow);
+    resultDeformationFieldNode->GetPropertyList()->SetProperty("levelwindow",levWinProp);
+    resultDeformationFieldNode->SetStringProperty("name", "DeformableRegistrationResultDeformationField");
+    mitk::VectorImageMapper2D::Pointer mapper = mitk::VectorImageMapper2D::New();
+    resultDeformationFieldNode->SetMapper(1, mapper);
+    resultDeformationFieldNode->SetVisibility(false);
+    this->GetDataStorage()->Add(resultDeformationFieldNode, movingNode);
+  }
+}
+
 void QmitkDeformableRegistrationView::SetImagesVisible(berry::ISelection::ConstPointer /*selection*/)
 {
   if (this->m_CurrentSelection->Size() == 0)
@@ -175,6 +175,11 @@ class REGISTRATION_EXPORT QmitkDeformableRegistrationView : public QmitkFunction
     */
     void Calculate();
 
+    /*!
+    \brief Adds the results of the demons registration, which runs in a background thread.
+    */
+    void DemonsRegistrationCalculated();
+
      /*!
      * Prints the values of the deformationfield
      */
@@ -203,6 +208,8 @@ class REGISTRATION_EXPORT QmitkDeformableRegistrationView : public QmitkFunction
     Ui::QmitkDeformableRegistrationViewControls m_Controls;
     mitk::DataNode::Pointer m_MovingNode;
     mitk::DataNode::Pointer m_FixedNode;
+    /// moving node of the running demons registration, the parent of its results
+    mitk::DataNode::Pointer m_DemonsMovingNode;
     bool m_ShowRedGreen;
     float m_Opacity;
     float m_OriginalOpacity;